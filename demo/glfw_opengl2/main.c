@@ -77,6 +77,7 @@ int main(void)
     int width = 0, height = 0;
     struct nk_context *ctx;
     struct nk_colorf bg;
+    double now, last;
 
     /* GLFW */
     glfwSetErrorCallback(error_callback);
@@ -112,10 +113,19 @@ int main(void)
     #endif
 
     bg.r = 0.10f, bg.g = 0.18f, bg.b = 0.24f, bg.a = 1.0f;
+    last = glfwGetTime();
     while (!glfwWindowShouldClose(win))
     {
-        /* Input */
-        glfwPollEvents();
+        /* Input: block while the UI is idle */
+        if (nk_needs_redraw(ctx)) glfwPollEvents();
+        else {
+            float deadline = nk_redraw_deadline(ctx);
+            if (deadline < 0) glfwWaitEvents();
+            else glfwWaitEventsTimeout(deadline);
+        }
+        now = glfwGetTime();
+        ctx->delta_time_seconds = (float)(now - last);
+        last = now;
         nk_glfw3_new_frame();
 
         /* GUI */
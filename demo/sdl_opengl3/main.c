@@ -77,6 +77,7 @@ int main(void)
     SDL_GLContext glContext;
     int win_width, win_height;
     int running = 1;
+    Uint32 now, last;
 
     /* GUI */
     struct nk_context *ctx;
@@ -128,10 +129,19 @@ int main(void)
     #endif
 
     bg.r = 0.10f, bg.g = 0.18f, bg.b = 0.24f, bg.a = 1.0f;
+    last = SDL_GetTicks();
     while (running)
     {
-        /* Input */
+        /* Input: block while the UI is idle */
         SDL_Event evt;
+        if (!nk_needs_redraw(ctx)) {
+            float deadline = nk_redraw_deadline(ctx);
+            if (deadline < 0) SDL_WaitEvent(NULL);
+            else SDL_WaitEventTimeout(NULL, (int)(deadline * 1000.0f));
+        }
+        now = SDL_GetTicks();
+        ctx->delta_time_seconds = (float)(now - last) / 1000.0f;
+        last = now;
         nk_input_begin(ctx);
         while (SDL_PollEvent(&evt)) {
             if (evt.type == SDL_QUIT) goto cleanup;
@@ -60,9 +60,13 @@ int running = nk_true;
 static void
 MainLoop(void* loopArg){
     struct nk_context *ctx = (struct nk_context *)loopArg;
+    static Uint32 last;
+    Uint32 now = SDL_GetTicks();
 
     /* Input */
     SDL_Event evt;
+    ctx->delta_time_seconds = last ? (float)(now - last) / 1000.0f: 0;
+    last = now;
     nk_input_begin(ctx);
     while (SDL_PollEvent(&evt)) {
         if (evt.type == SDL_QUIT) running = nk_false;
@@ -179,7 +183,15 @@ int main(int argc, char* argv[])
     #include <emscripten.h>
     emscripten_set_main_loop_arg(MainLoop, (void*)ctx, 0, nk_true);
 #else
-    while (running) MainLoop((void*)ctx);
+    while (running) {
+        /* block while the UI is idle */
+        if (!nk_needs_redraw(ctx)) {
+            float deadline = nk_redraw_deadline(ctx);
+            if (deadline < 0) SDL_WaitEvent(NULL);
+            else SDL_WaitEventTimeout(NULL, (int)(deadline * 1000.0f));
+        }
+        MainLoop((void*)ctx);
+    }
 #endif
 
     nk_sdl_shutdown();
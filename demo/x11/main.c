@@ -7,6 +7,7 @@
 #include <limits.h>
 #include <math.h>
 #include <sys/time.h>
+#include <sys/select.h>
 #include <unistd.h>
 #include <time.h>
 
@@ -69,6 +70,21 @@ sleep_for(long t)
     while(-1 == nanosleep(&req, &req));
 }
 
+static void
+wait_for_event(Display *dpy, float timeout)
+{
+    /* blocks until an event arrives or the timeout in seconds runs out */
+    fd_set fds;
+    struct timeval tv;
+    int fd = ConnectionNumber(dpy);
+    if (XPending(dpy)) return;
+    FD_ZERO(&fds);
+    FD_SET(fd, &fds);
+    tv.tv_sec = (long)timeout;
+    tv.tv_usec = (long)((timeout - (float)tv.tv_sec) * 1000000.0f);
+    select(fd + 1, &fds, NULL, NULL, (timeout < 0) ? NULL : &tv);
+}
+
 /* ===============================================================
  *
  *                          EXAMPLE
@@ -111,7 +127,7 @@ int
 main(void)
 {
     long dt;
-    long started;
+    long started, last;
     int running = 1;
     XWindow xw;
     struct nk_context *ctx;
@@ -154,11 +170,17 @@ main(void)
     /*set_style(ctx, THEME_DARK);*/
     #endif
 
+    last = timestamp();
     while (running)
     {
         /* Input */
         XEvent evt;
+        /* block while the UI is idle */
+        if (!nk_needs_redraw(ctx))
+            wait_for_event(xw.dpy, nk_redraw_deadline(ctx));
         started = timestamp();
+        ctx->delta_time_seconds = (float)(started - last) / 1000.0f;
+        last = started;
         nk_input_begin(ctx);
         while (XPending(xw.dpy)) {
             XNextEvent(xw.dpy, &evt);
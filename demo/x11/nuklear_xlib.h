@@ -70,6 +70,9 @@ NK_API void                 nk_xfont_del(Display *dpy, XFont *font);
 #ifndef NK_X11_DOUBLE_CLICK_HI
 #define NK_X11_DOUBLE_CLICK_HI 200
 #endif
+#ifndef NK_XLIB_MAX_BATCH
+#define NK_XLIB_MAX_BATCH 256
+#endif
 
 typedef struct XSurface XSurface;
 typedef struct XImageWithAlpha XImageWithAlpha;
@@ -88,6 +91,10 @@ struct XSurface {
     Window root;
     Drawable drawable;
     unsigned int w, h;
+    /* solid rects of one color waiting for a single XFillRectangles */
+    XRectangle batch[NK_XLIB_MAX_BATCH];
+    int batch_count;
+    unsigned long batch_color;
 };
 struct XImageWithAlpha {
     XImage* ximage;
@@ -157,6 +164,29 @@ nk_xsurf_resize(XSurface *surf, unsigned int w, unsigned int h)
         (unsigned int)DefaultDepth(surf->dpy, surf->screen));
 }
 
+NK_INTERN void
+nk_xsurf_flush(XSurface *surf)
+{
+    if (!surf->batch_count) return;
+    XSetForeground(surf->dpy, surf->gc, surf->batch_color);
+    XFillRectangles(surf->dpy, surf->drawable, surf->gc, surf->batch, surf->batch_count);
+    surf->batch_count = 0;
+}
+
+NK_INTERN void
+nk_xsurf_batch_rect(XSurface *surf, short x, short y, unsigned short w,
+    unsigned short h, unsigned long c)
+{
+    XRectangle *r;
+    if (!w || !h) return;
+    if (surf->batch_count && (surf->batch_color != c || surf->batch_count == NK_XLIB_MAX_BATCH))
+        nk_xsurf_flush(surf);
+    surf->batch_color = c;
+    r = &surf->batch[surf->batch_count++];
+    r->x = x; r->y = y;
+    r->width = w; r->height = h;
+}
+
 NK_INTERN void
 nk_xsurf_scissor(XSurface *surf, float x, float y, float w, float h)
 {
@@ -214,8 +244,8 @@ nk_xsurf_fill_rect(XSurface* surf, short x, short y, unsigned short w,
     unsigned short h, unsigned short r, struct nk_color col)
 {
     unsigned long c = nk_color_from_byte(&col.r);
+    if (r == 0) {nk_xsurf_batch_rect(surf, x, y, w, h, c); return;}
     XSetForeground(surf->dpy, surf->gc, c);
-    if (r == 0) {XFillRectangle(surf->dpy, surf->drawable, surf->gc, x, y, w, h); return;}
 
     {short xc = x + r;
     short yc = y + r;
@@ -392,10 +422,10 @@ nk_xsurf_draw_text(XSurface *surf, short x, short y, unsigned short w, unsigned
     unsigned long bg = nk_color_from_byte(&cbg.r);
     unsigned long fg = nk_color_from_byte(&cfg.r);
 
-    XSetForeground(surf->dpy, surf->gc, bg);
-    XFillRectangle(surf->dpy, surf->drawable, surf->gc, (int)x, (int)y, (unsigned)w, (unsigned)h);
+    nk_xsurf_batch_rect(surf, x, y, w, h, bg);
     if(!text || !font || !len) return;
 
+    nk_xsurf_flush(surf);
     tx = (int)x;
     ty = (int)y + font->ascent;
     XSetForeground(surf->dpy, surf->gc, fg);
@@ -877,6 +907,10 @@ nk_xlib_render(Drawable screen, struct nk_color clear)
     nk_xsurf_clear(xlib.surf, nk_color_from_byte(&clear.r));
     nk_foreach(cmd, &xlib.ctx)
     {
+        /* solid rects are queued so everything else has to wait for them */
+        if (cmd->type != NK_COMMAND_TEXT && (cmd->type != NK_COMMAND_RECT_FILLED ||
+            ((const struct nk_command_rect_filled*)cmd)->rounding))
+            nk_xsurf_flush(surf);
         switch (cmd->type) {
         case NK_COMMAND_NOP: break;
         case NK_COMMAND_SCISSOR: {
@@ -952,6 +986,7 @@ nk_xlib_render(Drawable screen, struct nk_color clear)
         default: break;
         }
     }
+    nk_xsurf_flush(surf);
     nk_clear(ctx);
     nk_xsurf_blit(screen, surf, surf->w, surf->h);
 }
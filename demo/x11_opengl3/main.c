@@ -9,6 +9,8 @@
 #include <math.h>
 #include <time.h>
 #include <limits.h>
+#include <sys/time.h>
+#include <sys/select.h>
 
 #define NK_INCLUDE_FIXED_TYPES
 #define NK_INCLUDE_STANDARD_IO
@@ -114,10 +116,34 @@ has_extension(const char *string, const char *ext)
     return nk_false;
 }
 
+static long
+timestamp(void)
+{
+    struct timeval tv;
+    if (gettimeofday(&tv, NULL) < 0) return 0;
+    return (long)((long)tv.tv_sec * 1000 + (long)tv.tv_usec/1000);
+}
+
+static void
+wait_for_event(Display *dpy, float timeout)
+{
+    /* blocks until an event arrives or the timeout in seconds runs out */
+    fd_set fds;
+    struct timeval tv;
+    int fd = ConnectionNumber(dpy);
+    if (XPending(dpy)) return;
+    FD_ZERO(&fds);
+    FD_SET(fd, &fds);
+    tv.tv_sec = (long)timeout;
+    tv.tv_usec = (long)((timeout - (float)tv.tv_sec) * 1000000.0f);
+    select(fd + 1, &fds, NULL, NULL, (timeout < 0) ? NULL : &tv);
+}
+
 int main(void)
 {
     /* Platform */
     int running = 1;
+    long now, last;
     struct XWindow win;
     GLXContext glContext;
     struct nk_context *ctx;
@@ -256,10 +282,17 @@ int main(void)
     #endif
 
     bg.r = 0.10f, bg.g = 0.18f, bg.b = 0.24f, bg.a = 1.0f;
+    last = timestamp();
     while (running)
     {
         /* Input */
         XEvent evt;
+        /* block while the UI is idle */
+        if (!nk_needs_redraw(ctx))
+            wait_for_event(win.dpy, nk_redraw_deadline(ctx));
+        now = timestamp();
+        ctx->delta_time_seconds = (float)(now - last) / 1000.0f;
+        last = now;
         nk_input_begin(ctx);
         while (XPending(win.dpy)) {
             XNextEvent(win.dpy, &evt);
@@ -0,0 +1,161 @@
+/* nuklear - 1.32.0 - public domain */
+/* Headless rawfb benchmark. Renders a dashboard of many windows into a
+ * memory framebuffer with nk_rawfb_render and nk_rawfb_render_tiled,
+ * checks that both produce the same pixels and prints the render time
+ * for an increasing number of threads. The vertex path is timed as well.
+ *
+ *      ./bin/benchmark [width] [height] [frames] [max threads] [aa] */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <assert.h>
+#include <time.h>
+
+#define NK_INCLUDE_FIXED_TYPES
+#define NK_INCLUDE_STANDARD_IO
+#define NK_INCLUDE_STANDARD_VARARGS
+#define NK_INCLUDE_DEFAULT_ALLOCATOR
+#define NK_IMPLEMENTATION
+#define NK_RAWFB_IMPLEMENTATION
+#define NK_RAWFB_THREADS
+#define NK_INCLUDE_FONT_BAKING
+#define NK_INCLUDE_DEFAULT_FONT
+#define NK_INCLUDE_SOFTWARE_FONT
+#define NK_INCLUDE_VERTEX_BUFFER_OUTPUT
+#define NK_UINT_DRAW_INDEX /* a 4K dashboard needs more than 65535 vertices */
+
+#include "../../nuklear.h"
+#include "nuklear_rawfb.h"
+#include "../overview.c"
+
+static double
+timestamp(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+}
+
+static void
+dashboard(struct nk_context *ctx, int width, int height)
+{
+    int x, y, i;
+    const int w = 480, h = 420;
+    char title[32];
+    for (y = 0; y + h <= height; y += h) {
+        for (x = 0; x + w <= width; x += w) {
+            if (x == 0 && y == 0) continue;
+            sprintf(title, "Panel %d %d", x / w, y / h);
+            if (nk_begin(ctx, title, nk_rect((float)x, (float)y, (float)w, (float)h),
+                NK_WINDOW_BORDER|NK_WINDOW_TITLE|NK_WINDOW_NO_SCROLLBAR)) {
+                static nk_size progress = 40;
+                static float value = 0.3f;
+                nk_layout_row_dynamic(ctx, 20, 2);
+                for (i = 0; i < 4; ++i) {
+                    nk_labelf(ctx, NK_TEXT_LEFT, "Sensor %d", i);
+                    nk_progress(ctx, &progress, 100, nk_true);
+                }
+                nk_layout_row_dynamic(ctx, 25, 3);
+                nk_button_label(ctx, "Start");
+                nk_button_label(ctx, "Stop");
+                nk_slider_float(ctx, 0, &value, 1.0f, 0.01f);
+                nk_layout_row_dynamic(ctx, 140, 1);
+                if (nk_chart_begin(ctx, NK_CHART_LINES, 64, -1.0f, 1.0f)) {
+                    for (i = 0; i < 64; ++i)
+                        nk_chart_push(ctx, (float)sin((float)(i + x + y) * 0.2f));
+                    nk_chart_end(ctx);
+                }
+                nk_layout_row_dynamic(ctx, 80, 1);
+                if (nk_chart_begin(ctx, NK_CHART_COLUMN, 32, 0.0f, 1.0f)) {
+                    for (i = 0; i < 32; ++i)
+                        nk_chart_push(ctx, (float)fabs(cos((float)(i * 3 + x) * 0.1f)));
+                    nk_chart_end(ctx);
+                }
+            }
+            nk_end(ctx);
+        }
+    }
+    overview(ctx);
+}
+
+int
+main(int argc, char **argv)
+{
+    int i, threads, mismatch = 0;
+    int width = (argc > 1) ? atoi(argv[1]) : 3840;
+    int height = (argc > 2) ? atoi(argv[2]) : 2160;
+    int frames = (argc > 3) ? atoi(argv[3]) : 20;
+    int max_threads = (argc > 4) ? atoi(argv[4]) : 8;
+    size_t size = (size_t)width * (size_t)height * 4;
+    unsigned char *fb = malloc(size);
+    unsigned char *reference = malloc(size);
+    static unsigned char tex_scratch[512 * 512];
+    struct rawfb_context *rawfb;
+    struct nk_color clear = nk_rgb(30,30,30);
+    double start, serial = 0, vertices = 0;
+
+    if (!fb || !reference) return 1;
+    rawfb = nk_rawfb_init(fb, tex_scratch, width, height, width * 4, PIXEL_LAYOUT_XRGB_8888);
+    if (!rawfb) return 1;
+    if (argc > 5 && !strcmp(argv[5], "aa"))
+        nk_rawfb_set_anti_aliasing(rawfb, NK_ANTI_ALIASING_ON);
+
+    /* let window positions and sizes settle before comparing frames */
+    for (i = 0; i < 3; ++i) {
+        nk_input_begin(&rawfb->ctx);
+        nk_input_end(&rawfb->ctx);
+        dashboard(&rawfb->ctx, width, height);
+        nk_rawfb_render(rawfb, clear, 1);
+    }
+    memcpy(reference, fb, size);
+
+    for (i = 0; i < frames; ++i) {
+        nk_input_begin(&rawfb->ctx);
+        nk_input_end(&rawfb->ctx);
+        dashboard(&rawfb->ctx, width, height);
+        start = timestamp();
+        nk_rawfb_render(rawfb, clear, 1);
+        serial += timestamp() - start;
+    }
+    printf("%dx%d serial: %.2f ms/frame\n", width, height, serial / frames);
+
+    for (i = 0; i < frames; ++i) {
+        nk_input_begin(&rawfb->ctx);
+        nk_input_end(&rawfb->ctx);
+        dashboard(&rawfb->ctx, width, height);
+        start = timestamp();
+        nk_rawfb_render_vertices(rawfb, clear, 1);
+        vertices += timestamp() - start;
+    }
+    printf("%dx%d vertices: %.2f ms/frame\n", width, height, vertices / frames);
+
+    for (threads = 1; threads <= max_threads; threads *= 2) {
+        double tiled = 0;
+        for (i = 0; i < frames; ++i) {
+            nk_input_begin(&rawfb->ctx);
+            nk_input_end(&rawfb->ctx);
+            dashboard(&rawfb->ctx, width, height);
+            memset(fb, 0xAB, size);
+            start = timestamp();
+            nk_rawfb_render_tiled(rawfb, clear, 1, threads);
+            tiled += timestamp() - start;
+            if (memcmp(fb, reference, size)) {
+                mismatch = 1;
+                break;
+            }
+        }
+        if (mismatch) {
+            printf("tiled output with %d threads differs from serial output\n", threads);
+            break;
+        }
+        printf("%dx%d tiled, %d threads: %.2f ms/frame (%.2fx)\n", width, height,
+            threads, tiled / frames, serial / tiled);
+    }
+    nk_rawfb_shutdown(rawfb);
+    free(reference);
+    free(fb);
+    return mismatch;
+}
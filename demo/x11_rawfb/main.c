@@ -32,6 +32,7 @@
 #include <limits.h>
 #include <math.h>
 #include <sys/time.h>
+#include <sys/select.h>
 #include <unistd.h>
 #include <time.h>
 
@@ -103,6 +104,21 @@ sleep_for(long t)
     while(-1 == nanosleep(&req, &req));
 }
 
+static void
+wait_for_event(Display *dpy, float timeout)
+{
+    /* blocks until an event arrives or the timeout in seconds runs out */
+    fd_set fds;
+    struct timeval tv;
+    int fd = ConnectionNumber(dpy);
+    if (XPending(dpy)) return;
+    FD_ZERO(&fds);
+    FD_SET(fd, &fds);
+    tv.tv_sec = (long)timeout;
+    tv.tv_usec = (long)((timeout - (float)tv.tv_sec) * 1000000.0f);
+    select(fd + 1, &fds, NULL, NULL, (timeout < 0) ? NULL : &tv);
+}
+
 /* ===============================================================
  *
  *                          EXAMPLE
@@ -136,16 +152,128 @@ sleep_for(long t)
   #include "../node_editor.c"
 #endif
 
+static int
+gui(struct nk_context *ctx)
+{
+    if (nk_begin(ctx, "Demo", nk_rect(50, 50, 200, 200),
+        NK_WINDOW_BORDER|NK_WINDOW_MOVABLE|
+        NK_WINDOW_CLOSABLE|NK_WINDOW_MINIMIZABLE|NK_WINDOW_TITLE)) {
+        enum {EASY, HARD};
+        static int op = EASY;
+        static int property = 20;
+
+        nk_layout_row_static(ctx, 30, 80, 1);
+        if (nk_button_label(ctx, "button"))
+            fprintf(stdout, "button pressed\n");
+        nk_layout_row_dynamic(ctx, 30, 2);
+        if (nk_option_label(ctx, "easy", op == EASY)) op = EASY;
+        if (nk_option_label(ctx, "hard", op == HARD)) op = HARD;
+        nk_layout_row_dynamic(ctx, 25, 1);
+        nk_property_int(ctx, "Compression:", 0, &property, 100, 10, 1);
+    }
+    nk_end(ctx);
+    if (nk_window_is_closed(ctx, "Demo")) return 0;
+
+    /* -------------- EXAMPLES ---------------- */
+    #ifdef INCLUDE_CALCULATOR
+      calculator(ctx);
+    #endif
+    #ifdef INCLUDE_OVERVIEW
+      overview(ctx);
+    #endif
+    #ifdef INCLUDE_NODE_EDITOR
+      node_editor(ctx);
+    #endif
+    /* ----------------------------------------- */
+    return 1;
+}
+
+/* ===============================================================
+ *
+ *                          REPLAY
+ *
+ * ===============================================================*/
+/* `zahnrad record FILE` stores all input of a session in FILE.
+ * `zahnrad replay FILE` runs it again without a display into a memory
+ * framebuffer of the recorded size, compares the draw commands of every
+ * frame with the recording and prints the time per frame. */
+static void
+record_save(const char *path, struct nk_buffer *recording)
+{
+    FILE *file = fopen(path, "wb");
+    if (!file || fwrite(nk_buffer_memory(recording), 1, recording->allocated, file)
+        != recording->allocated)
+        fprintf(stderr, "could not write %s\n", path);
+    if (file) fclose(file);
+}
+
+static int
+replay(const char *path)
+{
+    static unsigned char tex_scratch[512 * 512];
+    struct rawfb_context *rawfb;
+    struct nk_replay rp;
+    unsigned char *data, *fb;
+    long size, started, dt;
+    int mismatches = 0;
+    FILE *file;
+
+    file = fopen(path, "rb");
+    if (!file) die("could not open %s", path);
+    fseek(file, 0, SEEK_END);
+    size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    data = (unsigned char*)malloc((size_t)NK_MAX(size, 1));
+    if (!data || fread(data, 1, (size_t)size, file) != (size_t)size)
+        die("could not read %s", path);
+    fclose(file);
+    if (!nk_replay_init(&rp, data, (nk_size)size))
+        die("%s is not an input recording", path);
+
+    fb = (unsigned char*)malloc(WINDOW_WIDTH * WINDOW_HEIGHT * 4);
+    if (!fb) die("out of memory");
+    rawfb = nk_rawfb_init(fb, tex_scratch, WINDOW_WIDTH, WINDOW_HEIGHT,
+        WINDOW_WIDTH * 4, PIXEL_LAYOUT_XRGB_8888);
+    if (!rawfb) die("could not create the framebuffer");
+
+    started = timestamp();
+    while (nk_replay_frame(&rawfb->ctx, &rp)) {
+        if (rp.resized && (rp.width != rawfb->fb.w || rp.height != rawfb->fb.h)) {
+            /* layouts depend on the size the frame was recorded at */
+            unsigned char *resized = (unsigned char*)malloc((size_t)NK_MAX(rp.width * rp.height * 4, 1));
+            if (!resized) die("out of memory");
+            nk_rawfb_resize_fb(rawfb, resized, (unsigned int)rp.width, (unsigned int)rp.height,
+                (unsigned int)rp.width * 4, PIXEL_LAYOUT_XRGB_8888);
+            free(fb);
+            fb = resized;
+        }
+        if (!gui(&rawfb->ctx)) break;
+        if (!nk_replay_check(&rawfb->ctx, &rp)) {
+            fprintf(stderr, "frame %d: draw commands differ from the recording\n", rp.frame);
+            mismatches++;
+        }
+        nk_rawfb_render(rawfb, nk_rgb(30,30,30), 1);
+    }
+    dt = timestamp() - started;
+    printf("%d frames, %d mismatches, %.3f ms/frame\n", rp.frame, mismatches,
+        rp.frame ? (double)dt / rp.frame : 0.0);
+
+    nk_rawfb_shutdown(rawfb);
+    free(fb);
+    free(data);
+    return mismatches ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
 /* ===============================================================
  *
  *                          DEMO
  *
  * ===============================================================*/
 int
-main(void)
+main(int argc, char **argv)
 {
     long dt;
-    long started;
+    long started, last;
     int running = 1;
     int status;
     XWindow xw;
@@ -153,6 +281,14 @@ main(void)
     void *fb = NULL;
     rawfb_pl pl;
     unsigned char tex_scratch[512 * 512];
+    const char *record = NULL;
+    struct nk_buffer recording;
+    int width = 0, height = 0;
+
+    if (argc > 2 && !strcmp(argv[1], "replay"))
+        return replay(argv[2]);
+    if (argc > 2 && !strcmp(argv[1], "record"))
+        record = argv[2];
 
     /* X11 */
     memset(&xw, 0, sizeof xw);
@@ -187,6 +323,10 @@ main(void)
     /* GUI */
     rawfb = nk_rawfb_init(fb, tex_scratch, xw.width, xw.height, xw.width * 4, pl);
     if (!rawfb) running = 0;
+    else if (record) {
+        nk_buffer_init_default(&recording);
+        nk_record_begin(&rawfb->ctx, &recording);
+    }
 
     #ifdef INCLUDE_STYLE
     /*set_style(&rawfb->ctx, THEME_WHITE);*/
@@ -195,48 +335,30 @@ main(void)
     /*set_style(&rawfb->ctx, THEME_DARK);*/
     #endif
 
+    last = timestamp();
     while (running) {
         /* Input */
         XEvent evt;
+        /* block while the UI is idle */
+        if (!nk_needs_redraw(&rawfb->ctx))
+            wait_for_event(xw.dpy, nk_redraw_deadline(&rawfb->ctx));
         started = timestamp();
+        rawfb->ctx.delta_time_seconds = (float)(started - last) / 1000.0f;
+        last = started;
         nk_input_begin(&rawfb->ctx);
         while (XCheckWindowEvent(xw.dpy, xw.win, xw.swa.event_mask, &evt)) {
             if (XFilterEvent(&evt, xw.win)) continue;
             nk_xlib_handle_event(xw.dpy, xw.screen, xw.win, &evt, rawfb);
         }
+        if (rawfb->fb.w != width || rawfb->fb.h != height) {
+            width = rawfb->fb.w;
+            height = rawfb->fb.h;
+            nk_record_resize(&rawfb->ctx, width, height);
+        }
         nk_input_end(&rawfb->ctx);
 
         /* GUI */
-        if (nk_begin(&rawfb->ctx, "Demo", nk_rect(50, 50, 200, 200),
-            NK_WINDOW_BORDER|NK_WINDOW_MOVABLE|
-            NK_WINDOW_CLOSABLE|NK_WINDOW_MINIMIZABLE|NK_WINDOW_TITLE)) {
-            enum {EASY, HARD};
-            static int op = EASY;
-            static int property = 20;
-
-            nk_layout_row_static(&rawfb->ctx, 30, 80, 1);
-            if (nk_button_label(&rawfb->ctx, "button"))
-                fprintf(stdout, "button pressed\n");
-            nk_layout_row_dynamic(&rawfb->ctx, 30, 2);
-            if (nk_option_label(&rawfb->ctx, "easy", op == EASY)) op = EASY;
-            if (nk_option_label(&rawfb->ctx, "hard", op == HARD)) op = HARD;
-            nk_layout_row_dynamic(&rawfb->ctx, 25, 1);
-            nk_property_int(&rawfb->ctx, "Compression:", 0, &property, 100, 10, 1);
-        }
-        nk_end(&rawfb->ctx);
-        if (nk_window_is_closed(&rawfb->ctx, "Demo")) break;
-
-        /* -------------- EXAMPLES ---------------- */
-        #ifdef INCLUDE_CALCULATOR
-          calculator(&rawfb->ctx);
-        #endif
-        #ifdef INCLUDE_OVERVIEW
-          overview(&rawfb->ctx);
-        #endif
-        #ifdef INCLUDE_NODE_EDITOR
-          node_editor(&rawfb->ctx);
-        #endif
-        /* ----------------------------------------- */
+        if (!gui(&rawfb->ctx)) break;
 
         /* Draw framebuffer */
         nk_rawfb_render(rawfb, nk_rgb(30,30,30), 1);
@@ -252,6 +374,11 @@ main(void)
             sleep_for(DTIME - dt);
     }
 
+    if (record && rawfb) {
+        nk_record_end(&rawfb->ctx);
+        record_save(record, &recording);
+        nk_buffer_free(&recording);
+    }
     nk_rawfb_shutdown(rawfb);
     nk_xlib_shutdown();
     XUnmapWindow(xw.dpy, xw.win);
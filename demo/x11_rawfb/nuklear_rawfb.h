@@ -36,15 +36,49 @@ struct rawfb_context;
 typedef enum rawfb_pixel_layout {
     PIXEL_LAYOUT_XRGB_8888,
     PIXEL_LAYOUT_RGBX_8888,
+    PIXEL_LAYOUT_RGB_565,
+    /* 8-bit pseudo color, the palette has to be programmed as 3-3-2 RGB */
+    PIXEL_LAYOUT_RGB_332
 }
 rawfb_pl;
 
+/* Pixels of an image drawn with nk_image_ptr(&image). Images with a NULL
+ * handle are taken from the font atlas, which holds the mouse cursors. */
+struct rawfb_image {
+    void *pixels;
+    int w, h, pitch;
+    rawfb_pl pl;
+    enum nk_font_atlas_format format;
+};
+enum rawfb_image_filter {
+    RAWFB_FILTER_NEAREST,
+    RAWFB_FILTER_BILINEAR,
+    RAWFB_FILTER_BOX /* averages all covered pixels when shrinking, bilinear otherwise */
+};
+
 
 /* All functions are thread-safe */
 NK_API struct rawfb_context *nk_rawfb_init(void *fb, void *tex_mem, const unsigned int w, const unsigned int h, const unsigned int pitch, const rawfb_pl pl);
-NK_API void                  nk_rawfb_render(const struct rawfb_context *rawfb, const struct nk_color clear, const unsigned char enable_clear);
+NK_API void                  nk_rawfb_render(struct rawfb_context *rawfb, const struct nk_color clear, const unsigned char enable_clear);
+/* Bins all commands into NK_RAWFB_TILE_SIZE sized screen tiles and rasterizes the
+ * tiles on `threads` threads (needs NK_RAWFB_THREADS, otherwise tiles are drawn on
+ * the calling thread). The result is identical to nk_rawfb_render. */
+NK_API void                  nk_rawfb_render_tiled(struct rawfb_context *rawfb, const struct nk_color clear, const unsigned char enable_clear, const int threads);
 NK_API void                  nk_rawfb_shutdown(struct rawfb_context *rawfb);
 NK_API void                  nk_rawfb_resize_fb(struct rawfb_context *rawfb, void *fb, const unsigned int w, const unsigned int h, const unsigned int pitch, const rawfb_pl pl);
+/* Anti-aliases filled polygons, circles, arcs, triangles and rounded rects. Off by default. */
+NK_API void                  nk_rawfb_set_anti_aliasing(struct rawfb_context *rawfb, enum nk_anti_aliasing aa);
+/* Filter used to scale images. Defaults to RAWFB_FILTER_NEAREST. */
+NK_API void                  nk_rawfb_set_image_filter(struct rawfb_context *rawfb, enum rawfb_image_filter filter);
+#ifdef NK_INCLUDE_VERTEX_BUFFER_OUTPUT
+/* Renders the nk_convert output of the frame by rasterizing its triangles, the
+ * same geometry a GPU backend would draw. Images are struct rawfb_image as for
+ * nk_rawfb_render. Without NK_UINT_DRAW_INDEX draw indices are 16 bit and a frame
+ * is limited to 65535 vertices, which big or anti-aliased frames easily exceed. */
+NK_API void                  nk_rawfb_render_vertices(struct rawfb_context *rawfb, const struct nk_color clear, const unsigned char enable_clear);
+#endif
+/* Ordered dithering of gradients on RGB565 and RGB332 framebuffers. Off by default. */
+NK_API void                  nk_rawfb_set_dithering(struct rawfb_context *rawfb, const int enable);
 
 #endif
 /*
@@ -55,18 +89,92 @@ NK_API void                  nk_rawfb_resize_fb(struct rawfb_context *rawfb, voi
  * ===============================================================
  */
 #ifdef NK_RAWFB_IMPLEMENTATION
-struct rawfb_image {
-    void *pixels;
-    int w, h, pitch;
-    rawfb_pl pl;
-    enum nk_font_atlas_format format;
+/* only the C89 double versions of the math functions are used, the float
+ * ones are not declared by <math.h> in strict C89 builds */
+#include <math.h>
+
+/* Span kernels are vectorized for the instruction sets enabled at compile
+ * time (e.g. -msse2, -mavx2 or -mfpu=neon). Define NK_RAWFB_NO_SIMD to
+ * always use the scalar versions. */
+#ifndef NK_RAWFB_NO_SIMD
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NK_RAWFB_SSE2
+#include <emmintrin.h>
+#ifdef __AVX2__
+#define NK_RAWFB_AVX2
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define NK_RAWFB_NEON
+#include <arm_neon.h>
+#endif
+#endif
+#ifdef NK_RAWFB_THREADS
+#include <pthread.h>
+#endif
+#ifndef NK_RAWFB_TILE_SIZE
+#define NK_RAWFB_TILE_SIZE 64
+#endif
+#ifndef NK_RAWFB_AA_SAMPLES
+#define NK_RAWFB_AA_SAMPLES 8
+#endif
+#ifndef NK_RAWFB_GLYPH_CACHE_MEMORY
+#define NK_RAWFB_GLYPH_CACHE_MEMORY (1024 * 1024)
+#endif
+
+struct rawfb_glyph {
+    /* coverage mask of a glyph already scaled to the drawn font height */
+    const void *font;
+    nk_rune codepoint;
+    float height;
+    float xadvance;
+    struct nk_vec2 offset;
+    int w, h;
+    int mask;
+};
+struct rawfb_glyph_cache {
+    /* open addressing table, a slot is empty if its font is NULL */
+    struct rawfb_glyph *slots;
+    int capacity, count;
+    unsigned char *masks;
+    int mask_size, mask_capacity;
+};
+struct rawfb_target {
+    /* everything needed to rasterize commands, one per drawing thread */
+    struct nk_rect scissors;
+    struct rawfb_image fb;
+    struct rawfb_image font_tex;
+    enum nk_anti_aliasing aa;
+    enum rawfb_image_filter filter;
+    int dither;
+    /* new glyphs are only added to the cache if `fill_glyphs` is set */
+    struct rawfb_glyph_cache *glyphs;
+    int fill_glyphs;
+};
+struct rawfb_tile_item {
+    const struct nk_command *cmd;
+    struct nk_rect scissors;
 };
 struct rawfb_context {
     struct nk_context ctx;
-    struct nk_rect scissors;
     struct rawfb_image fb;
     struct rawfb_image font_tex;
     struct nk_font_atlas atlas;
+    struct nk_draw_null_texture null;
+#ifdef NK_INCLUDE_VERTEX_BUFFER_OUTPUT
+    struct nk_buffer cmds, vertices, elements;
+#endif
+    enum nk_anti_aliasing aa;
+    enum rawfb_image_filter filter;
+    int dither;
+    struct rawfb_glyph_cache glyphs;
+    /* tiled rendering: commands of tile t are items[bins[tiles[t]..tiles[t+1]]] */
+    struct rawfb_tile_item *items;
+    int item_capacity;
+    int *bins;
+    int bin_capacity;
+    int *tiles;
+    int tile_capacity;
 };
 
 #ifndef MIN
@@ -76,6 +184,31 @@ struct rawfb_context {
 #define MAX(a,b) ((a) < (b) ? (b) : (a))
 #endif
 
+static int
+nk_rawfb_reserve(void **mem, int *capacity, const int count, const size_t size)
+{
+    void *tmp;
+    int n = MAX(*capacity, 256);
+    if (count <= *capacity) return 1;
+    while (n < count) n *= 2;
+    tmp = realloc(*mem, (size_t)n * size);
+    if (!tmp) return 0;
+    *mem = tmp;
+    *capacity = n;
+    return 1;
+}
+
+static unsigned int
+nk_rawfb_narrow(const unsigned int r, const unsigned int g, const unsigned int b,
+    const rawfb_pl pl)
+{
+    /* rounds 8-bit channels to the nearest level of a 16 or 8-bit layout */
+    if (pl == PIXEL_LAYOUT_RGB_565)
+        return ((r * 249 + 1014) >> 11) << 11 | ((g * 253 + 505) >> 10) << 5 |
+            ((b * 249 + 1014) >> 11);
+    return ((r * 14 + 255) / 510) << 5 | ((g * 14 + 255) / 510) << 2 | ((b * 6 + 255) / 510);
+}
+
 static unsigned int
 nk_rawfb_color2int(const struct nk_color c, rawfb_pl pl)
 {
@@ -94,6 +227,10 @@ nk_rawfb_color2int(const struct nk_color c, rawfb_pl pl)
 	res |= c.g << 8;
 	res |= c.b;
 	break;
+    case PIXEL_LAYOUT_RGB_565:
+    case PIXEL_LAYOUT_RGB_332:
+	res = nk_rawfb_narrow(c.r, c.g, c.b, pl);
+	break;
 
     default:
 	perror("nk_rawfb_color2int(): Unsupported pixel layout.\n");
@@ -120,6 +257,18 @@ nk_rawfb_int2color(const unsigned int i, rawfb_pl pl)
 	col.g = (i >> 8) & 0xff;
 	col.b = i & 0xff;
 	break;
+    case PIXEL_LAYOUT_RGB_565:
+	col.r = (nk_byte)((i >> 8 & 0xf8) | (i >> 13));
+	col.g = (nk_byte)((i >> 3 & 0xfc) | (i >> 9 & 0x03));
+	col.b = (nk_byte)((i << 3 & 0xf8) | (i >> 2 & 0x07));
+	col.a = 0xff;
+	break;
+    case PIXEL_LAYOUT_RGB_332:
+	col.r = (nk_byte)((i & 0xe0) | (i >> 3 & 0x1c) | (i >> 6));
+	col.g = (nk_byte)((i << 3 & 0xe0) | (i & 0x1c) | (i >> 3 & 0x03));
+	col.b = (nk_byte)((i & 0x03) * 0x55);
+	col.a = 0xff;
+	break;
 
     default:
 	perror("nk_rawfb_int2color(): Unsupported pixel layout.\n");
@@ -128,65 +277,751 @@ nk_rawfb_int2color(const unsigned int i, rawfb_pl pl)
     return col;
 }
 
+/*
+ * Span kernels
+ *
+ * All kernels work on runs of 32-bit pixels. Blending is done with the same
+ * fixed-point formula on every path, (s*a + d*(255-a) + 128) / 255 with the
+ * division rounded exactly, so SIMD and scalar output are bit identical.
+ */
+static unsigned int
+nk_rawfb_blend(const unsigned int d, const unsigned int s, const unsigned int a)
+{
+    /* blends two channels at once in each half of the 32-bit word */
+    const unsigned int ia = 255 - a;
+    unsigned int rb = (s & 0x00ff00ff) * a + (d & 0x00ff00ff) * ia + 0x00800080;
+    unsigned int ag = ((s >> 8) & 0x00ff00ff) * a + ((d >> 8) & 0x00ff00ff) * ia + 0x00800080;
+    rb = ((rb + ((rb >> 8) & 0x00ff00ff)) >> 8) & 0x00ff00ff;
+    ag = (ag + ((ag >> 8) & 0x00ff00ff)) & 0xff00ff00;
+    return rb | ag;
+}
+
+#ifdef NK_RAWFB_SSE2
+static __m128i
+nk_rawfb_div255_sse2(const __m128i t)
+{
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+#endif
+#ifdef NK_RAWFB_AVX2
+static __m256i
+nk_rawfb_div255_avx2(const __m256i t)
+{
+    return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+}
+#endif
+
 static void
-nk_rawfb_ctx_setpixel(const struct rawfb_context *rawfb,
-    const short x0, const short y0, const struct nk_color col)
+nk_rawfb_span_fill(unsigned int *dst, const int n, const unsigned int c)
 {
-    unsigned int c = nk_rawfb_color2int(col, rawfb->fb.pl);
-    unsigned char *pixels = rawfb->fb.pixels;
-    unsigned int *ptr;
+    int i = 0;
+#ifdef NK_RAWFB_AVX2
+    const __m256i c8 = _mm256_set1_epi32((int)c);
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_si256((__m256i*)(dst + i), c8);
+#endif
+#if defined(NK_RAWFB_SSE2)
+    {const __m128i c4 = _mm_set1_epi32((int)c);
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_si128((__m128i*)(dst + i), c4);}
+#elif defined(NK_RAWFB_NEON)
+    {const uint32x4_t c4 = vdupq_n_u32(c);
+    for (; i + 4 <= n; i += 4)
+        vst1q_u32(dst + i, c4);}
+#endif
+    for (; i < n; ++i)
+        dst[i] = c;
+}
 
-    pixels += y0 * rawfb->fb.pitch;
-    ptr = (unsigned int *)pixels + x0;
+static void
+nk_rawfb_span_blend(unsigned int *dst, const int n, const unsigned int c,
+    const unsigned int a)
+{
+    /* blends the constant color `c` with alpha `a` over the span */
+    int i = 0;
+#ifdef NK_RAWFB_AVX2
+    {const __m256i zero = _mm256_setzero_si256();
+    const __m256i via = _mm256_set1_epi16((short)(255 - a));
+    const __m256i s = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(
+        _mm256_set1_epi32((int)c), zero), _mm256_set1_epi16((short)a)), _mm256_set1_epi16(128));
+    for (; i + 8 <= n; i += 8) {
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i lo = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), via), s);
+        __m256i hi = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), via), s);
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_packus_epi16(
+            nk_rawfb_div255_avx2(lo), nk_rawfb_div255_avx2(hi)));
+    }}
+#endif
+#if defined(NK_RAWFB_SSE2)
+    {const __m128i zero = _mm_setzero_si128();
+    const __m128i via = _mm_set1_epi16((short)(255 - a));
+    const __m128i s = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(
+        _mm_set1_epi32((int)c), zero), _mm_set1_epi16((short)a)), _mm_set1_epi16(128));
+    for (; i + 4 <= n; i += 4) {
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), via), s);
+        __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), via), s);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(
+            nk_rawfb_div255_sse2(lo), nk_rawfb_div255_sse2(hi)));
+    }}
+#elif defined(NK_RAWFB_NEON)
+    {const uint8x8_t via = vdup_n_u8((uint8_t)(255 - a));
+    const uint16x8_t s = vmlal_u8(vdupq_n_u16(128),
+        vreinterpret_u8_u32(vdup_n_u32(c)), vdup_n_u8((uint8_t)a));
+    for (; i + 4 <= n; i += 4) {
+        uint8x16_t d = vreinterpretq_u8_u32(vld1q_u32(dst + i));
+        uint16x8_t lo = vmlal_u8(s, vget_low_u8(d), via);
+        uint16x8_t hi = vmlal_u8(s, vget_high_u8(d), via);
+        lo = vsraq_n_u16(lo, lo, 8);
+        hi = vsraq_n_u16(hi, hi, 8);
+        vst1q_u32(dst + i, vreinterpretq_u32_u8(vcombine_u8(
+            vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8))));
+    }}
+#endif
+    for (; i < n; ++i)
+        dst[i] = nk_rawfb_blend(dst[i], c, a);
+}
 
-    if (y0 < rawfb->scissors.h && y0 >= rawfb->scissors.y &&
-        x0 >= rawfb->scissors.x && x0 < rawfb->scissors.w)
-        *ptr = c;
+static void
+nk_rawfb_span_blend_src(unsigned int *dst, const unsigned int *src,
+    const int n, const int ashift)
+{
+    /* blends pixels with their own alpha which is stored at bit `ashift` */
+    int i = 0;
+#ifdef NK_RAWFB_AVX2
+    {const __m256i zero = _mm256_setzero_si256();
+    const __m256i v255 = _mm256_set1_epi16(255);
+    const __m256i v128 = _mm256_set1_epi16(128);
+    for (; i + 8 <= n; i += 8) {
+        __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i slo = _mm256_unpacklo_epi8(s, zero), shi = _mm256_unpackhi_epi8(s, zero);
+        __m256i dlo = _mm256_unpacklo_epi8(d, zero), dhi = _mm256_unpackhi_epi8(d, zero);
+        __m256i alo, ahi;
+        if (ashift) {
+            alo = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(slo, 0xFF), 0xFF);
+            ahi = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(shi, 0xFF), 0xFF);
+        } else {
+            alo = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(slo, 0x00), 0x00);
+            ahi = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(shi, 0x00), 0x00);
+        }
+        slo = _mm256_add_epi16(_mm256_add_epi16(_mm256_mullo_epi16(slo, alo),
+            _mm256_mullo_epi16(dlo, _mm256_sub_epi16(v255, alo))), v128);
+        shi = _mm256_add_epi16(_mm256_add_epi16(_mm256_mullo_epi16(shi, ahi),
+            _mm256_mullo_epi16(dhi, _mm256_sub_epi16(v255, ahi))), v128);
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_packus_epi16(
+            nk_rawfb_div255_avx2(slo), nk_rawfb_div255_avx2(shi)));
+    }}
+#endif
+#if defined(NK_RAWFB_SSE2)
+    {const __m128i zero = _mm_setzero_si128();
+    const __m128i v255 = _mm_set1_epi16(255);
+    const __m128i v128 = _mm_set1_epi16(128);
+    const __m128i amask = _mm_set1_epi32((int)(0xffu << ashift));
+    for (; i + 4 <= n; i += 4) {
+        __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i d, slo, shi, dlo, dhi, alo, ahi;
+        /* fully transparent runs are common in glyphs and gradients */
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(s, amask), zero)) == 0xFFFF)
+            continue;
+        d = _mm_loadu_si128((const __m128i*)(dst + i));
+        slo = _mm_unpacklo_epi8(s, zero); shi = _mm_unpackhi_epi8(s, zero);
+        dlo = _mm_unpacklo_epi8(d, zero); dhi = _mm_unpackhi_epi8(d, zero);
+        if (ashift) {
+            alo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(slo, 0xFF), 0xFF);
+            ahi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(shi, 0xFF), 0xFF);
+        } else {
+            alo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(slo, 0x00), 0x00);
+            ahi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(shi, 0x00), 0x00);
+        }
+        slo = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(slo, alo),
+            _mm_mullo_epi16(dlo, _mm_sub_epi16(v255, alo))), v128);
+        shi = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(shi, ahi),
+            _mm_mullo_epi16(dhi, _mm_sub_epi16(v255, ahi))), v128);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(
+            nk_rawfb_div255_sse2(slo), nk_rawfb_div255_sse2(shi)));
+    }}
+#elif defined(NK_RAWFB_NEON)
+    {const uint16x8_t v128 = vdupq_n_u16(128);
+    for (; i + 8 <= n; i += 8) {
+        /* deinterleave 8 pixels into one vector per channel */
+        uint8x8x4_t s = vld4_u8((const uint8_t*)(src + i));
+        uint8x8x4_t d = vld4_u8((const uint8_t*)(dst + i));
+        uint8x8_t a = s.val[ashift / 8], ia = vmvn_u8(a);
+        int k;
+        for (k = 0; k < 4; ++k) {
+            uint16x8_t t = vmlal_u8(vmlal_u8(v128, s.val[k], a), d.val[k], ia);
+            d.val[k] = vshrn_n_u16(vsraq_n_u16(t, t, 8), 8);
+        }
+        vst4_u8((uint8_t*)(dst + i), d);
+    }}
+#endif
+    for (; i < n; ++i) {
+        const unsigned int a = (src[i] >> ashift) & 0xff;
+        if (a) dst[i] = nk_rawfb_blend(dst[i], src[i], a);
+    }
 }
 
 static void
-nk_rawfb_line_horizontal(const struct rawfb_context *rawfb,
-    const short x0, const short y, const short x1, const struct nk_color col)
+nk_rawfb_span_blend_mask(unsigned int *dst, const unsigned char *mask,
+    const int n, const unsigned int c, const unsigned int a)
 {
-    /* This function is called the most. Try to optimize it a bit...
-     * It does not check for scissors or image borders.
-     * The caller has to make sure it does no exceed bounds. */
-    unsigned int i, n;
-    unsigned int c[16];
-    unsigned char *pixels = rawfb->fb.pixels;
-    unsigned int *ptr;
+    /* blends the constant color `c` with alpha `a` scaled by a coverage mask */
+    int i = 0;
+#ifdef NK_RAWFB_AVX2
+    {const __m256i zero = _mm256_setzero_si256();
+    const __m256i v255 = _mm256_set1_epi16(255);
+    const __m256i v128 = _mm256_set1_epi16(128);
+    const __m256i va = _mm256_set1_epi16((short)a);
+    const __m256i s = _mm256_unpacklo_epi8(_mm256_set1_epi32((int)c), zero);
+    for (; i + 8 <= n; i += 8) {
+        __m128i m = _mm_loadl_epi64((const __m128i*)(mask + i)), lo, hi;
+        __m256i d, alo, ahi, dlo, dhi;
+        if (!_mm_cvtsi128_si32(m) && !_mm_cvtsi128_si32(_mm_srli_epi64(m, 32)))
+            continue;
+        /* spread the coverage of pixel k over its four channels */
+        m = _mm_unpacklo_epi8(m, _mm_setzero_si128());
+        lo = _mm_unpacklo_epi16(m, m);
+        hi = _mm_unpackhi_epi16(m, m);
+        alo = _mm256_inserti128_si256(_mm256_castsi128_si256(
+            _mm_unpacklo_epi32(lo, lo)), _mm_unpacklo_epi32(hi, hi), 1);
+        ahi = _mm256_inserti128_si256(_mm256_castsi128_si256(
+            _mm_unpackhi_epi32(lo, lo)), _mm_unpackhi_epi32(hi, hi), 1);
+        if (a != 255) {
+            alo = nk_rawfb_div255_avx2(_mm256_add_epi16(_mm256_mullo_epi16(alo, va), v128));
+            ahi = nk_rawfb_div255_avx2(_mm256_add_epi16(_mm256_mullo_epi16(ahi, va), v128));
+        }
+        d = _mm256_loadu_si256((const __m256i*)(dst + i));
+        dlo = _mm256_unpacklo_epi8(d, zero); dhi = _mm256_unpackhi_epi8(d, zero);
+        dlo = _mm256_add_epi16(_mm256_add_epi16(_mm256_mullo_epi16(s, alo),
+            _mm256_mullo_epi16(dlo, _mm256_sub_epi16(v255, alo))), v128);
+        dhi = _mm256_add_epi16(_mm256_add_epi16(_mm256_mullo_epi16(s, ahi),
+            _mm256_mullo_epi16(dhi, _mm256_sub_epi16(v255, ahi))), v128);
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_packus_epi16(
+            nk_rawfb_div255_avx2(dlo), nk_rawfb_div255_avx2(dhi)));
+    }}
+#endif
+#if defined(NK_RAWFB_SSE2)
+    {const __m128i zero = _mm_setzero_si128();
+    const __m128i v255 = _mm_set1_epi16(255);
+    const __m128i v128 = _mm_set1_epi16(128);
+    const __m128i va = _mm_set1_epi16((short)a);
+    const __m128i s = _mm_unpacklo_epi8(_mm_set1_epi32((int)c), zero);
+    for (; i + 4 <= n; i += 4) {
+        int bits;
+        __m128i m, d, alo, ahi, dlo, dhi;
+        memcpy(&bits, mask + i, sizeof(bits));
+        if (!bits) continue;
+        m = _mm_unpacklo_epi8(_mm_cvtsi32_si128(bits), zero);
+        m = _mm_unpacklo_epi16(m, m);
+        alo = _mm_unpacklo_epi32(m, m);
+        ahi = _mm_unpackhi_epi32(m, m);
+        if (a != 255) {
+            alo = nk_rawfb_div255_sse2(_mm_add_epi16(_mm_mullo_epi16(alo, va), v128));
+            ahi = nk_rawfb_div255_sse2(_mm_add_epi16(_mm_mullo_epi16(ahi, va), v128));
+        }
+        d = _mm_loadu_si128((const __m128i*)(dst + i));
+        dlo = _mm_unpacklo_epi8(d, zero); dhi = _mm_unpackhi_epi8(d, zero);
+        dlo = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(s, alo),
+            _mm_mullo_epi16(dlo, _mm_sub_epi16(v255, alo))), v128);
+        dhi = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(s, ahi),
+            _mm_mullo_epi16(dhi, _mm_sub_epi16(v255, ahi))), v128);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(
+            nk_rawfb_div255_sse2(dlo), nk_rawfb_div255_sse2(dhi)));
+    }}
+#elif defined(NK_RAWFB_NEON)
+    {const uint16x8_t v128 = vdupq_n_u16(128);
+    const uint8x8_t va = vdup_n_u8((uint8_t)a);
+    for (; i + 8 <= n; i += 8) {
+        uint8x8_t m = vld1_u8(mask + i), ia;
+        uint8x8x4_t d;
+        int k;
+        if (!vget_lane_u64(vreinterpret_u64_u8(m), 0))
+            continue;
+        if (a != 255) {
+            uint16x8_t t = vmlal_u8(v128, m, va);
+            m = vshrn_n_u16(vsraq_n_u16(t, t, 8), 8);
+        }
+        ia = vmvn_u8(m);
+        d = vld4_u8((const uint8_t*)(dst + i));
+        for (k = 0; k < 4; ++k) {
+            uint16x8_t t = vmlal_u8(vmlal_u8(v128,
+                vdup_n_u8((uint8_t)(c >> (8 * k))), m), d.val[k], ia);
+            d.val[k] = vshrn_n_u16(vsraq_n_u16(t, t, 8), 8);
+        }
+        vst4_u8((uint8_t*)(dst + i), d);
+    }}
+#endif
+    for (; i < n; ++i) {
+        unsigned int m = mask[i];
+        if (a != 255) {
+            m = m * a + 128;
+            m = (m + (m >> 8)) >> 8;
+        }
+        if (m) dst[i] = nk_rawfb_blend(dst[i], c, m);
+    }
+}
 
-    pixels += y * rawfb->fb.pitch;
-    ptr = (unsigned int *)pixels + x0;
+static void
+nk_rawfb_span_lerp(unsigned int *dst, const unsigned int *a, const unsigned int *b,
+    const int n, const unsigned int t)
+{
+    /* mixes two rows of pixels, t = 0 gives `a` and t = 255 gives `b` */
+    int i = 0;
+#ifdef NK_RAWFB_AVX2
+    {const __m256i zero = _mm256_setzero_si256();
+    const __m256i vt = _mm256_set1_epi16((short)t);
+    const __m256i vit = _mm256_set1_epi16((short)(255 - t));
+    const __m256i v128 = _mm256_set1_epi16(128);
+    for (; i + 8 <= n; i += 8) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+        __m256i lo = _mm256_add_epi16(_mm256_add_epi16(_mm256_mullo_epi16(
+            _mm256_unpacklo_epi8(vb, zero), vt), _mm256_mullo_epi16(
+            _mm256_unpacklo_epi8(va, zero), vit)), v128);
+        __m256i hi = _mm256_add_epi16(_mm256_add_epi16(_mm256_mullo_epi16(
+            _mm256_unpackhi_epi8(vb, zero), vt), _mm256_mullo_epi16(
+            _mm256_unpackhi_epi8(va, zero), vit)), v128);
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_packus_epi16(
+            nk_rawfb_div255_avx2(lo), nk_rawfb_div255_avx2(hi)));
+    }}
+#endif
+#if defined(NK_RAWFB_SSE2)
+    {const __m128i zero = _mm_setzero_si128();
+    const __m128i vt = _mm_set1_epi16((short)t);
+    const __m128i vit = _mm_set1_epi16((short)(255 - t));
+    const __m128i v128 = _mm_set1_epi16(128);
+    for (; i + 4 <= n; i += 4) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+        __m128i lo = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(
+            _mm_unpacklo_epi8(vb, zero), vt), _mm_mullo_epi16(
+            _mm_unpacklo_epi8(va, zero), vit)), v128);
+        __m128i hi = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(
+            _mm_unpackhi_epi8(vb, zero), vt), _mm_mullo_epi16(
+            _mm_unpackhi_epi8(va, zero), vit)), v128);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(
+            nk_rawfb_div255_sse2(lo), nk_rawfb_div255_sse2(hi)));
+    }}
+#elif defined(NK_RAWFB_NEON)
+    {const uint8x8_t vt = vdup_n_u8((uint8_t)t);
+    const uint8x8_t vit = vdup_n_u8((uint8_t)(255 - t));
+    const uint16x8_t v128 = vdupq_n_u16(128);
+    for (; i + 4 <= n; i += 4) {
+        uint8x16_t va = vreinterpretq_u8_u32(vld1q_u32(a + i));
+        uint8x16_t vb = vreinterpretq_u8_u32(vld1q_u32(b + i));
+        uint16x8_t lo = vmlal_u8(vmlal_u8(v128, vget_low_u8(vb), vt), vget_low_u8(va), vit);
+        uint16x8_t hi = vmlal_u8(vmlal_u8(v128, vget_high_u8(vb), vt), vget_high_u8(va), vit);
+        lo = vsraq_n_u16(lo, lo, 8);
+        hi = vsraq_n_u16(hi, hi, 8);
+        vst1q_u32(dst + i, vreinterpretq_u32_u8(vcombine_u8(
+            vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8))));
+    }}
+#endif
+    for (; i < n; ++i)
+        dst[i] = nk_rawfb_blend(a[i], b[i], t);
+}
 
-    n = x1 - x0;
-    for (i = 0; i < sizeof(c) / sizeof(c[0]); i++)
-        c[i] = nk_rawfb_color2int(col, rawfb->fb.pl);
+static void
+nk_rawfb_span_accumulate(unsigned int *sum, const unsigned int *src, const int n)
+{
+    /* adds the four channels of every pixel to four counters per pixel */
+    int i = 0;
+#if defined(NK_RAWFB_SSE2)
+    {const __m128i zero = _mm_setzero_si128();
+    for (; i + 4 <= n; i += 4) {
+        __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i lo = _mm_unpacklo_epi8(s, zero), hi = _mm_unpackhi_epi8(s, zero);
+        __m128i *acc = (__m128i*)(sum + 4 * i);
+        _mm_storeu_si128(acc + 0, _mm_add_epi32(_mm_loadu_si128(acc + 0), _mm_unpacklo_epi16(lo, zero)));
+        _mm_storeu_si128(acc + 1, _mm_add_epi32(_mm_loadu_si128(acc + 1), _mm_unpackhi_epi16(lo, zero)));
+        _mm_storeu_si128(acc + 2, _mm_add_epi32(_mm_loadu_si128(acc + 2), _mm_unpacklo_epi16(hi, zero)));
+        _mm_storeu_si128(acc + 3, _mm_add_epi32(_mm_loadu_si128(acc + 3), _mm_unpackhi_epi16(hi, zero)));
+    }}
+#elif defined(NK_RAWFB_NEON)
+    for (; i + 4 <= n; i += 4) {
+        uint8x16_t s = vreinterpretq_u8_u32(vld1q_u32(src + i));
+        uint16x8_t lo = vmovl_u8(vget_low_u8(s)), hi = vmovl_u8(vget_high_u8(s));
+        unsigned int *acc = sum + 4 * i;
+        vst1q_u32(acc + 0, vaddw_u16(vld1q_u32(acc + 0), vget_low_u16(lo)));
+        vst1q_u32(acc + 4, vaddw_u16(vld1q_u32(acc + 4), vget_high_u16(lo)));
+        vst1q_u32(acc + 8, vaddw_u16(vld1q_u32(acc + 8), vget_low_u16(hi)));
+        vst1q_u32(acc + 12, vaddw_u16(vld1q_u32(acc + 12), vget_high_u16(hi)));
+    }
+#endif
+    for (; i < n; ++i) {
+        sum[4*i+0] += src[i] & 0xff;
+        sum[4*i+1] += (src[i] >> 8) & 0xff;
+        sum[4*i+2] += (src[i] >> 16) & 0xff;
+        sum[4*i+3] += src[i] >> 24;
+    }
+}
 
-    while (n > 16) {
-        memcpy((void *)ptr, c, sizeof(c));
-        n -= 16; ptr += 16;
-    } for (i = 0; i < n; i++)
-        ptr[i] = c[i];
+static void
+nk_rawfb_span_gradient(unsigned int *dst, int n, const int *from,
+    const int *step, const rawfb_pl pl)
+{
+    /* interpolates r,g,b,a in 16.16 fixed point from `from` by `step` per
+     * pixel and blends the result in chunks over the span */
+    #define NK_RAWFB_GRADIENT_CHUNK 64
+    unsigned int buf[NK_RAWFB_GRADIENT_CHUNK];
+    int v[4], i, k, shift[4];
+    const int opaque = (from[3] >> 16) == 255 && step[3] == 0;
+    const int ashift = (pl == PIXEL_LAYOUT_XRGB_8888) ? 24 : 0;
+#if defined(NK_RAWFB_SSE2)
+    __m128i cv[4], cstep[4], cshift[4];
+#elif defined(NK_RAWFB_NEON)
+    int32x4_t cv[4], cstep[4], cshift[4];
+#endif
+    for (k = 0; k < 4; ++k) {
+        v[k] = from[k];
+        shift[k] = (pl == PIXEL_LAYOUT_XRGB_8888) ? 16 - 8 * k: 24 - 8 * k;
+    }
+    shift[3] = ashift;
+#if defined(NK_RAWFB_SSE2)
+    for (k = 0; k < 4; ++k) {
+        cv[k] = _mm_set_epi32(v[k] + 3 * step[k], v[k] + 2 * step[k], v[k] + step[k], v[k]);
+        cstep[k] = _mm_set1_epi32(4 * step[k]);
+        cshift[k] = _mm_cvtsi32_si128(shift[k]);
+    }
+#elif defined(NK_RAWFB_NEON)
+    for (k = 0; k < 4; ++k) {
+        int lanes[4];
+        lanes[0] = v[k]; lanes[1] = v[k] + step[k];
+        lanes[2] = v[k] + 2 * step[k]; lanes[3] = v[k] + 3 * step[k];
+        cv[k] = vld1q_s32(lanes);
+        cstep[k] = vdupq_n_s32(4 * step[k]);
+        cshift[k] = vdupq_n_s32(shift[k]);
+    }
+#endif
+    while (n > 0) {
+        const int count = MIN(n, NK_RAWFB_GRADIENT_CHUNK);
+        unsigned int *out = opaque ? dst: buf;
+        i = 0;
+#if defined(NK_RAWFB_SSE2)
+        for (; i + 4 <= count; i += 4) {
+            __m128i p = _mm_setzero_si128();
+            for (k = 0; k < 4; ++k) {
+                p = _mm_or_si128(p, _mm_sll_epi32(_mm_srli_epi32(cv[k], 16), cshift[k]));
+                cv[k] = _mm_add_epi32(cv[k], cstep[k]);
+            }
+            _mm_storeu_si128((__m128i*)(out + i), p);
+        }
+        for (k = 0; k < 4; ++k)
+            v[k] = _mm_cvtsi128_si32(cv[k]);
+#elif defined(NK_RAWFB_NEON)
+        for (; i + 4 <= count; i += 4) {
+            uint32x4_t p = vdupq_n_u32(0);
+            for (k = 0; k < 4; ++k) {
+                p = vorrq_u32(p, vshlq_u32(vreinterpretq_u32_s32(
+                    vshrq_n_s32(cv[k], 16)), cshift[k]));
+                cv[k] = vaddq_s32(cv[k], cstep[k]);
+            }
+            vst1q_u32(out + i, p);
+        }
+        for (k = 0; k < 4; ++k)
+            v[k] = vgetq_lane_s32(cv[k], 0);
+#endif
+        for (; i < count; ++i) {
+            out[i] = ((unsigned int)(v[0] >> 16) << shift[0]) |
+                ((unsigned int)(v[1] >> 16) << shift[1]) |
+                ((unsigned int)(v[2] >> 16) << shift[2]) |
+                ((unsigned int)(v[3] >> 16) << shift[3]);
+            for (k = 0; k < 4; ++k)
+                v[k] += step[k];
+        }
+        if (!opaque)
+            nk_rawfb_span_blend_src(dst, buf, count, ashift);
+        dst += count;
+        n -= count;
+    }
+    #undef NK_RAWFB_GRADIENT_CHUNK
+}
+
+/*
+ * Framebuffer spans
+ *
+ * 32-bit framebuffers are drawn into directly. RGB565 and RGB332 rows are
+ * widened to XRGB_8888 in small chunks, run through the kernels above and
+ * narrowed again. Opaque solid spans are written in the native format.
+ */
+#define NK_RAWFB_SPAN_CHUNK 64
+
+enum rawfb_span_op {
+    RAWFB_SPAN_COLOR,    /* constant color `c` with alpha `a` */
+    RAWFB_SPAN_MASK,     /* constant color `c` with alpha `a` scaled by `mask` */
+    RAWFB_SPAN_PIXELS,   /* `src` pixels blended with their own alpha */
+    RAWFB_SPAN_GRADIENT  /* 16.16 colors starting at `from`, see span_gradient */
+};
+struct rawfb_span {
+    enum rawfb_span_op op;
+    unsigned int c, a;
+    const unsigned char *mask;
+    const unsigned int *src;
+    const int *from, *step;
+};
+
+static const unsigned char nk_rawfb_bayer[4][4] = {
+    { 0,  8,  2, 10},
+    {12,  4, 14,  6},
+    { 3, 11,  1,  9},
+    {15,  7, 13,  5}
+};
+
+static int
+nk_rawfb_bytes_per_pixel(const rawfb_pl pl)
+{
+    switch (pl) {
+    case PIXEL_LAYOUT_RGB_565: return 2;
+    case PIXEL_LAYOUT_RGB_332: return 1;
+    default: return 4;
+    }
+}
+
+static rawfb_pl
+nk_rawfb_work_layout(const rawfb_pl pl)
+{
+    /* layout of the pixels the span kernels see */
+    return (nk_rawfb_bytes_per_pixel(pl) == 4) ? pl: PIXEL_LAYOUT_XRGB_8888;
 }
 
 static void
-nk_rawfb_img_setpixel(const struct rawfb_image *img,
-    const int x0, const int y0, const struct nk_color col)
+nk_rawfb_span_fill16(unsigned short *dst, const int n, const unsigned short c)
 {
-    unsigned int c = nk_rawfb_color2int(col, img->pl);
-    unsigned char *ptr;
-    unsigned int *pixel;
-    NK_ASSERT(img);
-    if (y0 < img->h && y0 >= 0 && x0 >= 0 && x0 < img->w) {
-        ptr = img->pixels + (img->pitch * y0);
-	pixel = (unsigned int *)ptr;
+    int i = 0;
+#if defined(NK_RAWFB_SSE2)
+    {const __m128i c8 = _mm_set1_epi16((short)c);
+    for (; i + 8 <= n; i += 8)
+        _mm_storeu_si128((__m128i*)(dst + i), c8);}
+#elif defined(NK_RAWFB_NEON)
+    {const uint16x8_t c8 = vdupq_n_u16(c);
+    for (; i + 8 <= n; i += 8)
+        vst1q_u16(dst + i, c8);}
+#endif
+    for (; i < n; ++i)
+        dst[i] = c;
+}
 
-        if (img->format == NK_FONT_ATLAS_ALPHA8) {
-            ptr[x0] = col.a;
-        } else {
-	    pixel[x0] = c;
+static void
+nk_rawfb_unpack(unsigned int *dst, const void *src, const int n, const rawfb_pl pl)
+{
+    /* widens n RGB565 or RGB332 pixels to opaque XRGB_8888 */
+    int i = 0;
+    if (pl == PIXEL_LAYOUT_RGB_565) {
+        const unsigned short *p = (const unsigned short*)src;
+#if defined(NK_RAWFB_SSE2)
+        {const __m128i m6 = _mm_set1_epi16(63), m5 = _mm_set1_epi16(31);
+        const __m128i alpha = _mm_set1_epi16((short)0xff00);
+        for (; i + 8 <= n; i += 8) {
+            __m128i v = _mm_loadu_si128((const __m128i*)(p + i));
+            __m128i r = _mm_srli_epi16(v, 11);
+            __m128i g = _mm_and_si128(_mm_srli_epi16(v, 5), m6);
+            __m128i b = _mm_and_si128(v, m5);
+            r = _mm_or_si128(_mm_or_si128(_mm_slli_epi16(r, 3), _mm_srli_epi16(r, 2)), alpha);
+            g = _mm_or_si128(_mm_slli_epi16(g, 2), _mm_srli_epi16(g, 4));
+            b = _mm_or_si128(_mm_slli_epi16(b, 3), _mm_srli_epi16(b, 2));
+            b = _mm_or_si128(b, _mm_slli_epi16(g, 8));
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_unpacklo_epi16(b, r));
+            _mm_storeu_si128((__m128i*)(dst + i + 4), _mm_unpackhi_epi16(b, r));
+        }}
+#elif defined(NK_RAWFB_NEON)
+        for (; i + 8 <= n; i += 8) {
+            uint16x8_t v = vld1q_u16(p + i);
+            uint8x8_t r = vmovn_u16(vshrq_n_u16(v, 11));
+            uint8x8_t g = vmovn_u16(vandq_u16(vshrq_n_u16(v, 5), vdupq_n_u16(63)));
+            uint8x8_t b = vmovn_u16(vandq_u16(v, vdupq_n_u16(31)));
+            uint8x8x4_t out;
+            out.val[0] = vorr_u8(vshl_n_u8(b, 3), vshr_n_u8(b, 2));
+            out.val[1] = vorr_u8(vshl_n_u8(g, 2), vshr_n_u8(g, 4));
+            out.val[2] = vorr_u8(vshl_n_u8(r, 3), vshr_n_u8(r, 2));
+            out.val[3] = vdup_n_u8(255);
+            vst4_u8((uint8_t*)(dst + i), out);
         }
+#endif
+        for (; i < n; ++i)
+            dst[i] = nk_rawfb_color2int(nk_rawfb_int2color(p[i], pl), PIXEL_LAYOUT_XRGB_8888);
+    } else {
+        const unsigned char *p = (const unsigned char*)src;
+        for (; i < n; ++i)
+            dst[i] = nk_rawfb_color2int(nk_rawfb_int2color(p[i], pl), PIXEL_LAYOUT_XRGB_8888);
+    }
+}
+
+#ifdef NK_RAWFB_SSE2
+static __m128i
+nk_rawfb_pack565_sse2(const __m128i p)
+{
+    /* four XRGB pixels to RGB565 sign extended to 32 bits for packs_epi32 */
+    const __m128i m = _mm_set1_epi32(0xff);
+    const __m128i mul5 = _mm_set1_epi32(249), add5 = _mm_set1_epi32(1014);
+    __m128i r = _mm_and_si128(_mm_srli_epi32(p, 16), m);
+    __m128i g = _mm_and_si128(_mm_srli_epi32(p, 8), m);
+    __m128i b = _mm_and_si128(p, m);
+    r = _mm_srli_epi32(_mm_add_epi32(_mm_mullo_epi16(r, mul5), add5), 11);
+    g = _mm_srli_epi32(_mm_add_epi32(_mm_mullo_epi16(g, _mm_set1_epi32(253)),
+        _mm_set1_epi32(505)), 10);
+    b = _mm_srli_epi32(_mm_add_epi32(_mm_mullo_epi16(b, mul5), add5), 11);
+    r = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(r, 11), _mm_slli_epi32(g, 5)), b);
+    return _mm_srai_epi32(_mm_slli_epi32(r, 16), 16);
+}
+#endif
+
+static unsigned int
+nk_rawfb_dither(const unsigned int v, const unsigned int levels, const unsigned int t)
+{
+    /* quantizes v to 0..levels with the threshold (t+0.5)/16 instead of 0.5 */
+    return (v * levels * 32 + (2 * t + 1) * 255) / (255 * 32);
+}
+
+static void
+nk_rawfb_pack(void *dst, const unsigned int *src, const int n, const rawfb_pl pl,
+    const int x, const int y, const int dither)
+{
+    /* narrows n XRGB_8888 pixels at screen position (x,y) to RGB565 or
+     * RGB332, either rounded or with an ordered 4x4 dither pattern */
+    int i = 0;
+    if (dither) {
+        const unsigned char *bayer = nk_rawfb_bayer[y & 3];
+        const unsigned int rl = (pl == PIXEL_LAYOUT_RGB_565) ? 31: 7;
+        const unsigned int gl = (pl == PIXEL_LAYOUT_RGB_565) ? 63: 7;
+        const unsigned int bl = (pl == PIXEL_LAYOUT_RGB_565) ? 31: 3;
+        for (; i < n; ++i) {
+            const unsigned int t = bayer[(x + i) & 3];
+            const unsigned int r = nk_rawfb_dither(src[i] >> 16 & 0xff, rl, t);
+            const unsigned int g = nk_rawfb_dither(src[i] >> 8 & 0xff, gl, t);
+            const unsigned int b = nk_rawfb_dither(src[i] & 0xff, bl, t);
+            if (pl == PIXEL_LAYOUT_RGB_565)
+                ((unsigned short*)dst)[i] = (unsigned short)(r << 11 | g << 5 | b);
+            else ((unsigned char*)dst)[i] = (unsigned char)(r << 5 | g << 2 | b);
+        }
+    } else if (pl == PIXEL_LAYOUT_RGB_565) {
+        unsigned short *p = (unsigned short*)dst;
+#if defined(NK_RAWFB_SSE2)
+        for (; i + 8 <= n; i += 8) {
+            __m128i lo = _mm_loadu_si128((const __m128i*)(src + i));
+            __m128i hi = _mm_loadu_si128((const __m128i*)(src + i + 4));
+            _mm_storeu_si128((__m128i*)(p + i), _mm_packs_epi32(
+                nk_rawfb_pack565_sse2(lo), nk_rawfb_pack565_sse2(hi)));
+        }
+#elif defined(NK_RAWFB_NEON)
+        {const uint8x8_t mul5 = vdup_n_u8(249), mul6 = vdup_n_u8(253);
+        for (; i + 8 <= n; i += 8) {
+            uint8x8x4_t v = vld4_u8((const uint8_t*)(src + i));
+            uint16x8_t r = vshrq_n_u16(vmlal_u8(vdupq_n_u16(1014), v.val[2], mul5), 11);
+            uint16x8_t g = vshrq_n_u16(vmlal_u8(vdupq_n_u16(505), v.val[1], mul6), 10);
+            uint16x8_t b = vshrq_n_u16(vmlal_u8(vdupq_n_u16(1014), v.val[0], mul5), 11);
+            vst1q_u16(p + i, vorrq_u16(vorrq_u16(vshlq_n_u16(r, 11), vshlq_n_u16(g, 5)), b));
+        }}
+#endif
+        for (; i < n; ++i)
+            p[i] = (unsigned short)nk_rawfb_narrow(src[i] >> 16 & 0xff,
+                src[i] >> 8 & 0xff, src[i] & 0xff, pl);
+    } else {
+        unsigned char *p = (unsigned char*)dst;
+        for (; i < n; ++i)
+            p[i] = (unsigned char)nk_rawfb_narrow(src[i] >> 16 & 0xff,
+                src[i] >> 8 & 0xff, src[i] & 0xff, pl);
+    }
+}
+
+static void
+nk_rawfb_span_apply(unsigned int *dst, const int n, const struct rawfb_span *s,
+    const int offset, const rawfb_pl pl)
+{
+    /* runs the kernel of `s` on n pixels starting `offset` pixels into the span */
+    int from[4], k;
+    switch (s->op) {
+    case RAWFB_SPAN_COLOR:
+        if (s->a == 255) nk_rawfb_span_fill(dst, n, s->c);
+        else nk_rawfb_span_blend(dst, n, s->c, s->a);
+        break;
+    case RAWFB_SPAN_MASK:
+        nk_rawfb_span_blend_mask(dst, s->mask + offset, n, s->c, s->a);
+        break;
+    case RAWFB_SPAN_PIXELS:
+        nk_rawfb_span_blend_src(dst, s->src + offset, n,
+            (pl == PIXEL_LAYOUT_XRGB_8888) ? 24: 0);
+        break;
+    case RAWFB_SPAN_GRADIENT:
+        for (k = 0; k < 4; ++k)
+            from[k] = s->from[k] + s->step[k] * offset;
+        nk_rawfb_span_gradient(dst, n, from, s->step, pl);
+        break;
+    }
+}
+
+static void
+nk_rawfb_draw_span(const struct rawfb_target *target, const int x, const int y,
+    const int n, const struct rawfb_span *s)
+{
+    /* draws pixels x .. x+n of row y, the span has to be clipped already */
+    unsigned char *row = (unsigned char*)target->fb.pixels + y * target->fb.pitch;
+    const rawfb_pl pl = target->fb.pl;
+    const int bpp = nk_rawfb_bytes_per_pixel(pl);
+    unsigned int buf[NK_RAWFB_SPAN_CHUNK];
+    int i, k;
+
+    if (bpp == 4) {
+        nk_rawfb_span_apply((unsigned int*)row + x, n, s, 0, pl);
+        return;
+    }
+    if (s->op == RAWFB_SPAN_COLOR && s->a == 255) {
+        const unsigned int c = nk_rawfb_narrow(s->c >> 16 & 0xff,
+            s->c >> 8 & 0xff, s->c & 0xff, pl);
+        if (bpp == 2) nk_rawfb_span_fill16((unsigned short*)row + x, n, (unsigned short)c);
+        else memset(row + x, (int)c, (size_t)n);
+        return;
+    }
+    for (i = 0; i < n; i += k) {
+        k = MIN(n - i, NK_RAWFB_SPAN_CHUNK);
+        nk_rawfb_unpack(buf, row + (x + i) * bpp, k, pl);
+        nk_rawfb_span_apply(buf, k, s, i, PIXEL_LAYOUT_XRGB_8888);
+        nk_rawfb_pack(row + (x + i) * bpp, buf, k, pl, x + i, y,
+            target->dither && s->op == RAWFB_SPAN_GRADIENT);
+    }
+}
+
+static void
+nk_rawfb_ctx_setpixel(const struct rawfb_target *target,
+    const short x0, const short y0, const struct nk_color col)
+{
+    struct rawfb_span s;
+    if (y0 < target->scissors.h && y0 >= target->scissors.y &&
+        x0 >= target->scissors.x && x0 < target->scissors.w) {
+        s.op = RAWFB_SPAN_COLOR;
+        s.c = nk_rawfb_color2int(col, nk_rawfb_work_layout(target->fb.pl));
+        s.a = col.a;
+        nk_rawfb_draw_span(target, x0, y0, 1, &s);
+    }
+}
+
+static void
+nk_rawfb_line_horizontal(const struct rawfb_target *target,
+    short x0, const short y, short x1, const struct nk_color col)
+{
+    /* This function is called the most. It clips the span [x0, x1) once
+     * against the scissor rect and hands it to a span kernel. */
+    struct rawfb_span s;
+
+    if (y < target->scissors.y || y >= target->scissors.h || col.a == 0)
+        return;
+    x0 = MAX(x0, (short)target->scissors.x);
+    x1 = MIN(x1, (short)target->scissors.w);
+    if (x0 >= x1) return;
+
+    s.op = RAWFB_SPAN_COLOR;
+    s.c = nk_rawfb_color2int(col, nk_rawfb_work_layout(target->fb.pl));
+    s.a = col.a;
+    nk_rawfb_draw_span(target, x0, y, x1 - x0, &s);
+}
+
+static unsigned int
+nk_rawfb_read_pixel(const unsigned char *row, const int x, const rawfb_pl pl)
+{
+    switch (nk_rawfb_bytes_per_pixel(pl)) {
+    case 2: return ((const unsigned short*)row)[x];
+    case 1: return row[x];
+    default: return ((const unsigned int*)row)[x];
     }
 }
 
@@ -195,7 +1030,6 @@ nk_rawfb_img_getpixel(const struct rawfb_image *img, const int x0, const int y0)
 {
     struct nk_color col = {0, 0, 0, 0};
     unsigned char *ptr;
-    unsigned int pixel;
     NK_ASSERT(img);
     if (y0 < img->h && y0 >= 0 && x0 >= 0 && x0 < img->w) {
         ptr = img->pixels + (img->pitch * y0);
@@ -203,56 +1037,47 @@ nk_rawfb_img_getpixel(const struct rawfb_image *img, const int x0, const int y0)
         if (img->format == NK_FONT_ATLAS_ALPHA8) {
             col.a = ptr[x0];
             col.b = col.g = col.r = 0xff;
-        } else {
-	    pixel = ((unsigned int *)ptr)[x0];
-	    col = nk_rawfb_int2color(pixel, img->pl);
-        }
+        } else col = nk_rawfb_int2color(nk_rawfb_read_pixel(ptr, x0, img->pl), img->pl);
     } return col;
 }
 static void
-nk_rawfb_img_blendpixel(const struct rawfb_image *img,
-    const int x0, const int y0, struct nk_color col)
-{
-    struct nk_color col2;
-    unsigned char inv_a;
-    if (col.a == 0)
-        return;
-
-    inv_a = 0xff - col.a;
-    col2 = nk_rawfb_img_getpixel(img, x0, y0);
-    col.r = (col.r * col.a + col2.r * inv_a) >> 8;
-    col.g = (col.g * col.a + col2.g * inv_a) >> 8;
-    col.b = (col.b * col.a + col2.b * inv_a) >> 8;
-    nk_rawfb_img_setpixel(img, x0, y0, col);
-}
-
-static void
-nk_rawfb_scissor(struct rawfb_context *rawfb,
+nk_rawfb_scissor(struct rawfb_target *target,
                  const float x,
                  const float y,
                  const float w,
                  const float h)
 {
-    rawfb->scissors.x = MIN(MAX(x, 0), rawfb->fb.w);
-    rawfb->scissors.y = MIN(MAX(y, 0), rawfb->fb.h);
-    rawfb->scissors.w = MIN(MAX(w + x, 0), rawfb->fb.w);
-    rawfb->scissors.h = MIN(MAX(h + y, 0), rawfb->fb.h);
+    target->scissors.x = MIN(MAX(x, 0), target->fb.w);
+    target->scissors.y = MIN(MAX(y, 0), target->fb.h);
+    target->scissors.w = MIN(MAX(w + x, 0), target->fb.w);
+    target->scissors.h = MIN(MAX(h + y, 0), target->fb.h);
+}
+
+static int
+nk_rawfb_outside(const struct rawfb_target *target,
+    const int x0, const int y0, const int x1, const int y1)
+{
+    /* true if the inclusive rect (x0,y0)-(x1,y1) misses the scissor rect */
+    return x1 < target->scissors.x || x0 >= target->scissors.w ||
+        y1 < target->scissors.y || y0 >= target->scissors.h;
 }
 
 static void
-nk_rawfb_stroke_line(const struct rawfb_context *rawfb,
+nk_rawfb_stroke_line(const struct rawfb_target *target,
     short x0, short y0, short x1, short y1,
     const unsigned int line_thickness, const struct nk_color col)
 {
     short tmp;
     int dy, dx, stepx, stepy;
 
+    if (nk_rawfb_outside(target, MIN(x0, x1), MIN(y0, y1), MAX(x0, x1), MAX(y0, y1)))
+        return;
     dy = y1 - y0;
     dx = x1 - x0;
 
     /* fast path */
     if (dy == 0) {
-        if (dx == 0 || y0 >= rawfb->scissors.h || y0 < rawfb->scissors.y)
+        if (dx == 0 || y0 >= target->scissors.h || y0 < target->scissors.y)
             return;
 
         if (dx < 0) {
@@ -261,11 +1086,7 @@ nk_rawfb_stroke_line(const struct rawfb_context *rawfb,
             x1 = x0;
             x0 = tmp;
         }
-        x1 = MIN(rawfb->scissors.w, x1);
-        x0 = MIN(rawfb->scissors.w, x0);
-        x1 = MAX(rawfb->scissors.x, x1);
-        x0 = MAX(rawfb->scissors.x, x0);
-        nk_rawfb_line_horizontal(rawfb, x0, y0, x1, col);
+        nk_rawfb_line_horizontal(target, x0, y0, x1, col);
         return;
     }
     if (dy < 0) {
@@ -281,7 +1102,7 @@ nk_rawfb_stroke_line(const struct rawfb_context *rawfb,
     dy <<= 1;
     dx <<= 1;
 
-    nk_rawfb_ctx_setpixel(rawfb, x0, y0, col);
+    nk_rawfb_ctx_setpixel(target, x0, y0, col);
     if (dx > dy) {
         int fraction = dy - (dx >> 1);
         while (x0 != x1) {
@@ -291,7 +1112,7 @@ nk_rawfb_stroke_line(const struct rawfb_context *rawfb,
             }
             x0 += stepx;
             fraction += dy;
-            nk_rawfb_ctx_setpixel(rawfb, x0, y0, col);
+            nk_rawfb_ctx_setpixel(target, x0, y0, col);
         }
     } else {
         int fraction = dx - (dy >> 1);
@@ -302,76 +1123,212 @@ nk_rawfb_stroke_line(const struct rawfb_context *rawfb,
             }
             y0 += stepy;
             fraction += dx;
-            nk_rawfb_ctx_setpixel(rawfb, x0, y0, col);
+            nk_rawfb_ctx_setpixel(target, x0, y0, col);
         }
     }
 }
 
+struct rawfb_edge {
+    /* polygon edge going down from y0 to y1, x is the position at y0 */
+    float x, dxdy, y0, y1;
+};
+struct rawfb_crossing {
+    float x;
+    int edge;
+};
+
+static int
+nk_rawfb_edge_cmp(const void *a, const void *b)
+{
+    const float ya = ((const struct rawfb_edge*)a)->y0;
+    const float yb = ((const struct rawfb_edge*)b)->y0;
+    return (ya < yb) ? -1: (ya > yb);
+}
+
 static void
-nk_rawfb_fill_polygon(const struct rawfb_context *rawfb,
-    const struct nk_vec2i *pnts, int count, const struct nk_color col)
+nk_rawfb_fill_path(const struct rawfb_target *target,
+    const struct nk_vec2 *pnts, const int count, const struct nk_color col)
 {
-    int i = 0;
-    #define MAX_POINTS 64
-    int left = 10000, top = 10000, bottom = 0, right = 0;
-    int nodes, nodeX[MAX_POINTS], pixelX, pixelY, j, swap ;
-
-    if (count == 0) return;
-    if (count > MAX_POINTS)
-        count = MAX_POINTS;
-
-    /* Get polygon dimensions */
-    for (i = 0; i < count; i++) {
-        if (left > pnts[i].x)
-            left = pnts[i].x;
-        if (right < pnts[i].x)
-            right = pnts[i].x;
-        if (top > pnts[i].y)
-            top = pnts[i].y;
-        if (bottom < pnts[i].y)
-            bottom = pnts[i].y;
-    } bottom++; right++;
-
-    /* Polygon scanline algorithm released under public-domain by Darel Rex Finley, 2007 */
-    /*  Loop through the rows of the image. */
-    for (pixelY = top; pixelY < bottom; pixelY ++) {
-        nodes = 0; /*  Build a list of nodes. */
-        j = count - 1;
-        for (i = 0; i < count; i++) {
-            if (((pnts[i].y < pixelY) && (pnts[j].y >= pixelY)) ||
-                ((pnts[j].y < pixelY) && (pnts[i].y >= pixelY))) {
-                nodeX[nodes++]= (int)((float)pnts[i].x
-                     + ((float)pixelY - (float)pnts[i].y) / ((float)pnts[j].y - (float)pnts[i].y)
-                     * ((float)pnts[j].x - (float)pnts[i].x));
-            } j = i;
-        }
+    /* Active edge table scan converter using the even-odd rule. Without
+     * anti-aliasing each row is sampled once at its center. Otherwise
+     * NK_RAWFB_AA_SAMPLES rows are sampled per pixel row, the exact
+     * horizontal coverage of every sample is accumulated and the row is
+     * written as opaque runs and coverage masked runs. */
+    struct rawfb_edge edge_stack[64], *edges = edge_stack;
+    struct rawfb_crossing active_stack[64], *active = active_stack;
+    int cover_stack[2 * 256 + 1], *cover = cover_stack;
+    unsigned char mask_stack[256], *mask = mask_stack;
+    const int samples = (target->aa == NK_ANTI_ALIASING_ON) ? NK_RAWFB_AA_SAMPLES: 1;
+    float top, bottom, left, right;
+    int i, j, n = 0, next = 0, nactive = 0, x0, x1, y0, y1, y, s, w;
+    struct rawfb_span span;
+
+    if (count < 3 || !col.a) return;
+    top = bottom = pnts[0].y;
+    left = right = pnts[0].x;
+    for (i = 1; i < count; ++i) {
+        top = MIN(top, pnts[i].y); bottom = MAX(bottom, pnts[i].y);
+        left = MIN(left, pnts[i].x); right = MAX(right, pnts[i].x);
+    }
+    x0 = MAX((int)floor(left), (int)target->scissors.x);
+    x1 = MIN((int)ceil(right), (int)target->scissors.w);
+    y0 = MAX((int)floor(top), (int)target->scissors.y);
+    y1 = MIN((int)ceil(bottom), (int)target->scissors.h);
+    if (x0 >= x1 || y0 >= y1) return;
+    w = x1 - x0;
+
+    if (count > 64) {
+        edges = malloc((size_t)count * sizeof(struct rawfb_edge));
+        active = malloc((size_t)count * sizeof(struct rawfb_crossing));
+        if (!edges || !active) goto cleanup;
+    }
+    if (samples > 1 && w > 256) {
+        cover = malloc((size_t)(2 * w + 1) * sizeof(int));
+        mask = malloc((size_t)w);
+        if (!cover || !mask) goto cleanup;
+    }
 
-        /*  Sort the nodes, via a simple “Bubble” sort. */
-        i = 0;
-        while (i < nodes - 1) {
-            if (nodeX[i] > nodeX[i+1]) {
-                swap = nodeX[i];
-                nodeX[i] = nodeX[i+1];
-                nodeX[i+1] = swap;
-                if (i) i--;
-            } else i++;
-        }
-        /*  Fill the pixels between node pairs. */
-        for (i = 0; i < nodes; i += 2) {
-            if (nodeX[i+0] >= right) break;
-            if (nodeX[i+1] > left) {
-                if (nodeX[i+0] < left) nodeX[i+0] = left ;
-                if (nodeX[i+1] > right) nodeX[i+1] = right;
-                for (pixelX = nodeX[i]; pixelX < nodeX[i + 1]; pixelX++)
-                    nk_rawfb_ctx_setpixel(rawfb, pixelX, pixelY, col);
+    /* build the edge table sorted by the upper end of each edge */
+    for (i = 0, j = count - 1; i < count; j = i++) {
+        const struct nk_vec2 *a = &pnts[j], *b = &pnts[i];
+        if (a->y == b->y) continue;
+        if (a->y > b->y) {a = &pnts[i]; b = &pnts[j];}
+        edges[n].x = a->x;
+        edges[n].y0 = a->y;
+        edges[n].y1 = b->y;
+        edges[n].dxdy = (b->x - a->x) / (b->y - a->y);
+        n++;
+    }
+    qsort(edges, (size_t)n, sizeof(struct rawfb_edge), nk_rawfb_edge_cmp);
+    if (samples > 1)
+        memset(cover, 0, (size_t)(2 * w + 1) * sizeof(int));
+
+    span.c = nk_rawfb_color2int(col, nk_rawfb_work_layout(target->fb.pl));
+    span.a = col.a;
+    for (y = y0; y < y1; ++y) {
+        int lo = w, hi = 0;
+        for (s = 0; s < samples; ++s) {
+            const float sy = (float)y + ((float)s + 0.5f) / (float)samples;
+
+            /* retire edges above the sample and activate the new ones */
+            for (i = j = 0; i < nactive; ++i)
+                if (edges[active[i].edge].y1 > sy) active[j++] = active[i];
+            nactive = j;
+            for (; next < n && edges[next].y0 <= sy; ++next) {
+                if (edges[next].y1 <= sy) continue;
+                active[nactive++].edge = next;
+            }
+
+            /* crossings stay almost sorted between samples */
+            for (i = 0; i < nactive; ++i) {
+                const struct rawfb_edge *e = &edges[active[i].edge];
+                struct rawfb_crossing t;
+                t.edge = active[i].edge;
+                t.x = e->x + (sy - e->y0) * e->dxdy;
+                for (j = i; j > 0 && active[j-1].x > t.x; --j)
+                    active[j] = active[j-1];
+                active[j] = t;
+            }
+
+            for (i = 0; i + 1 < nactive; i += 2) {
+                const float l = MAX(active[i].x, (float)x0);
+                const float r = MIN(active[i+1].x, (float)x1);
+                int fl, fr, a, b;
+                if (l >= r) continue;
+                if (samples == 1) {
+                    /* pixels with their center inside the span */
+                    nk_rawfb_line_horizontal(target, (short)ceil(l - 0.5f), (short)y,
+                        (short)ceil(r - 0.5f), col);
+                    continue;
+                }
+                /* coverage in 1/256 pixel, cover[w + i] holds the change of
+                 * the fully covered run that starts at pixel i */
+                fl = (int)(l * 256.0f) - x0 * 256;
+                fr = (int)(r * 256.0f) - x0 * 256;
+                a = fl >> 8; b = fr >> 8;
+                if (a == b) cover[a] += fr - fl;
+                else {
+                    cover[a] += 256 - (fl & 255);
+                    cover[w + a + 1] += 256;
+                    cover[w + b] -= 256;
+                    if (b < w) cover[b] += fr & 255;
+                }
+                lo = MIN(lo, a);
+                hi = MAX(hi, MIN(b + 1, w));
             }
         }
+        if (samples == 1 || lo >= hi) continue;
+
+        /* resolve the coverage into a mask and write it as runs */
+        {const int total = samples * 256;
+        int run = 0;
+        for (i = lo; i < hi; ++i) {
+            int v;
+            run += cover[w + i];
+            v = MIN(run + cover[i], total);
+            mask[i] = (unsigned char)((v * 255 + total / 2) / total);
+            cover[i] = cover[w + i] = 0;
+        }
+        cover[w + hi] = 0;
+        for (i = lo; i < hi; i = j) {
+            if (mask[i] == 255) {
+                for (j = i; j < hi && mask[j] == 255; ++j);
+                span.op = RAWFB_SPAN_COLOR;
+            } else {
+                for (j = i; j < hi && mask[j] != 255; ++j);
+                span.op = RAWFB_SPAN_MASK;
+                span.mask = mask + i;
+            }
+            nk_rawfb_draw_span(target, x0 + i, y, j - i, &span);
+        }}
     }
-    #undef MAX_POINTS
+
+cleanup:
+    if (edges != edge_stack) free(edges);
+    if (active != active_stack) free(active);
+    if (cover != cover_stack) free(cover);
+    if (mask != mask_stack) free(mask);
 }
 
 static void
-nk_rawfb_stroke_arc(const struct rawfb_context *rawfb,
+nk_rawfb_fill_polygon(const struct rawfb_target *target,
+    const struct nk_vec2i *pnts, const int count, const struct nk_color col)
+{
+    struct nk_vec2 stack[64], *points = stack;
+    int i;
+    if (count < 3) return;
+    if (count > 64) {
+        points = malloc((size_t)count * sizeof(struct nk_vec2));
+        if (!points) return;
+    }
+    for (i = 0; i < count; ++i)
+        points[i] = nk_vec2((float)pnts[i].x, (float)pnts[i].y);
+    nk_rawfb_fill_path(target, points, count, col);
+    if (points != stack) free(points);
+}
+
+static int
+nk_rawfb_arc_segments(const float r)
+{
+    /* segments per quarter circle so that the error stays below 0.1px */
+    return MIN(MAX((int)ceil(2.0 * sqrt(r)), 2), 64);
+}
+
+static int
+nk_rawfb_arc_points(struct nk_vec2 *pnts, const float cx, const float cy,
+    const float rx, const float ry, const float a0, const float a1, const int segments)
+{
+    int i;
+    for (i = 0; i <= segments; ++i) {
+        const float a = a0 + (a1 - a0) * (float)i / (float)segments;
+        pnts[i].x = cx + (float)cos(a) * rx;
+        pnts[i].y = cy + (float)sin(a) * ry;
+    }
+    return segments + 1;
+}
+
+static void
+nk_rawfb_stroke_arc(const struct rawfb_target *target,
     short x0, short y0, short w, short h, const short s,
     const short line_thickness, const struct nk_color col)
 {
@@ -383,6 +1340,7 @@ nk_rawfb_stroke_arc(const struct rawfb_context *rawfb,
 
     if (s != 0 && s != 90 && s != 180 && s != 270) return;
     if (w < 1 || h < 1) return;
+    if (nk_rawfb_outside(target, x0, y0, x0 + w + 1, y0 + h + 1)) return;
 
     /* Convert upper left to center */
     h = (h + 1) / 2;
@@ -392,13 +1350,13 @@ nk_rawfb_stroke_arc(const struct rawfb_context *rawfb,
     /* First half */
     for (x = 0, y = h, sigma = 2*b2+a2*(1-2*h); b2*x <= a2*y; x++) {
         if (s == 180)
-            nk_rawfb_ctx_setpixel(rawfb, x0 + x, y0 + y, col);
+            nk_rawfb_ctx_setpixel(target, x0 + x, y0 + y, col);
         else if (s == 270)
-            nk_rawfb_ctx_setpixel(rawfb, x0 - x, y0 + y, col);
+            nk_rawfb_ctx_setpixel(target, x0 - x, y0 + y, col);
         else if (s == 0)
-            nk_rawfb_ctx_setpixel(rawfb, x0 + x, y0 - y, col);
+            nk_rawfb_ctx_setpixel(target, x0 + x, y0 - y, col);
         else if (s == 90)
-            nk_rawfb_ctx_setpixel(rawfb, x0 - x, y0 - y, col);
+            nk_rawfb_ctx_setpixel(target, x0 - x, y0 - y, col);
         if (sigma >= 0) {
             sigma += fa2 * (1 - y);
             y--;
@@ -408,13 +1366,13 @@ nk_rawfb_stroke_arc(const struct rawfb_context *rawfb,
     /* Second half */
     for (x = w, y = 0, sigma = 2*a2+b2*(1-2*w); a2*y <= b2*x; y++) {
         if (s == 180)
-            nk_rawfb_ctx_setpixel(rawfb, x0 + x, y0 + y, col);
+            nk_rawfb_ctx_setpixel(target, x0 + x, y0 + y, col);
         else if (s == 270)
-            nk_rawfb_ctx_setpixel(rawfb, x0 - x, y0 + y, col);
+            nk_rawfb_ctx_setpixel(target, x0 - x, y0 + y, col);
         else if (s == 0)
-            nk_rawfb_ctx_setpixel(rawfb, x0 + x, y0 - y, col);
+            nk_rawfb_ctx_setpixel(target, x0 + x, y0 - y, col);
         else if (s == 90)
-            nk_rawfb_ctx_setpixel(rawfb, x0 - x, y0 - y, col);
+            nk_rawfb_ctx_setpixel(target, x0 - x, y0 - y, col);
         if (sigma >= 0) {
             sigma += fb2 * (1 - x);
             x--;
@@ -423,321 +1381,184 @@ nk_rawfb_stroke_arc(const struct rawfb_context *rawfb,
 }
 
 static void
-nk_rawfb_fill_arc(const struct rawfb_context *rawfb, short x0, short y0,
-    short w, short h, const short s, const struct nk_color col)
+nk_rawfb_fill_arc(const struct rawfb_target *target, const short cx, const short cy,
+    const unsigned short r, float a0, float a1, const struct nk_color col)
 {
-    /* Bresenham's ellipses - modified to fill one quarter */
-    const int a2 = (w * w) / 4;
-    const int b2 = (h * h) / 4;
-    const int fa2 = 4 * a2, fb2 = 4 * b2;
-    int x, y, sigma;
-    struct nk_vec2i pnts[3];
-    if (w < 1 || h < 1) return;
-    if (s != 0 && s != 90 && s != 180 && s != 270)
-        return;
-
-    /* Convert upper left to center */
-    h = (h + 1) / 2;
-    w = (w + 1) / 2;
-    x0 += w;
-    y0 += h;
-
-    pnts[0].x = x0;
-    pnts[0].y = y0;
-    pnts[2].x = x0;
-    pnts[2].y = y0;
-
-    /* First half */
-    for (x = 0, y = h, sigma = 2*b2+a2*(1-2*h); b2*x <= a2*y; x++) {
-        if (s == 180) {
-            pnts[1].x = x0 + x; pnts[1].y = y0 + y;
-        } else if (s == 270) {
-            pnts[1].x = x0 - x; pnts[1].y = y0 + y;
-        } else if (s == 0) {
-            pnts[1].x = x0 + x; pnts[1].y = y0 - y;
-        } else if (s == 90) {
-            pnts[1].x = x0 - x; pnts[1].y = y0 - y;
-        }
-        nk_rawfb_fill_polygon(rawfb, pnts, 3, col);
-        pnts[2] = pnts[1];
-        if (sigma >= 0) {
-            sigma += fa2 * (1 - y);
-            y--;
-        } sigma += b2 * ((4 * x) + 6);
-    }
-
-    /* Second half */
-    for (x = w, y = 0, sigma = 2*a2+b2*(1-2*w); a2*y <= b2*x; y++) {
-        if (s == 180) {
-            pnts[1].x = x0 + x; pnts[1].y = y0 + y;
-        } else if (s == 270) {
-            pnts[1].x = x0 - x; pnts[1].y = y0 + y;
-        } else if (s == 0) {
-            pnts[1].x = x0 + x; pnts[1].y = y0 - y;
-        } else if (s == 90) {
-            pnts[1].x = x0 - x; pnts[1].y = y0 - y;
-        }
-        nk_rawfb_fill_polygon(rawfb, pnts, 3, col);
-        pnts[2] = pnts[1];
-        if (sigma >= 0) {
-            sigma += fb2 * (1 - x);
-            x--;
-        } sigma += a2 * ((4 * y) + 6);
-    }
+    /* pie slice between the angles a0 and a1 given in radians */
+    struct nk_vec2 pnts[4 * 64 + 2];
+    int n, segments;
+    if (!r) return;
+    if (nk_rawfb_outside(target, cx - r, cy - r, cx + r, cy + r)) return;
+    if (a1 < a0) {float t = a0; a0 = a1; a1 = t;}
+    a1 = MIN(a1, a0 + 2.0f * NK_PI);
+    segments = (int)ceil((float)nk_rawfb_arc_segments(r) * (a1 - a0) / (NK_PI * 0.5f));
+    pnts[0] = nk_vec2(cx, cy);
+    n = 1 + nk_rawfb_arc_points(pnts + 1, cx, cy, r, r, a0, a1, MAX(segments, 1));
+    nk_rawfb_fill_path(target, pnts, n, col);
 }
 
 static void
-nk_rawfb_stroke_rect(const struct rawfb_context *rawfb,
+nk_rawfb_stroke_rect(const struct rawfb_target *target,
     const short x, const short y, const short w, const short h,
     const short r, const short line_thickness, const struct nk_color col)
 {
     if (r == 0) {
-        nk_rawfb_stroke_line(rawfb, x, y, x + w, y, line_thickness, col);
-        nk_rawfb_stroke_line(rawfb, x, y + h, x + w, y + h, line_thickness, col);
-        nk_rawfb_stroke_line(rawfb, x, y, x, y + h, line_thickness, col);
-        nk_rawfb_stroke_line(rawfb, x + w, y, x + w, y + h, line_thickness, col);
+        nk_rawfb_stroke_line(target, x, y, x + w, y, line_thickness, col);
+        nk_rawfb_stroke_line(target, x, y + h, x + w, y + h, line_thickness, col);
+        nk_rawfb_stroke_line(target, x, y, x, y + h, line_thickness, col);
+        nk_rawfb_stroke_line(target, x + w, y, x + w, y + h, line_thickness, col);
     } else {
         const short xc = x + r;
         const short yc = y + r;
         const short wc = (short)(w - 2 * r);
         const short hc = (short)(h - 2 * r);
 
-        nk_rawfb_stroke_line(rawfb, xc, y, xc + wc, y, line_thickness, col);
-        nk_rawfb_stroke_line(rawfb, x + w, yc, x + w, yc + hc, line_thickness, col);
-        nk_rawfb_stroke_line(rawfb, xc, y + h, xc + wc, y + h, line_thickness, col);
-        nk_rawfb_stroke_line(rawfb, x, yc, x, yc + hc, line_thickness, col);
+        nk_rawfb_stroke_line(target, xc, y, xc + wc, y, line_thickness, col);
+        nk_rawfb_stroke_line(target, x + w, yc, x + w, yc + hc, line_thickness, col);
+        nk_rawfb_stroke_line(target, xc, y + h, xc + wc, y + h, line_thickness, col);
+        nk_rawfb_stroke_line(target, x, yc, x, yc + hc, line_thickness, col);
 
-        nk_rawfb_stroke_arc(rawfb, xc + wc - r, y,
+        nk_rawfb_stroke_arc(target, xc + wc - r, y,
                 (unsigned)r*2, (unsigned)r*2, 0 , line_thickness, col);
-        nk_rawfb_stroke_arc(rawfb, x, y,
+        nk_rawfb_stroke_arc(target, x, y,
                 (unsigned)r*2, (unsigned)r*2, 90 , line_thickness, col);
-        nk_rawfb_stroke_arc(rawfb, x, yc + hc - r,
+        nk_rawfb_stroke_arc(target, x, yc + hc - r,
                 (unsigned)r*2, (unsigned)r*2, 270 , line_thickness, col);
-        nk_rawfb_stroke_arc(rawfb, xc + wc - r, yc + hc - r,
+        nk_rawfb_stroke_arc(target, xc + wc - r, yc + hc - r,
                 (unsigned)r*2, (unsigned)r*2, 180 , line_thickness, col);
     }
 }
 
 static void
-nk_rawfb_fill_rect(const struct rawfb_context *rawfb,
+nk_rawfb_fill_rect(const struct rawfb_target *target,
     const short x, const short y, const short w, const short h,
     const short r, const struct nk_color col)
 {
     int i;
     if (r == 0) {
-        for (i = 0; i < h; i++)
-            nk_rawfb_stroke_line(rawfb, x, y + i, x + w, y + i, 1, col);
+        const int y0 = MAX(y, (int)target->scissors.y);
+        const int y1 = MIN(y + h, (int)target->scissors.h);
+        for (i = y0; i < y1; i++)
+            nk_rawfb_line_horizontal(target, x, i, x + w, col);
     } else {
-        const short xc = x + r;
-        const short yc = y + r;
-        const short wc = (short)(w - 2 * r);
-        const short hc = (short)(h - 2 * r);
-
-        struct nk_vec2i pnts[12];
-        pnts[0].x = x;
-        pnts[0].y = yc;
-        pnts[1].x = xc;
-        pnts[1].y = yc;
-        pnts[2].x = xc;
-        pnts[2].y = y;
-
-        pnts[3].x = xc + wc;
-        pnts[3].y = y;
-        pnts[4].x = xc + wc;
-        pnts[4].y = yc;
-        pnts[5].x = x + w;
-        pnts[5].y = yc;
-
-        pnts[6].x = x + w;
-        pnts[6].y = yc + hc;
-        pnts[7].x = xc + wc;
-        pnts[7].y = yc + hc;
-        pnts[8].x = xc + wc;
-        pnts[8].y = y + h;
-
-        pnts[9].x = xc;
-        pnts[9].y = y + h;
-        pnts[10].x = xc;
-        pnts[10].y = yc + hc;
-        pnts[11].x = x;
-        pnts[11].y = yc + hc;
-
-        nk_rawfb_fill_polygon(rawfb, pnts, 12, col);
-
-        nk_rawfb_fill_arc(rawfb, xc + wc - r, y,
-                (unsigned)r*2, (unsigned)r*2, 0 , col);
-        nk_rawfb_fill_arc(rawfb, x, y,
-                (unsigned)r*2, (unsigned)r*2, 90 , col);
-        nk_rawfb_fill_arc(rawfb, x, yc + hc - r,
-                (unsigned)r*2, (unsigned)r*2, 270 , col);
-        nk_rawfb_fill_arc(rawfb, xc + wc - r, yc + hc - r,
-                (unsigned)r*2, (unsigned)r*2, 180 , col);
+        /* one outline for the whole shape so anti-aliased edges do not
+         * leave seams between the corners and the body */
+        struct nk_vec2 pnts[4 * (64 + 1)];
+        const float rf = (float)MIN(r, MIN(w, h) / 2);
+        const int segments = nk_rawfb_arc_segments(rf);
+        int n = 0;
+        if (nk_rawfb_outside(target, x, y, x + w, y + h)) return;
+        n += nk_rawfb_arc_points(pnts + n, x + w - rf, y + rf, rf, rf, -NK_PI * 0.5f, 0, segments);
+        n += nk_rawfb_arc_points(pnts + n, x + w - rf, y + h - rf, rf, rf, 0, NK_PI * 0.5f, segments);
+        n += nk_rawfb_arc_points(pnts + n, x + rf, y + h - rf, rf, rf, NK_PI * 0.5f, NK_PI, segments);
+        n += nk_rawfb_arc_points(pnts + n, x + rf, y + rf, rf, rf, NK_PI, NK_PI * 1.5f, segments);
+        nk_rawfb_fill_path(target, pnts, n, col);
     }
 }
 
 NK_API void
-nk_rawfb_draw_rect_multi_color(const struct rawfb_context *rawfb,
+nk_rawfb_draw_rect_multi_color(const struct rawfb_target *target,
     const short x, const short y, const short w, const short h, struct nk_color tl,
     struct nk_color tr, struct nk_color br, struct nk_color bl)
 {
-    int i, j;
-    struct nk_color *edge_buf;
-    struct nk_color *edge_t;
-    struct nk_color *edge_b;
-    struct nk_color *edge_l;
-    struct nk_color *edge_r;
-    struct nk_color pixel;
-
-    edge_buf = malloc(((2*w) + (2*h)) * sizeof(struct nk_color));
-    if (edge_buf == NULL)
-	return;
-
-    edge_t = edge_buf;
-    edge_b = edge_buf + w;
-    edge_l = edge_buf + (w*2);
-    edge_r = edge_buf + (w*2) + h;
-
-    /* Top and bottom edge gradients */
-    for (i=0; i<w; i++)
-    {
-	edge_t[i].r = (((((float)tr.r - tl.r)/(w-1))*i) + 0.5) + tl.r;
-	edge_t[i].g = (((((float)tr.g - tl.g)/(w-1))*i) + 0.5) + tl.g;
-	edge_t[i].b = (((((float)tr.b - tl.b)/(w-1))*i) + 0.5) + tl.b;
-	edge_t[i].a = (((((float)tr.a - tl.a)/(w-1))*i) + 0.5) + tl.a;
-
-	edge_b[i].r = (((((float)br.r - bl.r)/(w-1))*i) + 0.5) + bl.r;
-	edge_b[i].g = (((((float)br.g - bl.g)/(w-1))*i) + 0.5) + bl.g;
-	edge_b[i].b = (((((float)br.b - bl.b)/(w-1))*i) + 0.5) + bl.b;
-	edge_b[i].a = (((((float)br.a - bl.a)/(w-1))*i) + 0.5) + bl.a;
-    }
-
-    /* Left and right edge gradients */
-    for (i=0; i<h; i++)
-    {
-	edge_l[i].r = (((((float)bl.r - tl.r)/(h-1))*i) + 0.5) + tl.r;
-	edge_l[i].g = (((((float)bl.g - tl.g)/(h-1))*i) + 0.5) + tl.g;
-	edge_l[i].b = (((((float)bl.b - tl.b)/(h-1))*i) + 0.5) + tl.b;
-	edge_l[i].a = (((((float)bl.a - tl.a)/(h-1))*i) + 0.5) + tl.a;
-
-	edge_r[i].r = (((((float)br.r - tr.r)/(h-1))*i) + 0.5) + tr.r;
-	edge_r[i].g = (((((float)br.g - tr.g)/(h-1))*i) + 0.5) + tr.g;
-	edge_r[i].b = (((((float)br.b - tr.b)/(h-1))*i) + 0.5) + tr.b;
-	edge_r[i].a = (((((float)br.a - tr.a)/(h-1))*i) + 0.5) + tr.a;
-    }
-
-    for (i=0; i<h; i++) {
-	for (j=0; j<w; j++) {
-	    if (i==0) {
-		nk_rawfb_img_blendpixel(&rawfb->fb, x+j, y+i, edge_t[j]);
-	    } else if (i==h-1) {
-		nk_rawfb_img_blendpixel(&rawfb->fb, x+j, y+i, edge_b[j]);
-	    } else {
-		if (j==0) {
-		    nk_rawfb_img_blendpixel(&rawfb->fb, x+j, y+i, edge_l[i]);
-		} else if (j==w-1) {
-		    nk_rawfb_img_blendpixel(&rawfb->fb, x+j, y+i, edge_r[i]);
-		} else {
-		    pixel.r = (((((float)edge_r[i].r - edge_l[i].r)/(w-1))*j) + 0.5) + edge_l[i].r;
-		    pixel.g = (((((float)edge_r[i].g - edge_l[i].g)/(w-1))*j) + 0.5) + edge_l[i].g;
-		    pixel.b = (((((float)edge_r[i].b - edge_l[i].b)/(w-1))*j) + 0.5) + edge_l[i].b;
-		    pixel.a = (((((float)edge_r[i].a - edge_l[i].a)/(w-1))*j) + 0.5) + edge_l[i].a;
-		    nk_rawfb_img_blendpixel(&rawfb->fb, x+j, y+i, pixel);
-		}
-	    }
-	}
-    }
-
-    free(edge_buf);
+    /* Interpolates the left and right edge colors per row in 16.16 fixed
+     * point and fills the clipped part of each row with a gradient span. */
+    int i, k, x0, x1, y0, y1;
+    int tl_c[4], tr_c[4], bl_c[4], br_c[4];
+    int left[4], right[4], from[4], step[4];
+    struct rawfb_span s;
+    if (w <= 0 || h <= 0) return;
+
+    x0 = MAX(x, (int)target->scissors.x);
+    x1 = MIN(x + w, (int)target->scissors.w);
+    y0 = MAX(y, (int)target->scissors.y);
+    y1 = MIN(y + h, (int)target->scissors.h);
+    if (x0 >= x1 || y0 >= y1) return;
+
+    tl_c[0] = tl.r; tl_c[1] = tl.g; tl_c[2] = tl.b; tl_c[3] = tl.a;
+    tr_c[0] = tr.r; tr_c[1] = tr.g; tr_c[2] = tr.b; tr_c[3] = tr.a;
+    bl_c[0] = bl.r; bl_c[1] = bl.g; bl_c[2] = bl.b; bl_c[3] = bl.a;
+    br_c[0] = br.r; br_c[1] = br.g; br_c[2] = br.b; br_c[3] = br.a;
+
+    s.op = RAWFB_SPAN_GRADIENT;
+    s.from = from;
+    s.step = step;
+    for (i = y0; i < y1; ++i) {
+        for (k = 0; k < 4; ++k) {
+            left[k] = (tl_c[k] << 16) + (h > 1 ? (((bl_c[k] - tl_c[k]) << 16) / (h - 1)) * (i - y): 0);
+            right[k] = (tr_c[k] << 16) + (h > 1 ? (((br_c[k] - tr_c[k]) << 16) / (h - 1)) * (i - y): 0);
+            step[k] = (w > 1) ? (right[k] - left[k]) / (w - 1): 0;
+            from[k] = left[k] + step[k] * (x0 - x) + 0x8000;
+        }
+        nk_rawfb_draw_span(target, x0, i, x1 - x0, &s);
+    }
 }
 
 static void
-nk_rawfb_fill_triangle(const struct rawfb_context *rawfb,
+nk_rawfb_fill_triangle(const struct rawfb_target *target,
     const short x0, const short y0, const short x1, const short y1,
     const short x2, const short y2, const struct nk_color col)
 {
-    struct nk_vec2i pnts[3];
-    pnts[0].x = x0;
-    pnts[0].y = y0;
-    pnts[1].x = x1;
-    pnts[1].y = y1;
-    pnts[2].x = x2;
-    pnts[2].y = y2;
-    nk_rawfb_fill_polygon(rawfb, pnts, 3, col);
+    struct nk_vec2 pnts[3];
+    pnts[0] = nk_vec2(x0, y0);
+    pnts[1] = nk_vec2(x1, y1);
+    pnts[2] = nk_vec2(x2, y2);
+    nk_rawfb_fill_path(target, pnts, 3, col);
 }
 
 static void
-nk_rawfb_stroke_triangle(const struct rawfb_context *rawfb,
+nk_rawfb_stroke_triangle(const struct rawfb_target *target,
     const short x0, const short y0, const short x1, const short y1,
     const short x2, const short y2, const unsigned short line_thickness,
     const struct nk_color col)
 {
-    nk_rawfb_stroke_line(rawfb, x0, y0, x1, y1, line_thickness, col);
-    nk_rawfb_stroke_line(rawfb, x1, y1, x2, y2, line_thickness, col);
-    nk_rawfb_stroke_line(rawfb, x2, y2, x0, y0, line_thickness, col);
+    nk_rawfb_stroke_line(target, x0, y0, x1, y1, line_thickness, col);
+    nk_rawfb_stroke_line(target, x1, y1, x2, y2, line_thickness, col);
+    nk_rawfb_stroke_line(target, x2, y2, x0, y0, line_thickness, col);
 }
 
 static void
-nk_rawfb_stroke_polygon(const struct rawfb_context *rawfb,
+nk_rawfb_stroke_polygon(const struct rawfb_target *target,
     const struct nk_vec2i *pnts, const int count,
     const unsigned short line_thickness, const struct nk_color col)
 {
     int i;
     for (i = 1; i < count; ++i)
-        nk_rawfb_stroke_line(rawfb, pnts[i-1].x, pnts[i-1].y, pnts[i].x,
+        nk_rawfb_stroke_line(target, pnts[i-1].x, pnts[i-1].y, pnts[i].x,
                 pnts[i].y, line_thickness, col);
-    nk_rawfb_stroke_line(rawfb, pnts[count-1].x, pnts[count-1].y,
+    nk_rawfb_stroke_line(target, pnts[count-1].x, pnts[count-1].y,
             pnts[0].x, pnts[0].y, line_thickness, col);
 }
 
 static void
-nk_rawfb_stroke_polyline(const struct rawfb_context *rawfb,
+nk_rawfb_stroke_polyline(const struct rawfb_target *target,
     const struct nk_vec2i *pnts, const int count,
     const unsigned short line_thickness, const struct nk_color col)
 {
     int i;
     for (i = 0; i < count-1; ++i)
-        nk_rawfb_stroke_line(rawfb, pnts[i].x, pnts[i].y,
+        nk_rawfb_stroke_line(target, pnts[i].x, pnts[i].y,
                  pnts[i+1].x, pnts[i+1].y, line_thickness, col);
 }
 
 static void
-nk_rawfb_fill_circle(const struct rawfb_context *rawfb,
+nk_rawfb_fill_circle(const struct rawfb_target *target,
     short x0, short y0, short w, short h, const struct nk_color col)
 {
-    /* Bresenham's ellipses */
-    const int a2 = (w * w) / 4;
-    const int b2 = (h * h) / 4;
-    const int fa2 = 4 * a2, fb2 = 4 * b2;
-    int x, y, sigma;
-
-    /* Convert upper left to center */
-    h = (h + 1) / 2;
-    w = (w + 1) / 2;
-    x0 += w;
-    y0 += h;
-
-    /* First half */
-    for (x = 0, y = h, sigma = 2*b2+a2*(1-2*h); b2*x <= a2*y; x++) {
-        nk_rawfb_stroke_line(rawfb, x0 - x, y0 + y, x0 + x, y0 + y, 1, col);
-        nk_rawfb_stroke_line(rawfb, x0 - x, y0 - y, x0 + x, y0 - y, 1, col);
-        if (sigma >= 0) {
-            sigma += fa2 * (1 - y);
-            y--;
-        } sigma += b2 * ((4 * x) + 6);
-    }
-    /* Second half */
-    for (x = w, y = 0, sigma = 2*a2+b2*(1-2*w); a2*y <= b2*x; y++) {
-        nk_rawfb_stroke_line(rawfb, x0 - x, y0 + y, x0 + x, y0 + y, 1, col);
-        nk_rawfb_stroke_line(rawfb, x0 - x, y0 - y, x0 + x, y0 - y, 1, col);
-        if (sigma >= 0) {
-            sigma += fb2 * (1 - x);
-            x--;
-        } sigma += a2 * ((4 * y) + 6);
-    }
+    /* ellipse inscribed into the rect as a polygon with enough segments
+     * to look round at its size */
+    struct nk_vec2 pnts[4 * 64 + 1];
+    const float rx = (float)w * 0.5f, ry = (float)h * 0.5f;
+    int n;
+    if (w < 1 || h < 1) return;
+    if (nk_rawfb_outside(target, x0, y0, x0 + w + 1, y0 + h + 1)) return;
+    n = nk_rawfb_arc_points(pnts, x0 + rx, y0 + ry, rx, ry, 0, 2.0f * NK_PI,
+        4 * nk_rawfb_arc_segments(MAX(rx, ry)));
+    nk_rawfb_fill_path(target, pnts, n - 1, col);
 }
 
 static void
-nk_rawfb_stroke_circle(const struct rawfb_context *rawfb,
+nk_rawfb_stroke_circle(const struct rawfb_target *target,
     short x0, short y0, short w, short h, const short line_thickness,
     const struct nk_color col)
 {
@@ -746,6 +1567,7 @@ nk_rawfb_stroke_circle(const struct rawfb_context *rawfb,
     const int b2 = (h * h) / 4;
     const int fa2 = 4 * a2, fb2 = 4 * b2;
     int x, y, sigma;
+    if (nk_rawfb_outside(target, x0, y0, x0 + w + 1, y0 + h + 1)) return;
 
     /* Convert upper left to center */
     h = (h + 1) / 2;
@@ -755,10 +1577,10 @@ nk_rawfb_stroke_circle(const struct rawfb_context *rawfb,
 
     /* First half */
     for (x = 0, y = h, sigma = 2*b2+a2*(1-2*h); b2*x <= a2*y; x++) {
-        nk_rawfb_ctx_setpixel(rawfb, x0 + x, y0 + y, col);
-        nk_rawfb_ctx_setpixel(rawfb, x0 - x, y0 + y, col);
-        nk_rawfb_ctx_setpixel(rawfb, x0 + x, y0 - y, col);
-        nk_rawfb_ctx_setpixel(rawfb, x0 - x, y0 - y, col);
+        nk_rawfb_ctx_setpixel(target, x0 + x, y0 + y, col);
+        nk_rawfb_ctx_setpixel(target, x0 - x, y0 + y, col);
+        nk_rawfb_ctx_setpixel(target, x0 + x, y0 - y, col);
+        nk_rawfb_ctx_setpixel(target, x0 - x, y0 - y, col);
         if (sigma >= 0) {
             sigma += fa2 * (1 - y);
             y--;
@@ -766,10 +1588,10 @@ nk_rawfb_stroke_circle(const struct rawfb_context *rawfb,
     }
     /* Second half */
     for (x = w, y = 0, sigma = 2*a2+b2*(1-2*w); a2*y <= b2*x; y++) {
-        nk_rawfb_ctx_setpixel(rawfb, x0 + x, y0 + y, col);
-        nk_rawfb_ctx_setpixel(rawfb, x0 - x, y0 + y, col);
-        nk_rawfb_ctx_setpixel(rawfb, x0 + x, y0 - y, col);
-        nk_rawfb_ctx_setpixel(rawfb, x0 - x, y0 - y, col);
+        nk_rawfb_ctx_setpixel(target, x0 + x, y0 + y, col);
+        nk_rawfb_ctx_setpixel(target, x0 - x, y0 + y, col);
+        nk_rawfb_ctx_setpixel(target, x0 + x, y0 - y, col);
+        nk_rawfb_ctx_setpixel(target, x0 - x, y0 - y, col);
         if (sigma >= 0) {
             sigma += fb2 * (1 - x);
             x--;
@@ -778,7 +1600,7 @@ nk_rawfb_stroke_circle(const struct rawfb_context *rawfb,
 }
 
 static void
-nk_rawfb_stroke_curve(const struct rawfb_context *rawfb,
+nk_rawfb_stroke_curve(const struct rawfb_target *target,
     const struct nk_vec2i p1, const struct nk_vec2i p2,
     const struct nk_vec2i p3, const struct nk_vec2i p4,
     const unsigned int num_segments, const unsigned short line_thickness,
@@ -799,16 +1621,24 @@ nk_rawfb_stroke_curve(const struct rawfb_context *rawfb,
         float w4 = t * t *t;
         float x = w1 * p1.x + w2 * p2.x + w3 * p3.x + w4 * p4.x;
         float y = w1 * p1.y + w2 * p2.y + w3 * p3.y + w4 * p4.y;
-        nk_rawfb_stroke_line(rawfb, last.x, last.y,
+        nk_rawfb_stroke_line(target, last.x, last.y,
                 (short)x, (short)y, line_thickness,col);
         last.x = (short)x; last.y = (short)y;
     }
 }
 
 static void
-nk_rawfb_clear(const struct rawfb_context *rawfb, const struct nk_color col)
+nk_rawfb_clear(const struct rawfb_target *target, const struct nk_color col)
 {
-    nk_rawfb_fill_rect(rawfb, 0, 0, rawfb->fb.w, rawfb->fb.h, 0, col);
+    int i;
+    const int x0 = (int)target->scissors.x, x1 = (int)target->scissors.w;
+    struct rawfb_span s;
+    if (x0 >= x1) return;
+    s.op = RAWFB_SPAN_COLOR;
+    s.c = nk_rawfb_color2int(col, nk_rawfb_work_layout(target->fb.pl));
+    s.a = 255;
+    for (i = (int)target->scissors.y; i < (int)target->scissors.h; ++i)
+        nk_rawfb_draw_span(target, x0, i, x1 - x0, &s);
 }
 
 NK_API struct rawfb_context*
@@ -831,7 +1661,8 @@ nk_rawfb_init(void *fb, void *tex_mem, const unsigned int w, const unsigned int
     rawfb->fb.h = h;
     rawfb->fb.pl = pl;
 
-    if (pl == PIXEL_LAYOUT_RGBX_8888 || pl == PIXEL_LAYOUT_XRGB_8888) {
+    if (pl == PIXEL_LAYOUT_RGBX_8888 || pl == PIXEL_LAYOUT_XRGB_8888 ||
+        pl == PIXEL_LAYOUT_RGB_565 || pl == PIXEL_LAYOUT_RGB_332) {
     rawfb->fb.format = NK_FONT_ATLAS_RGBA32;
     rawfb->fb.pitch = pitch;
     }
@@ -864,49 +1695,181 @@ nk_rawfb_init(void *fb, void *tex_mem, const unsigned int w, const unsigned int
     };
     /* Store the font texture in tex scratch memory */
     memcpy(rawfb->font_tex.pixels, tex, rawfb->font_tex.pitch * rawfb->font_tex.h);
-    nk_font_atlas_end(&rawfb->atlas, nk_handle_ptr(NULL), NULL);
+    nk_font_atlas_end(&rawfb->atlas, nk_handle_ptr(NULL), &rawfb->null);
     if (rawfb->atlas.default_font)
         nk_style_set_font(&rawfb->ctx, &rawfb->atlas.default_font->handle);
     nk_style_load_all_cursors(&rawfb->ctx, rawfb->atlas.cursors);
-    nk_rawfb_scissor(rawfb, 0, 0, rawfb->fb.w, rawfb->fb.h);
+#ifdef NK_INCLUDE_VERTEX_BUFFER_OUTPUT
+    nk_buffer_init_default(&rawfb->cmds);
+    nk_buffer_init_default(&rawfb->vertices);
+    nk_buffer_init_default(&rawfb->elements);
+#endif
     return rawfb;
 }
 
+struct rawfb_scaler {
+    /* source rows converted to the framebuffer layout and tinted */
+    const struct rawfb_image *src;
+    rawfb_pl pl;
+    struct nk_color tint;
+    int x0, n;
+    unsigned int lut[256];
+    unsigned int *rows[2];
+    int row_y[2], next;
+};
+
+static const unsigned int*
+nk_rawfb_scaler_row(struct rawfb_scaler *s, const int y)
+{
+    /* returns pixels x0 .. x0+n of source row y, the last two are kept */
+    const unsigned char *in = (const unsigned char*)s->src->pixels + y * s->src->pitch;
+    unsigned int *out;
+    int i;
+    if (s->row_y[0] == y) return s->rows[0];
+    if (s->row_y[1] == y) return s->rows[1];
+    if (s->src->format == NK_FONT_ATLAS_RGBA32 && s->src->pl == s->pl &&
+        s->tint.r == 255 && s->tint.g == 255 && s->tint.b == 255 && s->tint.a == 255)
+        return (const unsigned int*)in + s->x0;
+
+    out = s->rows[s->next];
+    s->row_y[s->next] = y;
+    s->next ^= 1;
+    if (s->src->format == NK_FONT_ATLAS_ALPHA8) {
+        for (i = 0; i < s->n; ++i)
+            out[i] = s->lut[in[s->x0 + i]];
+    } else {
+        for (i = 0; i < s->n; ++i) {
+            struct nk_color c = nk_rawfb_int2color(
+                nk_rawfb_read_pixel(in, s->x0 + i, s->src->pl), s->src->pl);
+            c.r = (nk_byte)((c.r * s->tint.r + 127) / 255);
+            c.g = (nk_byte)((c.g * s->tint.g + 127) / 255);
+            c.b = (nk_byte)((c.b * s->tint.b + 127) / 255);
+            c.a = (nk_byte)((c.a * s->tint.a + 127) / 255);
+            out[i] = nk_rawfb_color2int(c, s->pl);
+        }
+    }
+    return out;
+}
+
 static void
-nk_rawfb_stretch_image(const struct rawfb_image *dst,
-    const struct rawfb_image *src, const struct nk_rect *dst_rect,
-    const struct nk_rect *src_rect, const struct nk_rect *dst_scissors,
-    const struct nk_color *fg)
-{
-    short i, j;
-    struct nk_color col;
-    float xinc = src_rect->w / dst_rect->w;
-    float yinc = src_rect->h / dst_rect->h;
-    float xoff = src_rect->x, yoff = src_rect->y;
-
-    /* Simple nearest filtering rescaling */
-    /* TODO: use bilinear filter */
-    for (j = 0; j < (short)dst_rect->h; j++) {
-        for (i = 0; i < (short)dst_rect->w; i++) {
-            if (dst_scissors) {
-                if (i + (int)(dst_rect->x + 0.5f) < dst_scissors->x || i + (int)(dst_rect->x + 0.5f) >= dst_scissors->w)
-                    continue;
-                if (j + (int)(dst_rect->y + 0.5f) < dst_scissors->y || j + (int)(dst_rect->y + 0.5f) >= dst_scissors->h)
-                    continue;
+nk_rawfb_scale_image(const struct rawfb_target *target, const struct rawfb_image *src,
+    const int sx, const int sy, const int sw, const int sh,
+    const int x, const int y, const int w, const int h, const struct nk_color tint)
+{
+    /* Scales the source rect (sx,sy,sw,sh) onto the destination rect and
+     * blends it. Only the visible part of the destination is visited and
+     * source positions are walked in 16.16 fixed point. Nearest and bilinear
+     * filtering sample at pixel centers, the box filter averages every source
+     * pixel whose position falls into the destination pixel. */
+    unsigned int stack[1024], *mem = stack, *tmp, *out, *sum = 0;
+    const int i0 = MAX(0, (int)target->scissors.x - x);
+    const int j0 = MAX(0, (int)target->scissors.y - y);
+    const int i1 = MIN(w, (int)target->scissors.w - x);
+    const int j1 = MIN(h, (int)target->scissors.h - y);
+    const int xstep = (int)(((long)sw << 16) / MAX(w, 1));
+    const int ystep = (int)(((long)sh << 16) / MAX(h, 1));
+    enum rawfb_image_filter filter = target->filter;
+    struct rawfb_scaler s;
+    struct rawfb_span span;
+    int i, j, k, xa, xb;
+    size_t size;
+
+    if (i0 >= i1 || j0 >= j1 || sw <= 0 || sh <= 0 || !tint.a) return;
+    if (filter == RAWFB_FILTER_BOX && xstep <= 0x10000 && ystep <= 0x10000)
+        filter = RAWFB_FILTER_BILINEAR;
+
+    /* source columns needed by the visible destination columns */
+    if (filter == RAWFB_FILTER_BOX) {
+        xa = (int)(((long)i0 * xstep) >> 16);
+        xb = (int)(((long)i1 * xstep + 0xffff) >> 16);
+    } else {
+        xa = (int)(((long)(2 * i0 + 1) * xstep / 2 - 0x8000) >> 16);
+        xb = (int)(((long)(2 * i1 - 1) * xstep / 2 + 0x8000) >> 16) + 1;
+    }
+    xa = MAX(xa, 0);
+    xb = MIN(MAX(xb, xa + 1), sw);
+
+    s.src = src;
+    s.pl = nk_rawfb_work_layout(target->fb.pl);
+    s.tint = tint;
+    s.x0 = sx + xa;
+    s.n = xb - xa;
+    s.row_y[0] = s.row_y[1] = -1;
+    s.next = 0;
+    if (src->format == NK_FONT_ATLAS_ALPHA8) {
+        struct nk_color c = tint;
+        for (k = 0; k < 256; ++k) {
+            c.a = (nk_byte)((k * tint.a + 127) / 255);
+            s.lut[k] = nk_rawfb_color2int(c, s.pl);
+        }
+    }
+
+    /* two converted rows, one filtered row, the output row and the box sums */
+    size = (size_t)(3 * s.n + (i1 - i0));
+    if (filter == RAWFB_FILTER_BOX) size += (size_t)(4 * s.n);
+    if (size > sizeof(stack) / sizeof(stack[0])) {
+        mem = malloc(size * sizeof(unsigned int));
+        if (!mem) return;
+    }
+    s.rows[0] = mem;
+    s.rows[1] = mem + s.n;
+    tmp = mem + 2 * s.n;
+    out = mem + 3 * s.n;
+    if (filter == RAWFB_FILTER_BOX)
+        sum = out + (i1 - i0);
+    span.op = RAWFB_SPAN_PIXELS;
+    span.src = out;
+
+    for (j = j0; j < j1; ++j) {
+        if (filter == RAWFB_FILTER_NEAREST) {
+            const unsigned int *row = nk_rawfb_scaler_row(&s,
+                sy + MIN((int)(((long)(2 * j + 1) * ystep / 2) >> 16), sh - 1));
+            for (i = i0; i < i1; ++i) {
+                int px = (int)(((long)(2 * i + 1) * xstep / 2) >> 16) - xa;
+                out[i - i0] = row[MIN(px, s.n - 1)];
+            }
+        } else if (filter == RAWFB_FILTER_BILINEAR) {
+            const int fy = (int)((long)(2 * j + 1) * ystep / 2) - 0x8000;
+            const int r0 = NK_CLAMP(0, fy >> 16, sh - 1);
+            const int r1 = MIN(r0 + 1, sh - 1);
+            const unsigned int *a = nk_rawfb_scaler_row(&s, sy + r0);
+            const unsigned int *b = nk_rawfb_scaler_row(&s, sy + r1);
+            if (fy < 0 || r0 == r1 || !(fy & 0xff00)) tmp = (unsigned int*)a;
+            else {
+                tmp = mem + 2 * s.n;
+                nk_rawfb_span_lerp(tmp, a, b, s.n, (unsigned int)(fy >> 8) & 0xff);
+            }
+            for (i = i0; i < i1; ++i) {
+                const int fx = (int)((long)(2 * i + 1) * xstep / 2) - 0x8000;
+                const int c0 = NK_CLAMP(0, (fx >> 16) - xa, s.n - 1);
+                const int c1 = MIN(c0 + 1, s.n - 1);
+                out[i - i0] = (fx < 0) ? tmp[c0]:
+                    nk_rawfb_blend(tmp[c0], tmp[c1], (unsigned int)(fx >> 8) & 0xff);
+            }
+        } else {
+            const int ra = (int)(((long)j * ystep) >> 16);
+            const int rb = MIN(MAX((int)(((long)(j + 1) * ystep) >> 16), ra + 1), sh);
+            memset(sum, 0, (size_t)(4 * s.n) * sizeof(unsigned int));
+            for (k = ra; k < rb; ++k)
+                nk_rawfb_span_accumulate(sum, nk_rawfb_scaler_row(&s, sy + k), s.n);
+            for (i = i0; i < i1; ++i) {
+                const int ca = (int)(((long)i * xstep) >> 16) - xa;
+                const int cb = MIN(MAX((int)(((long)(i + 1) * xstep) >> 16) - xa, ca + 1), s.n);
+                const unsigned int count = (unsigned int)((cb - ca) * (rb - ra));
+                unsigned int c[4] = {0, 0, 0, 0};
+                for (k = ca; k < cb; ++k) {
+                    c[0] += sum[4*k+0]; c[1] += sum[4*k+1];
+                    c[2] += sum[4*k+2]; c[3] += sum[4*k+3];
+                }
+                out[i - i0] = ((c[0] + count / 2) / count) |
+                    (((c[1] + count / 2) / count) << 8) |
+                    (((c[2] + count / 2) / count) << 16) |
+                    (((c[3] + count / 2) / count) << 24);
             }
-            col = nk_rawfb_img_getpixel(src, (int)xoff, (int) yoff);
-	    if (col.r || col.g || col.b)
-	    {
-		col.r = fg->r;
-		col.g = fg->g;
-		col.b = fg->b;
-	    }
-            nk_rawfb_img_blendpixel(dst, i + (int)(dst_rect->x + 0.5f), j + (int)(dst_rect->y + 0.5f), col);
-            xoff += xinc;
         }
-        xoff = src_rect->x;
-        yoff += yinc;
+        nk_rawfb_draw_span(target, x + i0, y + j, i1 - i0, &span);
     }
+    if (mem != stack) free(mem);
 }
 
 static void
@@ -936,8 +1899,185 @@ nk_rawfb_font_query_font_glyph(nk_handle handle, const float height,
     glyph->uv[1] = nk_vec2(g->u1, g->v1);
 }
 
+static void
+nk_rawfb_glyph_sample(const struct rawfb_image *tex, const struct nk_rect *src,
+    const int w, const int h, const int row, const int col, const int n,
+    unsigned char *out)
+{
+    /* nearest filtered coverage of `n` pixels of a glyph scaled to w x h */
+    int i;
+    const float xinc = src->w / (float)w;
+    const int y = (int)(src->y + (float)row * (src->h / (float)h));
+    for (i = 0; i < n; ++i)
+        out[i] = nk_rawfb_img_getpixel(tex, (int)(src->x + (float)(col + i) * xinc), y).a;
+}
+
+static unsigned int
+nk_rawfb_glyph_hash(const void *font, const nk_rune codepoint, const float height)
+{
+    unsigned int h = codepoint * 2654435761u;
+    h ^= (unsigned int)(height * 64.0f) * 40503u;
+    h ^= (unsigned int)((nk_size)font >> 4) * 2246822519u;
+    return h ^ (h >> 15);
+}
+
+static int
+nk_rawfb_glyph_cache_grow(struct rawfb_glyph_cache *cache)
+{
+    int i, capacity = cache->capacity ? cache->capacity * 2: 256;
+    struct rawfb_glyph *slots = calloc((size_t)capacity, sizeof(struct rawfb_glyph));
+    if (!slots) return 0;
+    for (i = 0; i < cache->capacity; ++i) {
+        const struct rawfb_glyph *g = &cache->slots[i];
+        unsigned int k;
+        if (!g->font) continue;
+        k = nk_rawfb_glyph_hash(g->font, g->codepoint, g->height);
+        while (slots[k & (unsigned)(capacity-1)].font) k++;
+        slots[k & (unsigned)(capacity-1)] = *g;
+    }
+    free(cache->slots);
+    cache->slots = slots;
+    cache->capacity = capacity;
+    return 1;
+}
+
+static void
+nk_rawfb_glyph_cache_trim(struct rawfb_glyph_cache *cache)
+{
+    /* starts over once the masks outgrow their budget, this is only done
+     * between frames so glyphs stay valid while commands are drawn */
+    if (cache->mask_size <= NK_RAWFB_GLYPH_CACHE_MEMORY) return;
+    if (cache->slots)
+        memset(cache->slots, 0, (size_t)cache->capacity * sizeof(struct rawfb_glyph));
+    cache->count = 0;
+    cache->mask_size = 0;
+}
+
+static void
+nk_rawfb_glyph_cache_free(struct rawfb_glyph_cache *cache)
+{
+    free(cache->slots);
+    free(cache->masks);
+    NK_MEMSET(cache, 0, sizeof(*cache));
+}
+
+static const struct rawfb_glyph*
+nk_rawfb_glyph_lookup(const struct rawfb_target *target, const struct nk_user_font *font,
+    const nk_rune codepoint, const float height, const int fill)
+{
+    /* returns the cached glyph or adds it if `fill` is set, NULL otherwise */
+    struct rawfb_glyph_cache *cache = target->glyphs;
+    struct rawfb_glyph *g;
+    struct nk_user_font_glyph info;
+    struct nk_rect src;
+    const void *key = font->userdata.ptr;
+    unsigned int k;
+    int j, size;
+
+    if (!cache || !key) return NULL;
+    if (cache->capacity) {
+        k = nk_rawfb_glyph_hash(key, codepoint, height);
+        for (;; ++k) {
+            g = &cache->slots[k & (unsigned)(cache->capacity-1)];
+            if (!g->font) break;
+            if (g->font == key && g->codepoint == codepoint && g->height == height)
+                return g;
+        }
+    }
+    if (!fill) return NULL;
+    if ((cache->count + 1) * 2 > cache->capacity && !nk_rawfb_glyph_cache_grow(cache))
+        return NULL;
+
+    /* rasterize the mask exactly like a direct nearest filtered blit */
+    nk_rawfb_font_query_font_glyph(font->userdata, height, &info, codepoint, 0);
+    src.x = info.uv[0].x * target->font_tex.w;
+    src.y = info.uv[0].y * target->font_tex.h;
+    src.w = info.uv[1].x * target->font_tex.w - info.uv[0].x * target->font_tex.w;
+    src.h = info.uv[1].y * target->font_tex.h - info.uv[0].y * target->font_tex.h;
+    k = nk_rawfb_glyph_hash(key, codepoint, height);
+    while (cache->slots[k & (unsigned)(cache->capacity-1)].font) k++;
+    g = &cache->slots[k & (unsigned)(cache->capacity-1)];
+    g->w = MAX((int)ceil(info.width), 0);
+    g->h = MAX((int)ceil(info.height), 0);
+    size = g->w * g->h;
+    if (!nk_rawfb_reserve((void**)&cache->masks, &cache->mask_capacity,
+            cache->mask_size + size, 1))
+        return NULL;
+    g->font = key;
+    g->codepoint = codepoint;
+    g->height = height;
+    g->xadvance = info.xadvance;
+    g->offset = info.offset;
+    g->mask = cache->mask_size;
+    for (j = 0; j < g->h; ++j)
+        nk_rawfb_glyph_sample(&target->font_tex, &src, g->w, g->h, j, 0, g->w,
+            cache->masks + g->mask + j * g->w);
+    cache->mask_size += size;
+    cache->count++;
+    return g;
+}
+
+static void
+nk_rawfb_cache_text(const struct rawfb_target *target, const struct nk_user_font *font,
+    const char *text, const int len, const float font_height)
+{
+    /* adds all glyphs of a text up front so tiles only have to read the cache */
+    int text_len = 0, glyph_len;
+    nk_rune unicode;
+    if (!text) return;
+    while (text_len < len) {
+        glyph_len = nk_utf_decode(text + text_len, &unicode, len - text_len);
+        if (!glyph_len || unicode == NK_UTF_INVALID) break;
+        nk_rawfb_glyph_lookup(target, font, unicode, font_height, 1);
+        text_len += glyph_len;
+    }
+}
+
+static void
+nk_rawfb_draw_glyph(const struct rawfb_target *target,
+    const struct rawfb_glyph *glyph, const struct nk_user_font_glyph *info,
+    const int x, const int y, const struct nk_color fg)
+{
+    /* blits a glyph mask clipped to the scissor rect. Glyphs missing from
+     * the cache are sampled from the font texture one row part at a time */
+    unsigned char row[64];
+    struct rawfb_span s;
+    const int w = glyph ? glyph->w: MAX((int)ceil(info->width), 0);
+    const int h = glyph ? glyph->h: MAX((int)ceil(info->height), 0);
+    const int i0 = MAX(0, (int)target->scissors.x - x);
+    const int j0 = MAX(0, (int)target->scissors.y - y);
+    const int i1 = MIN(w, (int)target->scissors.w - x);
+    const int j1 = MIN(h, (int)target->scissors.h - y);
+    struct nk_rect src;
+    int i, j;
+
+    if (i0 >= i1 || j0 >= j1 || !fg.a) return;
+    s.op = RAWFB_SPAN_MASK;
+    s.c = nk_rawfb_color2int(fg, nk_rawfb_work_layout(target->fb.pl));
+    s.a = fg.a;
+    if (!glyph) {
+        src.x = info->uv[0].x * target->font_tex.w;
+        src.y = info->uv[0].y * target->font_tex.h;
+        src.w = info->uv[1].x * target->font_tex.w - info->uv[0].x * target->font_tex.w;
+        src.h = info->uv[1].y * target->font_tex.h - info->uv[0].y * target->font_tex.h;
+    }
+    for (j = j0; j < j1; ++j) {
+        if (glyph) {
+            s.mask = target->glyphs->masks + glyph->mask + j * w + i0;
+            nk_rawfb_draw_span(target, x + i0, y + j, i1 - i0, &s);
+            continue;
+        }
+        s.mask = row;
+        for (i = i0; i < i1; i += (int)sizeof(row)) {
+            const int n = MIN(i1 - i, (int)sizeof(row));
+            nk_rawfb_glyph_sample(&target->font_tex, &src, w, h, j, i, n, row);
+            nk_rawfb_draw_span(target, x + i, y + j, n, &s);
+        }
+    }
+}
+
 NK_API void
-nk_rawfb_draw_text(const struct rawfb_context *rawfb,
+nk_rawfb_draw_text(const struct rawfb_target *target,
     const struct nk_user_font *font, const struct nk_rect rect,
     const char *text, const int len, const float font_height,
     const struct nk_color fg)
@@ -957,30 +2097,25 @@ nk_rawfb_draw_text(const struct rawfb_context *rawfb,
 
     /* draw every glyph image */
     while (text_len < len && glyph_len) {
-        struct nk_rect src_rect;
-        struct nk_rect dst_rect;
+        const struct rawfb_glyph *cached;
+        struct nk_vec2 offset;
         float char_width = 0;
         if (unicode == NK_UTF_INVALID) break;
-
-        /* query currently drawn glyph information */
         next_glyph_len = nk_utf_decode(text + text_len + glyph_len, &next, (int)len - text_len);
-        nk_rawfb_font_query_font_glyph(font->userdata, font_height, &g, unicode,
-                    (next == NK_UTF_INVALID) ? '\0' : next);
-
-        /* calculate and draw glyph drawing rectangle and image */
-        char_width = g.xadvance;
-        src_rect.x = g.uv[0].x * rawfb->font_tex.w;
-        src_rect.y = g.uv[0].y * rawfb->font_tex.h;
-        src_rect.w = g.uv[1].x * rawfb->font_tex.w - g.uv[0].x * rawfb->font_tex.w;
-        src_rect.h = g.uv[1].y * rawfb->font_tex.h - g.uv[0].y * rawfb->font_tex.h;
-
-        dst_rect.x = x + g.offset.x + rect.x;
-        dst_rect.y = g.offset.y + rect.y;
-        dst_rect.w = ceilf(g.width);
-        dst_rect.h = ceilf(g.height);
 
-        /* Use software rescaling to blit glyph from font_text to framebuffer */
-        nk_rawfb_stretch_image(&rawfb->fb, &rawfb->font_tex, &dst_rect, &src_rect, &rawfb->scissors, &fg);
+        /* cached glyphs already know their metrics and scaled coverage */
+        cached = nk_rawfb_glyph_lookup(target, font, unicode, font_height, target->fill_glyphs);
+        if (cached) {
+            char_width = cached->xadvance;
+            offset = cached->offset;
+        } else {
+            nk_rawfb_font_query_font_glyph(font->userdata, font_height, &g, unicode,
+                        (next == NK_UTF_INVALID) ? '\0' : next);
+            char_width = g.xadvance;
+            offset = g.offset;
+        }
+        nk_rawfb_draw_glyph(target, cached, &g,
+            (int)(x + offset.x + rect.x + 0.5f), (int)(offset.y + rect.y + 0.5f), fg);
 
         /* offset next glyph */
         text_len += glyph_len;
@@ -991,29 +2126,37 @@ nk_rawfb_draw_text(const struct rawfb_context *rawfb,
 }
 
 NK_API void
-nk_rawfb_drawimage(const struct rawfb_context *rawfb,
+nk_rawfb_drawimage(const struct rawfb_target *target,
     const int x, const int y, const int w, const int h,
     const struct nk_image *img, const struct nk_color *col)
 {
-    struct nk_rect src_rect;
-    struct nk_rect dst_rect;
-
-    src_rect.x = img->region[0];
-    src_rect.y = img->region[1];
-    src_rect.w = img->region[2];
-    src_rect.h = img->region[3];
-
-    dst_rect.x = x;
-    dst_rect.y = y;
-    dst_rect.w = w;
-    dst_rect.h = h;
-    nk_rawfb_stretch_image(&rawfb->fb, &rawfb->font_tex, &dst_rect, &src_rect, &rawfb->scissors, col);
+    const struct rawfb_image *src = img->handle.ptr ?
+        (const struct rawfb_image*)img->handle.ptr: &target->font_tex;
+    int sx = img->region[0], sy = img->region[1];
+    int sw = img->region[2], sh = img->region[3];
+    if (!sw || !sh) {
+        sx = sy = 0;
+        sw = src->w;
+        sh = src->h;
+    }
+    sw = MIN(sw, src->w - sx);
+    sh = MIN(sh, src->h - sy);
+    nk_rawfb_scale_image(target, src, sx, sy, sw, sh, x, y, w, h, *col);
 }
 
 NK_API void
 nk_rawfb_shutdown(struct rawfb_context *rawfb)
 {
     if (rawfb) {
+	free(rawfb->items);
+	free(rawfb->bins);
+	free(rawfb->tiles);
+	nk_rawfb_glyph_cache_free(&rawfb->glyphs);
+#ifdef NK_INCLUDE_VERTEX_BUFFER_OUTPUT
+	nk_buffer_free(&rawfb->cmds);
+	nk_buffer_free(&rawfb->vertices);
+	nk_buffer_free(&rawfb->elements);
+#endif
 	nk_free(&rawfb->ctx);
 	NK_MEMSET(rawfb, 0, sizeof(struct rawfb_context));
 	free(rawfb);
@@ -1036,93 +2179,652 @@ nk_rawfb_resize_fb(struct rawfb_context *rawfb,
 }
 
 NK_API void
-nk_rawfb_render(const struct rawfb_context *rawfb,
+nk_rawfb_set_anti_aliasing(struct rawfb_context *rawfb, enum nk_anti_aliasing aa)
+{
+    rawfb->aa = aa;
+}
+
+NK_API void
+nk_rawfb_set_image_filter(struct rawfb_context *rawfb, enum rawfb_image_filter filter)
+{
+    rawfb->filter = filter;
+}
+
+NK_API void
+nk_rawfb_set_dithering(struct rawfb_context *rawfb, const int enable)
+{
+    rawfb->dither = enable;
+}
+
+static void
+nk_rawfb_draw_command(struct rawfb_target *target, const struct nk_command *cmd)
+{
+    switch (cmd->type) {
+    case NK_COMMAND_NOP: break;
+    case NK_COMMAND_SCISSOR: {
+        const struct nk_command_scissor *s =(const struct nk_command_scissor*)cmd;
+        nk_rawfb_scissor(target, s->x, s->y, s->w, s->h);
+    } break;
+    case NK_COMMAND_LINE: {
+        const struct nk_command_line *l = (const struct nk_command_line *)cmd;
+        nk_rawfb_stroke_line(target, l->begin.x, l->begin.y, l->end.x,
+            l->end.y, l->line_thickness, l->color);
+    } break;
+    case NK_COMMAND_RECT: {
+        const struct nk_command_rect *r = (const struct nk_command_rect *)cmd;
+        nk_rawfb_stroke_rect(target, r->x, r->y, r->w, r->h,
+            (unsigned short)r->rounding, r->line_thickness, r->color);
+    } break;
+    case NK_COMMAND_RECT_FILLED: {
+        const struct nk_command_rect_filled *r = (const struct nk_command_rect_filled *)cmd;
+        nk_rawfb_fill_rect(target, r->x, r->y, r->w, r->h,
+            (unsigned short)r->rounding, r->color);
+    } break;
+    case NK_COMMAND_CIRCLE: {
+        const struct nk_command_circle *c = (const struct nk_command_circle *)cmd;
+        nk_rawfb_stroke_circle(target, c->x, c->y, c->w, c->h, c->line_thickness, c->color);
+    } break;
+    case NK_COMMAND_CIRCLE_FILLED: {
+        const struct nk_command_circle_filled *c = (const struct nk_command_circle_filled *)cmd;
+        nk_rawfb_fill_circle(target, c->x, c->y, c->w, c->h, c->color);
+    } break;
+    case NK_COMMAND_TRIANGLE: {
+        const struct nk_command_triangle*t = (const struct nk_command_triangle*)cmd;
+        nk_rawfb_stroke_triangle(target, t->a.x, t->a.y, t->b.x, t->b.y,
+            t->c.x, t->c.y, t->line_thickness, t->color);
+    } break;
+    case NK_COMMAND_TRIANGLE_FILLED: {
+        const struct nk_command_triangle_filled *t = (const struct nk_command_triangle_filled *)cmd;
+        nk_rawfb_fill_triangle(target, t->a.x, t->a.y, t->b.x, t->b.y,
+            t->c.x, t->c.y, t->color);
+    } break;
+    case NK_COMMAND_POLYGON: {
+        const struct nk_command_polygon *p =(const struct nk_command_polygon*)cmd;
+        nk_rawfb_stroke_polygon(target, p->points, p->point_count, p->line_thickness,p->color);
+    } break;
+    case NK_COMMAND_POLYGON_FILLED: {
+        const struct nk_command_polygon_filled *p = (const struct nk_command_polygon_filled *)cmd;
+        nk_rawfb_fill_polygon(target, p->points, p->point_count, p->color);
+    } break;
+    case NK_COMMAND_POLYLINE: {
+        const struct nk_command_polyline *p = (const struct nk_command_polyline *)cmd;
+        nk_rawfb_stroke_polyline(target, p->points, p->point_count, p->line_thickness, p->color);
+    } break;
+    case NK_COMMAND_TEXT: {
+        const struct nk_command_text *t = (const struct nk_command_text*)cmd;
+        nk_rawfb_draw_text(target, t->font, nk_rect(t->x, t->y, t->w, t->h),
+            t->string, t->length, t->height, t->foreground);
+    } break;
+    case NK_COMMAND_CURVE: {
+        const struct nk_command_curve *q = (const struct nk_command_curve *)cmd;
+        nk_rawfb_stroke_curve(target, q->begin, q->ctrl[0], q->ctrl[1],
+            q->end, 22, q->line_thickness, q->color);
+    } break;
+    case NK_COMMAND_RECT_MULTI_COLOR: {
+        const struct nk_command_rect_multi_color *q = (const struct nk_command_rect_multi_color *)cmd;
+        nk_rawfb_draw_rect_multi_color(target, q->x, q->y, q->w, q->h, q->left, q->top, q->right, q->bottom);
+    } break;
+    case NK_COMMAND_IMAGE: {
+        const struct nk_command_image *q = (const struct nk_command_image *)cmd;
+        nk_rawfb_drawimage(target, q->x, q->y, q->w, q->h, &q->img, &q->col);
+    } break;
+    case NK_COMMAND_ARC: {
+        assert(0 && "NK_COMMAND_ARC not implemented\n");
+    } break;
+    case NK_COMMAND_ARC_FILLED: {
+        const struct nk_command_arc_filled *a = (const struct nk_command_arc_filled *)cmd;
+        nk_rawfb_fill_arc(target, a->cx, a->cy, a->r, a->a[0], a->a[1], a->color);
+    } break;
+    default: break;
+    }
+}
+
+static int
+nk_rawfb_points_bounds(const struct nk_vec2i *pnts, const int count,
+    const float pad, struct nk_rect *r)
+{
+    int i;
+    if (count <= 0) return 0;
+    r->x = r->w = pnts[0].x;
+    r->y = r->h = pnts[0].y;
+    for (i = 1; i < count; ++i) {
+        r->x = MIN(r->x, pnts[i].x); r->w = MAX(r->w, pnts[i].x);
+        r->y = MIN(r->y, pnts[i].y); r->h = MAX(r->h, pnts[i].y);
+    }
+    r->x -= pad; r->y -= pad;
+    r->w += pad + 1; r->h += pad + 1;
+    return 1;
+}
+
+static int
+nk_rawfb_command_bounds(const struct nk_command *cmd, struct nk_rect *r)
+{
+    /* Conservative pixel bounds of a drawing command in the same min/max
+     * form as the scissor rect. Returns 0 for commands that draw nothing. */
+    float x, y, w, h, pad = 2;
+    struct nk_vec2i p[4];
+    switch (cmd->type) {
+    case NK_COMMAND_LINE: {
+        const struct nk_command_line *l = (const struct nk_command_line *)cmd;
+        p[0] = l->begin; p[1] = l->end;
+        return nk_rawfb_points_bounds(p, 2, pad + l->line_thickness, r);
+    }
+    case NK_COMMAND_CURVE: {
+        const struct nk_command_curve *q = (const struct nk_command_curve *)cmd;
+        p[0] = q->begin; p[1] = q->ctrl[0]; p[2] = q->ctrl[1]; p[3] = q->end;
+        return nk_rawfb_points_bounds(p, 4, pad + q->line_thickness, r);
+    }
+    case NK_COMMAND_TRIANGLE: {
+        const struct nk_command_triangle *t = (const struct nk_command_triangle *)cmd;
+        p[0] = t->a; p[1] = t->b; p[2] = t->c;
+        return nk_rawfb_points_bounds(p, 3, pad + t->line_thickness, r);
+    }
+    case NK_COMMAND_TRIANGLE_FILLED: {
+        const struct nk_command_triangle_filled *t = (const struct nk_command_triangle_filled *)cmd;
+        p[0] = t->a; p[1] = t->b; p[2] = t->c;
+        return nk_rawfb_points_bounds(p, 3, pad, r);
+    }
+    case NK_COMMAND_POLYGON: {
+        const struct nk_command_polygon *q = (const struct nk_command_polygon *)cmd;
+        return nk_rawfb_points_bounds(q->points, q->point_count, pad + q->line_thickness, r);
+    }
+    case NK_COMMAND_POLYGON_FILLED: {
+        const struct nk_command_polygon_filled *q = (const struct nk_command_polygon_filled *)cmd;
+        return nk_rawfb_points_bounds(q->points, q->point_count, pad, r);
+    }
+    case NK_COMMAND_POLYLINE: {
+        const struct nk_command_polyline *q = (const struct nk_command_polyline *)cmd;
+        return nk_rawfb_points_bounds(q->points, q->point_count, pad + q->line_thickness, r);
+    }
+    case NK_COMMAND_RECT: {
+        const struct nk_command_rect *q = (const struct nk_command_rect *)cmd;
+        x = q->x; y = q->y; w = q->w; h = q->h;
+        pad += q->line_thickness;
+    } break;
+    case NK_COMMAND_RECT_FILLED: {
+        const struct nk_command_rect_filled *q = (const struct nk_command_rect_filled *)cmd;
+        x = q->x; y = q->y; w = q->w; h = q->h;
+    } break;
+    case NK_COMMAND_RECT_MULTI_COLOR: {
+        const struct nk_command_rect_multi_color *q = (const struct nk_command_rect_multi_color *)cmd;
+        x = q->x; y = q->y; w = q->w; h = q->h;
+    } break;
+    case NK_COMMAND_CIRCLE: {
+        const struct nk_command_circle *c = (const struct nk_command_circle *)cmd;
+        x = c->x; y = c->y; w = c->w; h = c->h;
+        pad += c->line_thickness;
+    } break;
+    case NK_COMMAND_CIRCLE_FILLED: {
+        const struct nk_command_circle_filled *c = (const struct nk_command_circle_filled *)cmd;
+        x = c->x; y = c->y; w = c->w; h = c->h;
+    } break;
+    case NK_COMMAND_ARC: {
+        const struct nk_command_arc *a = (const struct nk_command_arc *)cmd;
+        x = a->cx - a->r; y = a->cy - a->r; w = h = 2 * a->r;
+        pad += a->line_thickness;
+    } break;
+    case NK_COMMAND_ARC_FILLED: {
+        const struct nk_command_arc_filled *a = (const struct nk_command_arc_filled *)cmd;
+        x = a->cx - a->r; y = a->cy - a->r; w = h = 2 * a->r;
+    } break;
+    case NK_COMMAND_TEXT: {
+        /* glyphs may reach out of the text rect by their offsets */
+        const struct nk_command_text *t = (const struct nk_command_text *)cmd;
+        x = t->x; y = t->y; w = t->w; h = t->h;
+        pad += t->height;
+    } break;
+    case NK_COMMAND_IMAGE: {
+        const struct nk_command_image *q = (const struct nk_command_image *)cmd;
+        x = q->x; y = q->y; w = q->w; h = q->h;
+    } break;
+    default: return 0;
+    }
+    r->x = x - pad; r->y = y - pad;
+    r->w = x + w + pad; r->h = y + h + pad;
+    return 1;
+}
+
+NK_API void
+nk_rawfb_render(struct rawfb_context *rawfb,
                 const struct nk_color clear,
                 const unsigned char enable_clear)
 {
     const struct nk_command *cmd;
+    struct rawfb_target target;
+    target.fb = rawfb->fb;
+    target.font_tex = rawfb->font_tex;
+    target.aa = rawfb->aa;
+    target.filter = rawfb->filter;
+    target.dither = rawfb->dither;
+    target.glyphs = &rawfb->glyphs;
+    target.fill_glyphs = 1;
+    nk_rawfb_glyph_cache_trim(target.glyphs);
+    nk_rawfb_scissor(&target, 0, 0, rawfb->fb.w, rawfb->fb.h);
     if (enable_clear)
-        nk_rawfb_clear(rawfb, clear);
-
-    nk_foreach(cmd, (struct nk_context*)&rawfb->ctx) {
-        switch (cmd->type) {
-        case NK_COMMAND_NOP: break;
-        case NK_COMMAND_SCISSOR: {
-            const struct nk_command_scissor *s =(const struct nk_command_scissor*)cmd;
-            nk_rawfb_scissor((struct rawfb_context *)rawfb, s->x, s->y, s->w, s->h);
-        } break;
-        case NK_COMMAND_LINE: {
-            const struct nk_command_line *l = (const struct nk_command_line *)cmd;
-            nk_rawfb_stroke_line(rawfb, l->begin.x, l->begin.y, l->end.x,
-                l->end.y, l->line_thickness, l->color);
-        } break;
-        case NK_COMMAND_RECT: {
-            const struct nk_command_rect *r = (const struct nk_command_rect *)cmd;
-            nk_rawfb_stroke_rect(rawfb, r->x, r->y, r->w, r->h,
-                (unsigned short)r->rounding, r->line_thickness, r->color);
-        } break;
-        case NK_COMMAND_RECT_FILLED: {
-            const struct nk_command_rect_filled *r = (const struct nk_command_rect_filled *)cmd;
-            nk_rawfb_fill_rect(rawfb, r->x, r->y, r->w, r->h,
-                (unsigned short)r->rounding, r->color);
-        } break;
-        case NK_COMMAND_CIRCLE: {
-            const struct nk_command_circle *c = (const struct nk_command_circle *)cmd;
-            nk_rawfb_stroke_circle(rawfb, c->x, c->y, c->w, c->h, c->line_thickness, c->color);
-        } break;
-        case NK_COMMAND_CIRCLE_FILLED: {
-            const struct nk_command_circle_filled *c = (const struct nk_command_circle_filled *)cmd;
-            nk_rawfb_fill_circle(rawfb, c->x, c->y, c->w, c->h, c->color);
-        } break;
-        case NK_COMMAND_TRIANGLE: {
-            const struct nk_command_triangle*t = (const struct nk_command_triangle*)cmd;
-            nk_rawfb_stroke_triangle(rawfb, t->a.x, t->a.y, t->b.x, t->b.y,
-                t->c.x, t->c.y, t->line_thickness, t->color);
-        } break;
-        case NK_COMMAND_TRIANGLE_FILLED: {
-            const struct nk_command_triangle_filled *t = (const struct nk_command_triangle_filled *)cmd;
-            nk_rawfb_fill_triangle(rawfb, t->a.x, t->a.y, t->b.x, t->b.y,
-                t->c.x, t->c.y, t->color);
-        } break;
-        case NK_COMMAND_POLYGON: {
-            const struct nk_command_polygon *p =(const struct nk_command_polygon*)cmd;
-            nk_rawfb_stroke_polygon(rawfb, p->points, p->point_count, p->line_thickness,p->color);
-        } break;
-        case NK_COMMAND_POLYGON_FILLED: {
-            const struct nk_command_polygon_filled *p = (const struct nk_command_polygon_filled *)cmd;
-            nk_rawfb_fill_polygon(rawfb, p->points, p->point_count, p->color);
-        } break;
-        case NK_COMMAND_POLYLINE: {
-            const struct nk_command_polyline *p = (const struct nk_command_polyline *)cmd;
-            nk_rawfb_stroke_polyline(rawfb, p->points, p->point_count, p->line_thickness, p->color);
-        } break;
-        case NK_COMMAND_TEXT: {
-            const struct nk_command_text *t = (const struct nk_command_text*)cmd;
-            nk_rawfb_draw_text(rawfb, t->font, nk_rect(t->x, t->y, t->w, t->h),
-                t->string, t->length, t->height, t->foreground);
-        } break;
-        case NK_COMMAND_CURVE: {
-            const struct nk_command_curve *q = (const struct nk_command_curve *)cmd;
-            nk_rawfb_stroke_curve(rawfb, q->begin, q->ctrl[0], q->ctrl[1],
-                q->end, 22, q->line_thickness, q->color);
-        } break;
-        case NK_COMMAND_RECT_MULTI_COLOR: {
-	    const struct nk_command_rect_multi_color *q = (const struct nk_command_rect_multi_color *)cmd;
-	    nk_rawfb_draw_rect_multi_color(rawfb, q->x, q->y, q->w, q->h, q->left, q->top, q->right, q->bottom);
-	} break;
-        case NK_COMMAND_IMAGE: {
-            const struct nk_command_image *q = (const struct nk_command_image *)cmd;
-            nk_rawfb_drawimage(rawfb, q->x, q->y, q->w, q->h, &q->img, &q->col);
-        } break;
-        case NK_COMMAND_ARC: {
-            assert(0 && "NK_COMMAND_ARC not implemented\n");
-        } break;
-        case NK_COMMAND_ARC_FILLED: {
-            assert(0 && "NK_COMMAND_ARC_FILLED not implemented\n");
-        } break;
-        default: break;
+        nk_rawfb_clear(&target, clear);
+
+    nk_foreach(cmd, &rawfb->ctx)
+        nk_rawfb_draw_command(&target, cmd);
+    nk_clear(&rawfb->ctx);
+}
+
+struct rawfb_tile_job {
+    struct rawfb_context *rawfb;
+    struct nk_color clear;
+    unsigned char enable_clear;
+    int tiles_x, tile_count;
+    int next;
+#ifdef NK_RAWFB_THREADS
+    pthread_mutex_t lock;
+#endif
+};
+
+static void
+nk_rawfb_render_tile(const struct rawfb_tile_job *job, const int tile)
+{
+    /* replays all commands binned into the tile clipped to the tile rect */
+    int i;
+    struct nk_rect area;
+    struct rawfb_target target;
+    struct rawfb_context *rawfb = job->rawfb;
+
+    target.fb = rawfb->fb;
+    target.font_tex = rawfb->font_tex;
+    target.aa = rawfb->aa;
+    target.filter = rawfb->filter;
+    target.dither = rawfb->dither;
+    target.glyphs = &rawfb->glyphs;
+    target.fill_glyphs = 0;
+    nk_rawfb_scissor(&target, (float)((tile % job->tiles_x) * NK_RAWFB_TILE_SIZE),
+        (float)((tile / job->tiles_x) * NK_RAWFB_TILE_SIZE),
+        NK_RAWFB_TILE_SIZE, NK_RAWFB_TILE_SIZE);
+    area = target.scissors;
+    if (job->enable_clear)
+        nk_rawfb_clear(&target, job->clear);
+
+    for (i = rawfb->tiles[tile]; i < rawfb->tiles[tile+1]; ++i) {
+        const struct rawfb_tile_item *item = &rawfb->items[rawfb->bins[i]];
+        target.scissors.x = MAX(item->scissors.x, area.x);
+        target.scissors.y = MAX(item->scissors.y, area.y);
+        target.scissors.w = MIN(item->scissors.w, area.w);
+        target.scissors.h = MIN(item->scissors.h, area.h);
+        nk_rawfb_draw_command(&target, item->cmd);
+    }
+}
+
+static int
+nk_rawfb_next_tile(struct rawfb_tile_job *job)
+{
+    int tile;
+#ifdef NK_RAWFB_THREADS
+    pthread_mutex_lock(&job->lock);
+#endif
+    tile = (job->next < job->tile_count) ? job->next++: -1;
+#ifdef NK_RAWFB_THREADS
+    pthread_mutex_unlock(&job->lock);
+#endif
+    return tile;
+}
+
+static void*
+nk_rawfb_tile_worker(void *arg)
+{
+    struct rawfb_tile_job *job = (struct rawfb_tile_job*)arg;
+    int tile;
+    while ((tile = nk_rawfb_next_tile(job)) >= 0)
+        nk_rawfb_render_tile(job, tile);
+    return NULL;
+}
+
+NK_API void
+nk_rawfb_render_tiled(struct rawfb_context *rawfb, const struct nk_color clear,
+    const unsigned char enable_clear, const int threads)
+{
+    int i, t, x, y, item_count = 0, bin_count = 0;
+    const struct nk_command *cmd;
+    struct rawfb_target target;
+    struct rawfb_tile_job job;
+#ifdef NK_RAWFB_THREADS
+    pthread_t workers[64];
+    int worker_count = 0;
+#endif
+
+    job.rawfb = rawfb;
+    job.clear = clear;
+    job.enable_clear = enable_clear;
+    job.tiles_x = (rawfb->fb.w + NK_RAWFB_TILE_SIZE - 1) / NK_RAWFB_TILE_SIZE;
+    job.tile_count = job.tiles_x * ((rawfb->fb.h + NK_RAWFB_TILE_SIZE - 1) / NK_RAWFB_TILE_SIZE);
+    job.next = 0;
+    if (!nk_rawfb_reserve((void**)&rawfb->tiles, &rawfb->tile_capacity,
+            job.tile_count + 1, sizeof(int))) {
+        nk_rawfb_render(rawfb, clear, enable_clear);
+        return;
+    }
+    memset(rawfb->tiles, 0, (size_t)(job.tile_count + 1) * sizeof(int));
+
+    /* collect drawing commands with their scissor rect and count the
+     * commands per tile. Glyphs are cached here since tiles can only read
+     * the glyph cache. */
+    target.fb = rawfb->fb;
+    target.font_tex = rawfb->font_tex;
+    target.aa = rawfb->aa;
+    target.filter = rawfb->filter;
+    target.dither = rawfb->dither;
+    target.glyphs = &rawfb->glyphs;
+    target.fill_glyphs = 1;
+    nk_rawfb_glyph_cache_trim(target.glyphs);
+    nk_rawfb_scissor(&target, 0, 0, rawfb->fb.w, rawfb->fb.h);
+    nk_foreach(cmd, &rawfb->ctx) {
+        struct nk_rect b;
+        if (cmd->type == NK_COMMAND_SCISSOR) {
+            nk_rawfb_draw_command(&target, cmd);
+            continue;
+        }
+        if (!nk_rawfb_command_bounds(cmd, &b)) continue;
+        b.x = MAX(b.x, target.scissors.x); b.y = MAX(b.y, target.scissors.y);
+        b.w = MIN(b.w, target.scissors.w); b.h = MIN(b.h, target.scissors.h);
+        if (b.x >= b.w || b.y >= b.h) continue;
+        if (cmd->type == NK_COMMAND_TEXT) {
+            const struct nk_command_text *text = (const struct nk_command_text*)cmd;
+            nk_rawfb_cache_text(&target, text->font, text->string, text->length, text->height);
+        }
+        if (!nk_rawfb_reserve((void**)&rawfb->items, &rawfb->item_capacity,
+                item_count + 1, sizeof(struct rawfb_tile_item))) {
+            nk_rawfb_render(rawfb, clear, enable_clear);
+            return;
+        }
+        rawfb->items[item_count].cmd = cmd;
+        rawfb->items[item_count].scissors = target.scissors;
+        item_count++;
+        for (y = (int)b.y / NK_RAWFB_TILE_SIZE; y <= ((int)ceil(b.h) - 1) / NK_RAWFB_TILE_SIZE; ++y)
+        for (x = (int)b.x / NK_RAWFB_TILE_SIZE; x <= ((int)ceil(b.w) - 1) / NK_RAWFB_TILE_SIZE; ++x) {
+            rawfb->tiles[y * job.tiles_x + x + 1]++;
+            bin_count++;
         }
-    } nk_clear((struct nk_context*)&rawfb->ctx);
+    }
+    if (!nk_rawfb_reserve((void**)&rawfb->bins, &rawfb->bin_capacity,
+            bin_count, sizeof(int))) {
+        nk_rawfb_render(rawfb, clear, enable_clear);
+        return;
+    }
+
+    /* turn counts into offsets and fill the bins in command order. Filling
+     * advances tiles[t] to the start of tile t+1 so shift them back after. */
+    for (t = 1; t <= job.tile_count; ++t)
+        rawfb->tiles[t] += rawfb->tiles[t-1];
+    for (i = 0; i < item_count; ++i) {
+        struct nk_rect b;
+        const struct rawfb_tile_item *item = &rawfb->items[i];
+        nk_rawfb_command_bounds(item->cmd, &b);
+        b.x = MAX(b.x, item->scissors.x); b.y = MAX(b.y, item->scissors.y);
+        b.w = MIN(b.w, item->scissors.w); b.h = MIN(b.h, item->scissors.h);
+        for (y = (int)b.y / NK_RAWFB_TILE_SIZE; y <= ((int)ceil(b.h) - 1) / NK_RAWFB_TILE_SIZE; ++y)
+        for (x = (int)b.x / NK_RAWFB_TILE_SIZE; x <= ((int)ceil(b.w) - 1) / NK_RAWFB_TILE_SIZE; ++x)
+            rawfb->bins[rawfb->tiles[y * job.tiles_x + x]++] = i;
+    }
+    for (t = job.tile_count; t > 0; --t)
+        rawfb->tiles[t] = rawfb->tiles[t-1];
+    rawfb->tiles[0] = 0;
+
+    /* the calling thread works on tiles as well */
+#ifdef NK_RAWFB_THREADS
+    pthread_mutex_init(&job.lock, NULL);
+    for (i = 1; i < MIN(threads, (int)(sizeof(workers)/sizeof(workers[0]))); ++i)
+        if (!pthread_create(&workers[worker_count], NULL, nk_rawfb_tile_worker, &job))
+            worker_count++;
+#else
+    NK_UNUSED(threads);
+#endif
+    nk_rawfb_tile_worker(&job);
+#ifdef NK_RAWFB_THREADS
+    for (i = 0; i < worker_count; ++i)
+        pthread_join(workers[i], NULL);
+    pthread_mutex_destroy(&job.lock);
+#endif
+    nk_clear(&rawfb->ctx);
+}
+
+#ifdef NK_INCLUDE_VERTEX_BUFFER_OUTPUT
+/*
+ * Vertex path
+ *
+ * nk_rawfb_render_vertices runs nk_convert like the GPU backends and fills
+ * the triangles with the OpenGL conventions: pixel centers at +0.5, eight
+ * bits of sub-pixel precision and the top-left rule, so shared edges are
+ * drawn once. Edge functions are evaluated exactly in doubles and solved
+ * per row for the covered run, which is then drawn by a span kernel that
+ * fits what varies across the triangle: solid color, gradient, glyph mask
+ * or textured pixels.
+ */
+struct rawfb_vertex {
+    float position[2];
+    float uv[2];
+    nk_byte col[4];
+};
+struct rawfb_edge_function {
+    /* E(px) = c + a * px on the current row, the run needs E >= bias */
+    double dx, dy, a, c;
+    int bias;
+};
+
+static int
+nk_rawfb_fixed_clamp(double v)
+{
+    /* 16.16 channel value rounded and kept inside 0..255 */
+    v = v * 65536.0 + 32768.0;
+    return (int)MIN(MAX(v, 0.0), 255.0 * 65536.0 + 65535.0);
 }
+
+static void
+nk_rawfb_channel_run(int *from, int *step, const double at, const double step_at, const int n)
+{
+    /* fixed point run whose first and last value are clamped */
+    const int last = nk_rawfb_fixed_clamp(at + step_at * (n - 1));
+    *from = nk_rawfb_fixed_clamp(at);
+    *step = (n > 1) ? (last - *from) / (n - 1): 0;
+}
+
+static void
+nk_rawfb_draw_triangle(const struct rawfb_target *target, const struct rawfb_image *tex,
+    const struct rawfb_vertex *v0, const struct rawfb_vertex *v1, const struct rawfb_vertex *v2)
+{
+    const struct rawfb_vertex *v[3];
+    struct rawfb_edge_function e[3];
+    double x[3], y[3], area, top, bottom, attr[6][3];
+    const int flat_color = !memcmp(v0->col, v1->col, 4) && !memcmp(v0->col, v2->col, 4);
+    const int flat_uv = v0->uv[0] == v1->uv[0] && v0->uv[0] == v2->uv[0] &&
+        v0->uv[1] == v1->uv[1] && v0->uv[1] == v2->uv[1];
+    const rawfb_pl pl = nk_rawfb_work_layout(target->fb.pl);
+    struct rawfb_span span;
+    int i, k, py, y0, y1, from[4], step[4];
+
+    v[0] = v0; v[1] = v1; v[2] = v2;
+    for (k = 0; k < 3; ++k) {
+        x[k] = floor(v[k]->position[0] * 256.0 + 0.5);
+        y[k] = floor(v[k]->position[1] * 256.0 + 0.5);
+    }
+    area = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+    if (area == 0) return;
+    if (area < 0) {
+        /* wind all triangles the same way */
+        double t;
+        v[1] = v2; v[2] = v1;
+        t = x[1]; x[1] = x[2]; x[2] = t;
+        t = y[1]; y[1] = y[2]; y[2] = t;
+        area = -area;
+    }
+    for (k = 0; k < 3; ++k) {
+        const int j = (k + 1) % 3;
+        e[k].dx = x[j] - x[k];
+        e[k].dy = y[j] - y[k];
+        e[k].a = -e[k].dy * 256.0;
+        e[k].bias = (e[k].dy < 0 || (e[k].dy == 0 && e[k].dx > 0)) ? 0: 1;
+    }
+    top = MIN(y[0], MIN(y[1], y[2]));
+    bottom = MAX(y[0], MAX(y[1], y[2]));
+    y0 = MAX((int)ceil((top - 128.0) / 256.0), (int)target->scissors.y);
+    y1 = MIN((int)ceil((bottom - 128.0) / 256.0), (int)target->scissors.h);
+    if (y0 >= y1) return;
+
+    /* r,g,b,a,u,v of every vertex, a flat texel is folded into the color */
+    for (k = 0; k < 3; ++k) {
+        struct nk_color c = nk_rgba(v[k]->col[0], v[k]->col[1], v[k]->col[2], v[k]->col[3]);
+        if (flat_uv) {
+            const struct nk_color t = nk_rawfb_img_getpixel(tex,
+                NK_CLAMP(0, (int)floor(v0->uv[0] * tex->w), tex->w - 1),
+                NK_CLAMP(0, (int)floor(v0->uv[1] * tex->h), tex->h - 1));
+            c.r = (nk_byte)((c.r * t.r + 127) / 255);
+            c.g = (nk_byte)((c.g * t.g + 127) / 255);
+            c.b = (nk_byte)((c.b * t.b + 127) / 255);
+            c.a = (nk_byte)((c.a * t.a + 127) / 255);
+        }
+        attr[0][k] = c.r; attr[1][k] = c.g; attr[2][k] = c.b; attr[3][k] = c.a;
+        attr[4][k] = v[k]->uv[0] * tex->w; attr[5][k] = v[k]->uv[1] * tex->h;
+    }
+    if (flat_color && !attr[3][0]) return;
+    if (flat_uv) span.op = flat_color ? RAWFB_SPAN_COLOR: RAWFB_SPAN_GRADIENT;
+    else if (flat_color && tex->format == NK_FONT_ATLAS_ALPHA8) span.op = RAWFB_SPAN_MASK;
+    else span.op = RAWFB_SPAN_PIXELS;
+    span.c = nk_rawfb_color2int(nk_rgba((nk_byte)attr[0][0], (nk_byte)attr[1][0],
+        (nk_byte)attr[2][0], (nk_byte)attr[3][0]), pl);
+    span.a = (unsigned int)attr[3][0];
+    span.from = from;
+    span.step = step;
+
+    for (py = y0; py < y1; ++py) {
+        const double cy = py * 256.0 + 128.0;
+        double lo = target->scissors.x, hi = target->scissors.w - 1, l1, l2, dl1, dl2;
+        int x0, n;
+        for (k = 0; k < 3; ++k) {
+            e[k].c = e[k].dx * (cy - y[k]) + e[k].dy * (x[k] - 128.0) - e[k].bias;
+            if (e[k].a > 0) lo = MAX(lo, ceil(-e[k].c / e[k].a));
+            else if (e[k].a < 0) hi = MIN(hi, floor(e[k].c / -e[k].a));
+            else if (e[k].c < 0) hi = lo - 1;
+        }
+        if (lo > hi) continue;
+        x0 = (int)lo;
+        n = (int)(hi - lo) + 1;
+        if (span.op == RAWFB_SPAN_COLOR) {
+            nk_rawfb_draw_span(target, x0, py, n, &span);
+            continue;
+        }
+
+        /* barycentric weights of vertex 1 and 2 at the first pixel */
+        l1 = (e[2].c + e[2].bias + e[2].a * lo) / area;
+        l2 = (e[0].c + e[0].bias + e[0].a * lo) / area;
+        dl1 = e[2].a / area;
+        dl2 = e[0].a / area;
+        if (span.op == RAWFB_SPAN_GRADIENT) {
+            for (k = 0; k < 4; ++k)
+                nk_rawfb_channel_run(&from[k], &step[k], attr[k][0] + l1 * (attr[k][1] - attr[k][0]) +
+                    l2 * (attr[k][2] - attr[k][0]), dl1 * (attr[k][1] - attr[k][0]) +
+                    dl2 * (attr[k][2] - attr[k][0]), n);
+            nk_rawfb_draw_span(target, x0, py, n, &span);
+            continue;
+        }
+
+        /* textured spans sample the nearest texel in 16.16 fixed point */
+        {unsigned int pixels[64];
+        unsigned char mask[64];
+        int uv[2], duv[2], c[4];
+        for (k = 0; k < 6; ++k) {
+            const double at = attr[k][0] + l1 * (attr[k][1] - attr[k][0]) + l2 * (attr[k][2] - attr[k][0]);
+            const double d = dl1 * (attr[k][1] - attr[k][0]) + dl2 * (attr[k][2] - attr[k][0]);
+            if (k < 4) nk_rawfb_channel_run(&from[k], &step[k], at, d, n);
+            else {
+                uv[k-4] = (int)floor(at * 65536.0);
+                duv[k-4] = (int)floor(d * 65536.0);
+            }
+        }
+        span.mask = mask;
+        span.src = pixels;
+        for (k = 0; k < 4; ++k)
+            c[k] = from[k];
+        for (i = 0; i < n; i += 64) {
+            const int count = MIN(n - i, 64);
+            int j;
+            for (j = 0; j < count; ++j) {
+                const int tx = NK_CLAMP(0, uv[0] >> 16, tex->w - 1);
+                const int ty = NK_CLAMP(0, uv[1] >> 16, tex->h - 1);
+                uv[0] += duv[0]; uv[1] += duv[1];
+                if (span.op == RAWFB_SPAN_MASK) {
+                    mask[j] = ((const unsigned char*)tex->pixels)[ty * tex->pitch + tx];
+                } else {
+                    struct nk_color t = nk_rawfb_img_getpixel(tex, tx, ty);
+                    t.r = (nk_byte)(((c[0] >> 16) * t.r + 127) / 255);
+                    t.g = (nk_byte)(((c[1] >> 16) * t.g + 127) / 255);
+                    t.b = (nk_byte)(((c[2] >> 16) * t.b + 127) / 255);
+                    t.a = (nk_byte)(((c[3] >> 16) * t.a + 127) / 255);
+                    pixels[j] = nk_rawfb_color2int(t, pl);
+                    for (k = 0; k < 4; ++k)
+                        c[k] += step[k];
+                }
+            }
+            nk_rawfb_draw_span(target, x0 + i, py, count, &span);
+        }}
+    }
+}
+
+NK_API void
+nk_rawfb_render_vertices(struct rawfb_context *rawfb, const struct nk_color clear,
+    const unsigned char enable_clear)
+{
+    static const struct nk_draw_vertex_layout_element vertex_layout[] = {
+        {NK_VERTEX_POSITION, NK_FORMAT_FLOAT, NK_OFFSETOF(struct rawfb_vertex, position)},
+        {NK_VERTEX_TEXCOORD, NK_FORMAT_FLOAT, NK_OFFSETOF(struct rawfb_vertex, uv)},
+        {NK_VERTEX_COLOR, NK_FORMAT_R8G8B8A8, NK_OFFSETOF(struct rawfb_vertex, col)},
+        {NK_VERTEX_LAYOUT_END}
+    };
+    const struct nk_draw_command *cmd;
+    const struct rawfb_vertex *vertices;
+    const nk_draw_index *offset;
+    struct nk_convert_config config;
+    struct rawfb_target target;
+    unsigned int i;
+
+    NK_MEMSET(&config, 0, sizeof(config));
+    config.vertex_layout = vertex_layout;
+    config.vertex_size = sizeof(struct rawfb_vertex);
+    config.vertex_alignment = NK_ALIGNOF(struct rawfb_vertex);
+    config.null = rawfb->null;
+    config.circle_segment_count = 22;
+    config.curve_segment_count = 22;
+    config.arc_segment_count = 22;
+    config.global_alpha = 1.0f;
+    config.shape_AA = rawfb->aa;
+    config.line_AA = rawfb->aa;
+    nk_buffer_clear(&rawfb->cmds);
+    nk_buffer_clear(&rawfb->vertices);
+    nk_buffer_clear(&rawfb->elements);
+    nk_convert(&rawfb->ctx, &rawfb->cmds, &rawfb->vertices, &rawfb->elements, &config);
+
+    target.fb = rawfb->fb;
+    target.font_tex = rawfb->font_tex;
+    target.aa = rawfb->aa;
+    target.filter = rawfb->filter;
+    target.dither = rawfb->dither;
+    target.glyphs = &rawfb->glyphs;
+    target.fill_glyphs = 0;
+    nk_rawfb_scissor(&target, 0, 0, rawfb->fb.w, rawfb->fb.h);
+    if (enable_clear)
+        nk_rawfb_clear(&target, clear);
+
+    vertices = (const struct rawfb_vertex*)nk_buffer_memory_const(&rawfb->vertices);
+    offset = (const nk_draw_index*)nk_buffer_memory_const(&rawfb->elements);
+    nk_draw_foreach(cmd, &rawfb->ctx, &rawfb->cmds) {
+        const struct rawfb_image *tex = cmd->texture.ptr ?
+            (const struct rawfb_image*)cmd->texture.ptr: &rawfb->font_tex;
+        if (!cmd->elem_count) continue;
+        nk_rawfb_scissor(&target, cmd->clip_rect.x, cmd->clip_rect.y,
+            cmd->clip_rect.w, cmd->clip_rect.h);
+        for (i = 0; i + 2 < cmd->elem_count; i += 3)
+            nk_rawfb_draw_triangle(&target, tex, &vertices[offset[i]],
+                &vertices[offset[i+1]], &vertices[offset[i+2]]);
+        offset += cmd->elem_count;
+    }
+    nk_clear(&rawfb->ctx);
+}
+#endif
+
 #endif
 
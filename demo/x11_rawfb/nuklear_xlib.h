@@ -57,6 +57,10 @@ NK_API void nk_xlib_shutdown(void);
 #include <sys/ipc.h>
 #include <sys/shm.h>
 
+#ifndef NK_XLIB_DAMAGE_TILE
+#define NK_XLIB_DAMAGE_TILE 64
+#endif
+
 static struct  {
     struct nk_context ctx;
     struct XSurface *surf;
@@ -67,6 +71,10 @@ static struct  {
     XShmSegmentInfo xsi;
     char fallback;
     GC gc;
+    /* last presented frame, only tiles that differ from it are sent */
+    char *shadow;
+    char *dirty;
+    int shadow_valid;
 } xlib;
 
 NK_API int
@@ -152,6 +160,9 @@ nk_xlib_init(Display *dpy, Visual *vis, int screen, Window root,
 	return 0;
     }
 
+    xlib.shadow = malloc((size_t)(h * xlib.ximg->bytes_per_line));
+    xlib.dirty = malloc(w / NK_XLIB_DAMAGE_TILE + 1);
+    xlib.shadow_valid = 0;
     return 1;
 }
 
@@ -287,17 +298,71 @@ nk_xlib_shutdown(void)
         XDestroyImage(xlib.ximg);
         shmdt(xlib.xsi.shmaddr);
         shmctl(xlib.xsi.shmid, IPC_RMID, NULL);
-    } NK_MEMSET(&xlib, 0, sizeof(xlib));
+    }
+    free(xlib.shadow);
+    free(xlib.dirty);
+    NK_MEMSET(&xlib, 0, sizeof(xlib));
+}
+
+static void
+nk_xlib_put(Drawable screen, int x, int y, int w, int h)
+{
+    if (w <= 0 || h <= 0) return;
+    if (xlib.fallback)
+        XPutImage(xlib.dpy, screen, xlib.gc, xlib.ximg, x, y, x, y, w, h);
+    else XShmPutImage(xlib.dpy, screen, xlib.gc, xlib.ximg, x, y, x, y, w, h, False);
 }
 
 NK_API void
 nk_xlib_render(Drawable screen)
 {
-    if (xlib.fallback)
-        XPutImage(xlib.dpy, screen, xlib.gc, xlib.ximg,
-            0, 0, 0, 0, xlib.ximg->width, xlib.ximg->height);
-    else XShmPutImage(xlib.dpy, screen, xlib.gc, xlib.ximg,
-            0, 0, 0, 0, xlib.ximg->width, xlib.ximg->height, False);
+    /* Compares the frame with the last one in NK_XLIB_DAMAGE_TILE sized tiles
+     * and sends each run of changed tiles in a tile row as one image. Runs
+     * spanning the same columns in consecutive tile rows are merged. */
+    const int tile = NK_XLIB_DAMAGE_TILE;
+    const int w = xlib.ximg->width, h = xlib.ximg->height;
+    const int pitch = xlib.ximg->bytes_per_line;
+    const int bpp = xlib.ximg->bits_per_pixel / 8;
+    const int columns = (w + tile - 1) / tile;
+    int x0 = 0, x1 = 0, y0 = 0, y1 = 0;
+    int i, j, y;
+
+    if (!xlib.shadow || !xlib.dirty || !xlib.shadow_valid) {
+        nk_xlib_put(screen, 0, 0, w, h);
+        if (xlib.shadow && xlib.dirty) {
+            memcpy(xlib.shadow, xlib.ximg->data, (size_t)(h * pitch));
+            xlib.shadow_valid = 1;
+        }
+        return;
+    }
+    for (y = 0; y < h; y += tile) {
+        const int rows = NK_MIN(tile, h - y);
+        memset(xlib.dirty, 0, (size_t)columns);
+        for (j = y; j < y + rows; ++j) {
+            const char *a = xlib.ximg->data + j * pitch, *b = xlib.shadow + j * pitch;
+            for (i = 0; i < columns; ++i) {
+                const int n = NK_MIN(tile, w - i * tile) * bpp;
+                if (!xlib.dirty[i] && memcmp(a + i * tile * bpp, b + i * tile * bpp, (size_t)n))
+                    xlib.dirty[i] = 1;
+            }
+        }
+        for (i = 0; i < columns; i = j) {
+            int l, r;
+            if (!xlib.dirty[i]) {j = i + 1; continue;}
+            for (j = i; j < columns && xlib.dirty[j]; ++j);
+            l = i * tile; r = NK_MIN(j * tile, w);
+            if (l == x0 && r == x1 && y == y1) {
+                y1 = y + rows;
+            } else {
+                nk_xlib_put(screen, x0, y0, x1 - x0, y1 - y0);
+                x0 = l; x1 = r; y0 = y; y1 = y + rows;
+            }
+            for (l = y; l < y + rows; ++l)
+                memcpy(xlib.shadow + l * pitch + i * tile * bpp,
+                    xlib.ximg->data + l * pitch + i * tile * bpp, (size_t)((r - i * tile) * bpp));
+        }
+    }
+    nk_xlib_put(screen, x0, y0, x1 - x0, y1 - y0);
 }
 #endif
 
@@ -78,6 +78,14 @@ NK_API void                 nk_xfont_del(Display *dpy, XFont *font);
 #ifndef NK_X11_DOUBLE_CLICK_HI
 #define NK_X11_DOUBLE_CLICK_HI 200
 #endif
+#ifdef NK_XLIB_USE_XFT
+#ifndef NK_XLIB_MAX_GLYPHS
+#define NK_XLIB_MAX_GLYPHS 512
+#endif
+#ifndef NK_XLIB_COLOR_CACHE
+#define NK_XLIB_COLOR_CACHE 32
+#endif
+#endif
 
 typedef struct XSurface XSurface;
 typedef struct XImageWithAlpha XImageWithAlpha;
@@ -100,8 +108,15 @@ struct XSurface {
     Window root;
     Drawable drawable;
     unsigned int w, h;
+    XRectangle clip;
+    int clip_valid;
 #ifdef NK_XLIB_USE_XFT
     XftDraw * ftdraw;
+    XftGlyphFontSpec glyphs[NK_XLIB_MAX_GLYPHS];
+    int glyph_count;
+    unsigned int glyph_key;
+    XftColor glyph_color;
+    int glyph_x0, glyph_y0, glyph_x1, glyph_y1;
 #endif
 };
 struct XImageWithAlpha {
@@ -109,6 +124,13 @@ struct XImageWithAlpha {
     GC clipMaskGC;
     Pixmap clipMask;
 };
+#ifdef NK_XLIB_USE_XFT
+struct XColorCacheEntry {
+    unsigned int key;
+    unsigned long used;
+    XftColor color;
+};
+#endif
 static struct  {
     char *clipboard_data;
     int clipboard_len;
@@ -127,6 +149,9 @@ static struct  {
 #ifdef NK_XLIB_USE_XFT
     Visual *vis;
     Colormap cmap;
+    struct XColorCacheEntry colors[NK_XLIB_COLOR_CACHE];
+    int color_count;
+    unsigned long color_clock;
 #endif
     long last_button_click;
 } xlib;
@@ -184,6 +209,62 @@ nk_xsurf_resize(XSurface *surf, unsigned int w, unsigned int h)
 	return;
 }
 
+#ifdef NK_XLIB_USE_XFT
+NK_INTERN unsigned int
+nk_xft_color_key(struct nk_color col)
+{
+    return ((unsigned int)col.r << 24) | ((unsigned int)col.g << 16) |
+        ((unsigned int)col.b << 8) | (unsigned int)col.a;
+}
+
+NK_INTERN XftColor*
+nk_xft_color(struct nk_color col)
+{
+    /* a frame only uses a handful of text colors so allocations are kept
+     * around and the least recently used one is released on overflow */
+    unsigned int key = nk_xft_color_key(col);
+    struct XColorCacheEntry *e, *lru = 0;
+    XRenderColor xrc;
+    int i;
+    for (i = 0; i < xlib.color_count; ++i) {
+        e = &xlib.colors[i];
+        if (e->key == key) {
+            e->used = ++xlib.color_clock;
+            return &e->color;
+        }
+        if (!lru || e->used < lru->used) lru = e;
+    }
+    if (xlib.color_count < NK_XLIB_COLOR_CACHE)
+        e = &xlib.colors[xlib.color_count++];
+    else {
+        e = lru;
+        XftColorFree(xlib.dpy, xlib.vis, xlib.cmap, &e->color);
+    }
+    xrc.red = col.r * 257;
+    xrc.green = col.g * 257;
+    xrc.blue = col.b * 257;
+    xrc.alpha = col.a * 257;
+    if (!XftColorAllocValue(xlib.dpy, xlib.vis, xlib.cmap, &xrc, &e->color)) {
+        *e = xlib.colors[--xlib.color_count];
+        return 0;
+    }
+    e->key = key;
+    e->used = ++xlib.color_clock;
+    return &e->color;
+}
+#endif
+
+NK_INTERN void
+nk_xsurf_flush(XSurface *surf)
+{
+#ifdef NK_XLIB_USE_XFT
+    if (!surf->glyph_count) return;
+    XftDrawGlyphFontSpec(surf->ftdraw, &surf->glyph_color, surf->glyphs, surf->glyph_count);
+    surf->glyph_count = 0;
+#endif
+    (void)surf;
+}
+
 NK_INTERN void
 nk_xsurf_scissor(XSurface *surf, float x, float y, float w, float h)
 {
@@ -192,6 +273,12 @@ nk_xsurf_scissor(XSurface *surf, float x, float y, float w, float h)
     clip_rect.y = (short)(y-1);
     clip_rect.width = (unsigned short)(w+2);
     clip_rect.height = (unsigned short)(h+2);
+    if (surf->clip_valid && surf->clip.x == clip_rect.x && surf->clip.y == clip_rect.y &&
+        surf->clip.width == clip_rect.width && surf->clip.height == clip_rect.height)
+        return;
+    nk_xsurf_flush(surf);
+    surf->clip = clip_rect;
+    surf->clip_valid = 1;
     XSetClipRectangles(surf->dpy, surf->gc, 0, 0, &clip_rect, 1, Unsorted);
 
 #ifdef NK_XLIB_USE_XFT
@@ -423,7 +510,17 @@ nk_xsurf_draw_text(XSurface *surf, short x, short y, unsigned short w, unsigned
     int tx, ty;
     unsigned long bg = nk_color_from_byte(&cbg.r);
     unsigned long fg = nk_color_from_byte(&cfg.r);
-
+#ifdef NK_XLIB_USE_XFT
+    XftColor *color;
+    unsigned int key;
+
+    /* glyphs of earlier text are still queued so they have to land before
+     * a background that would cover them */
+    if (surf->glyph_count && x < surf->glyph_x1 && x + w > surf->glyph_x0 &&
+        y < surf->glyph_y1 && y + h > surf->glyph_y0)
+        nk_xsurf_flush(surf);
+    (void)fg;
+#endif
     XSetForeground(surf->dpy, surf->gc, bg);
     XFillRectangle(surf->dpy, surf->drawable, surf->gc, (int)x, (int)y, (unsigned)w, (unsigned)h);
     if(!text || !font || !len) return;
@@ -431,15 +528,40 @@ nk_xsurf_draw_text(XSurface *surf, short x, short y, unsigned short w, unsigned
     tx = (int)x;
     ty = (int)y + font->ascent;
 #ifdef NK_XLIB_USE_XFT
-    XRenderColor xrc;
-    XftColor color;
-    xrc.red = cfg.r * 257;
-    xrc.green = cfg.g * 257;
-    xrc.blue = cfg.b * 257;
-    xrc.alpha = cfg.a * 257;
-    XftColorAllocValue(surf->dpy, xlib.vis, xlib.cmap, &xrc, &color);
-    XftDrawStringUtf8(surf->ftdraw, &color, font->ft, tx, ty, (FcChar8*)text, len);
-	XftColorFree(surf->dpy, xlib.vis, xlib.cmap, &color);
+    /* consecutive text in the same color is sent as one glyph spec list */
+    key = nk_xft_color_key(cfg);
+    if (surf->glyph_count && surf->glyph_key != key)
+        nk_xsurf_flush(surf);
+    if (!(color = nk_xft_color(cfg))) return;
+    if (!surf->glyph_count) {
+        surf->glyph_x0 = surf->glyph_x1 = (int)x;
+        surf->glyph_y0 = surf->glyph_y1 = (int)y;
+    }
+    surf->glyph_key = key;
+    surf->glyph_color = *color;
+    surf->glyph_x0 = NK_MIN(surf->glyph_x0, (int)x);
+    surf->glyph_y0 = NK_MIN(surf->glyph_y0, (int)y);
+    surf->glyph_y1 = NK_MAX(surf->glyph_y1, (int)y + (int)h);
+    while (len > 0) {
+        XftGlyphFontSpec *spec;
+        XGlyphInfo info;
+        FT_UInt glyph;
+        nk_rune rune;
+        int n = nk_utf_decode(text, &rune, len);
+        if (!n || rune == NK_UTF_INVALID) break;
+        text += n; len -= n;
+        if (surf->glyph_count == NK_XLIB_MAX_GLYPHS)
+            nk_xsurf_flush(surf);
+        glyph = XftCharIndex(surf->dpy, font->ft, (FcChar32)rune);
+        spec = &surf->glyphs[surf->glyph_count++];
+        spec->font = font->ft;
+        spec->glyph = glyph;
+        spec->x = (short)tx;
+        spec->y = (short)ty;
+        XftGlyphExtents(surf->dpy, font->ft, &glyph, 1, &info);
+        tx += info.xOff;
+    }
+    surf->glyph_x1 = NK_MAX(surf->glyph_x1, NK_MAX((int)x + (int)w, tx));
 #else
     XSetForeground(surf->dpy, surf->gc, fg);
     if(font->set) XmbDrawString(surf->dpy,surf->drawable, font->set, surf->gc, tx, ty, (const char*)text, (int)len);
@@ -548,6 +670,7 @@ nk_xsurf_draw_image(XSurface *surf, short x, short y, unsigned short w, unsigned
         }
         XPutImage(surf->dpy, surf->drawable, surf->gc, aimage->ximage, 0, 0, x, y, w, h);
         XSetClipMask(surf->dpy, surf->gc, None);
+        surf->clip_valid = 0;
     }
 }
 
@@ -939,6 +1062,11 @@ nk_xlib_handle_event(Display *dpy, int screen, Window win, XEvent *evt)
 NK_API void
 nk_xlib_shutdown(void)
 {
+#ifdef NK_XLIB_USE_XFT
+    int i;
+    for (i = 0; i < xlib.color_count; ++i)
+        XftColorFree(xlib.dpy, xlib.vis, xlib.cmap, &xlib.colors[i].color);
+#endif
     nk_xsurf_del(xlib.surf);
     nk_free(&xlib.ctx);
     XFreeCursor(xlib.dpy, xlib.cursor);
@@ -955,6 +1083,9 @@ nk_xlib_render(Drawable screen, struct nk_color clear)
     nk_xsurf_clear(xlib.surf, nk_color_from_byte(&clear.r));
     nk_foreach(cmd, &xlib.ctx)
     {
+        /* queued glyphs have to be drawn before anything that is not text */
+        if (cmd->type != NK_COMMAND_TEXT && cmd->type != NK_COMMAND_SCISSOR)
+            nk_xsurf_flush(surf);
         switch (cmd->type) {
         case NK_COMMAND_NOP: break;
         case NK_COMMAND_SCISSOR: {
@@ -1030,6 +1161,7 @@ nk_xlib_render(Drawable screen, struct nk_color clear)
         default: break;
         }
     }
+    nk_xsurf_flush(surf);
     nk_clear(ctx);
     nk_xsurf_blit(screen, surf, surf->w, surf->h);
 }
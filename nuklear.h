@@ -144,7 +144,7 @@
 /// ------------|---------------------------------------------------------------
 /// NK_ASSERT   | If you don't define this, nuklear will use <assert.h> with assert().
 /// NK_MEMSET   | You can define this to 'memset' or your own memset implementation replacement. If not nuklear will use its own version.
-/// NK_MEMCPY   | You can define this to 'memcpy' or your own memcpy implementation replacement. If not nuklear will use its own version.
+/// NK_MEMCPY   | You can define this to 'memmove' or your own memmove implementation replacement. If not nuklear will use its own version. String edits move overlapping ranges with it, so a plain 'memcpy' is not enough.
 /// NK_SQRT     | You can define this to 'sqrt' or your own sqrt implementation replacement. If not nuklear will use its own slow and not highly accurate version.
 /// NK_SIN      | You can define this to 'sinf' or your own sine implementation replacement. If not nuklear will use its own approximation implementation.
 /// NK_COS      | You can define this to 'cosf' or your own cosine implementation replacement. If not nuklear will use its own approximation implementation.
@@ -438,6 +438,7 @@ struct nk_draw_list;
 struct nk_user_font;
 struct nk_panel;
 struct nk_context;
+struct nk_replay;
 struct nk_draw_vertex_layout_element;
 struct nk_style_button;
 struct nk_style_toggle;
@@ -474,6 +475,7 @@ enum nk_collapse_states {NK_MINIMIZED = nk_false, NK_MAXIMIZED = nk_true};
 enum nk_show_states     {NK_HIDDEN = nk_false, NK_SHOWN = nk_true};
 enum nk_chart_type      {NK_CHART_LINES, NK_CHART_COLUMN, NK_CHART_MAX};
 enum nk_chart_event     {NK_CHART_HOVERING = 0x01, NK_CHART_CLICKED = 0x02};
+enum nk_chart_sampling  {NK_CHART_SAMPLE_MINMAX, NK_CHART_SAMPLE_LTTB};
 enum nk_color_format    {NK_RGB, NK_RGBA};
 enum nk_popup_type      {NK_POPUP_STATIC, NK_POPUP_DYNAMIC};
 enum nk_layout_format   {NK_DYNAMIC, NK_STATIC};
@@ -666,6 +668,71 @@ NK_API void nk_free(struct nk_context*);
 */
 NK_API void nk_set_user_data(struct nk_context*, nk_handle handle);
 #endif
+/*/// #### nk_needs_redraw
+/// Returns whether another frame has to be built right away or if the
+/// application can block until the next input event or the deadline
+/// returned by `nk_redraw_deadline`. Has to be called after `nk_clear`.
+/// A frame is needed after clicks, key or text input, scrolling, while a
+/// mouse button is held down and while the drawn output still changes.
+/// Mouse motion only counts if it changed the output, for example by
+/// hovering a widget. Tracking starts with the first call, which always
+/// returns `true(1)`.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// int nk_needs_redraw(struct nk_context *ctx);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to a previously initialized `nk_context` struct
+///
+/// Returns `true(1)` if the next frame should not wait for input
+*/
+NK_API int nk_needs_redraw(struct nk_context*);
+/*/// #### nk_redraw_deadline
+/// Returns the number of seconds the application can wait for input before
+/// the next frame has to be built anyway, for example to hide scrollbars
+/// after `NK_SCROLLBAR_HIDING_TIMEOUT`. Returns 0 if a frame is needed now
+/// and a negative value if there is no deadline.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// float nk_redraw_deadline(const struct nk_context *ctx);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to a previously initialized `nk_context` struct
+*/
+NK_API float nk_redraw_deadline(const struct nk_context*);
+/*/// #### nk_request_redraw
+/// Requests a frame at the latest after the given number of seconds, for
+/// example for animations or blinking cursors. Only the earliest request
+/// made while building a frame is kept.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// void nk_request_redraw(struct nk_context *ctx, float seconds);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to a previously initialized `nk_context` struct
+/// __seconds__ | Time from the end of the current frame, 0 for the next frame
+*/
+NK_API void nk_request_redraw(struct nk_context*, float seconds);
+/*/// #### nk_frame_hash
+/// Hashes all draw commands of the current frame in drawing order. Fonts,
+/// image handles and custom callbacks are left out so the hash of a frame
+/// is the same between runs of a program. Has to be called before `nk_clear`.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// nk_hash nk_frame_hash(struct nk_context *ctx);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to a previously initialized `nk_context` struct
+*/
+NK_API nk_hash nk_frame_hash(struct nk_context*);
 /* =============================================================================
  *
  *                                  INPUT
@@ -910,6 +977,105 @@ NK_API void nk_input_unicode(struct nk_context*, nk_rune);
 /// __ctx__     | Must point to a previously initialized `nk_context` struct
 */
 NK_API void nk_input_end(struct nk_context*);
+/*/// #### nk_record_begin
+/// Starts recording all following `nk_input_xxx` calls together with frame
+/// boundaries into a buffer. Each cleared frame additionally stores the
+/// `nk_frame_hash` of its draw commands so a replay can verify them.
+/// Input written directly into `nk_context::input` is not recorded, except for
+/// the mouse position at the end of each frame, which backends overwrite to
+/// hold the cursor in place while the mouse is grabbed.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// int nk_record_begin(struct nk_context *ctx, struct nk_buffer *out);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to a previously initialized `nk_context` struct
+/// __out__     | Must point to an initialized buffer that the recording is appended to
+///
+/// Returns `false(0)` if the context is already recording
+*/
+NK_API int nk_record_begin(struct nk_context*, struct nk_buffer *out);
+/*/// #### nk_record_end
+/// Stops recording. The buffer passed to `nk_record_begin` holds the recording.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// void nk_record_end(struct nk_context *ctx);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to a previously initialized `nk_context` struct
+*/
+NK_API void nk_record_end(struct nk_context*);
+/*/// #### nk_record_resize
+/// Records the size of the surface the UI is drawn to. Has to be called
+/// between `nk_input_begin` and `nk_input_end` once after `nk_record_begin`
+/// and whenever the size changes, since window layouts depend on it.
+/// Does nothing if the context is not recording.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// void nk_record_resize(struct nk_context *ctx, int width, int height);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to a previously initialized `nk_context` struct
+/// __width__   | Width of the surface in pixels
+/// __height__  | Height of the surface in pixels
+*/
+NK_API void nk_record_resize(struct nk_context*, int width, int height);
+/*/// #### nk_replay_init
+/// Prepares the replay of a recording made with `nk_record_begin`.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// int nk_replay_init(struct nk_replay *replay, const void *memory, nk_size size);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __replay__  | Replay state to initialize
+/// __memory__  | Recording which has to stay valid for the whole replay
+/// __size__    | Size of the recording in bytes
+///
+/// Returns `false(0)` if the memory does not hold a recording
+*/
+NK_API int nk_replay_init(struct nk_replay*, const void *memory, nk_size size);
+/*/// #### nk_replay_frame
+/// Replays the input of the next recorded frame. Replaces the
+/// `nk_input_begin`/`nk_input_end` block of a frame. If the frame recorded a
+/// new surface size `nk_replay::resized` is set and `nk_replay::width` and
+/// `nk_replay::height` hold the size the frame has to be drawn at.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// int nk_replay_frame(struct nk_context *ctx, struct nk_replay *replay);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to a previously initialized `nk_context` struct
+/// __replay__  | Replay state initialized by `nk_replay_init`
+///
+/// Returns `false(0)` if the recording ended or is broken
+*/
+NK_API int nk_replay_frame(struct nk_context*, struct nk_replay*);
+/*/// #### nk_replay_check
+/// Compares the draw commands of the current frame against the recorded
+/// frame. Has to be called after the UI was built and before `nk_clear`.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// int nk_replay_check(struct nk_context *ctx, const struct nk_replay *replay);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to a previously initialized `nk_context` struct
+/// __replay__  | Replay state after `nk_replay_frame`
+///
+/// Returns `true(1)` if both frames have the same hash or no hash was recorded
+*/
+NK_API int nk_replay_check(struct nk_context*, const struct nk_replay*);
 /* =============================================================================
  *
  *                                  DRAWING
@@ -2645,6 +2811,8 @@ NK_API struct nk_rect nk_layout_space_rect_to_local(struct nk_context*, struct n
 /// nk_group_scrolled_end           | Ends a group with manual scrollbar handling. Should only be called if nk_group_begin returned non-zero
 /// nk_group_get_scroll             | Gets the scroll offset for the given group
 /// nk_group_set_scroll             | Sets the scroll offset for the given group
+/// nk_group_begin_lazy             | Start a new group which only has to be filled if visible and remembers its content height
+/// nk_group_get_content_height     | Gets the content height of a lazy group from the last time it was filled
 */
 /*/// #### nk_group_begin
 /// Starts a new widget group. Requires a previous layouting function to specify a pos/size.
@@ -2762,6 +2930,48 @@ NK_API void nk_group_get_scroll(struct nk_context*, const char *id, nk_uint *x_o
 /// __y_offset__ | The y offset to scroll to
 */
 NK_API void nk_group_set_scroll(struct nk_context*, const char *id, nk_uint x_offset, nk_uint y_offset);
+/*/// #### nk_group_begin_lazy
+/// Starts a new widget group like `nk_group_begin` but only returns `true(1)` if
+/// the group actually has to be filled with widgets. Groups outside the parent
+/// clipping rectangle as well as minimized or closed groups return `false(0)`
+/// and must neither be filled nor ended. The height the group needs to show
+/// all its widgets without scrolling is measured in `nk_group_end` and kept
+/// until the group is filled the next time, so long lists of groups can be
+/// laid out with correct heights while only the visible ones are filled.
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// float height = nk_group_get_content_height(ctx, "stats");
+/// nk_layout_row_dynamic(ctx, height > 0 ? height: 200, 1);
+/// if (nk_group_begin_lazy(ctx, "stats", NK_WINDOW_NO_SCROLLBAR, 0)) {
+///     // [... widgets ...]
+///     nk_group_end(ctx);
+/// }
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter           | Description
+/// --------------------|-----------------------------------------------------------
+/// __ctx__             | Must point to an previously initialized `nk_context` struct
+/// __title__           | Must be an unique identifier for this group that is also used for the group header
+/// __flags__           | Window flags defined in the nk_panel_flags section with a number of different group behaviors
+/// __content_height__  | Optional pointer receiving the cached content height or 0 if the group was never filled
+///
+/// Returns `true(1)` if visible and fillable with widgets or `false(0)` otherwise
+*/
+NK_API int nk_group_begin_lazy(struct nk_context*, const char *title, nk_flags, float *content_height);
+/*/// #### nk_group_get_content_height
+/// Gets the height a group started with `nk_group_begin_lazy` needed to show
+/// all its widgets the last time it was filled.
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// float nk_group_get_content_height(struct nk_context*, const char *id);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter    | Description
+/// -------------|-----------------------------------------------------------
+/// __ctx__      | Must point to an previously initialized `nk_context` struct
+/// __id__       | The id of the group
+///
+/// Returns the group height including header and borders or 0 if unknown
+*/
+NK_API float nk_group_get_content_height(struct nk_context*, const char *id);
 /* =============================================================================
  *
  *                                  TREE
@@ -3022,6 +3232,26 @@ NK_API void nk_tree_element_pop(struct nk_context*);
  *                                  LIST VIEW
  *
  * ============================================================================= */
+/*  List views only lay out and draw the rows inside the visible area. Rows
+ *  either all share the same height passed to `nk_list_view_begin` or have
+ *  individual heights kept in a `nk_row_heights` cache which is passed to
+ *  `nk_list_view_begin_variable`. The cache stores prefix sums of all row
+ *  heights in a Fenwick tree so mapping the scroll offset to the first visible
+ *  row, as well as changing the height of a single row, takes O(log n) time.
+ *  Row heights are either filled in by `nk_row_heights_build` from a callback
+ *  or set one by one with `nk_row_heights_set`. Each visible row still has to
+ *  be laid out with its own height:
+ *
+ *      nk_row_heights_build(&heights, count, message_height, nk_handle_ptr(log));
+ *      ...
+ *      if (nk_list_view_begin_variable(ctx, &view, "log", 0, &heights)) {
+ *          for (i = view.begin; i < view.end; ++i) {
+ *              nk_layout_row_dynamic(ctx, (float)nk_row_heights_get(&heights, i), 1);
+ *              nk_label_wrap(ctx, messages[i]);
+ *          }
+ *          nk_list_view_end(&view);
+ *      }
+ */
 struct nk_list_view {
 /* public: */
     int begin, end, count;
@@ -3031,8 +3261,203 @@ struct nk_list_view {
     nk_uint *scroll_pointer;
     nk_uint scroll_value;
 };
+typedef int(*nk_plugin_row_height)(nk_handle, int row);
+struct nk_row_heights {
+    struct nk_allocator pool;
+    int *tree;
+    int count;
+    int capacity;
+};
 NK_API int nk_list_view_begin(struct nk_context*, struct nk_list_view *out, const char *id, nk_flags, int row_height, int row_count);
+NK_API int nk_list_view_begin_variable(struct nk_context*, struct nk_list_view *out, const char *id, nk_flags, const struct nk_row_heights*);
 NK_API void nk_list_view_end(struct nk_list_view*);
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+NK_API void nk_row_heights_init_default(struct nk_row_heights*);
+#endif
+NK_API void nk_row_heights_init(struct nk_row_heights*, const struct nk_allocator*);
+NK_API void nk_row_heights_free(struct nk_row_heights*);
+NK_API int nk_row_heights_build(struct nk_row_heights*, int count, nk_plugin_row_height, nk_handle);
+NK_API int nk_row_heights_resize(struct nk_row_heights*, int count, int height);
+NK_API void nk_row_heights_set(struct nk_row_heights*, int row, int height);
+NK_API int nk_row_heights_get(const struct nk_row_heights*, int row);
+NK_API int nk_row_heights_offset(const struct nk_row_heights*, int row);
+NK_API int nk_row_heights_find(const struct nk_row_heights*, int offset);
+/* =============================================================================
+ *
+ *                                  TEXT VIEW
+ *
+ * =============================================================================
+ *  Read-only viewer for texts that are too big to be copied into a string,
+ *  like log files or memory mapped dumps. The text is either a plain memory
+ *  block (for example the result of `mmap`) or is pulled on demand through a
+ *  `nk_plugin_read` callback, which is asked to fill `dst` with up to `len`
+ *  bytes starting at `offset` and returns the number of bytes written.
+ *
+ *  Only the lines inside the visible area are read and drawn. To find them
+ *  the view keeps a sparse line index which is built incrementally: every call
+ *  to `nk_text_view` scans at most `NK_TEXT_VIEW_INDEX_BUDGET` new bytes and
+ *  applications can call `nk_text_view_index` with a bigger budget between
+ *  frames to finish it faster. Until the scan is done the scrollbar only
+ *  covers the lines found so far. Growing sources like log files that are
+ *  still written to can announce their new size with `nk_text_view_set_size`.
+ *
+ *  Lines are selected by clicking and dragging and the selection is copied
+ *  to the clipboard on `NK_KEY_COPY` as long as the last click went into the
+ *  view. `nk_text_view_selection` returns the selected byte range for
+ *  applications that want to stream huge selections themselves. Lines longer
+ *  than `NK_TEXT_VIEW_BUFFER_SIZE` bytes are cut off.
+ *
+ *      struct nk_text_view view;
+ *      void *data = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+ *      nk_text_view_init_memory_default(&view, data, size);
+ *      ...
+ *      if (nk_begin(ctx, "Log", bounds, 0)) {
+ *          nk_layout_row_dynamic(ctx, 400, 1);
+ *          nk_text_view(ctx, &view, "log", NK_WINDOW_BORDER);
+ *      }
+ *      nk_end(ctx);
+ *      ...
+ *      nk_text_view_free(&view);
+ *      munmap(data, size);
+ */
+#ifndef NK_TEXT_VIEW_BUFFER_SIZE
+#define NK_TEXT_VIEW_BUFFER_SIZE 1024
+#endif
+
+typedef nk_size(*nk_plugin_read)(nk_handle, nk_size offset, char *dst, nk_size len);
+struct nk_text_view {
+/* public: */
+    nk_size size;
+    nk_size select_start;
+    nk_size select_end;
+/* private: */
+    const char *memory;
+    nk_plugin_read read;
+    nk_handle userdata;
+    struct nk_allocator pool;
+    nk_size *lines;
+    int line_capacity;
+    int line_count;
+    nk_size last_line;
+    nk_size indexed;
+    unsigned char selecting;
+    unsigned char active;
+    char buffer[NK_TEXT_VIEW_BUFFER_SIZE];
+};
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+NK_API void nk_text_view_init_default(struct nk_text_view*, nk_plugin_read, nk_handle, nk_size size);
+NK_API void nk_text_view_init_memory_default(struct nk_text_view*, const char *memory, nk_size size);
+#endif
+NK_API void nk_text_view_init(struct nk_text_view*, const struct nk_allocator*, nk_plugin_read, nk_handle, nk_size size);
+NK_API void nk_text_view_init_memory(struct nk_text_view*, const struct nk_allocator*, const char *memory, nk_size size);
+NK_API void nk_text_view_set_size(struct nk_text_view*, nk_size size);
+NK_API int nk_text_view_index(struct nk_text_view*, nk_size max_bytes);
+NK_API int nk_text_view_line_count(const struct nk_text_view*);
+NK_API int nk_text_view_selection(const struct nk_text_view*, nk_size *begin, nk_size *end);
+NK_API int nk_text_view(struct nk_context*, struct nk_text_view*, const char *id, nk_flags);
+NK_API void nk_text_view_free(struct nk_text_view*);
+/* =============================================================================
+ *
+ *                                  GRID
+ *
+ * =============================================================================
+ *  Scrollable table of `rows` times `columns` cells which only visits the
+ *  cells inside the visible area. Instead of laying out widgets the grid calls
+ *  `draw` for every visible cell with the screen rectangle of the cell, so the
+ *  per-frame cost only depends on the size of the grid widget and not on the
+ *  number of rows.
+ *
+ *  The first `frozen_rows` rows and `frozen_columns` columns stay in place
+ *  while the rest of the grid scrolls underneath them, which is used for
+ *  header rows and key columns. Column widths are read from `column_widths`
+ *  every frame and dragging a column border inside the frozen rows resizes the
+ *  column by writing back into the array, but never below `min_column_width`.
+ *
+ *      static void draw_cell(nk_handle data, struct nk_command_buffer *out,
+ *          struct nk_rect cell, int row, int column)
+ *      {
+ *          const char *text = table_cell(data.ptr, row, column);
+ *          nk_draw_text(out, cell, text, (int)strlen(text), font, bg, fg);
+ *      }
+ *      ...
+ *      grid.rows = 100000; grid.columns = 50;
+ *      grid.frozen_rows = 1; grid.frozen_columns = 1;
+ *      grid.row_height = 20; grid.column_widths = widths;
+ *      grid.draw = draw_cell; grid.userdata = nk_handle_ptr(table);
+ *      ...
+ *      nk_layout_row_dynamic(ctx, 400, 1);
+ *      nk_grid(ctx, &grid, "table", NK_WINDOW_BORDER);
+ */
+typedef void(*nk_plugin_draw_cell)(nk_handle, struct nk_command_buffer*, struct nk_rect cell, int row, int column);
+struct nk_grid {
+/* public: */
+    int rows, columns;
+    int frozen_rows, frozen_columns;
+    float row_height;
+    float *column_widths;
+    float min_column_width;
+    nk_plugin_draw_cell draw;
+    nk_handle userdata;
+/* private: */
+    int resizing;
+};
+NK_API int nk_grid(struct nk_context*, struct nk_grid*, const char *id, nk_flags);
+/* =============================================================================
+ *
+ *                                  TREE VIEW
+ *
+ * =============================================================================
+ *  Tree widget for big hierarchies like file systems or scene graphs. Unlike
+ *  `nk_tree_push` the application does not submit nodes every frame. Instead
+ *  the tree view keeps the currently open part of the tree flattened into an
+ *  array of rows and only asks for the children of a node when it is opened:
+ *
+ *  `children(userdata, parent, nodes, max)` returns the number of children of
+ *  `parent` if `nodes` is NULL and otherwise writes up to `max` child handles
+ *  into `nodes` and returns how many were written. The children of the root
+ *  are requested with the handle passed to `nk_tree_view_init`.
+ *  `label(userdata, node, &len)` returns the text shown for a node.
+ *
+ *  Like list views only the rows inside the visible area are laid out and
+ *  drawn and callbacks are only called for those rows, so the cost per frame
+ *  does not depend on the number of open nodes. Opening and closing a node
+ *  moves the rows behind it, which is linear in the number of open rows.
+ *  `selected` holds the row of the last clicked node or -1. After the
+ *  application data changed `nk_tree_view_reset` closes all nodes and
+ *  enumerates the root again.
+ */
+typedef int(*nk_plugin_tree_children)(nk_handle, nk_handle parent, nk_handle *nodes, int max);
+typedef const char*(*nk_plugin_tree_label)(nk_handle, nk_handle node, int *len);
+struct nk_tree_view_row {
+    int depth;
+    int children;
+    int open;
+};
+struct nk_tree_view {
+/* public: */
+    int count;
+    int selected;
+/* private: */
+    struct nk_allocator pool;
+    nk_plugin_tree_children children;
+    nk_plugin_tree_label label;
+    nk_handle userdata;
+    nk_handle root;
+    nk_handle *nodes;
+    struct nk_tree_view_row *rows;
+    int capacity;
+    int valid;
+};
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+NK_API void nk_tree_view_init_default(struct nk_tree_view*, nk_handle root, nk_plugin_tree_children, nk_plugin_tree_label, nk_handle userdata);
+#endif
+NK_API void nk_tree_view_init(struct nk_tree_view*, const struct nk_allocator*, nk_handle root, nk_plugin_tree_children, nk_plugin_tree_label, nk_handle userdata);
+NK_API void nk_tree_view_free(struct nk_tree_view*);
+NK_API void nk_tree_view_reset(struct nk_tree_view*);
+NK_API int nk_tree_view_expand(struct nk_tree_view*, int row);
+NK_API void nk_tree_view_collapse(struct nk_tree_view*, int row);
+NK_API nk_handle nk_tree_view_node(const struct nk_tree_view*, int row);
+NK_API int nk_tree_view(struct nk_context*, struct nk_tree_view*, const char *id, nk_flags);
 /* =============================================================================
  *
  *                                  WIDGET
@@ -3456,6 +3881,11 @@ NK_API void nk_chart_add_slot(struct nk_context *ctx, const enum nk_chart_type,
 NK_API void nk_chart_add_slot_colored(struct nk_context *ctx, const enum nk_chart_type, struct nk_color, struct nk_color active, int count, float min_value, float max_value);
 NK_API nk_flags nk_chart_push(struct nk_context*, float);
 NK_API nk_flags nk_chart_push_slot(struct nk_context*, float, int);
+NK_API nk_flags nk_chart_push_series(struct nk_context*, const float *values, int count, enum nk_chart_sampling);
+NK_API nk_flags nk_chart_push_series_slot(struct nk_context*, const float *values, int count, enum nk_chart_sampling, int slot);
+/* `stride` is the distance in bytes between two values or 0 for tightly packed floats */
+NK_API nk_flags nk_chart_push_array(struct nk_context*, const float *values, int count, int stride);
+NK_API nk_flags nk_chart_push_array_slot(struct nk_context*, const float *values, int count, int stride, int slot);
 NK_API void nk_chart_end(struct nk_context*);
 NK_API void nk_plot(struct nk_context*, enum nk_chart_type, const float *values, int count, int offset);
 NK_API void nk_plot_function(struct nk_context*, enum nk_chart_type, void *userdata, float(*value_getter)(void* user, int index), int count, int offset);
@@ -3504,6 +3934,59 @@ NK_API int nk_combo_item_symbol_label(struct nk_context*, enum nk_symbol_type, c
 NK_API int nk_combo_item_symbol_text(struct nk_context*, enum nk_symbol_type, const char*, int, nk_flags alignment);
 NK_API void nk_combo_close(struct nk_context*);
 NK_API void nk_combo_end(struct nk_context*);
+/* =============================================================================
+ *
+ *                                  COMBO LIST
+ *
+ * =============================================================================
+ *  Searchable combobox for huge item sets. Items are not submitted every frame
+ *  but fetched through `text(userdata, item, &len)` which returns the label of
+ *  an item, and only for the rows visible inside the popup list.
+ *
+ *  The popup starts with a focused edit field. Typing filters the items with
+ *  `nk_strmatch_fuzzy_text` and pressing enter picks the first match. The
+ *  filtered item index is only rebuilt if the filter text changed and typing
+ *  more characters only rescans the items which matched before.
+ *
+ *      struct nk_combo_list symbols;
+ *      nk_combo_list_init_default(&symbols, count, symbol_name, nk_handle_ptr(app));
+ *      ...
+ *      nk_layout_row_dynamic(ctx, 25, 1);
+ *      picked = nk_combo_list(ctx, &symbols, 20, nk_vec2(300, 400));
+ *      ...
+ *      nk_combo_list_free(&symbols);
+ *
+ *  After the item set changed `nk_combo_list_reset` updates the number of
+ *  items and throws away the filtered index.
+ */
+#ifndef NK_COMBO_LIST_FILTER_SIZE
+#define NK_COMBO_LIST_FILTER_SIZE 64
+#endif
+typedef const char*(*nk_plugin_item_text)(nk_handle, int item, int *len);
+struct nk_combo_list {
+/* public: */
+    int count;
+    int selected;
+/* private: */
+    struct nk_allocator pool;
+    nk_plugin_item_text text;
+    nk_handle userdata;
+    char filter[NK_COMBO_LIST_FILTER_SIZE];
+    int filter_len;
+    char query[NK_COMBO_LIST_FILTER_SIZE];
+    int *matches;
+    int match_count;
+    int capacity;
+    int valid;
+    int open;
+};
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+NK_API void nk_combo_list_init_default(struct nk_combo_list*, int count, nk_plugin_item_text, nk_handle userdata);
+#endif
+NK_API void nk_combo_list_init(struct nk_combo_list*, const struct nk_allocator*, int count, nk_plugin_item_text, nk_handle userdata);
+NK_API void nk_combo_list_free(struct nk_combo_list*);
+NK_API void nk_combo_list_reset(struct nk_combo_list*, int count);
+NK_API int nk_combo_list(struct nk_context*, struct nk_combo_list*, int item_height, struct nk_vec2 size);
 /* =============================================================================
  *
  *                                  CONTEXTUAL
@@ -3734,6 +4217,64 @@ NK_API double nk_strtod(const char *str, const char **endptr);
 NK_API int nk_strfilter(const char *text, const char *regexp);
 NK_API int nk_strmatch_fuzzy_string(char const *str, char const *pattern, int *out_score);
 NK_API int nk_strmatch_fuzzy_text(const char *txt, int txt_len, const char *pattern, int *out_score);
+/* =============================================================================
+ *
+ *                                  FUZZY MATCHER
+ *
+ * =============================================================================
+ *  Matches a pattern against a whole array of strings at once, for example to
+ *  filter a command palette on every keystroke. Each string gets a 32 bit
+ *  mask of the character classes it contains when the matcher is initialized.
+ *  Strings which lack any character class of the pattern are rejected with a
+ *  single AND before `nk_strmatch_fuzzy_text` has to look at them.
+ *
+ *  The matcher remembers which strings matched the last pattern. If the new
+ *  pattern only appends characters to it, only those strings are checked
+ *  again. `nk_fuzzy_match` writes the best `max` results into `results`
+ *  sorted by descending score and equal scores by index, and returns how many
+ *  were written. `matches` holds the total number of matching strings.
+ *
+ *      struct nk_fuzzy_matcher palette;
+ *      struct nk_fuzzy_match best[16];
+ *      nk_fuzzy_matcher_init_default(&palette, commands, command_count);
+ *      ...
+ *      n = nk_fuzzy_match(&palette, query, best, 16);
+ *      for (i = 0; i < n; ++i)
+ *          nk_label(ctx, commands[best[i].index], NK_TEXT_LEFT);
+ *      ...
+ *      nk_fuzzy_matcher_free(&palette);
+ *
+ *  The string array must stay valid while the matcher is used. After it
+ *  changed `nk_fuzzy_matcher_reset` has to be called.
+ */
+#ifndef NK_FUZZY_PATTERN_SIZE
+#define NK_FUZZY_PATTERN_SIZE 64
+#endif
+struct nk_fuzzy_match {
+    int index;
+    int score;
+};
+struct nk_fuzzy_matcher {
+/* public: */
+    int count;
+    int matches;
+/* private: */
+    struct nk_allocator pool;
+    const char *const *strings;
+    nk_uint *masks;
+    int *lengths;
+    int *candidates;
+    int capacity;
+    char pattern[NK_FUZZY_PATTERN_SIZE];
+    int valid;
+};
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+NK_API int nk_fuzzy_matcher_init_default(struct nk_fuzzy_matcher*, const char *const *strings, int count);
+#endif
+NK_API int nk_fuzzy_matcher_init(struct nk_fuzzy_matcher*, const struct nk_allocator*, const char *const *strings, int count);
+NK_API int nk_fuzzy_matcher_reset(struct nk_fuzzy_matcher*, const char *const *strings, int count);
+NK_API void nk_fuzzy_matcher_free(struct nk_fuzzy_matcher*);
+NK_API int nk_fuzzy_match(struct nk_fuzzy_matcher*, const char *pattern, struct nk_fuzzy_match *results, int max);
 /* =============================================================================
  *
  *                                  UTF-8
@@ -4160,17 +4701,52 @@ NK_API nk_size nk_buffer_total(struct nk_buffer*);
  *  to manage and manipulate dynamic or fixed size string content. This is _NOT_
  *  the default string handling method. The only instance you should have any contact
  *  with this API is if you interact with an `nk_text_edit` object inside one of the
- *  copy and paste functions and even there only for more advanced cases. */
+ *  copy and paste functions and even there only for more advanced cases.
+ *
+ *  Strings initialized with `nk_str_init_gap` keep an insertion gap at the
+ *  position of the last edit, which makes inserting and deleting near the
+ *  cursor independent of the total string size. The gap is closed again
+ *  whenever a direct pointer into the string is requested, so `nk_str_get`,
+ *  `nk_str_at_char` and `nk_str_at_rune` always see contiguous text. The
+ *  `_const` getters never move memory: the text behind their result is only
+ *  contiguous up to the gap, while `nk_str_rune_at` reads a single codepoint.
+ *
+ *  Dynamic strings can additionally keep a rune offset index by calling
+ *  `nk_str_build_index`. The index stores the byte offset of roughly every
+ *  n-th codepoint as well as of every line start and is updated on every
+ *  insert and delete, so codepoint lookups like `nk_str_rune_at` only have
+ *  to decode a few glyphs instead of the whole string in front of the
+ *  requested position. Text editors use the line starts to only layout and
+ *  draw the visible lines. Strings with an index have to be modified
+ *  through the `nk_str_xxx` functions only. */
+struct nk_str_checkpoint {
+    int rune; /* codepoint index */
+    int byte; /* byte offset of the codepoint */
+    int line; /* line of the codepoint */
+};
 struct nk_str {
     struct nk_buffer buffer;
     int len; /* in codepoints/runes/glyphs */
+    nk_size gap_begin; /* byte offset of the insertion gap */
+    nk_size gap_len; /* size of the insertion gap in bytes */
+    int gap_rune; /* codepoint index of the insertion gap */
+    int gap_buffer; /* nk_true if the string keeps an insertion gap */
+    struct nk_str_checkpoint *index; /* optional rune offset index */
+    int index_front; /* checkpoints in front of the last edit */
+    int index_back; /* checkpoints behind the last edit, relative to the end */
+    int index_capacity; /* number of allocated checkpoints */
+    int index_stride; /* codepoints between checkpoints or 0 if disabled */
+    int index_lines; /* number of line breaks, only counted with an index */
 };
 
 #ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
 NK_API void nk_str_init_default(struct nk_str*);
+NK_API void nk_str_init_gap_default(struct nk_str*);
 #endif
 NK_API void nk_str_init(struct nk_str*, const struct nk_allocator*, nk_size size);
 NK_API void nk_str_init_fixed(struct nk_str*, void *memory, nk_size size);
+NK_API void nk_str_init_gap(struct nk_str*, const struct nk_allocator*, nk_size size);
+NK_API int nk_str_build_index(struct nk_str*, int stride);
 NK_API void nk_str_clear(struct nk_str*);
 NK_API void nk_str_free(struct nk_str*);
 
@@ -4234,6 +4810,23 @@ NK_API int nk_str_len_char(struct nk_str*);
  * complexity I would not recommend editing gigabytes of data with it.
  * It is rather designed for uses cases which make sense for a GUI library not for
  * an full blown text editor.
+ *
+ * For bigger documents `nk_textedit_init_gap` sets up the same dynamically
+ * growing text editor on top of a gap buffer string. Typing and deleting
+ * around the cursor then no longer moves the remaining text on every key press
+ * and the string keeps a rune offset index (see `nk_str_build_index`) so
+ * cursor movement does not decode the whole text in front of the cursor.
+ * The index also tracks line starts, which lets the editor only measure and
+ * draw the lines inside the visible area.
+ *
+ * The undo/redo stack of every text editor is limited to a fixed number of
+ * records and characters. Calling `nk_textedit_undo_history` replaces it with
+ * a growable history which stores edits as UTF-8 and is only bounded by a
+ * memory limit, so large pastes and long editing sessions stay undoable.
+ * Editors set up by `nk_textedit_init_gap` use it by default with a limit of
+ * `NK_TEXTEDIT_UNDO_LIMIT` bytes. Once the limit is reached the oldest records
+ * are dropped. Limits below `NK_TEXTEDIT_HISTORY_MIN_SIZE` (1KB by default) are
+ * rejected and leave the editor unchanged.
  */
 #ifndef NK_TEXTEDIT_UNDOSTATECOUNT
 #define NK_TEXTEDIT_UNDOSTATECOUNT     99
@@ -4243,6 +4836,10 @@ NK_API int nk_str_len_char(struct nk_str*);
 #define NK_TEXTEDIT_UNDOCHARCOUNT      999
 #endif
 
+#ifndef NK_TEXTEDIT_UNDO_LIMIT
+#define NK_TEXTEDIT_UNDO_LIMIT         (16 * 1024 * 1024)
+#endif
+
 struct nk_text_edit;
 struct nk_clipboard {
     nk_handle userdata;
@@ -4264,6 +4861,14 @@ struct nk_text_undo_state {
    short redo_point;
    short undo_char_point;
    short redo_char_point;
+   /* growable history (see `nk_textedit_undo_history`) */
+   struct nk_allocator pool;
+   char *history;
+   nk_size history_size;
+   nk_size history_limit;
+   nk_size undo_begin;
+   nk_size undo_end;
+   nk_size redo_begin;
 };
 
 enum nk_text_edit_type {
@@ -4309,9 +4914,12 @@ NK_API int nk_filter_binary(const struct nk_text_edit*, nk_rune unicode);
 /* text editor */
 #ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
 NK_API void nk_textedit_init_default(struct nk_text_edit*);
+NK_API void nk_textedit_init_gap_default(struct nk_text_edit*);
 #endif
 NK_API void nk_textedit_init(struct nk_text_edit*, struct nk_allocator*, nk_size size);
 NK_API void nk_textedit_init_fixed(struct nk_text_edit*, void *memory, nk_size size);
+NK_API void nk_textedit_init_gap(struct nk_text_edit*, struct nk_allocator*, nk_size size);
+NK_API int nk_textedit_undo_history(struct nk_text_edit*, const struct nk_allocator*, nk_size limit);
 NK_API void nk_textedit_free(struct nk_text_edit*);
 NK_API void nk_textedit_text(struct nk_text_edit*, const char*, int total_len);
 NK_API void nk_textedit_delete(struct nk_text_edit*, int where, int len);
@@ -5328,6 +5936,7 @@ struct nk_panel {
     struct nk_rect bounds;
     nk_uint *offset_x;
     nk_uint *offset_y;
+    nk_uint *content_height;
     float at_x, at_y, max_x;
     float footer_height;
     float header_height;
@@ -5566,6 +6175,33 @@ struct nk_pool {
     nk_size cap;
 };
 
+struct nk_redraw {
+    nk_hash frame;
+    float deadline;
+    float request;
+    int requested;
+    int input;
+    int needed;
+    int enabled;
+};
+
+struct nk_record {
+    struct nk_buffer *buffer;
+    int x, y;
+};
+
+struct nk_replay {
+    const nk_byte *data;
+    nk_size size;
+    nk_size offset;
+    int x, y;
+    int frame;
+    nk_hash hash;
+    int has_hash;
+    int width, height;
+    int resized;
+};
+
 struct nk_context {
 /* public: can be accessed freely */
     struct nk_input input;
@@ -5593,6 +6229,10 @@ struct nk_context {
     struct nk_text_edit text_edit;
     /* draw buffer used for overlay drawing operation like cursor */
     struct nk_command_buffer overlay;
+    /* idle tracking for nk_needs_redraw */
+    struct nk_redraw redraw;
+    /* input recording started by nk_record_begin */
+    struct nk_record record;
 
     /* windows */
     int build;
@@ -5698,6 +6338,34 @@ template<typename T> struct nk_alignof{struct Big {T x; char c;}; enum {
 #define NK_BUFFER_DEFAULT_INITIAL_SIZE (4*1024)
 #endif
 
+#ifndef NK_STR_GAP_MIN_SIZE
+#define NK_STR_GAP_MIN_SIZE 64
+#endif
+
+#ifndef NK_STR_INDEX_STRIDE
+#define NK_STR_INDEX_STRIDE 64
+#endif
+
+#ifndef NK_TEXTEDIT_HISTORY_MIN_SIZE
+#define NK_TEXTEDIT_HISTORY_MIN_SIZE 1024
+#endif
+
+#ifndef NK_TEXT_VIEW_LINE_STRIDE
+#define NK_TEXT_VIEW_LINE_STRIDE 64
+#endif
+
+#ifndef NK_TEXT_VIEW_INDEX_BUDGET
+#define NK_TEXT_VIEW_INDEX_BUDGET (4 * 1024 * 1024)
+#endif
+
+#ifndef NK_TEXT_VIEW_MAX_COPY
+#define NK_TEXT_VIEW_MAX_COPY (16 * 1024 * 1024)
+#endif
+
+#ifndef NK_CHART_MARKER_SPACING
+#define NK_CHART_MARKER_SPACING 8
+#endif
+
 /* standard library headers */
 #ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
 #include <stdlib.h> /* malloc, free */
@@ -5811,7 +6479,6 @@ NK_LIB int nk_iceilf(float x);
 NK_LIB int nk_log10(double n);
 
 /* util */
-enum {NK_DO_NOT_STOP_ON_NEW_LINE, NK_STOP_ON_NEW_LINE};
 NK_LIB int nk_is_lower(int c);
 NK_LIB int nk_is_upper(int c);
 NK_LIB int nk_to_upper(int c);
@@ -5823,7 +6490,6 @@ NK_LIB char *nk_itoa(char *s, long n);
 NK_LIB int nk_string_float_limit(char *string, int prec);
 NK_LIB char *nk_dtoa(char *s, double n);
 NK_LIB int nk_text_clamp(const struct nk_user_font *font, const char *text, int text_len, float space, int *glyphs, float *text_width, nk_rune *sep_list, int sep_count);
-NK_LIB struct nk_vec2 nk_text_calculate_text_bounds(const struct nk_user_font *font, const char *begin, int byte_len, float row_height, const char **remaining, struct nk_vec2 *out_offset, int *glyphs, int op);
 #ifdef NK_INCLUDE_STANDARD_VARARGS
 NK_LIB int nk_strfmt(char *buf, int buf_size, const char *fmt, va_list args);
 #endif
@@ -5840,6 +6506,16 @@ NK_LIB void* nk_buffer_align(void *unaligned, nk_size align, nk_size *alignment,
 NK_LIB void* nk_buffer_alloc(struct nk_buffer *b, enum nk_buffer_allocation_type type, nk_size size, nk_size align);
 NK_LIB void* nk_buffer_realloc(struct nk_buffer *b, nk_size capacity, nk_size *size);
 
+/* utf-8 */
+NK_LIB int nk_utf_prev(const char *text, int pos);
+
+/* string */
+NK_LIB const char *nk_str_text_at(const struct nk_str *s, int pos, int *avail);
+NK_LIB int nk_str_rune_offset(const struct nk_str *s, int pos);
+NK_LIB int nk_str_line_of(const struct nk_str *s, int pos);
+NK_LIB int nk_str_line_begin(const struct nk_str *s, int line, int *rune);
+NK_LIB int nk_str_line_count(const struct nk_str *s);
+
 /* draw */
 NK_LIB void nk_command_buffer_init(struct nk_command_buffer *cb, struct nk_buffer *b, enum nk_command_clipping clip);
 NK_LIB void nk_command_buffer_reset(struct nk_command_buffer *b);
@@ -5855,6 +6531,25 @@ NK_LIB void nk_finish_buffer(struct nk_context *ctx, struct nk_command_buffer *b
 NK_LIB void nk_finish(struct nk_context *ctx, struct nk_window *w);
 NK_LIB void nk_build(struct nk_context *ctx);
 
+/* redraw */
+NK_LIB void nk_redraw_finish(struct nk_context *ctx);
+
+/* input recording */
+enum nk_record_op {
+    NK_RECORD_END,
+    NK_RECORD_MOTION,
+    NK_RECORD_BUTTON,
+    NK_RECORD_KEY,
+    NK_RECORD_UNICODE,
+    NK_RECORD_SCROLL,
+    NK_RECORD_HASH,
+    NK_RECORD_POSITION,
+    NK_RECORD_RESIZE
+};
+NK_LIB void nk_record_input(struct nk_context *ctx, enum nk_record_op op, int a, int b, int c);
+NK_LIB void nk_record_floats(struct nk_context *ctx, enum nk_record_op op, float a, float b);
+NK_LIB void nk_record_hash(struct nk_context *ctx);
+
 /* text editor */
 NK_LIB void nk_textedit_clear_state(struct nk_text_edit *state, enum nk_text_edit_type type, nk_plugin_filter filter);
 NK_LIB void nk_textedit_click(struct nk_text_edit *state, float x, float y, const struct nk_user_font *font, float row_height);
@@ -5971,7 +6666,7 @@ NK_LIB int nk_do_selectable(nk_flags *state, struct nk_command_buffer *out, stru
 NK_LIB int nk_do_selectable_image(nk_flags *state, struct nk_command_buffer *out, struct nk_rect bounds, const char *str, int len, nk_flags align, int *value, const struct nk_image *img, const struct nk_style_selectable *style, const struct nk_input *in, const struct nk_user_font *font);
 
 /* edit */
-NK_LIB void nk_edit_draw_text(struct nk_command_buffer *out, const struct nk_style_edit *style, float pos_x, float pos_y, float x_offset, const char *text, int byte_len, float row_height, const struct nk_user_font *font, struct nk_color background, struct nk_color foreground, int is_selected);
+NK_LIB void nk_edit_draw_text(struct nk_command_buffer *out, const struct nk_style_edit *style, float pos_x, float pos_y, float x_offset, const struct nk_str *str, int begin, int end, float row_height, const struct nk_user_font *font, struct nk_color background, struct nk_color foreground, int is_selected);
 NK_LIB nk_flags nk_do_edit(nk_flags *state, struct nk_command_buffer *out, struct nk_rect bounds, nk_flags flags, nk_plugin_filter filter, struct nk_text_edit *edit, const struct nk_style_edit *style, struct nk_input *in, const struct nk_user_font *font);
 
 /* color-picker */
@@ -7376,77 +8071,294 @@ nk_text_clamp(const struct nk_user_font *font, const char *text,
         return (!sep_len) ? len: sep_len;
     }
 }
-NK_LIB struct nk_vec2
-nk_text_calculate_text_bounds(const struct nk_user_font *font,
-    const char *begin, int byte_len, float row_height, const char **remaining,
-    struct nk_vec2 *out_offset, int *glyphs, int op)
-{
-    float line_height = row_height;
-    struct nk_vec2 text_size = nk_vec2(0,0);
-    float line_width = 0.0f;
-
-    float glyph_width;
-    int glyph_len = 0;
-    nk_rune unicode = 0;
-    int text_len = 0;
-    if (!begin || byte_len <= 0 || !font)
-        return nk_vec2(0,row_height);
-
-    glyph_len = nk_utf_decode(begin, &unicode, byte_len);
-    if (!glyph_len) return text_size;
-    glyph_width = font->width(font->userdata, font->height, begin, glyph_len);
-
-    *glyphs = 0;
-    while ((text_len < byte_len) && glyph_len) {
-        if (unicode == '\n') {
-            text_size.x = NK_MAX(text_size.x, line_width);
-            text_size.y += line_height;
-            line_width = 0;
-            *glyphs+=1;
-            if (op == NK_STOP_ON_NEW_LINE)
-                break;
-
-            text_len++;
-            glyph_len = nk_utf_decode(begin + text_len, &unicode, byte_len-text_len);
-            continue;
-        }
-
-        if (unicode == '\r') {
-            text_len++;
-            *glyphs+=1;
-            glyph_len = nk_utf_decode(begin + text_len, &unicode, byte_len-text_len);
-            continue;
-        }
-
-        *glyphs = *glyphs + 1;
-        text_len += glyph_len;
-        line_width += (float)glyph_width;
-        glyph_len = nk_utf_decode(begin + text_len, &unicode, byte_len-text_len);
-        glyph_width = font->width(font->userdata, font->height, begin+text_len, glyph_len);
-        continue;
-    }
-
-    if (text_size.x < line_width)
-        text_size.x = line_width;
-    if (out_offset)
-        *out_offset = nk_vec2(line_width, text_size.y + line_height);
-    if (line_width > 0 || text_size.y == 0.0f)
-        text_size.y += line_height;
-    if (remaining)
-        *remaining = begin+text_len;
-    return text_size;
-}
 
 
 
 
 
-/* ==============================================================
+/* ===============================================================
  *
- *                          COLOR
+ *                          FUZZY MATCHER
  *
  * ===============================================================*/
-NK_INTERN int
+NK_INTERN nk_uint
+nk_fuzzy_class(char c)
+{
+    /* characters which `nk_strmatch_fuzzy_text` treats as equal always end up
+     * in the same class. Lower case letters get one bit each while all other
+     * characters share the remaining six bits */
+    int lower = nk_to_lower(c);
+    if (lower >= 'a' && lower <= 'z')
+        return (nk_uint)1 << (lower - 'a');
+    return (nk_uint)1 << (26 + (lower + 256) % 6);
+}
+NK_INTERN int
+nk_fuzzy_score(const char *str, int len, const char *pattern, int *out_score)
+{
+    /* computes the same result as `nk_strmatch_fuzzy_text` but runs through
+     * the letters in front of the first and behind the last pattern match
+     * in tight loops since they can only change the score by a penalty */
+    const char *iter = pattern;
+    int i = 0, score = 0, best = -1, best_score = 0;
+    int prev_matched = nk_false, prev_lower = nk_false, prev_separator = nk_true;
+
+    if (*iter) {
+        int first = nk_to_lower(*iter);
+        while (i < len && nk_to_lower(str[i]) != first) ++i;
+        if (i == len) return nk_false;
+        if (i > 0) {
+            score = -i;
+            prev_lower = nk_is_lower(str[i-1]) != 0;
+            prev_separator = str[i-1] == '_' || str[i-1] == ' ';
+        }
+    }
+    for (; i < len; ++i) {
+        const char c = str[i];
+        int next_match, rematch;
+        if (!*iter && best >= 0) {
+            /* only letters equal to the best match can still matter and
+             * every other letter costs one point */
+            const int upper = nk_to_upper(str[best]);
+            for (;; ++i) {
+                int new_score;
+                const int from = i;
+                while (i < len && nk_to_upper(str[i]) != upper) ++i;
+                score -= i - from;
+                if (i == len) break;
+                if (i > from)
+                    prev_matched = nk_false;
+                prev_lower = nk_is_lower(str[i-1]) != 0;
+                prev_separator = str[i-1] == '_' || str[i-1] == ' ';
+                new_score = (prev_matched ? 5: 0) + (prev_separator ? 10: 0);
+                new_score += (prev_lower && nk_is_upper(str[i])) ? 10: 0;
+                if (new_score >= best_score) {
+                    score -= 1;
+                    best = i;
+                    best_score = new_score;
+                }
+                prev_matched = nk_true;
+            }
+            break;
+        }
+
+        next_match = *iter != '\0' && nk_to_lower(*iter) == nk_to_lower(c);
+        rematch = best >= 0 && nk_to_upper(str[best]) == nk_to_upper(c);
+        if ((next_match && best >= 0) || (best >= 0 && *iter != '\0' &&
+            nk_to_lower(str[best]) == nk_to_lower(*iter))) {
+            score += best_score;
+            best = -1;
+            best_score = 0;
+        }
+        if (next_match || rematch) {
+            /* adjacency, separator and camel case bonus */
+            int new_score = (prev_matched ? 5: 0) + (prev_separator ? 10: 0);
+            new_score += (prev_lower && nk_is_upper(c)) ? 10: 0;
+            if (iter == pattern)
+                score += NK_MAX(-3 * i, -9);
+            if (next_match)
+                ++iter;
+            if (new_score >= best_score) {
+                if (best >= 0)
+                    score -= 1;
+                best = i;
+                best_score = new_score;
+            }
+            prev_matched = nk_true;
+        } else {
+            score -= 1;
+            prev_matched = nk_false;
+        }
+        prev_lower = nk_is_lower(c) != 0;
+        prev_separator = c == '_' || c == ' ';
+    }
+    if (best >= 0)
+        score += best_score;
+    if (*iter != '\0')
+        return nk_false;
+    *out_score = score;
+    return nk_true;
+}
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+NK_API int
+nk_fuzzy_matcher_init_default(struct nk_fuzzy_matcher *matcher,
+    const char *const *strings, int count)
+{
+    struct nk_allocator alloc;
+    alloc.userdata.ptr = 0;
+    alloc.alloc = nk_malloc;
+    alloc.free = nk_mfree;
+    return nk_fuzzy_matcher_init(matcher, &alloc, strings, count);
+}
+#endif
+NK_API int
+nk_fuzzy_matcher_init(struct nk_fuzzy_matcher *matcher,
+    const struct nk_allocator *alloc, const char *const *strings, int count)
+{
+    NK_ASSERT(matcher);
+    NK_ASSERT(alloc);
+    if (!matcher || !alloc) return 0;
+    NK_MEMSET(matcher, 0, sizeof(*matcher));
+    matcher->pool = *alloc;
+    return nk_fuzzy_matcher_reset(matcher, strings, count);
+}
+NK_API void
+nk_fuzzy_matcher_free(struct nk_fuzzy_matcher *matcher)
+{
+    NK_ASSERT(matcher);
+    if (!matcher) return;
+    if (matcher->masks && matcher->pool.free)
+        matcher->pool.free(matcher->pool.userdata, matcher->masks);
+    matcher->masks = 0;
+    matcher->lengths = 0;
+    matcher->candidates = 0;
+    matcher->count = matcher->matches = matcher->capacity = 0;
+    matcher->valid = nk_false;
+}
+NK_API int
+nk_fuzzy_matcher_reset(struct nk_fuzzy_matcher *matcher,
+    const char *const *strings, int count)
+{
+    int i;
+    nk_uint classes[256];
+    NK_ASSERT(matcher);
+    NK_ASSERT(strings || !count);
+    if (!matcher || (!strings && count)) return 0;
+
+    matcher->valid = nk_false;
+    matcher->matches = 0;
+    matcher->count = 0;
+    matcher->strings = strings;
+    if (count > matcher->capacity) {
+        /* masks, lengths and candidates share one allocation */
+        void *memory;
+        nk_size size = (nk_size)count * (sizeof(nk_uint) + 2 * sizeof(int));
+        if (!matcher->pool.alloc || !matcher->pool.free) return 0;
+        memory = matcher->pool.alloc(matcher->pool.userdata, 0, size);
+        if (!memory) return 0;
+        if (matcher->masks)
+            matcher->pool.free(matcher->pool.userdata, matcher->masks);
+        matcher->masks = (nk_uint*)memory;
+        matcher->lengths = (int*)(void*)(matcher->masks + count);
+        matcher->candidates = matcher->lengths + count;
+        matcher->capacity = count;
+    }
+    for (i = 0; i < 256; ++i)
+        classes[i] = nk_fuzzy_class((char)i);
+    for (i = 0; i < count; ++i) {
+        const unsigned char *str = (const unsigned char*)strings[i];
+        nk_uint mask = 0;
+        int len = 0;
+        if (str) {
+            for (; str[len]; ++len)
+                mask |= classes[str[len]];
+        }
+        matcher->masks[i] = mask;
+        matcher->lengths[i] = len;
+    }
+    matcher->count = count;
+    return 1;
+}
+NK_INTERN int
+nk_fuzzy_worse(const struct nk_fuzzy_match *a, const struct nk_fuzzy_match *b)
+{
+    return a->score < b->score || (a->score == b->score && a->index > b->index);
+}
+NK_INTERN void
+nk_fuzzy_sift_down(struct nk_fuzzy_match *heap, int i, int n)
+{
+    /* min-heap with the worst result on top */
+    struct nk_fuzzy_match item = heap[i];
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= n) break;
+        if (child + 1 < n && nk_fuzzy_worse(&heap[child+1], &heap[child]))
+            child++;
+        if (!nk_fuzzy_worse(&heap[child], &item)) break;
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = item;
+}
+NK_INTERN void
+nk_fuzzy_push(struct nk_fuzzy_match *heap, int *n, int max, int index, int score)
+{
+    struct nk_fuzzy_match item;
+    int i;
+    item.index = index;
+    item.score = score;
+    if (*n == max) {
+        /* replace the worst result if the new one is better */
+        if (!nk_fuzzy_worse(heap, &item)) return;
+        heap[0] = item;
+        nk_fuzzy_sift_down(heap, 0, *n);
+        return;
+    }
+    i = (*n)++;
+    while (i > 0 && nk_fuzzy_worse(&item, &heap[(i-1)/2])) {
+        heap[i] = heap[(i-1)/2];
+        i = (i-1)/2;
+    }
+    heap[i] = item;
+}
+NK_API int
+nk_fuzzy_match(struct nk_fuzzy_matcher *matcher, const char *pattern,
+    struct nk_fuzzy_match *results, int max)
+{
+    int i, n = 0, found = 0, len, last, extend, total;
+    nk_uint mask = 0;
+
+    NK_ASSERT(matcher);
+    NK_ASSERT(pattern);
+    NK_ASSERT(results || max <= 0);
+    if (!matcher || !pattern) return 0;
+    if (!results) max = 0;
+
+    len = nk_strlen(pattern);
+    for (i = 0; i < len; ++i)
+        mask |= nk_fuzzy_class(pattern[i]);
+
+    /* a longer pattern only matches strings which matched the shorter one */
+    last = nk_strlen(matcher->pattern);
+    extend = matcher->valid && last <= len;
+    for (i = 0; i < last && extend; ++i)
+        extend = (matcher->pattern[i] == pattern[i]);
+    total = extend ? matcher->matches: matcher->count;
+
+    for (i = 0; i < total; ++i) {
+        int score, index = extend ? matcher->candidates[i]: i;
+        if ((matcher->masks[index] & mask) != mask || !matcher->lengths[index])
+            continue;
+        if (!nk_fuzzy_score(matcher->strings[index],
+                matcher->lengths[index], pattern, &score))
+            continue;
+        matcher->candidates[n++] = index;
+        if (max > 0)
+            nk_fuzzy_push(results, &found, max, index, score);
+    }
+    matcher->matches = n;
+    matcher->valid = (len < NK_FUZZY_PATTERN_SIZE);
+    if (matcher->valid)
+        NK_MEMCPY(matcher->pattern, pattern, (nk_size)len + 1);
+
+    /* heap sort puts the best result first */
+    for (i = found - 1; i > 0; --i) {
+        struct nk_fuzzy_match tmp = results[0];
+        results[0] = results[i];
+        results[i] = tmp;
+        nk_fuzzy_sift_down(results, 0, i);
+    }
+    return found;
+}
+
+
+
+
+/* ==============================================================
+ *
+ *                          COLOR
+ *
+ * ===============================================================*/
+NK_INTERN int
 nk_parse_hex(const char *p, int length)
 {
     int i = 0;
@@ -7959,6 +8871,26 @@ nk_utf_len(const char *str, int len)
     }
     return glyphs;
 }
+NK_LIB int
+nk_utf_prev(const char *text, int pos)
+{
+    /* returns the byte length of the glyph ending at byte offset `pos`.
+     * Invalid sequences are treated like `nk_utf_decode` does, which
+     * consumes a single byte for each stray continuation byte. */
+    int i, len;
+    nk_rune unicode;
+    NK_ASSERT(text);
+    if (!text || pos <= 0) return 0;
+    for (i = 1; i <= NK_UTF_SIZE && i <= pos; ++i) {
+        if (((nk_byte)text[pos-i] & 0xC0) == 0x80)
+            continue;
+        len = nk_utf_decode(text + pos - i, &unicode, i);
+        if (len == i || !len)
+            return i;
+        break;
+    }
+    return 1;
+}
 NK_API const char*
 nk_utf_at(const char *buffer, int length, int index,
     nk_rune *unicode, int *len)
@@ -8294,6 +9226,19 @@ nk_str_init_default(struct nk_str *str)
     alloc.free = nk_mfree;
     nk_buffer_init(&str->buffer, &alloc, 32);
     str->len = 0;
+    str->gap_begin = str->gap_len = 0;
+    str->gap_rune = 0;
+    str->gap_buffer = nk_false;
+    str->index = 0;
+    str->index_front = str->index_back = 0;
+    str->index_capacity = str->index_stride = 0;
+    str->index_lines = 0;
+}
+NK_API void
+nk_str_init_gap_default(struct nk_str *str)
+{
+    nk_str_init_default(str);
+    str->gap_buffer = nk_true;
 }
 #endif
 
@@ -8302,12 +9247,394 @@ nk_str_init(struct nk_str *str, const struct nk_allocator *alloc, nk_size size)
 {
     nk_buffer_init(&str->buffer, alloc, size);
     str->len = 0;
+    str->gap_begin = str->gap_len = 0;
+    str->gap_rune = 0;
+    str->gap_buffer = nk_false;
+    str->index = 0;
+    str->index_front = str->index_back = 0;
+    str->index_capacity = str->index_stride = 0;
+    str->index_lines = 0;
 }
 NK_API void
 nk_str_init_fixed(struct nk_str *str, void *memory, nk_size size)
 {
     nk_buffer_init_fixed(&str->buffer, memory, size);
     str->len = 0;
+    str->gap_begin = str->gap_len = 0;
+    str->gap_rune = 0;
+    str->gap_buffer = nk_false;
+    str->index = 0;
+    str->index_front = str->index_back = 0;
+    str->index_capacity = str->index_stride = 0;
+    str->index_lines = 0;
+}
+NK_API void
+nk_str_init_gap(struct nk_str *str, const struct nk_allocator *alloc, nk_size size)
+{
+    nk_str_init(str, alloc, size);
+    str->gap_buffer = nk_true;
+}
+NK_INTERN void
+nk_str_gap_move(struct nk_str *s, nk_size pos)
+{
+    /* moves the insertion gap to logical byte offset `pos` */
+    char *mem = (char*)s->buffer.memory.ptr;
+    nk_size n;
+    if (pos == s->gap_begin) return;
+    if (pos < s->gap_begin) {
+        n = s->gap_begin - pos;
+        s->gap_rune -= nk_utf_len(mem + pos, (int)n);
+        if (s->gap_len)
+            NK_MEMCPY(mem + pos + s->gap_len, mem + pos, n);
+    } else {
+        n = pos - s->gap_begin;
+        s->gap_rune += nk_utf_len(mem + s->gap_begin + s->gap_len, (int)n);
+        if (s->gap_len)
+            NK_MEMCPY(mem + s->gap_begin, mem + s->gap_begin + s->gap_len, n);
+    }
+    s->gap_begin = pos;
+}
+NK_INTERN int
+nk_str_gap_reserve(struct nk_str *s, nk_size len)
+{
+    /* grows the insertion gap to at least `len` bytes. The gap grows with the
+     * text so repeated inserts only move the text behind it occasionally */
+    nk_size text_len, tail, grow;
+    char *mem;
+    if (s->gap_len >= len) return 1;
+
+    text_len = s->buffer.allocated - s->gap_len;
+    tail = text_len - s->gap_begin;
+    grow = (len - s->gap_len) + NK_MAX((nk_size)NK_STR_GAP_MIN_SIZE, text_len/8);
+    if (!nk_buffer_alloc(&s->buffer, NK_BUFFER_FRONT, grow, 0))
+        return 0;
+
+    mem = (char*)s->buffer.memory.ptr;
+    if (tail) NK_MEMCPY(mem + s->gap_begin + s->gap_len + grow,
+        mem + s->gap_begin + s->gap_len, tail);
+    s->gap_len += grow;
+    return 1;
+}
+NK_INTERN void
+nk_str_gap_close(struct nk_str *s)
+{
+    /* moves the gap behind the text so the string content is contiguous */
+    nk_size text_len = s->buffer.allocated - s->gap_len;
+    if (!s->gap_len || s->gap_begin == text_len) return;
+    nk_str_gap_move(s, text_len);
+    s->gap_rune = s->len;
+}
+NK_LIB const char*
+nk_str_text_at(const struct nk_str *s, int pos, int *avail)
+{
+    /* maps a logical byte offset to memory without closing the gap and
+     * returns the number of bytes that can be read contiguously */
+    nk_size text_len;
+    const char *mem;
+
+    NK_ASSERT(s);
+    NK_ASSERT(avail);
+    if (!s || !avail) return 0;
+    text_len = s->buffer.allocated - s->gap_len;
+    mem = (const char*)s->buffer.memory.ptr;
+    if (pos < 0 || (nk_size)pos > text_len) {
+        *avail = 0;
+        return 0;
+    }
+    if (!s->gap_len) {
+        *avail = (int)(text_len - (nk_size)pos);
+        return mem + pos;
+    } else if ((nk_size)pos < s->gap_begin) {
+        *avail = (int)(s->gap_begin - (nk_size)pos);
+        return mem + pos;
+    }
+    *avail = (int)(text_len - (nk_size)pos);
+    return mem + s->gap_len + pos;
+}
+NK_INTERN int
+nk_str_walk(const struct nk_str *s, int offset, int runes)
+{
+    /* returns the logical byte offset `runes` codepoints behind byte offset
+     * `offset` or -1 if the string ends before */
+    const char *text;
+    int avail = 0;
+    int glyph_len;
+    int i = 0;
+    nk_rune unicode;
+
+    text = nk_str_text_at(s, offset, &avail);
+    if (!text) return -1;
+    glyph_len = nk_utf_decode(text, &unicode, avail);
+    while (i < runes && glyph_len) {
+        i++;
+        offset += glyph_len;
+        text += glyph_len;
+        avail -= glyph_len;
+        if (!avail) text = nk_str_text_at(s, offset, &avail);
+        glyph_len = nk_utf_decode(text, &unicode, avail);
+    }
+    if (i != runes) return -1;
+    return offset;
+}
+NK_INTERN struct nk_str_checkpoint
+nk_str_index_at(const struct nk_str *s, int i)
+{
+    /* checkpoints behind the last edit are stored relative to the end of the
+     * string so inserting and deleting does not have to touch them */
+    struct nk_str_checkpoint cp;
+    if (i < s->index_front) return s->index[i];
+    cp = s->index[s->index_capacity - s->index_back + (i - s->index_front)];
+    cp.rune = s->len - cp.rune;
+    cp.byte = (int)(s->buffer.allocated - s->gap_len) - cp.byte;
+    cp.line = s->index_lines - cp.line;
+    return cp;
+}
+NK_INTERN int
+nk_str_index_find(const struct nk_str *s, int pos)
+{
+    /* returns the last checkpoint in front of or at codepoint `pos` */
+    int lo = 0, hi = s->index_front + s->index_back - 1;
+    while (lo < hi) {
+        int mid = lo + (hi - lo + 1) / 2;
+        if (nk_str_index_at(s, mid).rune <= pos)
+            lo = mid;
+        else hi = mid - 1;
+    }
+    return lo;
+}
+NK_INTERN int
+nk_str_count_lines(const char *text, int len)
+{
+    int i, lines = 0;
+    for (i = 0; i < len; ++i)
+        if (text[i] == '\n') lines++;
+    return lines;
+}
+NK_INTERN void
+nk_str_index_split(struct nk_str *s, int pos)
+{
+    /* moves the split between absolute and relative checkpoints to logical
+     * byte offset `pos`. Has to be called before the string is modified */
+    int text_len = (int)(s->buffer.allocated - s->gap_len);
+    struct nk_str_checkpoint cp;
+    if (!s->index_stride) return;
+    while (s->index_front > 1 && s->index[s->index_front-1].byte > pos) {
+        cp = s->index[--s->index_front];
+        s->index_back++;
+        s->index[s->index_capacity - s->index_back].rune = s->len - cp.rune;
+        s->index[s->index_capacity - s->index_back].byte = text_len - cp.byte;
+        s->index[s->index_capacity - s->index_back].line = s->index_lines - cp.line;
+    }
+    while (s->index_back) {
+        cp = nk_str_index_at(s, s->index_front);
+        if (cp.byte > pos) break;
+        s->index[s->index_front++] = cp;
+        s->index_back--;
+    }
+}
+NK_INTERN void
+nk_str_index_erase(struct nk_str *s, int pos, int len)
+{
+    /* drops all checkpoints inside text that is about to be deleted and
+     * the one behind it if it would end up on top of an existing one */
+    int last;
+    if (!s->index_stride) return;
+    nk_str_index_split(s, pos);
+    last = s->index[s->index_front-1].byte;
+    while (s->index_back) {
+        int byte = nk_str_index_at(s, s->index_front).byte;
+        if (byte > pos + len || (byte == pos + len && last != pos)) break;
+        s->index_back--;
+    }
+}
+NK_INTERN void
+nk_str_index_free(struct nk_str *s)
+{
+    if (s->index && s->buffer.pool.free)
+        s->buffer.pool.free(s->buffer.pool.userdata, s->index);
+    s->index = 0;
+    s->index_front = s->index_back = 0;
+    s->index_capacity = s->index_stride = 0;
+    s->index_lines = 0;
+}
+NK_INTERN int
+nk_str_index_push(struct nk_str *s, struct nk_str_checkpoint cp)
+{
+    if (s->index_front + s->index_back >= s->index_capacity) {
+        int capacity = NK_MAX(16, s->index_capacity * 2);
+        struct nk_str_checkpoint *index = (struct nk_str_checkpoint*)
+            s->buffer.pool.alloc(s->buffer.pool.userdata, 0,
+                (nk_size)capacity * sizeof(struct nk_str_checkpoint));
+        if (!index) return 0;
+        if (s->index) {
+            NK_MEMCPY(index, s->index, (nk_size)s->index_front * sizeof(*index));
+            NK_MEMCPY(index + capacity - s->index_back,
+                s->index + s->index_capacity - s->index_back,
+                (nk_size)s->index_back * sizeof(*index));
+            s->buffer.pool.free(s->buffer.pool.userdata, s->index);
+        }
+        s->index = index;
+        s->index_capacity = capacity;
+    }
+    s->index[s->index_front++] = cp;
+    return 1;
+}
+NK_INTERN void
+nk_str_index_fill(struct nk_str *s)
+{
+    /* walks the text between the last edit and the next checkpoint behind it
+     * and adds a checkpoint at every line start and every `stride` codepoints.
+     * Has to be called after the string was modified */
+    struct nk_str_checkpoint cp, next;
+    const char *text;
+    int avail = 0;
+    int glyph_len;
+    int runes = 0;
+    int pushed = 1;
+    nk_rune unicode;
+
+    if (!s->index_stride) return;
+    cp = s->index[s->index_front-1];
+    if (s->index_back) {
+        next = nk_str_index_at(s, s->index_front);
+    } else {
+        next.rune = s->len;
+        next.byte = (int)(s->buffer.allocated - s->gap_len);
+        next.line = s->index_lines;
+    }
+
+    text = nk_str_text_at(s, cp.byte, &avail);
+    while (cp.byte < next.byte) {
+        glyph_len = nk_utf_decode(text, &unicode, avail);
+        if (!glyph_len) break;
+        cp.rune++;
+        cp.byte += glyph_len;
+        text += glyph_len;
+        avail -= glyph_len;
+        if (!avail) text = nk_str_text_at(s, cp.byte, &avail);
+        if (unicode == '\n') {
+            /* line starts always get a checkpoint, even at the end of the text */
+            cp.line++;
+            runes = 0;
+            if (cp.byte < next.byte || !s->index_back)
+                pushed = nk_str_index_push(s, cp);
+        } else if (++runes >= s->index_stride && cp.byte < next.byte) {
+            runes = 0;
+            pushed = nk_str_index_push(s, cp);
+        }
+        if (!pushed) break;
+    }
+    if (!pushed) {
+        /* out of memory so the index cannot be trusted anymore */
+        nk_str_index_free(s);
+    }
+}
+NK_INTERN void
+nk_str_index_clear(struct nk_str *s)
+{
+    if (!s->index_stride) return;
+    s->index[0].rune = s->index[0].byte = s->index[0].line = 0;
+    s->index_front = 1;
+    s->index_back = 0;
+    s->index_lines = 0;
+}
+NK_API int
+nk_str_build_index(struct nk_str *s, int stride)
+{
+    struct nk_str_checkpoint cp;
+    const char *text;
+    int offset = 0;
+    int avail = 0;
+
+    NK_ASSERT(s);
+    NK_ASSERT(stride >= 0);
+    if (!s || stride < 0) return 0;
+    if (s->buffer.type != NK_BUFFER_DYNAMIC || !s->buffer.pool.alloc)
+        return 0;
+
+    s->index_front = s->index_back = 0;
+    s->index_stride = 0;
+    cp.rune = cp.byte = cp.line = 0;
+    if (!nk_str_index_push(s, cp)) return 0;
+
+    /* count line breaks so the end of the text is known to `nk_str_index_fill` */
+    s->index_lines = 0;
+    text = nk_str_text_at(s, offset, &avail);
+    while (avail) {
+        s->index_lines += nk_str_count_lines(text, avail);
+        offset += avail;
+        text = nk_str_text_at(s, offset, &avail);
+    }
+    s->index_stride = (stride) ? stride: NK_STR_INDEX_STRIDE;
+    nk_str_index_fill(s);
+    return s->index_stride != 0;
+}
+NK_LIB int
+nk_str_rune_offset(const struct nk_str *s, int pos)
+{
+    /* returns the logical byte offset of codepoint `pos` or -1 if out of
+     * range. Decoding starts at the closest checkpoint of the rune offset
+     * index or the gap, since that is where most lookups are */
+    int offset = 0;
+    int i = 0;
+
+    if (pos < 0) return -1;
+    if (s->index_stride) {
+        struct nk_str_checkpoint cp;
+        cp = nk_str_index_at(s, nk_str_index_find(s, pos));
+        offset = cp.byte;
+        i = cp.rune;
+    }
+    if (s->gap_buffer) {
+        if (pos >= s->gap_rune && s->gap_rune > i) {
+            offset = (int)s->gap_begin;
+            i = s->gap_rune;
+        } else if (pos < s->gap_rune && s->gap_rune - pos < pos - i) {
+            /* closer to the gap so walk backwards */
+            const char *text = (const char*)s->buffer.memory.ptr;
+            offset = (int)s->gap_begin;
+            for (i = s->gap_rune; i > pos; --i)
+                offset -= nk_utf_prev(text, offset);
+            return offset;
+        }
+    }
+    return nk_str_walk(s, offset, pos - i);
+}
+NK_LIB int
+nk_str_line_of(const struct nk_str *s, int pos)
+{
+    /* returns the line of codepoint `pos`. Every line start has a checkpoint
+     * so the line of the closest checkpoint is the line of the codepoint */
+    NK_ASSERT(s->index_stride);
+    if (!s->index_stride || pos < 0) return 0;
+    return nk_str_index_at(s, nk_str_index_find(s, pos)).line;
+}
+NK_LIB int
+nk_str_line_begin(const struct nk_str *s, int line, int *rune)
+{
+    /* returns the byte offset and codepoint index of the beginning of `line`
+     * or -1 if the line does not exist */
+    struct nk_str_checkpoint cp;
+    int lo = 0, hi = s->index_front + s->index_back;
+
+    NK_ASSERT(s->index_stride);
+    NK_ASSERT(rune);
+    if (!s->index_stride || line < 0 || line > s->index_lines) return -1;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (nk_str_index_at(s, mid).line < line)
+            lo = mid + 1;
+        else hi = mid;
+    }
+    cp = nk_str_index_at(s, lo);
+    *rune = cp.rune;
+    return cp.byte;
+}
+NK_LIB int
+nk_str_line_count(const struct nk_str *s)
+{
+    NK_ASSERT(s->index_stride);
+    return s->index_lines + 1;
 }
 NK_API int
 nk_str_append_text_char(struct nk_str *s, const char *str, int len)
@@ -8316,10 +9643,18 @@ nk_str_append_text_char(struct nk_str *s, const char *str, int len)
     NK_ASSERT(s);
     NK_ASSERT(str);
     if (!s || !str || !len) return 0;
+    if (s->gap_buffer) {
+        int text_len = (int)(s->buffer.allocated - s->gap_len);
+        return nk_str_insert_at_char(s, text_len, str, len) ? len: 0;
+    }
+    nk_str_index_split(s, (int)s->buffer.allocated);
     mem = (char*)nk_buffer_alloc(&s->buffer, NK_BUFFER_FRONT, (nk_size)len * sizeof(char), 0);
     if (!mem) return 0;
     NK_MEMCPY(mem, str, (nk_size)len * sizeof(char));
     s->len += nk_utf_len(str, len);
+    if (s->index_stride)
+        s->index_lines += nk_str_count_lines(str, len);
+    nk_str_index_fill(s);
     return len;
 }
 NK_API int
@@ -8401,7 +9736,25 @@ nk_str_insert_at_char(struct nk_str *s, int pos, const char *str, int len)
     NK_ASSERT(s);
     NK_ASSERT(str);
     NK_ASSERT(len >= 0);
-    if (!s || !str || !len || (nk_size)pos > s->buffer.allocated) return 0;
+    if (!s || !str || !len || (nk_size)pos > s->buffer.allocated - s->gap_len) return 0;
+    if (s->gap_buffer) {
+        /* move the gap to the insert position and fill it */
+        int glyphs;
+        if (!nk_str_gap_reserve(s, (nk_size)len)) return 0;
+        nk_str_index_split(s, pos);
+        nk_str_gap_move(s, (nk_size)pos);
+        mem = nk_ptr_add(void, s->buffer.memory.ptr, s->gap_begin);
+        NK_MEMCPY(mem, str, (nk_size)len * sizeof(char));
+        glyphs = nk_utf_len(str, len);
+        s->gap_begin += (nk_size)len;
+        s->gap_len -= (nk_size)len;
+        s->gap_rune += glyphs;
+        s->len += glyphs;
+        if (s->index_stride)
+            s->index_lines += nk_str_count_lines(str, len);
+        nk_str_index_fill(s);
+        return 1;
+    }
     if ((s->buffer.allocated + (nk_size)len >= s->buffer.memory.size) &&
         (s->buffer.type == NK_BUFFER_FIXED)) return 0;
 
@@ -8410,6 +9763,7 @@ nk_str_insert_at_char(struct nk_str *s, int pos, const char *str, int len)
         nk_str_append_text_char(s, str, len);
         return 1;
     }
+    nk_str_index_split(s, pos);
     mem = nk_buffer_alloc(&s->buffer, NK_BUFFER_FRONT, (nk_size)len * sizeof(char), 0);
     if (!mem) return 0;
 
@@ -8422,26 +9776,24 @@ nk_str_insert_at_char(struct nk_str *s, int pos, const char *str, int len)
     mem = nk_ptr_add(void, s->buffer.memory.ptr, pos);
     NK_MEMCPY(mem, str, (nk_size)len * sizeof(char));
     s->len = nk_utf_len((char *)s->buffer.memory.ptr, (int)s->buffer.allocated);
+    if (s->index_stride)
+        s->index_lines += nk_str_count_lines(str, len);
+    nk_str_index_fill(s);
     return 1;
 }
 NK_API int
 nk_str_insert_at_rune(struct nk_str *str, int pos, const char *cstr, int len)
 {
-    int glyph_len;
-    nk_rune unicode;
-    const char *begin;
-    const char *buffer;
-
+    int offset;
     NK_ASSERT(str);
     NK_ASSERT(cstr);
     NK_ASSERT(len);
     if (!str || !cstr || !len) return 0;
-    begin = nk_str_at_rune(str, pos, &unicode, &glyph_len);
     if (!str->len)
         return nk_str_append_text_char(str, cstr, len);
-    buffer = nk_str_get_const(str);
-    if (!begin) return 0;
-    return nk_str_insert_at_char(str, (int)(begin - buffer), cstr, len);
+    offset = nk_str_rune_offset(str, pos);
+    if (offset < 0) return 0;
+    return nk_str_insert_at_char(str, offset, cstr, len);
 }
 NK_API int
 nk_str_insert_text_char(struct nk_str *str, int pos, const char *text, int len)
@@ -8523,57 +9875,76 @@ nk_str_remove_chars(struct nk_str *s, int len)
 {
     NK_ASSERT(s);
     NK_ASSERT(len >= 0);
-    if (!s || len < 0 || (nk_size)len > s->buffer.allocated) return;
+    if (!s || len < 0 || (nk_size)len > s->buffer.allocated - s->gap_len) return;
+    if (s->gap_buffer) {
+        int text_len = (int)(s->buffer.allocated - s->gap_len);
+        nk_str_delete_chars(s, text_len - len, len);
+        return;
+    }
     NK_ASSERT(((int)s->buffer.allocated - (int)len) >= 0);
+    nk_str_index_erase(s, (int)s->buffer.allocated - len, len);
+    if (s->index_stride)
+        s->index_lines -= nk_str_count_lines(nk_ptr_add(char,
+            s->buffer.memory.ptr, s->buffer.allocated - (nk_size)len), len);
     s->buffer.allocated -= (nk_size)len;
     s->len = nk_utf_len((char *)s->buffer.memory.ptr, (int)s->buffer.allocated);
+    nk_str_index_fill(s);
 }
 NK_API void
 nk_str_remove_runes(struct nk_str *str, int len)
 {
-    int index;
-    const char *begin;
-    const char *end;
-    nk_rune unicode;
-
+    int begin;
     NK_ASSERT(str);
     NK_ASSERT(len >= 0);
     if (!str || len < 0) return;
     if (len >= str->len) {
-        str->len = 0;
+        nk_str_clear(str);
         return;
     }
-
-    index = str->len - len;
-    begin = nk_str_at_rune(str, index, &unicode, &len);
-    end = (const char*)str->buffer.memory.ptr + str->buffer.allocated;
-    nk_str_remove_chars(str, (int)(end-begin)+1);
+    begin = nk_str_rune_offset(str, str->len - len);
+    if (begin < 0) return;
+    nk_str_remove_chars(str, (int)(str->buffer.allocated - str->gap_len) - begin);
 }
 NK_API void
 nk_str_delete_chars(struct nk_str *s, int pos, int len)
 {
     NK_ASSERT(s);
-    if (!s || !len || (nk_size)pos > s->buffer.allocated ||
-        (nk_size)(pos + len) > s->buffer.allocated) return;
-
+    if (!s || !len || (nk_size)pos > s->buffer.allocated - s->gap_len ||
+        (nk_size)(pos + len) > s->buffer.allocated - s->gap_len) return;
+
+    nk_str_index_erase(s, pos, len);
+    if (s->gap_buffer) {
+        /* move the gap to the deleted text and grow it over the text */
+        int glyphs;
+        nk_str_gap_move(s, (nk_size)pos);
+        glyphs = nk_utf_len(nk_ptr_add(char, s->buffer.memory.ptr,
+            s->gap_begin + s->gap_len), len);
+        if (s->index_stride)
+            s->index_lines -= nk_str_count_lines(nk_ptr_add(char,
+                s->buffer.memory.ptr, s->gap_begin + s->gap_len), len);
+        s->gap_len += (nk_size)len;
+        s->len -= glyphs;
+        nk_str_index_fill(s);
+        return;
+    }
     if ((nk_size)(pos + len) < s->buffer.allocated) {
         /* memmove */
         char *dst = nk_ptr_add(char, s->buffer.memory.ptr, pos);
         char *src = nk_ptr_add(char, s->buffer.memory.ptr, pos + len);
+        if (s->index_stride)
+            s->index_lines -= nk_str_count_lines(dst, len);
         NK_MEMCPY(dst, src, s->buffer.allocated - (nk_size)(pos + len));
         NK_ASSERT(((int)s->buffer.allocated - (int)len) >= 0);
         s->buffer.allocated -= (nk_size)len;
     } else nk_str_remove_chars(s, len);
     s->len = nk_utf_len((char *)s->buffer.memory.ptr, (int)s->buffer.allocated);
+    nk_str_index_fill(s);
 }
 NK_API void
 nk_str_delete_runes(struct nk_str *s, int pos, int len)
 {
-    char *temp;
-    nk_rune unicode;
-    char *begin;
-    char *end;
-    int unused;
+    int begin;
+    int end;
 
     NK_ASSERT(s);
     NK_ASSERT(s->len >= pos + len);
@@ -8581,73 +9952,41 @@ nk_str_delete_runes(struct nk_str *s, int pos, int len)
         len = NK_CLAMP(0, (s->len - pos), s->len);
     if (!len) return;
 
-    temp = (char *)s->buffer.memory.ptr;
-    begin = nk_str_at_rune(s, pos, &unicode, &unused);
-    if (!begin) return;
-    s->buffer.memory.ptr = begin;
-    end = nk_str_at_rune(s, len, &unicode, &unused);
-    s->buffer.memory.ptr = temp;
-    if (!end) return;
-    nk_str_delete_chars(s, (int)(begin - temp), (int)(end - begin));
+    begin = nk_str_rune_offset(s, pos);
+    if (begin < 0) return;
+    end = nk_str_rune_offset(s, pos + len);
+    if (end < 0) return;
+    nk_str_delete_chars(s, begin, end - begin);
 }
 NK_API char*
 nk_str_at_char(struct nk_str *s, int pos)
 {
     NK_ASSERT(s);
-    if (!s || pos > (int)s->buffer.allocated) return 0;
+    if (!s || pos > (int)(s->buffer.allocated - s->gap_len)) return 0;
+    nk_str_gap_close(s);
     return nk_ptr_add(char, s->buffer.memory.ptr, pos);
 }
 NK_API char*
 nk_str_at_rune(struct nk_str *str, int pos, nk_rune *unicode, int *len)
 {
-    int i = 0;
-    int src_len = 0;
-    int glyph_len = 0;
-    char *text;
-    int text_len;
-
-    NK_ASSERT(str);
-    NK_ASSERT(unicode);
-    NK_ASSERT(len);
-
-    if (!str || !unicode || !len) return 0;
-    if (pos < 0) {
-        *unicode = 0;
-        *len = 0;
-        return 0;
-    }
-
-    text = (char*)str->buffer.memory.ptr;
-    text_len = (int)str->buffer.allocated;
-    glyph_len = nk_utf_decode(text, unicode, text_len);
-    while (glyph_len) {
-        if (i == pos) {
-            *len = glyph_len;
-            break;
-        }
-
-        i++;
-        src_len = src_len + glyph_len;
-        glyph_len = nk_utf_decode(text + src_len, unicode, text_len - src_len);
-    }
-    if (i != pos) return 0;
-    return text + src_len;
+    /* callers read past the returned glyph so the text has to be contiguous */
+    if (str) nk_str_gap_close(str);
+    return (char*)nk_str_at_const(str, pos, unicode, len);
 }
 NK_API const char*
 nk_str_at_char_const(const struct nk_str *s, int pos)
 {
+    int avail;
     NK_ASSERT(s);
-    if (!s || pos > (int)s->buffer.allocated) return 0;
-    return nk_ptr_add(char, s->buffer.memory.ptr, pos);
+    if (!s) return 0;
+    return nk_str_text_at(s, pos, &avail);
 }
 NK_API const char*
 nk_str_at_const(const struct nk_str *str, int pos, nk_rune *unicode, int *len)
 {
-    int i = 0;
-    int src_len = 0;
-    int glyph_len = 0;
-    char *text;
-    int text_len;
+    int offset;
+    int avail;
+    const char *text;
 
     NK_ASSERT(str);
     NK_ASSERT(unicode);
@@ -8660,28 +9999,26 @@ nk_str_at_const(const struct nk_str *str, int pos, nk_rune *unicode, int *len)
         return 0;
     }
 
-    text = (char*)str->buffer.memory.ptr;
-    text_len = (int)str->buffer.allocated;
-    glyph_len = nk_utf_decode(text, unicode, text_len);
-    while (glyph_len) {
-        if (i == pos) {
-            *len = glyph_len;
-            break;
-        }
-
-        i++;
-        src_len = src_len + glyph_len;
-        glyph_len = nk_utf_decode(text + src_len, unicode, text_len - src_len);
-    }
-    if (i != pos) return 0;
-    return text + src_len;
+    offset = nk_str_rune_offset(str, pos);
+    if (offset < 0) return 0;
+    text = nk_str_text_at(str, offset, &avail);
+    *len = nk_utf_decode(text, unicode, avail);
+    return text;
 }
 NK_API nk_rune
 nk_str_rune_at(const struct nk_str *str, int pos)
 {
-    int len;
+    int avail;
+    int offset;
+    const char *text;
     nk_rune unicode = 0;
-    nk_str_at_const(str, pos, &unicode, &len);
+
+    NK_ASSERT(str);
+    if (!str) return 0;
+    offset = nk_str_rune_offset(str, pos);
+    if (offset < 0) return 0;
+    text = nk_str_text_at(str, offset, &avail);
+    nk_utf_decode(text, &unicode, avail);
     return unicode;
 }
 NK_API char*
@@ -8689,14 +10026,16 @@ nk_str_get(struct nk_str *s)
 {
     NK_ASSERT(s);
     if (!s || !s->len || !s->buffer.allocated) return 0;
+    nk_str_gap_close(s);
     return (char*)s->buffer.memory.ptr;
 }
 NK_API const char*
 nk_str_get_const(const struct nk_str *s)
 {
+    int avail;
     NK_ASSERT(s);
     if (!s || !s->len || !s->buffer.allocated) return 0;
-    return (const char*)s->buffer.memory.ptr;
+    return nk_str_text_at(s, 0, &avail);
 }
 NK_API int
 nk_str_len(struct nk_str *s)
@@ -8710,7 +10049,7 @@ nk_str_len_char(struct nk_str *s)
 {
     NK_ASSERT(s);
     if (!s || !s->len || !s->buffer.allocated) return 0;
-    return (int)s->buffer.allocated;
+    return (int)(s->buffer.allocated - s->gap_len);
 }
 NK_API void
 nk_str_clear(struct nk_str *str)
@@ -8718,13 +10057,19 @@ nk_str_clear(struct nk_str *str)
     NK_ASSERT(str);
     nk_buffer_clear(&str->buffer);
     str->len = 0;
+    str->gap_begin = str->gap_len = 0;
+    str->gap_rune = 0;
+    nk_str_index_clear(str);
 }
 NK_API void
 nk_str_free(struct nk_str *str)
 {
     NK_ASSERT(str);
+    nk_str_index_free(str);
     nk_buffer_free(&str->buffer);
     str->len = 0;
+    str->gap_begin = str->gap_len = 0;
+    str->gap_rune = 0;
 }
 
 
@@ -12898,8 +14243,8 @@ nk_font_bake(struct nk_font_baker *baker, void *image_memory, int width, int hei
                 dst_font->ascent = ((float)unscaled_ascent * font_scale);
                 dst_font->descent = ((float)unscaled_descent * font_scale);
                 dst_font->glyph_offset = glyph_n;
-                // Need to zero this, or it will carry over from a previous
-                // bake, and cause a segfault when accessing glyphs[].
+                /* Need to zero this, or it will carry over from a previous
+                 * bake, and cause a segfault when accessing glyphs[]. */
                 dst_font->glyph_count = 0;
             }
 
@@ -13964,10 +15309,26 @@ nk_input_begin(struct nk_context *ctx)
 NK_API void
 nk_input_end(struct nk_context *ctx)
 {
+    int i;
     struct nk_input *in;
     NK_ASSERT(ctx);
     if (!ctx) return;
     in = &ctx->input;
+
+    /* input whose effects can show up one frame late, or held buttons
+     * which drive repeating buttons and drags, keep frames coming */
+    ctx->redraw.input = in->keyboard.text_len > 0 ||
+        in->mouse.scroll_delta.x != 0 || in->mouse.scroll_delta.y != 0;
+    for (i = 0; i < NK_BUTTON_MAX; ++i)
+        if (in->mouse.buttons[i].clicked || in->mouse.buttons[i].down)
+            ctx->redraw.input = nk_true;
+    for (i = 0; i < NK_KEY_MAX; ++i)
+        if (in->keyboard.keys[i].clicked)
+            ctx->redraw.input = nk_true;
+    if (ctx->record.buffer) {
+        nk_record_input(ctx, NK_RECORD_POSITION, (int)in->mouse.pos.x, (int)in->mouse.pos.y, 0);
+        nk_record_floats(ctx, NK_RECORD_END, ctx->delta_time_seconds, 0);
+    }
     if (in->mouse.grab)
         in->mouse.grab = 0;
     if (in->mouse.ungrab) {
@@ -13983,6 +15344,8 @@ nk_input_motion(struct nk_context *ctx, int x, int y)
     NK_ASSERT(ctx);
     if (!ctx) return;
     in = &ctx->input;
+    if (ctx->record.buffer)
+        nk_record_input(ctx, NK_RECORD_MOTION, x, y, 0);
     in->mouse.pos.x = (float)x;
     in->mouse.pos.y = (float)y;
     in->mouse.delta.x = in->mouse.pos.x - in->mouse.prev.x;
@@ -13996,12 +15359,14 @@ nk_input_key(struct nk_context *ctx, enum nk_keys key, int down)
     if (!ctx) return;
     in = &ctx->input;
 #ifdef NK_KEYSTATE_BASED_INPUT
-    if (in->keyboard.keys[key].down != down)
-        in->keyboard.keys[key].clicked++;
+    if (in->keyboard.keys[key].down == down) return;
+    in->keyboard.keys[key].clicked++;
 #else
     in->keyboard.keys[key].clicked++;
 #endif
     in->keyboard.keys[key].down = down;
+    if (ctx->record.buffer)
+        nk_record_input(ctx, NK_RECORD_KEY, (int)key | (down ? 0x80: 0), 0, 0);
 }
 NK_API void
 nk_input_button(struct nk_context *ctx, enum nk_buttons id, int x, int y, int down)
@@ -14018,12 +15383,16 @@ nk_input_button(struct nk_context *ctx, enum nk_buttons id, int x, int y, int do
     btn->clicked_pos.y = (float)y;
     btn->down = down;
     btn->clicked++;
+    if (ctx->record.buffer)
+        nk_record_input(ctx, NK_RECORD_BUTTON, (int)id | (down ? 0x80: 0), x, y);
 }
 NK_API void
 nk_input_scroll(struct nk_context *ctx, struct nk_vec2 val)
 {
     NK_ASSERT(ctx);
     if (!ctx) return;
+    if (ctx->record.buffer)
+        nk_record_floats(ctx, NK_RECORD_SCROLL, val.x, val.y);
     ctx->input.mouse.scroll_delta.x += val.x;
     ctx->input.mouse.scroll_delta.y += val.y;
 }
@@ -14039,6 +15408,8 @@ nk_input_glyph(struct nk_context *ctx, const nk_glyph glyph)
     in = &ctx->input;
 
     len = nk_utf_decode(glyph, &unicode, NK_UTF_SIZE);
+    if (len && ctx->record.buffer)
+        nk_record_input(ctx, NK_RECORD_UNICODE, (int)unicode, 0, 0);
     if (len && ((in->keyboard.text_len + len) < NK_INPUT_MAX)) {
         nk_utf_encode(unicode, &in->keyboard.text[in->keyboard.text_len],
             NK_INPUT_MAX - in->keyboard.text_len);
@@ -14194,6 +15565,290 @@ nk_input_is_key_down(const struct nk_input *i, enum nk_keys key)
 
 
 
+/* ===============================================================
+ *
+ *                          RECORD
+ *
+ * ===============================================================*/
+/* A recording starts with a four byte magic followed by one opcode byte
+ * per input call. Coordinates are zigzag varints relative to the last
+ * recorded mouse position, floats and hashes are little endian words.
+ * Surface sizes are stored as NK_RECORD_RESIZE with two unsigned varints.
+ * The input of every frame ends with NK_RECORD_POSITION if the mouse
+ * position was changed outside of `nk_input_motion`, then NK_RECORD_END and,
+ * if the frame was cleared, NK_RECORD_HASH with `nk_frame_hash` of it. */
+NK_GLOBAL const char nk_record_magic[4] = {'N','K','R','1'};
+
+NK_INTERN int
+nk_record_uint(nk_byte *out, nk_uint v)
+{
+    int n = 0;
+    while (v >= 0x80) {
+        out[n++] = (nk_byte)(v | 0x80);
+        v >>= 7;
+    }
+    out[n++] = (nk_byte)v;
+    return n;
+}
+NK_INTERN int
+nk_record_int(nk_byte *out, int v)
+{
+    nk_uint u = (v < 0) ? ((~(nk_uint)v) << 1) | 1: (nk_uint)v << 1;
+    return nk_record_uint(out, u);
+}
+NK_INTERN int
+nk_record_word(nk_byte *out, nk_uint v)
+{
+    out[0] = (nk_byte)v;
+    out[1] = (nk_byte)(v >> 8);
+    out[2] = (nk_byte)(v >> 16);
+    out[3] = (nk_byte)(v >> 24);
+    return 4;
+}
+NK_INTERN int
+nk_record_float(nk_byte *out, float f)
+{
+    nk_uint u;
+    NK_MEMCPY(&u, &f, sizeof(u));
+    return nk_record_word(out, u);
+}
+NK_API int
+nk_record_begin(struct nk_context *ctx, struct nk_buffer *out)
+{
+    NK_ASSERT(ctx);
+    NK_ASSERT(out);
+    if (!ctx || !out || ctx->record.buffer) return 0;
+    ctx->record.buffer = out;
+    ctx->record.x = ctx->record.y = 0;
+    nk_buffer_push(out, NK_BUFFER_FRONT, nk_record_magic, sizeof(nk_record_magic), 1);
+    return 1;
+}
+NK_API void
+nk_record_end(struct nk_context *ctx)
+{
+    NK_ASSERT(ctx);
+    if (!ctx) return;
+    ctx->record.buffer = 0;
+}
+NK_API void
+nk_record_resize(struct nk_context *ctx, int width, int height)
+{
+    nk_byte data[11];
+    int n = 0;
+    NK_ASSERT(ctx);
+    if (!ctx || !ctx->record.buffer) return;
+    data[n++] = NK_RECORD_RESIZE;
+    n += nk_record_uint(data + n, (nk_uint)NK_MAX(width, 0));
+    n += nk_record_uint(data + n, (nk_uint)NK_MAX(height, 0));
+    nk_buffer_push(ctx->record.buffer, NK_BUFFER_FRONT, data, (nk_size)n, 1);
+}
+NK_LIB void
+nk_record_input(struct nk_context *ctx, enum nk_record_op op, int a, int b, int c)
+{
+    struct nk_record *r = &ctx->record;
+    nk_byte data[16];
+    int n = 0;
+
+    data[n++] = (nk_byte)op;
+    switch (op) {
+    case NK_RECORD_POSITION:
+        if (a == r->x && b == r->y) return;
+        /* fallthrough */
+    case NK_RECORD_MOTION:
+        n += nk_record_int(data + n, a - r->x);
+        n += nk_record_int(data + n, b - r->y);
+        r->x = a; r->y = b;
+        break;
+    case NK_RECORD_BUTTON:
+        /* button and key states are stored in the top bit */
+        data[n++] = (nk_byte)a;
+        n += nk_record_int(data + n, b - r->x);
+        n += nk_record_int(data + n, c - r->y);
+        break;
+    case NK_RECORD_KEY:
+        data[n++] = (nk_byte)a;
+        break;
+    case NK_RECORD_UNICODE:
+        n += nk_record_uint(data + n, (nk_uint)a);
+        break;
+    default: return;
+    }
+    nk_buffer_push(r->buffer, NK_BUFFER_FRONT, data, (nk_size)n, 1);
+}
+NK_LIB void
+nk_record_floats(struct nk_context *ctx, enum nk_record_op op, float a, float b)
+{
+    nk_byte data[9];
+    int n = 0;
+    data[n++] = (nk_byte)op;
+    n += nk_record_float(data + n, a);
+    if (op == NK_RECORD_SCROLL)
+        n += nk_record_float(data + n, b);
+    nk_buffer_push(ctx->record.buffer, NK_BUFFER_FRONT, data, (nk_size)n, 1);
+}
+NK_LIB void
+nk_record_hash(struct nk_context *ctx)
+{
+    nk_byte data[5];
+    data[0] = NK_RECORD_HASH;
+    nk_record_word(data + 1, nk_frame_hash(ctx));
+    nk_buffer_push(ctx->record.buffer, NK_BUFFER_FRONT, data, sizeof(data), 1);
+}
+
+/* ===============================================================
+ *
+ *                          REPLAY
+ *
+ * ===============================================================*/
+NK_INTERN int
+nk_replay_byte(struct nk_replay *r, nk_uint *v)
+{
+    if (r->offset >= r->size) return 0;
+    *v = r->data[r->offset++];
+    return 1;
+}
+NK_INTERN int
+nk_replay_uint(struct nk_replay *r, nk_uint *v)
+{
+    nk_uint b;
+    int shift = 0;
+    *v = 0;
+    do {
+        if (shift > 28 || !nk_replay_byte(r, &b)) return 0;
+        *v |= (b & 0x7F) << shift;
+        shift += 7;
+    } while (b & 0x80);
+    return 1;
+}
+NK_INTERN int
+nk_replay_int(struct nk_replay *r, int *v)
+{
+    nk_uint u;
+    if (!nk_replay_uint(r, &u)) return 0;
+    *v = (u & 1) ? (int)~(u >> 1): (int)(u >> 1);
+    return 1;
+}
+NK_INTERN int
+nk_replay_word(struct nk_replay *r, nk_uint *v)
+{
+    const nk_byte *p;
+    if (r->size - r->offset < 4) return 0;
+    p = r->data + r->offset;
+    *v = (nk_uint)p[0] | (nk_uint)p[1] << 8 | (nk_uint)p[2] << 16 | (nk_uint)p[3] << 24;
+    r->offset += 4;
+    return 1;
+}
+NK_INTERN int
+nk_replay_float(struct nk_replay *r, float *f)
+{
+    nk_uint u;
+    if (!nk_replay_word(r, &u)) return 0;
+    NK_MEMCPY(f, &u, sizeof(*f));
+    return 1;
+}
+NK_API int
+nk_replay_init(struct nk_replay *r, const void *memory, nk_size size)
+{
+    int i;
+    NK_ASSERT(r);
+    NK_ASSERT(memory);
+    if (!r || !memory) return 0;
+    nk_zero(r, sizeof(*r));
+    if (size < sizeof(nk_record_magic)) return 0;
+    for (i = 0; i < (int)sizeof(nk_record_magic); ++i)
+        if (((const char*)memory)[i] != nk_record_magic[i]) return 0;
+    r->data = (const nk_byte*)memory;
+    r->size = size;
+    r->offset = sizeof(nk_record_magic);
+    return 1;
+}
+NK_API int
+nk_replay_frame(struct nk_context *ctx, struct nk_replay *r)
+{
+    nk_uint op, v, h;
+    int x, y;
+    float fx, fy;
+
+    NK_ASSERT(ctx);
+    NK_ASSERT(r);
+    if (!ctx || !r || !r->data || r->offset >= r->size)
+        return 0;
+
+    nk_input_begin(ctx);
+    r->has_hash = nk_false;
+    r->resized = nk_false;
+    while (nk_replay_byte(r, &op)) {
+        switch (op) {
+        case NK_RECORD_MOTION:
+            if (!nk_replay_int(r, &x) || !nk_replay_int(r, &y)) goto corrupt;
+            r->x += x; r->y += y;
+            nk_input_motion(ctx, r->x, r->y);
+            break;
+        case NK_RECORD_BUTTON:
+            if (!nk_replay_byte(r, &v) || !nk_replay_int(r, &x) || !nk_replay_int(r, &y) ||
+                (v & 0x7F) >= NK_BUTTON_MAX) goto corrupt;
+            nk_input_button(ctx, (enum nk_buttons)(v & 0x7F), r->x + x, r->y + y, (v & 0x80) != 0);
+            break;
+        case NK_RECORD_KEY:
+            if (!nk_replay_byte(r, &v) || (v & 0x7F) >= NK_KEY_MAX) goto corrupt;
+            nk_input_key(ctx, (enum nk_keys)(v & 0x7F), (v & 0x80) != 0);
+            break;
+        case NK_RECORD_UNICODE:
+            if (!nk_replay_uint(r, &v)) goto corrupt;
+            nk_input_unicode(ctx, (nk_rune)v);
+            break;
+        case NK_RECORD_SCROLL:
+            if (!nk_replay_float(r, &fx) || !nk_replay_float(r, &fy)) goto corrupt;
+            nk_input_scroll(ctx, nk_vec2(fx, fy));
+            break;
+        case NK_RECORD_POSITION:
+            /* moves the cursor but keeps the motion delta of the frame */
+            if (!nk_replay_int(r, &x) || !nk_replay_int(r, &y)) goto corrupt;
+            r->x += x; r->y += y;
+            ctx->input.mouse.pos.x = (float)r->x;
+            ctx->input.mouse.pos.y = (float)r->y;
+            break;
+        case NK_RECORD_RESIZE:
+            if (!nk_replay_uint(r, &v) || !nk_replay_uint(r, &h)) goto corrupt;
+            r->width = (int)v;
+            r->height = (int)h;
+            r->resized = nk_true;
+            break;
+        case NK_RECORD_HASH:
+            /* frames cleared without input in between */
+            if (!nk_replay_word(r, &v)) goto corrupt;
+            break;
+        case NK_RECORD_END:
+            if (!nk_replay_float(r, &ctx->delta_time_seconds)) goto corrupt;
+            nk_input_end(ctx);
+            /* the hash of the recorded frame follows its input */
+            if (r->offset < r->size && r->data[r->offset] == NK_RECORD_HASH) {
+                r->offset++;
+                if (!nk_replay_word(r, &r->hash)) goto corrupt;
+                r->has_hash = nk_true;
+            }
+            r->frame++;
+            return 1;
+        default: goto corrupt;
+        }
+    }
+corrupt:
+    nk_input_end(ctx);
+    r->offset = r->size;
+    return 0;
+}
+NK_API int
+nk_replay_check(struct nk_context *ctx, const struct nk_replay *r)
+{
+    NK_ASSERT(ctx);
+    NK_ASSERT(r);
+    if (!ctx || !r) return 0;
+    return !r->has_hash || nk_frame_hash(ctx) == r->hash;
+}
+
+
+
+
 /* ===============================================================
  *
  *                              STYLE
@@ -15073,6 +16728,9 @@ nk_clear(struct nk_context *ctx)
     NK_ASSERT(ctx);
 
     if (!ctx) return;
+    if (ctx->record.buffer)
+        nk_record_hash(ctx);
+    nk_redraw_finish(ctx);
     if (ctx->use_pool)
         nk_buffer_clear(&ctx->memory);
     else nk_buffer_reset(&ctx->memory, NK_BUFFER_FRONT);
@@ -15274,11 +16932,12 @@ nk__begin(struct nk_context *ctx)
     if (!ctx) return 0;
     if (!ctx->count) return 0;
 
-    buffer = (nk_byte*)ctx->memory.memory.ptr;
     if (!ctx->build) {
         nk_build(ctx);
         ctx->build = nk_true;
     }
+    /* the cursor overlay drawn by nk_build can grow the buffer */
+    buffer = (nk_byte*)ctx->memory.memory.ptr;
     iter = ctx->begin;
     while (iter && ((iter->buffer.begin == iter->buffer.end) ||
         (iter->flags & NK_WINDOW_HIDDEN) || iter->seq != ctx->seq))
@@ -15305,6 +16964,144 @@ nk__next(struct nk_context *ctx, const struct nk_command *cmd)
 
 
 
+/* ===============================================================
+ *
+ *                          REDRAW
+ *
+ * ===============================================================*/
+#define NK_HASH_FIELDS(seed, type, cmd, first, last) \
+    seed = nk_murmur_hash(&((const type*)(cmd))->first, (int)((const nk_byte*)\
+        (&((const type*)(cmd))->last + 1) - (const nk_byte*)&((const type*)(cmd))->first), seed)
+
+NK_INTERN nk_hash
+nk_command_hash(const struct nk_command *cmd, nk_hash hash)
+{
+    /* only draw relevant fields are hashed, since commands are not zeroed
+     * and pointers differ between runs of the same program */
+    int type = (int)cmd->type;
+    hash = nk_murmur_hash(&type, (int)sizeof(type), hash);
+    switch (cmd->type) {
+    case NK_COMMAND_NOP: break;
+    case NK_COMMAND_SCISSOR:
+        NK_HASH_FIELDS(hash, struct nk_command_scissor, cmd, x, h); break;
+    case NK_COMMAND_LINE:
+        NK_HASH_FIELDS(hash, struct nk_command_line, cmd, line_thickness, color); break;
+    case NK_COMMAND_CURVE:
+        NK_HASH_FIELDS(hash, struct nk_command_curve, cmd, line_thickness, color); break;
+    case NK_COMMAND_RECT:
+        NK_HASH_FIELDS(hash, struct nk_command_rect, cmd, rounding, color); break;
+    case NK_COMMAND_RECT_FILLED:
+        NK_HASH_FIELDS(hash, struct nk_command_rect_filled, cmd, rounding, color); break;
+    case NK_COMMAND_RECT_MULTI_COLOR:
+        NK_HASH_FIELDS(hash, struct nk_command_rect_multi_color, cmd, x, right); break;
+    case NK_COMMAND_CIRCLE:
+        NK_HASH_FIELDS(hash, struct nk_command_circle, cmd, x, color); break;
+    case NK_COMMAND_CIRCLE_FILLED:
+        NK_HASH_FIELDS(hash, struct nk_command_circle_filled, cmd, x, color); break;
+    case NK_COMMAND_ARC:
+        NK_HASH_FIELDS(hash, struct nk_command_arc, cmd, cx, color); break;
+    case NK_COMMAND_ARC_FILLED:
+        NK_HASH_FIELDS(hash, struct nk_command_arc_filled, cmd, cx, r);
+        NK_HASH_FIELDS(hash, struct nk_command_arc_filled, cmd, a, color); break;
+    case NK_COMMAND_TRIANGLE:
+        NK_HASH_FIELDS(hash, struct nk_command_triangle, cmd, line_thickness, color); break;
+    case NK_COMMAND_TRIANGLE_FILLED:
+        NK_HASH_FIELDS(hash, struct nk_command_triangle_filled, cmd, a, color); break;
+    case NK_COMMAND_POLYGON: {
+        const struct nk_command_polygon *p = (const struct nk_command_polygon*)cmd;
+        NK_HASH_FIELDS(hash, struct nk_command_polygon, cmd, color, point_count);
+        hash = nk_murmur_hash(p->points, (int)(p->point_count * sizeof(p->points[0])), hash);
+    } break;
+    case NK_COMMAND_POLYGON_FILLED: {
+        const struct nk_command_polygon_filled *p = (const struct nk_command_polygon_filled*)cmd;
+        NK_HASH_FIELDS(hash, struct nk_command_polygon_filled, cmd, color, point_count);
+        hash = nk_murmur_hash(p->points, (int)(p->point_count * sizeof(p->points[0])), hash);
+    } break;
+    case NK_COMMAND_POLYLINE: {
+        const struct nk_command_polyline *p = (const struct nk_command_polyline*)cmd;
+        NK_HASH_FIELDS(hash, struct nk_command_polyline, cmd, color, point_count);
+        hash = nk_murmur_hash(p->points, (int)(p->point_count * sizeof(p->points[0])), hash);
+    } break;
+    case NK_COMMAND_TEXT: {
+        const struct nk_command_text *t = (const struct nk_command_text*)cmd;
+        NK_HASH_FIELDS(hash, struct nk_command_text, cmd, background, length);
+        hash = nk_murmur_hash(t->string, t->length, hash);
+    } break;
+    case NK_COMMAND_IMAGE:
+        NK_HASH_FIELDS(hash, struct nk_command_image, cmd, x, h);
+        NK_HASH_FIELDS(hash, struct nk_command_image, cmd, img.w, img.region);
+        NK_HASH_FIELDS(hash, struct nk_command_image, cmd, col, col); break;
+    case NK_COMMAND_CUSTOM:
+        NK_HASH_FIELDS(hash, struct nk_command_custom, cmd, x, h); break;
+    default: break;
+    }
+    return hash;
+}
+#undef NK_HASH_FIELDS
+NK_API nk_hash
+nk_frame_hash(struct nk_context *ctx)
+{
+    const struct nk_command *cmd;
+    nk_hash h = 0;
+    NK_ASSERT(ctx);
+    if (!ctx) return 0;
+    nk_foreach(cmd, ctx)
+        h = nk_command_hash(cmd, h);
+    return h;
+}
+NK_API void
+nk_request_redraw(struct nk_context *ctx, float seconds)
+{
+    struct nk_redraw *r;
+    NK_ASSERT(ctx);
+    if (!ctx) return;
+    r = &ctx->redraw;
+    seconds = NK_MAX(seconds, 0);
+    if (!r->requested || seconds < r->request)
+        r->request = seconds;
+    r->requested = nk_true;
+}
+NK_API int
+nk_needs_redraw(struct nk_context *ctx)
+{
+    NK_ASSERT(ctx);
+    if (!ctx) return nk_true;
+    if (!ctx->redraw.enabled) {
+        /* nothing is known about the frame before tracking started */
+        ctx->redraw.enabled = nk_true;
+        return nk_true;
+    }
+    return ctx->redraw.needed;
+}
+NK_API float
+nk_redraw_deadline(const struct nk_context *ctx)
+{
+    NK_ASSERT(ctx);
+    if (!ctx || !ctx->redraw.enabled || ctx->redraw.needed)
+        return 0;
+    return ctx->redraw.deadline;
+}
+NK_LIB void
+nk_redraw_finish(struct nk_context *ctx)
+{
+    struct nk_redraw *r = &ctx->redraw;
+    nk_hash frame;
+    if (r->enabled) {
+        /* a frame that looks different from the one before can still be
+         * settling, so it is always followed by another frame */
+        frame = nk_frame_hash(ctx);
+        r->needed = r->input || frame != r->frame ||
+            (r->requested && r->request <= 0);
+        r->frame = frame;
+    }
+    r->deadline = r->requested ? r->request: -1.0f;
+    r->requested = nk_false;
+    r->request = 0;
+}
+
+
+
+
 /* ===============================================================
  *
  *                              POOL
@@ -15997,6 +17794,8 @@ nk_panel_end(struct nk_context *ctx)
         if ((!has_input && is_window_hovered) || (!is_window_hovered && !any_item_active))
             window->scrollbar_hiding_timer += ctx->delta_time_seconds;
         else window->scrollbar_hiding_timer = 0;
+        if (window->scrollbar_hiding_timer < NK_SCROLLBAR_HIDING_TIMEOUT)
+            nk_request_redraw(ctx, NK_SCROLLBAR_HIDING_TIMEOUT - window->scrollbar_hiding_timer);
     } else window->scrollbar_hiding_timer = 0;
 
     /* window border */
@@ -18792,6 +20591,14 @@ nk_group_scrolled_end(struct nk_context *ctx)
     nk_unify(&clip, &parent->clip, pan.bounds.x, pan.bounds.y,
         pan.bounds.x + pan.bounds.w, pan.bounds.y + pan.bounds.h + panel_padding.x);
     nk_push_scissor(&pan.buffer, clip);
+
+    /* remember the height needed to show the whole content */
+    if (g->content_height) {
+        float height = g->at_y + g->row.height - pan.bounds.y + g->footer_height;
+        if (g->flags & NK_WINDOW_BORDER)
+            height += g->border;
+        *g->content_height = (nk_uint)nk_iceilf(NK_MAX(height, 0));
+    }
     nk_end(ctx);
 
     win->buffer = pan.buffer;
@@ -18850,6 +20657,56 @@ nk_group_end(struct nk_context *ctx)
 {
     nk_group_scrolled_end(ctx);
 }
+NK_INTERN nk_uint*
+nk_group_content_value(struct nk_context *ctx, const char *id)
+{
+    /* content height is kept next to the group scrollbar offsets */
+    nk_hash id_hash;
+    nk_uint *height;
+    struct nk_window *win = ctx->current;
+    id_hash = nk_murmur_hash(id, nk_strlen(id), NK_PANEL_GROUP);
+    height = nk_find_value(win, id_hash+2);
+    if (!height) {
+        height = nk_add_value(ctx, win, id_hash+2, 0);
+        if (height) *height = 0;
+    }
+    return height;
+}
+NK_API int
+nk_group_begin_lazy(struct nk_context *ctx, const char *title, nk_flags flags,
+    float *content_height)
+{
+    nk_uint *height;
+    NK_ASSERT(ctx);
+    NK_ASSERT(title);
+    NK_ASSERT(ctx->current);
+    NK_ASSERT(ctx->current->layout);
+    if (content_height) *content_height = 0;
+    if (!ctx || !ctx->current || !ctx->current->layout || !title)
+        return 0;
+
+    height = nk_group_content_value(ctx, title);
+    if (height && content_height)
+        *content_height = (float)*height;
+
+    /* minimized and closed groups have already been ended */
+    if (nk_group_begin_titled(ctx, title, title, flags) != 1)
+        return 0;
+    ctx->current->layout->content_height = height;
+    return 1;
+}
+NK_API float
+nk_group_get_content_height(struct nk_context *ctx, const char *id)
+{
+    nk_uint *height;
+    NK_ASSERT(ctx);
+    NK_ASSERT(id);
+    NK_ASSERT(ctx->current);
+    if (!ctx || !ctx->current || !ctx->current->layout || !id)
+        return 0;
+    height = nk_group_content_value(ctx, id);
+    return height ? (float)*height: 0;
+}
 NK_API void
 nk_group_get_scroll(struct nk_context *ctx, const char *id, nk_uint *x_offset, nk_uint *y_offset)
 {
@@ -18927,32 +20784,18 @@ nk_group_set_scroll(struct nk_context *ctx, const char *id, nk_uint x_offset, nk
  *                          LIST VIEW
  *
  * ===============================================================*/
-NK_API int
-nk_list_view_begin(struct nk_context *ctx, struct nk_list_view *view,
-    const char *title, nk_flags flags, int row_height, int row_count)
+NK_INTERN int
+nk_list_view_scroll_begin(struct nk_context *ctx, struct nk_list_view *view,
+    const char *title, nk_flags flags)
 {
     int title_len;
     nk_hash title_hash;
     nk_uint *x_offset;
     nk_uint *y_offset;
-
-    int result;
     struct nk_window *win;
-    struct nk_panel *layout;
-    const struct nk_style *style;
-    struct nk_vec2 item_spacing;
-
-    NK_ASSERT(ctx);
-    NK_ASSERT(view);
-    NK_ASSERT(title);
-    if (!ctx || !view || !title) return 0;
-
-    win = ctx->current;
-    style = &ctx->style;
-    item_spacing = style->window.spacing;
-    row_height += NK_MAX(0, (int)item_spacing.y);
 
     /* find persistent list view scrollbar offset */
+    win = ctx->current;
     title_len = (int)nk_strlen(title);
     title_hash = nk_murmur_hash(title, (int)title_len, NK_PANEL_GROUP);
     x_offset = nk_find_value(win, title_hash);
@@ -18969,7 +20812,29 @@ nk_list_view_begin(struct nk_context *ctx, struct nk_list_view *view,
     view->scroll_pointer = y_offset;
 
     *y_offset = 0;
-    result = nk_group_scrolled_offset_begin(ctx, x_offset, y_offset, title, flags);
+    view->ctx = ctx;
+    return nk_group_scrolled_offset_begin(ctx, x_offset, y_offset, title, flags);
+}
+NK_API int
+nk_list_view_begin(struct nk_context *ctx, struct nk_list_view *view,
+    const char *title, nk_flags flags, int row_height, int row_count)
+{
+    int result;
+    struct nk_window *win;
+    struct nk_panel *layout;
+    const struct nk_style *style;
+    struct nk_vec2 item_spacing;
+
+    NK_ASSERT(ctx);
+    NK_ASSERT(view);
+    NK_ASSERT(title);
+    if (!ctx || !view || !title) return 0;
+
+    style = &ctx->style;
+    item_spacing = style->window.spacing;
+    row_height += NK_MAX(0, (int)item_spacing.y);
+
+    result = nk_list_view_scroll_begin(ctx, view, title, flags);
     win = ctx->current;
     layout = win->layout;
 
@@ -18981,6 +20846,65 @@ nk_list_view_begin(struct nk_context *ctx, struct nk_list_view *view,
     view->ctx = ctx;
     return result;
 }
+NK_INTERN int
+nk_row_heights_search(const struct nk_row_heights *heights, int offset, int spacing)
+{
+    /* returns the row at `offset` if every row is followed by `spacing`
+     * pixels by descending the Fenwick tree, since each node covers a
+     * power of two number of rows the spacing can be added per node */
+    int row = 0;
+    int mask = 1;
+    if (!heights->count || offset < 0) return 0;
+    while (mask <= heights->count / 2) mask <<= 1;
+    for (; mask; mask >>= 1) {
+        int next = row + mask;
+        int height;
+        if (next > heights->count) continue;
+        height = heights->tree[next] + mask * spacing;
+        if (height <= offset) {
+            row = next;
+            offset -= height;
+        }
+    }
+    return NK_MIN(row, heights->count - 1);
+}
+NK_API int
+nk_list_view_begin_variable(struct nk_context *ctx, struct nk_list_view *view,
+    const char *title, nk_flags flags, const struct nk_row_heights *heights)
+{
+    int result;
+    int spacing;
+    int top, bottom, last;
+    struct nk_window *win;
+    struct nk_panel *layout;
+
+    NK_ASSERT(ctx);
+    NK_ASSERT(view);
+    NK_ASSERT(title);
+    NK_ASSERT(heights);
+    if (!ctx || !view || !title || !heights) return 0;
+
+    spacing = NK_MAX(0, (int)ctx->style.window.spacing.y);
+    result = nk_list_view_scroll_begin(ctx, view, title, flags);
+    win = ctx->current;
+    layout = win->layout;
+
+    view->total_height = nk_row_heights_offset(heights, heights->count) +
+        heights->count * spacing;
+    view->begin = view->end = view->count = 0;
+    if (heights->count) {
+        /* move the first row up by the part that is scrolled out of view */
+        view->begin = nk_row_heights_search(heights, (int)view->scroll_value, spacing);
+        top = nk_row_heights_offset(heights, view->begin) + view->begin * spacing;
+        bottom = (int)view->scroll_value + nk_iceilf(layout->clip.h);
+        last = nk_row_heights_search(heights, NK_MAX(bottom - 1, 0), spacing);
+        view->count = NK_MAX(last - view->begin + 1, 0);
+        view->end = view->begin + view->count;
+        if (result)
+            layout->at_y -= (float)NK_MAX((int)view->scroll_value - top, 0);
+    }
+    return result;
+}
 NK_API void
 nk_list_view_end(struct nk_list_view *view)
 {
@@ -19001,16 +20925,918 @@ nk_list_view_end(struct nk_list_view *view)
     nk_group_end(view->ctx);
 }
 
-
-
-
-
 /* ===============================================================
  *
- *                              WIDGET
+ *                          ROW HEIGHTS
  *
  * ===============================================================*/
-NK_API struct nk_rect
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+NK_API void
+nk_row_heights_init_default(struct nk_row_heights *heights)
+{
+    struct nk_allocator alloc;
+    alloc.userdata.ptr = 0;
+    alloc.alloc = nk_malloc;
+    alloc.free = nk_mfree;
+    nk_row_heights_init(heights, &alloc);
+}
+#endif
+NK_API void
+nk_row_heights_init(struct nk_row_heights *heights, const struct nk_allocator *alloc)
+{
+    NK_ASSERT(heights);
+    NK_ASSERT(alloc);
+    if (!heights || !alloc) return;
+    NK_MEMSET(heights, 0, sizeof(*heights));
+    heights->pool = *alloc;
+}
+NK_API void
+nk_row_heights_free(struct nk_row_heights *heights)
+{
+    NK_ASSERT(heights);
+    if (!heights) return;
+    if (heights->tree && heights->pool.free)
+        heights->pool.free(heights->pool.userdata, heights->tree);
+    heights->tree = 0;
+    heights->count = heights->capacity = 0;
+}
+NK_INTERN int
+nk_row_heights_reserve(struct nk_row_heights *heights, int count)
+{
+    int *tree;
+    int capacity;
+    if (count <= heights->capacity) return nk_true;
+    if (!heights->pool.alloc || !heights->pool.free) return nk_false;
+    capacity = NK_MAX(count, heights->capacity * 2);
+    capacity = NK_MAX(capacity, 64);
+    /* the tree is indexed starting at 1 */
+    tree = (int*)heights->pool.alloc(heights->pool.userdata, 0,
+        (nk_size)(capacity + 1) * sizeof(int));
+    if (!tree) return nk_false;
+    if (heights->tree) {
+        NK_MEMCPY(tree, heights->tree, (nk_size)(heights->count + 1) * sizeof(int));
+        heights->pool.free(heights->pool.userdata, heights->tree);
+    } else tree[0] = 0;
+    heights->tree = tree;
+    heights->capacity = capacity;
+    return nk_true;
+}
+NK_API int
+nk_row_heights_build(struct nk_row_heights *heights, int count,
+    nk_plugin_row_height height, nk_handle userdata)
+{
+    int i;
+    NK_ASSERT(heights);
+    NK_ASSERT(height);
+    if (!heights || !height || count < 0) return nk_false;
+    if (!nk_row_heights_reserve(heights, count)) return nk_false;
+
+    /* fill in all heights and push partial sums up in one pass */
+    for (i = 1; i <= count; ++i)
+        heights->tree[i] = height(userdata, i-1);
+    for (i = 1; i <= count; ++i) {
+        int parent = i + (i & -i);
+        if (parent <= count)
+            heights->tree[parent] += heights->tree[i];
+    }
+    heights->count = count;
+    return nk_true;
+}
+NK_API int
+nk_row_heights_resize(struct nk_row_heights *heights, int count, int height)
+{
+    int i;
+    NK_ASSERT(heights);
+    if (!heights || count < 0) return nk_false;
+    if (count <= heights->count) {
+        /* nodes only cover rows in front of them so shrinking is free */
+        heights->count = count;
+        return nk_true;
+    }
+    if (!nk_row_heights_reserve(heights, count)) return nk_false;
+    for (i = heights->count + 1; i <= count; ++i) {
+        /* a new node covers itself and the nodes right below it */
+        int child, sum = height;
+        for (child = i - 1; child > i - (i & -i); child -= (child & -child))
+            sum += heights->tree[child];
+        heights->tree[i] = sum;
+    }
+    heights->count = count;
+    return nk_true;
+}
+NK_API void
+nk_row_heights_set(struct nk_row_heights *heights, int row, int height)
+{
+    int i, delta;
+    NK_ASSERT(heights);
+    NK_ASSERT(row >= 0 && row < heights->count);
+    if (!heights || row < 0 || row >= heights->count) return;
+    delta = height - nk_row_heights_get(heights, row);
+    if (!delta) return;
+    for (i = row + 1; i <= heights->count; i += (i & -i))
+        heights->tree[i] += delta;
+}
+NK_API int
+nk_row_heights_get(const struct nk_row_heights *heights, int row)
+{
+    int i, parent, height;
+    NK_ASSERT(heights);
+    if (!heights || row < 0 || row >= heights->count) return 0;
+    /* subtract the nodes that end inside the range of the row's node */
+    i = row + 1;
+    height = heights->tree[i];
+    parent = i - (i & -i);
+    for (i = i - 1; i > parent; i -= (i & -i))
+        height -= heights->tree[i];
+    return height;
+}
+NK_API int
+nk_row_heights_offset(const struct nk_row_heights *heights, int row)
+{
+    int i, offset = 0;
+    NK_ASSERT(heights);
+    if (!heights) return 0;
+    row = NK_CLAMP(0, row, heights->count);
+    for (i = row; i > 0; i -= (i & -i))
+        offset += heights->tree[i];
+    return offset;
+}
+NK_API int
+nk_row_heights_find(const struct nk_row_heights *heights, int offset)
+{
+    NK_ASSERT(heights);
+    if (!heights) return 0;
+    return nk_row_heights_search(heights, offset, 0);
+}
+
+
+
+
+/* ===============================================================
+ *
+ *                          TEXT VIEW
+ *
+ * ===============================================================*/
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+NK_API void
+nk_text_view_init_default(struct nk_text_view *view, nk_plugin_read read,
+    nk_handle userdata, nk_size size)
+{
+    struct nk_allocator alloc;
+    alloc.userdata.ptr = 0;
+    alloc.alloc = nk_malloc;
+    alloc.free = nk_mfree;
+    nk_text_view_init(view, &alloc, read, userdata, size);
+}
+NK_API void
+nk_text_view_init_memory_default(struct nk_text_view *view,
+    const char *memory, nk_size size)
+{
+    struct nk_allocator alloc;
+    alloc.userdata.ptr = 0;
+    alloc.alloc = nk_malloc;
+    alloc.free = nk_mfree;
+    nk_text_view_init_memory(view, &alloc, memory, size);
+}
+#endif
+NK_API void
+nk_text_view_init(struct nk_text_view *view, const struct nk_allocator *alloc,
+    nk_plugin_read read, nk_handle userdata, nk_size size)
+{
+    NK_ASSERT(view);
+    NK_ASSERT(alloc);
+    NK_ASSERT(read);
+    if (!view || !alloc || !read) return;
+    NK_MEMSET(view, 0, sizeof(*view));
+    view->pool = *alloc;
+    view->read = read;
+    view->userdata = userdata;
+    view->size = size;
+}
+NK_API void
+nk_text_view_init_memory(struct nk_text_view *view,
+    const struct nk_allocator *alloc, const char *memory, nk_size size)
+{
+    NK_ASSERT(view);
+    NK_ASSERT(alloc);
+    NK_ASSERT(memory || !size);
+    if (!view || !alloc) return;
+    NK_MEMSET(view, 0, sizeof(*view));
+    view->pool = *alloc;
+    view->memory = memory;
+    view->size = memory ? size: 0;
+}
+NK_API void
+nk_text_view_free(struct nk_text_view *view)
+{
+    NK_ASSERT(view);
+    if (!view) return;
+    if (view->lines && view->pool.free)
+        view->pool.free(view->pool.userdata, view->lines);
+    view->lines = 0;
+    view->line_capacity = 0;
+    view->line_count = 0;
+    view->last_line = view->indexed = 0;
+}
+NK_API void
+nk_text_view_set_size(struct nk_text_view *view, nk_size size)
+{
+    NK_ASSERT(view);
+    if (!view) return;
+    if (size < view->indexed) {
+        /* text got truncated so the index has to be rebuilt from scratch */
+        view->line_count = 0;
+        view->last_line = view->indexed = 0;
+    }
+    view->size = size;
+    view->select_start = NK_MIN(view->select_start, size);
+    view->select_end = NK_MIN(view->select_end, size);
+}
+NK_INTERN const char*
+nk_text_view_fetch(struct nk_text_view *view, nk_size offset, nk_size len,
+    nk_size *fetched)
+{
+    /* returns a pointer to at most `len` bytes of text starting at `offset`
+     * which either points directly into the memory block or into the
+     * scratch buffer filled by the read callback */
+    *fetched = 0;
+    if (offset >= view->size) return 0;
+    len = NK_MIN(len, view->size - offset);
+    if (view->memory) {
+        *fetched = len;
+        return view->memory + offset;
+    }
+    len = NK_MIN(len, (nk_size)NK_TEXT_VIEW_BUFFER_SIZE);
+    *fetched = NK_MIN(view->read(view->userdata, offset, view->buffer, len), len);
+    return view->buffer;
+}
+NK_INTERN nk_size
+nk_text_view_next_line(struct nk_text_view *view, nk_size offset)
+{
+    /* returns the offset behind the next new line or the text size */
+    const char *text;
+    nk_size len, i;
+    while ((text = nk_text_view_fetch(view, offset, view->size, &len)) && len) {
+        for (i = 0; i < len; ++i)
+            if (text[i] == '\n') return offset + i + 1;
+        offset += len;
+    }
+    return view->size;
+}
+NK_INTERN int
+nk_text_view_push_line(struct nk_text_view *view, nk_size offset)
+{
+    int slot;
+    NK_ASSERT(view->line_count % NK_TEXT_VIEW_LINE_STRIDE == 0);
+    slot = view->line_count / NK_TEXT_VIEW_LINE_STRIDE - 1;
+    if (slot >= view->line_capacity) {
+        nk_size *lines;
+        int capacity = NK_MAX(64, view->line_capacity * 2);
+        if (!view->pool.alloc || !view->pool.free) return nk_false;
+        lines = (nk_size*)view->pool.alloc(view->pool.userdata, 0,
+            (nk_size)capacity * sizeof(nk_size));
+        if (!lines) return nk_false;
+        if (view->lines) {
+            NK_MEMCPY(lines, view->lines, (nk_size)view->line_capacity * sizeof(nk_size));
+            view->pool.free(view->pool.userdata, view->lines);
+        }
+        view->lines = lines;
+        view->line_capacity = capacity;
+    }
+    view->lines[slot] = offset;
+    return nk_true;
+}
+NK_API int
+nk_text_view_index(struct nk_text_view *view, nk_size max_bytes)
+{
+    nk_size end, len, i;
+    const char *text;
+
+    NK_ASSERT(view);
+    if (!view) return nk_true;
+    end = view->size;
+    if (max_bytes < end - view->indexed)
+        end = view->indexed + max_bytes;
+
+    while (view->indexed < end) {
+        text = nk_text_view_fetch(view, view->indexed, end - view->indexed, &len);
+        if (!text || !len) break;
+        for (i = 0; i < len; ++i) {
+            if (text[i] != '\n') continue;
+            view->line_count++;
+            if (!(view->line_count % NK_TEXT_VIEW_LINE_STRIDE) &&
+                !nk_text_view_push_line(view, view->indexed + i + 1)) {
+                /* out of memory: stop in front of the line and retry later */
+                view->line_count--;
+                view->indexed += i;
+                return nk_false;
+            }
+            view->last_line = view->indexed + i + 1;
+        }
+        view->indexed += len;
+    }
+    return view->indexed >= view->size;
+}
+NK_API int
+nk_text_view_line_count(const struct nk_text_view *view)
+{
+    NK_ASSERT(view);
+    if (!view) return 0;
+    return view->line_count + ((view->last_line < view->size) ? 1: 0);
+}
+NK_API int
+nk_text_view_selection(const struct nk_text_view *view, nk_size *begin, nk_size *end)
+{
+    NK_ASSERT(view);
+    NK_ASSERT(begin);
+    NK_ASSERT(end);
+    if (!view || !begin || !end) return nk_false;
+    *begin = NK_MIN(view->select_start, view->select_end);
+    *end = NK_MAX(view->select_start, view->select_end);
+    return *begin != *end;
+}
+NK_INTERN nk_size
+nk_text_view_line_begin(struct nk_text_view *view, int line)
+{
+    int i, n = line % NK_TEXT_VIEW_LINE_STRIDE;
+    int slot = line / NK_TEXT_VIEW_LINE_STRIDE;
+    nk_size offset = slot ? view->lines[slot-1]: 0;
+    for (i = 0; i < n; ++i)
+        offset = nk_text_view_next_line(view, offset);
+    return offset;
+}
+NK_INTERN int
+nk_text_view_hit(const struct nk_user_font *font, const char *text, int len, float x)
+{
+    /* returns the byte offset of the glyph boundary closest to `x` */
+    int glyph_len, offset = 0;
+    float width = 0;
+    nk_rune unicode;
+
+    while (offset < len) {
+        float glyph_width;
+        glyph_len = nk_utf_decode(text + offset, &unicode, len - offset);
+        if (!glyph_len) break;
+        glyph_width = font->width(font->userdata, font->height, text + offset, glyph_len);
+        if (x < width + glyph_width * 0.5f) break;
+        width += glyph_width;
+        offset += glyph_len;
+    }
+    return offset;
+}
+NK_INTERN void
+nk_text_view_copy(struct nk_context *ctx, struct nk_text_view *view)
+{
+    nk_size begin, end, len, done = 0;
+    char *mem;
+
+    if (!ctx->clip.copy || !nk_text_view_selection(view, &begin, &end))
+        return;
+    len = NK_MIN(end - begin, (nk_size)NK_TEXT_VIEW_MAX_COPY);
+    if (view->memory) {
+        ctx->clip.copy(ctx->clip.userdata, view->memory + begin, (int)len);
+        return;
+    }
+    if (!view->pool.alloc || !view->pool.free) return;
+    mem = (char*)view->pool.alloc(view->pool.userdata, 0, len);
+    if (!mem) return;
+    while (done < len) {
+        nk_size n = view->read(view->userdata, begin + done, mem + done, len - done);
+        if (!n) break;
+        done += NK_MIN(n, len - done);
+    }
+    ctx->clip.copy(ctx->clip.userdata, mem, (int)done);
+    view->pool.free(view->pool.userdata, mem);
+}
+NK_API int
+nk_text_view(struct nk_context *ctx, struct nk_text_view *view,
+    const char *id, nk_flags flags)
+{
+    int i, row_height;
+    nk_size offset, begin, end;
+    int has_selection;
+    struct nk_list_view list;
+    struct nk_text text;
+    const struct nk_style *style;
+    const struct nk_user_font *font;
+    struct nk_command_buffer *out;
+    const struct nk_input *in;
+    struct nk_rect area;
+
+    NK_ASSERT(ctx);
+    NK_ASSERT(view);
+    NK_ASSERT(id);
+    if (!ctx || !view || !id || !ctx->current)
+        return 0;
+
+    style = &ctx->style;
+    font = style->font;
+    nk_text_view_index(view, NK_TEXT_VIEW_INDEX_BUDGET);
+    row_height = nk_iceilf(font->height + 2 * style->text.padding.y);
+    area = nk_widget_bounds(ctx);
+    if (!nk_list_view_begin(ctx, &list, id, flags, row_height,
+            nk_text_view_line_count(view)))
+        return 0;
+
+    out = &ctx->current->buffer;
+    in = (ctx->current->layout->flags & NK_WINDOW_ROM) ? 0: &ctx->input;
+    if (in && !in->mouse.buttons[NK_BUTTON_LEFT].down)
+        view->selecting = nk_false;
+    /* like an edit box the view only owns the copy key after a click into it */
+    if (nk_input_is_mouse_pressed(&ctx->input, NK_BUTTON_LEFT))
+        view->active = (unsigned char)(in && nk_input_is_mouse_hovering_rect(in, area));
+
+    text.padding = style->text.padding;
+    text.background = style->window.background;
+    text.text = style->text.color;
+    has_selection = nk_text_view_selection(view, &begin, &end);
+
+    nk_layout_row_dynamic(ctx, (float)row_height, 1);
+    offset = (list.begin < list.end) ? nk_text_view_line_begin(view, list.begin): 0;
+    for (i = list.begin; i < list.end; ++i) {
+        int len = 0;
+        int line_end = nk_false;
+        nk_size next = view->size;
+        nk_size fetched;
+        struct nk_rect bounds;
+        enum nk_widget_layout_states state;
+        const char *line = nk_text_view_fetch(view, offset,
+            NK_TEXT_VIEW_BUFFER_SIZE, &fetched);
+
+        /* cut the fetched bytes down to the current line */
+        while (line && (nk_size)len < fetched) {
+            if (line[len] == '\n') {
+                next = offset + (nk_size)len + 1;
+                line_end = nk_true;
+                break;
+            } len++;
+        }
+        if (len && line[len-1] == '\r') len--;
+        if (!line) line = view->buffer;
+
+        state = nk_widget(&bounds, ctx);
+        if (state) {
+            if (has_selection && begin <= offset + (nk_size)len && end > offset) {
+                /* highlight the selected part of the line */
+                struct nk_rect sel = bounds;
+                int from = (begin > offset) ? (int)NK_MIN(begin - offset, (nk_size)len): 0;
+                float x = bounds.x + text.padding.x;
+                sel.x = x + font->width(font->userdata, font->height, line, from);
+                if (end > offset + (nk_size)len)
+                    sel.w = bounds.x + bounds.w - sel.x;
+                else sel.w = x + font->width(font->userdata, font->height,
+                        line, (int)(end - offset)) - sel.x;
+                if (sel.w > 0)
+                    nk_fill_rect(out, sel, 0, style->edit.selected_normal);
+            }
+            nk_widget_text(out, bounds, line, len, &text, NK_TEXT_LEFT, font);
+        }
+        if (state == NK_WIDGET_VALID && in) {
+            /* click sets the selection anchor and dragging extends it */
+            float x = in->mouse.pos.x - bounds.x - text.padding.x;
+            nk_size hit = offset + (nk_size)nk_text_view_hit(font, line, len, x);
+            if (nk_input_has_mouse_click_down_in_rect(in, NK_BUTTON_LEFT, bounds, nk_true)) {
+                view->select_start = view->select_end = hit;
+                view->selecting = nk_true;
+            } else if (view->selecting && in->mouse.pos.y >= bounds.y &&
+                in->mouse.pos.y < bounds.y + bounds.h) {
+                view->select_end = hit;
+            }
+        }
+        if (i + 1 < list.end)
+            offset = (line_end || !line) ? next:
+                nk_text_view_next_line(view, offset + fetched);
+    }
+    nk_list_view_end(&list);
+
+    if (in && view->active && nk_input_is_key_pressed(in, NK_KEY_COPY))
+        nk_text_view_copy(ctx, view);
+    return 1;
+}
+
+
+
+
+/* ===============================================================
+ *
+ *                          GRID
+ *
+ * ===============================================================*/
+NK_INTERN void
+nk_grid_draw_block(struct nk_grid *grid, struct nk_command_buffer *out,
+    struct nk_rect area, const struct nk_rect *clip, float x, float y,
+    int row_begin, int row_end, int column_begin, int column_end)
+{
+    /* draws the visible cells of one frozen or scrolling part of the grid
+     * where (x,y) is the screen position of cell (row_begin, column_begin) */
+    int row, column, first, last;
+    struct nk_rect cell;
+
+    if (row_begin >= row_end || column_begin >= column_end) return;
+    nk_unify(&area, clip, area.x, area.y, area.x + area.w, area.y + area.h);
+    if (area.w <= 0 || area.h <= 0) return;
+
+    first = row_begin + (int)NK_MAX((area.y - y) / grid->row_height, 0.0f);
+    last = row_begin + nk_iceilf((area.y + area.h - y) / grid->row_height);
+    last = NK_MIN(last, row_end);
+
+    /* skip the columns left of the visible area */
+    column = column_begin;
+    while (column < column_end && x + grid->column_widths[column] <= area.x)
+        x += grid->column_widths[column++];
+
+    nk_push_scissor(out, area);
+    for (; column < column_end && x < area.x + area.w; ++column) {
+        cell.x = x;
+        cell.w = grid->column_widths[column];
+        cell.h = grid->row_height;
+        for (row = first; row < last; ++row) {
+            cell.y = y + (float)(row - row_begin) * grid->row_height;
+            grid->draw(grid->userdata, out, cell, row, column);
+        }
+        x += cell.w;
+    }
+}
+NK_INTERN void
+nk_grid_resize(struct nk_grid *grid, const struct nk_input *in,
+    struct nk_rect area, const struct nk_rect *clip, float x,
+    int column_begin, int column_end)
+{
+    /* starts resizing a column when clicking on its right border */
+    int column;
+    struct nk_rect handle;
+
+    nk_unify(&area, clip, area.x, area.y, area.x + area.w, area.y + area.h);
+    if (area.w <= 0 || area.h <= 0) return;
+    handle.y = area.y;
+    handle.h = area.h;
+    handle.w = 6;
+    for (column = column_begin; column < column_end && x < area.x + area.w; ++column) {
+        x += grid->column_widths[column];
+        handle.x = x - handle.w * 0.5f;
+        if (x >= area.x && nk_input_has_mouse_click_down_in_rect(in,
+                NK_BUTTON_LEFT, handle, nk_true))
+            grid->resizing = column + 1;
+    }
+}
+NK_API int
+nk_grid(struct nk_context *ctx, struct nk_grid *grid, const char *id, nk_flags flags)
+{
+    int i, frozen_rows, frozen_columns;
+    float total_width = 0, frozen_width = 0, frozen_height;
+    float scroll_x, scroll_y;
+    struct nk_rect view, clip, area;
+    struct nk_command_buffer *out;
+    const struct nk_input *in;
+    struct nk_panel *layout;
+
+    NK_ASSERT(ctx);
+    NK_ASSERT(grid);
+    NK_ASSERT(id);
+    NK_ASSERT(grid->draw);
+    NK_ASSERT(grid->column_widths || !grid->columns);
+    if (!ctx || !grid || !id || !grid->draw || grid->row_height <= 0 ||
+        (!grid->column_widths && grid->columns))
+        return 0;
+    if (!nk_group_begin(ctx, id, flags))
+        return 0;
+
+    layout = ctx->current->layout;
+    out = &ctx->current->buffer;
+    in = (layout->flags & NK_WINDOW_ROM) ? 0: &ctx->input;
+    view = layout->bounds;
+    clip = layout->clip;
+    frozen_rows = NK_CLAMP(0, grid->frozen_rows, grid->rows);
+    frozen_columns = NK_CLAMP(0, grid->frozen_columns, grid->columns);
+    frozen_height = (float)frozen_rows * grid->row_height;
+
+    /* continue resizing a column until the mouse button is released */
+    if (grid->resizing > 0 && grid->resizing <= grid->columns &&
+        in && in->mouse.buttons[NK_BUTTON_LEFT].down) {
+        float *width = &grid->column_widths[grid->resizing-1];
+        *width = NK_MAX(grid->min_column_width, *width + in->mouse.delta.x);
+    } else grid->resizing = 0;
+
+    for (i = 0; i < grid->columns; ++i) {
+        total_width += grid->column_widths[i];
+        if (i + 1 == frozen_columns)
+            frozen_width = total_width;
+    }
+    scroll_x = (float)*layout->offset_x;
+    scroll_y = (float)*layout->offset_y;
+
+    /* scrolling cells */
+    area = nk_rect(view.x + frozen_width, view.y + frozen_height,
+        view.w - frozen_width, view.h - frozen_height);
+    nk_grid_draw_block(grid, out, area, &clip, area.x - scroll_x, area.y - scroll_y,
+        frozen_rows, grid->rows, frozen_columns, grid->columns);
+
+    /* frozen rows and columns are drawn on top */
+    area = nk_rect(view.x + frozen_width, view.y, view.w - frozen_width, frozen_height);
+    nk_grid_draw_block(grid, out, area, &clip, area.x - scroll_x, view.y,
+        0, frozen_rows, frozen_columns, grid->columns);
+    if (in && !grid->resizing && frozen_rows)
+        nk_grid_resize(grid, in, area, &clip, area.x - scroll_x,
+            frozen_columns, grid->columns);
+
+    area = nk_rect(view.x, view.y + frozen_height, frozen_width, view.h - frozen_height);
+    nk_grid_draw_block(grid, out, area, &clip, view.x, area.y - scroll_y,
+        frozen_rows, grid->rows, 0, frozen_columns);
+
+    area = nk_rect(view.x, view.y, frozen_width, frozen_height);
+    nk_grid_draw_block(grid, out, area, &clip, view.x, view.y,
+        0, frozen_rows, 0, frozen_columns);
+    if (in && !grid->resizing && frozen_rows)
+        nk_grid_resize(grid, in, area, &clip, view.x, 0, frozen_columns);
+    nk_push_scissor(out, clip);
+
+    /* let the group scrollbars cover the whole grid */
+    layout->at_y = view.y + (float)grid->rows * grid->row_height;
+    layout->max_x = view.x + total_width;
+    nk_group_end(ctx);
+    return 1;
+}
+
+
+
+
+/* ===============================================================
+ *
+ *                          TREE VIEW
+ *
+ * ===============================================================*/
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+NK_API void
+nk_tree_view_init_default(struct nk_tree_view *view, nk_handle root,
+    nk_plugin_tree_children children, nk_plugin_tree_label label,
+    nk_handle userdata)
+{
+    struct nk_allocator alloc;
+    alloc.userdata.ptr = 0;
+    alloc.alloc = nk_malloc;
+    alloc.free = nk_mfree;
+    nk_tree_view_init(view, &alloc, root, children, label, userdata);
+}
+#endif
+NK_API void
+nk_tree_view_init(struct nk_tree_view *view, const struct nk_allocator *alloc,
+    nk_handle root, nk_plugin_tree_children children, nk_plugin_tree_label label,
+    nk_handle userdata)
+{
+    NK_ASSERT(view);
+    NK_ASSERT(alloc);
+    NK_ASSERT(children);
+    NK_ASSERT(label);
+    if (!view || !alloc || !children || !label) return;
+    NK_MEMSET(view, 0, sizeof(*view));
+    view->pool = *alloc;
+    view->root = root;
+    view->children = children;
+    view->label = label;
+    view->userdata = userdata;
+    view->selected = -1;
+}
+NK_API void
+nk_tree_view_free(struct nk_tree_view *view)
+{
+    NK_ASSERT(view);
+    if (!view) return;
+    if (view->pool.free) {
+        if (view->nodes) view->pool.free(view->pool.userdata, view->nodes);
+        if (view->rows) view->pool.free(view->pool.userdata, view->rows);
+    }
+    view->nodes = 0;
+    view->rows = 0;
+    view->count = view->capacity = 0;
+    view->selected = -1;
+    view->valid = nk_false;
+}
+NK_API void
+nk_tree_view_reset(struct nk_tree_view *view)
+{
+    NK_ASSERT(view);
+    if (!view) return;
+    view->count = 0;
+    view->selected = -1;
+    view->valid = nk_false;
+}
+NK_INTERN int
+nk_tree_view_reserve(struct nk_tree_view *view, int count)
+{
+    int capacity;
+    nk_handle *nodes;
+    struct nk_tree_view_row *rows;
+
+    if (count <= view->capacity) return nk_true;
+    if (!view->pool.alloc || !view->pool.free) return nk_false;
+    capacity = NK_MAX(count, view->capacity * 2);
+    capacity = NK_MAX(capacity, 64);
+    nodes = (nk_handle*)view->pool.alloc(view->pool.userdata, 0,
+        (nk_size)capacity * sizeof(nk_handle));
+    rows = (struct nk_tree_view_row*)view->pool.alloc(view->pool.userdata, 0,
+        (nk_size)capacity * sizeof(struct nk_tree_view_row));
+    if (!nodes || !rows) {
+        if (nodes) view->pool.free(view->pool.userdata, nodes);
+        if (rows) view->pool.free(view->pool.userdata, rows);
+        return nk_false;
+    }
+    if (view->count) {
+        NK_MEMCPY(nodes, view->nodes, (nk_size)view->count * sizeof(nk_handle));
+        NK_MEMCPY(rows, view->rows, (nk_size)view->count * sizeof(struct nk_tree_view_row));
+    }
+    if (view->nodes) view->pool.free(view->pool.userdata, view->nodes);
+    if (view->rows) view->pool.free(view->pool.userdata, view->rows);
+    view->nodes = nodes;
+    view->rows = rows;
+    view->capacity = capacity;
+    return nk_true;
+}
+NK_INTERN void
+nk_tree_view_move(struct nk_tree_view *view, int dst, int src, int count)
+{
+    /* moves rows within the arrays; the ranges overlap so this cannot use
+     * NK_MEMCPY, which may be defined as a plain memcpy */
+    int i;
+    if (dst > src) {
+        for (i = count - 1; i >= 0; --i) {
+            view->nodes[dst + i] = view->nodes[src + i];
+            view->rows[dst + i] = view->rows[src + i];
+        }
+    } else {
+        for (i = 0; i < count; ++i) {
+            view->nodes[dst + i] = view->nodes[src + i];
+            view->rows[dst + i] = view->rows[src + i];
+        }
+    }
+}
+NK_INTERN int
+nk_tree_view_insert(struct nk_tree_view *view, int at, nk_handle parent, int depth)
+{
+    /* enumerates the children of `parent` into new rows starting at `at`
+     * and returns the number of inserted rows */
+    int i, n, tail;
+    n = view->children(view->userdata, parent, 0, 0);
+    if (n <= 0 || !nk_tree_view_reserve(view, view->count + n))
+        return 0;
+
+    tail = view->count - at;
+    nk_tree_view_move(view, at + n, at, tail);
+    i = view->children(view->userdata, parent, view->nodes + at, n);
+    i = NK_CLAMP(0, i, n);
+    if (i < n) /* fewer children than announced so close the hole again */
+        nk_tree_view_move(view, at + i, at + n, tail);
+    n = i;
+    for (i = 0; i < n; ++i) {
+        view->rows[at + i].depth = depth;
+        view->rows[at + i].children = -1;
+        view->rows[at + i].open = nk_false;
+    }
+    view->count += n;
+    if (view->selected >= at)
+        view->selected += n;
+    return n;
+}
+NK_INTERN void
+nk_tree_view_validate(struct nk_tree_view *view)
+{
+    if (view->valid) return;
+    view->count = 0;
+    view->selected = -1;
+    nk_tree_view_insert(view, 0, view->root, 0);
+    view->valid = nk_true;
+}
+NK_API int
+nk_tree_view_expand(struct nk_tree_view *view, int row)
+{
+    int n;
+    NK_ASSERT(view);
+    if (!view) return 0;
+    nk_tree_view_validate(view);
+    if (row < 0 || row >= view->count) return 0;
+    if (view->rows[row].open) return view->rows[row].children;
+    n = nk_tree_view_insert(view, row + 1, view->nodes[row], view->rows[row].depth + 1);
+    view->rows[row].children = n;
+    view->rows[row].open = (n > 0);
+    return n;
+}
+NK_API void
+nk_tree_view_collapse(struct nk_tree_view *view, int row)
+{
+    int end, removed;
+    NK_ASSERT(view);
+    if (!view || row < 0 || row >= view->count || !view->rows[row].open)
+        return;
+
+    /* all rows behind the node with a bigger depth belong to its subtree */
+    end = row + 1;
+    while (end < view->count && view->rows[end].depth > view->rows[row].depth)
+        end++;
+    removed = end - (row + 1);
+    nk_tree_view_move(view, row + 1, end, view->count - end);
+    view->count -= removed;
+    view->rows[row].open = nk_false;
+    if (view->selected > row && view->selected < end)
+        view->selected = row;
+    else if (view->selected >= end)
+        view->selected -= removed;
+}
+NK_API nk_handle
+nk_tree_view_node(const struct nk_tree_view *view, int row)
+{
+    nk_handle handle = {0};
+    NK_ASSERT(view);
+    if (!view || row < 0 || row >= view->count) return handle;
+    return view->nodes[row];
+}
+NK_API int
+nk_tree_view(struct nk_context *ctx, struct nk_tree_view *view,
+    const char *id, nk_flags flags)
+{
+    int i, row_height;
+    int toggle = -1;
+    struct nk_list_view list;
+    struct nk_text text;
+    const struct nk_style *style;
+    const struct nk_user_font *font;
+    struct nk_command_buffer *out;
+    const struct nk_input *in;
+
+    NK_ASSERT(ctx);
+    NK_ASSERT(view);
+    NK_ASSERT(id);
+    if (!ctx || !view || !id || !ctx->current)
+        return 0;
+
+    style = &ctx->style;
+    font = style->font;
+    nk_tree_view_validate(view);
+    row_height = nk_iceilf(font->height + 2 * style->tab.padding.y);
+    if (!nk_list_view_begin(ctx, &list, id, flags, row_height, view->count))
+        return 0;
+
+    out = &ctx->current->buffer;
+    in = (ctx->current->layout->flags & NK_WINDOW_ROM) ? 0: &ctx->input;
+    text.padding = style->tab.padding;
+    text.background = style->window.background;
+    text.text = style->tab.text;
+
+    nk_layout_row_dynamic(ctx, (float)row_height, 1);
+    for (i = list.begin; i < list.end; ++i) {
+        int len = 0;
+        const char *label;
+        struct nk_rect bounds, sym, content;
+        struct nk_tree_view_row *row = &view->rows[i];
+        enum nk_widget_layout_states state = nk_widget(&bounds, ctx);
+        if (!state) continue;
+
+        /* children are only counted once a row becomes visible */
+        if (row->children < 0)
+            row->children = NK_MAX(view->children(view->userdata, view->nodes[i], 0, 0), 0);
+
+        sym.w = sym.h = font->height;
+        sym.x = bounds.x + (float)row->depth * style->tab.indent + style->tab.padding.x;
+        sym.y = bounds.y + (bounds.h - sym.h) * 0.5f;
+        content = bounds;
+        content.x = sym.x + sym.w;
+        content.w = NK_MAX(bounds.x + bounds.w - content.x, 0);
+
+        if (view->selected == i)
+            nk_fill_rect(out, content, 0, style->edit.selected_normal);
+        if (row->children)
+            nk_draw_symbol(out, row->open ? style->tab.sym_minimize: style->tab.sym_maximize,
+                sym, style->window.background, style->tab.text, 1.0f, font);
+        label = view->label(view->userdata, view->nodes[i], &len);
+        if (label)
+            nk_widget_text(out, content, label, len, &text, NK_TEXT_LEFT, font);
+
+        if (state == NK_WIDGET_VALID && in) {
+            if (row->children && nk_input_has_mouse_click_down_in_rect(in,
+                    NK_BUTTON_LEFT, sym, nk_true))
+                toggle = i;
+            else if (nk_input_has_mouse_click_down_in_rect(in, NK_BUTTON_LEFT, content, nk_true))
+                view->selected = i;
+        }
+    }
+    nk_list_view_end(&list);
+
+    /* only change the rows after all visible rows have been drawn */
+    if (toggle >= 0) {
+        if (view->rows[toggle].open)
+            nk_tree_view_collapse(view, toggle);
+        else nk_tree_view_expand(view, toggle);
+    }
+    return 1;
+}
+
+
+
+
+/* ===============================================================
+ *
+ *                              WIDGET
+ *
+ * ===============================================================*/
+NK_API struct nk_rect
 nk_widget_bounds(struct nk_context *ctx)
 {
     struct nk_rect bounds;
@@ -21719,6 +24545,7 @@ struct nk_text_edit_row {
 NK_INTERN void nk_textedit_makeundo_delete(struct nk_text_edit*, int, int);
 NK_INTERN void nk_textedit_makeundo_insert(struct nk_text_edit*, int, int);
 NK_INTERN void nk_textedit_makeundo_replace(struct nk_text_edit*, int, int, int);
+NK_INTERN void nk_textedit_history_pop(struct nk_text_undo_state*);
 #define NK_TEXT_HAS_SELECTION(s)   ((s)->select_start != (s)->select_end)
 
 NK_INTERN float
@@ -21726,29 +24553,49 @@ nk_textedit_get_width(const struct nk_text_edit *edit, int line_start, int char_
     const struct nk_user_font *font)
 {
     int len = 0;
+    int avail = 0;
     nk_rune unicode = 0;
-    const char *str = nk_str_at_const(&edit->string, line_start + char_id, &unicode, &len);
+    const char *str;
+    int offset = nk_str_rune_offset(&edit->string, line_start + char_id);
+    if (offset < 0) return 0;
+    str = nk_str_text_at(&edit->string, offset, &avail);
+    len = nk_utf_decode(str, &unicode, avail);
     return font->width(font->userdata, font->height, str, len);
 }
 NK_INTERN void
 nk_textedit_layout_row(struct nk_text_edit_row *r, struct nk_text_edit *edit,
     int line_start_id, float row_height, const struct nk_user_font *font)
 {
-    int l;
+    /* measures one line up to and including its newline and reads the text
+     * in chunks so the insertion gap can stay where it is */
+    int glyph_len;
     int glyphs = 0;
+    int avail = 0;
+    float width = 0;
     nk_rune unicode;
-    const char *remaining;
-    int len = nk_str_len_char(&edit->string);
-    const char *end = nk_str_get_const(&edit->string) + len;
-    const char *text = nk_str_at_const(&edit->string, line_start_id, &unicode, &l);
-    const struct nk_vec2 size = nk_text_calculate_text_bounds(font,
-        text, (int)(end - text), row_height, &remaining, 0, &glyphs, NK_STOP_ON_NEW_LINE);
+    const char *text = 0;
+    int offset = nk_str_rune_offset(&edit->string, line_start_id);
+
+    if (offset >= 0)
+        text = nk_str_text_at(&edit->string, offset, &avail);
+    while (avail) {
+        glyph_len = nk_utf_decode(text, &unicode, avail);
+        if (!glyph_len) break;
+        glyphs++;
+        if (unicode == '\n') break;
+        if (unicode != '\r')
+            width += font->width(font->userdata, font->height, text, glyph_len);
+        offset += glyph_len;
+        text += glyph_len;
+        avail -= glyph_len;
+        if (!avail) text = nk_str_text_at(&edit->string, offset, &avail);
+    }
 
     r->x0 = 0.0f;
-    r->x1 = size.x;
-    r->baseline_y_delta = size.y;
+    r->x1 = width;
+    r->baseline_y_delta = row_height;
     r->ymin = 0.0f;
-    r->ymax = size.y;
+    r->ymax = row_height;
     r->num_chars = glyphs;
 }
 NK_INTERN int
@@ -21764,20 +24611,30 @@ nk_textedit_locate_coord(struct nk_text_edit *edit, float x, float y,
     r.ymin = r.ymax = 0;
     r.num_chars = 0;
 
-    /* search rows to find one that straddles 'y' */
-    while (i < n) {
-        nk_textedit_layout_row(&r, edit, i, row_height, font);
-        if (r.num_chars <= 0)
+    if (edit->string.index_stride && !edit->single_line) {
+        /* rows are lines so the line index finds the row directly */
+        int line = (y < 0) ? 0: (int)(y / row_height);
+        if (!n || y < 0)
+            return 0;
+        if (nk_str_line_begin(&edit->string, line, &i) < 0 || i >= n)
             return n;
+        nk_textedit_layout_row(&r, edit, i, row_height, font);
+    } else {
+        /* search rows to find one that straddles 'y' */
+        while (i < n) {
+            nk_textedit_layout_row(&r, edit, i, row_height, font);
+            if (r.num_chars <= 0)
+                return n;
 
-        if (i==0 && y < base_y + r.ymin)
-            return 0;
+            if (i==0 && y < base_y + r.ymin)
+                return 0;
 
-        if (y < base_y + r.ymax)
-            break;
+            if (y < base_y + r.ymax)
+                break;
 
-        i += r.num_chars;
-        base_y += r.baseline_y_delta;
+            i += r.num_chars;
+            base_y += r.baseline_y_delta;
+        }
     }
 
     /* below all text, return 'after' last character */
@@ -21845,6 +24702,33 @@ nk_textedit_find_charpos(struct nk_text_find *find, struct nk_text_edit *state,
     int i=0, first;
 
     nk_zero_struct(r);
+    if (!single_line && state->string.index_stride) {
+        /* rows are lines so the line index finds the row directly */
+        int line = nk_str_line_of(&state->string, (n == z) ? NK_MAX(z-1, 0): n);
+        nk_str_line_begin(&state->string, line, &i);
+        if (line > 0)
+            nk_str_line_begin(&state->string, line - 1, &prev_start);
+        if (n == z && z) {
+            /* behind the last character like the row scan below */
+            prev_start = i;
+            i = z;
+        }
+        nk_textedit_layout_row(&r, state, i, row_height, font);
+        find->first_char = first = i;
+        find->length = r.num_chars;
+        find->x = r.x0;
+        find->y = (float)line * row_height;
+        find->height = r.ymax - r.ymin;
+        find->prev_first = prev_start;
+        if (n == z) {
+            find->x = r.x1;
+            find->y = r.ymin;
+        } else {
+            for (i=0; first+i < n; ++i)
+                find->x += nk_textedit_get_width(state, first, i, font);
+        }
+        return;
+    }
     if (n == z) {
         /* if it's at the end, then find the last line -- simpler than trying to
         explicitly handle this case in the regular code */
@@ -21966,10 +24850,9 @@ nk_textedit_move_to_last(struct nk_text_edit *state)
 NK_INTERN int
 nk_is_word_boundary( struct nk_text_edit *state, int idx)
 {
-    int len;
     nk_rune c;
-    if (idx <= 0) return 1;
-    if (!nk_str_at_rune(&state->string, idx, &c, &len)) return 1;
+    if (idx <= 0 || idx > state->string.len) return 1;
+    c = nk_str_rune_at(&state->string, idx);
     return (c == ' ' || c == '\t' ||c == 0x3000 || c == ',' || c == ';' ||
             c == '(' || c == ')' || c == '{' || c == '}' || c == '[' || c == ']' ||
             c == '|');
@@ -22041,7 +24924,9 @@ nk_textedit_paste(struct nk_text_edit *state, char const *ctext, int len)
         return 1;
     }
     /* remove the undo since we didn't actually insert the characters */
-    if (state->undo.undo_point)
+    if (state->undo.history)
+        nk_textedit_history_pop(&state->undo);
+    else if (state->undo.undo_point)
         --state->undo.undo_point;
     return 0;
 }
@@ -22493,28 +25378,279 @@ NK_INTERN nk_rune*
 nk_textedit_createundo(struct nk_text_undo_state *state, int pos,
     int insert_len, int delete_len)
 {
-    struct nk_text_undo_record *r = nk_textedit_create_undo_record(state, insert_len);
-    if (r == 0)
-        return 0;
+    struct nk_text_undo_record *r = nk_textedit_create_undo_record(state, insert_len);
+    if (r == 0)
+        return 0;
+
+    r->where = pos;
+    r->insert_length = (short) insert_len;
+    r->delete_length = (short) delete_len;
+
+    if (insert_len == 0) {
+        r->char_storage = -1;
+        return 0;
+    } else {
+        r->char_storage = state->undo_char_point;
+        state->undo_char_point = (short)(state->undo_char_point +  insert_len);
+        return &state->undo_char[r->char_storage];
+    }
+}
+/* The growable undo history keeps undo records at the front of one
+ * allocation growing up and redo records at the back growing down, like the
+ * fixed arrays above. Undo records are stored as [bytes][text][delta] so the
+ * newest one can be popped from the top and the oldest one dropped from the
+ * bottom, redo records as [delta][text]. Dropped undo records only advance
+ * `undo_begin` and the space is reclaimed by moving the remaining records
+ * down once a quarter of the history is free again. */
+struct nk_text_undo_delta {
+    int where;
+    int insert_length;
+    int delete_length;
+    int bytes;
+};
+#define NK_TEXT_UNDO_RECORD_SIZE(n) (sizeof(int) + (nk_size)(n) + sizeof(struct nk_text_undo_delta))
+#define NK_TEXT_REDO_RECORD_SIZE(n) (sizeof(struct nk_text_undo_delta) + (nk_size)(n))
+
+NK_INTERN int
+nk_textedit_text_range(const struct nk_str *s, int where, int len, int *begin)
+{
+    /* returns the number of bytes taken up by `len` runes at `where` */
+    int end;
+    *begin = nk_str_rune_offset(s, where);
+    end = nk_str_rune_offset(s, where + len);
+    if (*begin < 0 || end < 0) return 0;
+    return end - *begin;
+}
+NK_INTERN void
+nk_textedit_text_copy(const struct nk_str *s, int begin, int len, char *dst)
+{
+    /* copies `len` bytes at byte offset `begin` around the gap */
+    while (len > 0) {
+        int avail = 0;
+        const char *text = nk_str_text_at(s, begin, &avail);
+        if (!text || !avail) break;
+        avail = NK_MIN(avail, len);
+        NK_MEMCPY(dst, text, (nk_size)avail);
+        dst += avail;
+        begin += avail;
+        len -= avail;
+    }
+}
+NK_INTERN struct nk_text_undo_delta
+nk_textedit_history_top(const struct nk_text_undo_state *s)
+{
+    struct nk_text_undo_delta d;
+    NK_MEMCPY(&d, s->history + s->undo_end - sizeof(d), sizeof(d));
+    return d;
+}
+NK_INTERN void
+nk_textedit_history_pop(struct nk_text_undo_state *s)
+{
+    struct nk_text_undo_delta d;
+    if (s->undo_end == s->undo_begin) return;
+    d = nk_textedit_history_top(s);
+    s->undo_end -= NK_TEXT_UNDO_RECORD_SIZE(d.bytes);
+}
+NK_INTERN void
+nk_textedit_history_drop(struct nk_text_undo_state *s)
+{
+    /* discard the oldest entry in the undo history */
+    int bytes;
+    NK_MEMCPY(&bytes, s->history + s->undo_begin, sizeof(bytes));
+    s->undo_begin += NK_TEXT_UNDO_RECORD_SIZE(bytes);
+    if (s->undo_begin == s->undo_end)
+        s->undo_begin = s->undo_end = 0;
+}
+NK_INTERN int
+nk_textedit_history_reserve(struct nk_text_undo_state *s, nk_size need, nk_size keep)
+{
+    /* makes room for `need` bytes between the undo and redo records while
+     * never dropping the newest `keep` bytes of undo records */
+    nk_size undo_len, redo_len;
+    if (s->redo_begin - s->undo_end >= need)
+        return nk_true;
+
+    undo_len = s->undo_end - s->undo_begin;
+    redo_len = s->history_size - s->redo_begin;
+    if (undo_len + redo_len + need > s->history_size &&
+        s->history_size < s->history_limit)
+    {
+        /* grow the history and move undo and redo records to both ends */
+        char *history;
+        nk_size size = NK_MAX(s->history_size * 2, NK_TEXTEDIT_HISTORY_MIN_SIZE);
+        size = NK_MAX(size, undo_len + redo_len + need);
+        size = NK_MIN(size, s->history_limit);
+        history = (char*)s->pool.alloc(s->pool.userdata, 0, size);
+        if (history) {
+            if (undo_len)
+                NK_MEMCPY(history, s->history + s->undo_begin, undo_len);
+            if (redo_len)
+                NK_MEMCPY(history + size - redo_len, s->history + s->redo_begin, redo_len);
+            if (s->history)
+                s->pool.free(s->pool.userdata, s->history);
+            s->history = history;
+            s->history_size = size;
+            s->undo_begin = 0;
+            s->undo_end = undo_len;
+            s->redo_begin = size - redo_len;
+            if (s->redo_begin - s->undo_end >= need)
+                return nk_true;
+        }
+    }
+    if (undo_len + redo_len + need > s->history_size) {
+        /* drop old records until a quarter of the history is free afterwards
+         * so moving the remaining records down is amortized over many edits */
+        nk_size target = s->history_size - s->history_size / 4;
+        while (undo_len > keep && undo_len + redo_len + need > target) {
+            nk_textedit_history_drop(s);
+            undo_len = s->undo_end - s->undo_begin;
+        }
+        if (undo_len + redo_len + need > s->history_size)
+            return nk_false;
+    }
+    if (s->undo_begin) {
+        NK_MEMCPY(s->history, s->history + s->undo_begin, undo_len);
+        s->undo_begin = 0;
+        s->undo_end = undo_len;
+    }
+    return nk_true;
+}
+NK_INTERN void
+nk_textedit_history_push(struct nk_text_edit *state, int where,
+    int insert_len, int delete_len)
+{
+    struct nk_text_undo_state *s = &state->undo;
+    struct nk_text_undo_delta d;
+    int begin = 0;
+    char *record;
+
+    /* any time we create a new undo record, we discard redo */
+    s->redo_begin = s->history_size;
+    d.where = where;
+    d.insert_length = insert_len;
+    d.delete_length = delete_len;
+    d.bytes = insert_len ? nk_textedit_text_range(&state->string, where, insert_len, &begin): 0;
+    if (!d.bytes) d.insert_length = 0;
+    if (!nk_textedit_history_reserve(s, NK_TEXT_UNDO_RECORD_SIZE(d.bytes), 0)) {
+        /* the edit can't be stored so older records can't be undone either */
+        s->undo_begin = s->undo_end = 0;
+        return;
+    }
+    record = s->history + s->undo_end;
+    NK_MEMCPY(record, &d.bytes, sizeof(d.bytes));
+    nk_textedit_text_copy(&state->string, begin, d.bytes, record + sizeof(int));
+    NK_MEMCPY(record + sizeof(int) + d.bytes, &d, sizeof(d));
+    s->undo_end += NK_TEXT_UNDO_RECORD_SIZE(d.bytes);
+}
+NK_INTERN void
+nk_textedit_history_undo(struct nk_text_edit *state)
+{
+    struct nk_text_undo_state *s = &state->undo;
+    struct nk_text_undo_delta u, r;
+    int begin = 0;
+    const char *text;
+
+    if (s->undo_end == s->undo_begin)
+        return;
+
+    /* apply the undo record and store the deleted text as redo record */
+    u = nk_textedit_history_top(s);
+    r.where = u.where;
+    r.insert_length = u.delete_length;
+    r.delete_length = u.insert_length;
+    r.bytes = r.insert_length ? nk_textedit_text_range(&state->string,
+        u.where, u.delete_length, &begin): 0;
+    if (!r.bytes) r.insert_length = 0;
+    if (nk_textedit_history_reserve(s, NK_TEXT_REDO_RECORD_SIZE(r.bytes),
+            NK_TEXT_UNDO_RECORD_SIZE(u.bytes))) {
+        s->redo_begin -= NK_TEXT_REDO_RECORD_SIZE(r.bytes);
+        NK_MEMCPY(s->history + s->redo_begin, &r, sizeof(r));
+        nk_textedit_text_copy(&state->string, begin, r.bytes,
+            s->history + s->redo_begin + sizeof(r));
+    } else s->redo_begin = s->history_size;
+
+    nk_textedit_history_pop(s);
+    text = s->history + s->undo_end + sizeof(int);
+    if (u.delete_length)
+        nk_str_delete_runes(&state->string, u.where, u.delete_length);
+    if (u.insert_length)
+        nk_str_insert_text_utf8(&state->string, u.where, text, u.insert_length);
+    state->cursor = u.where + u.insert_length;
+}
+NK_INTERN void
+nk_textedit_history_redo(struct nk_text_edit *state)
+{
+    struct nk_text_undo_state *s = &state->undo;
+    struct nk_text_undo_delta u, r;
+    int begin = 0;
+    char *record;
 
-    r->where = pos;
-    r->insert_length = (short) insert_len;
-    r->delete_length = (short) delete_len;
+    if (s->redo_begin == s->history_size)
+        return;
 
-    if (insert_len == 0) {
-        r->char_storage = -1;
-        return 0;
-    } else {
-        r->char_storage = state->undo_char_point;
-        state->undo_char_point = (short)(state->undo_char_point +  insert_len);
-        return &state->undo_char[r->char_storage];
-    }
+    /* apply the redo record and store the deleted text as undo record */
+    NK_MEMCPY(&r, s->history + s->redo_begin, sizeof(r));
+    u.where = r.where;
+    u.insert_length = r.delete_length;
+    u.delete_length = r.insert_length;
+    u.bytes = u.insert_length ? nk_textedit_text_range(&state->string,
+        r.where, r.delete_length, &begin): 0;
+    if (!u.bytes) u.insert_length = 0;
+    if (nk_textedit_history_reserve(s, NK_TEXT_UNDO_RECORD_SIZE(u.bytes), 0)) {
+        record = s->history + s->undo_end;
+        NK_MEMCPY(record, &u.bytes, sizeof(u.bytes));
+        nk_textedit_text_copy(&state->string, begin, u.bytes, record + sizeof(int));
+        NK_MEMCPY(record + sizeof(int) + u.bytes, &u, sizeof(u));
+        s->undo_end += NK_TEXT_UNDO_RECORD_SIZE(u.bytes);
+    } else s->undo_begin = s->undo_end = 0;
+
+    /* the redo record stays valid since reserving never touches redo records */
+    record = s->history + s->redo_begin;
+    s->redo_begin += NK_TEXT_REDO_RECORD_SIZE(r.bytes);
+    if (r.delete_length)
+        nk_str_delete_runes(&state->string, r.where, r.delete_length);
+    if (r.insert_length)
+        nk_str_insert_text_utf8(&state->string, r.where,
+            record + sizeof(r), r.insert_length);
+    state->cursor = r.where + r.insert_length;
+}
+NK_API int
+nk_textedit_undo_history(struct nk_text_edit *state,
+    const struct nk_allocator *alloc, nk_size limit)
+{
+    struct nk_text_undo_state *s;
+    char *history;
+    NK_ASSERT(state);
+    NK_ASSERT(alloc);
+    if (!state || !alloc || !alloc->alloc || !alloc->free)
+        return nk_false;
+    if (limit && limit < NK_TEXTEDIT_HISTORY_MIN_SIZE)
+        return nk_false;
+
+    /* allocate up front so a failure leaves the current history untouched */
+    history = (char*)alloc->alloc(alloc->userdata, 0, NK_TEXTEDIT_HISTORY_MIN_SIZE);
+    if (!history) return nk_false;
+
+    s = &state->undo;
+    if (s->history)
+        s->pool.free(s->pool.userdata, s->history);
+    s->pool = *alloc;
+    s->history = history;
+    s->history_size = NK_TEXTEDIT_HISTORY_MIN_SIZE;
+    s->history_limit = limit ? limit: (nk_size)-1;
+    s->undo_begin = s->undo_end = 0;
+    s->redo_begin = s->history_size;
+    return nk_true;
 }
 NK_API void
 nk_textedit_undo(struct nk_text_edit *state)
 {
     struct nk_text_undo_state *s = &state->undo;
     struct nk_text_undo_record u, *r;
+    if (s->history) {
+        nk_textedit_history_undo(state);
+        return;
+    }
     if (s->undo_point == 0)
         return;
 
@@ -22582,6 +25718,10 @@ nk_textedit_redo(struct nk_text_edit *state)
 {
     struct nk_text_undo_state *s = &state->undo;
     struct nk_text_undo_record *u, r;
+    if (s->history) {
+        nk_textedit_history_redo(state);
+        return;
+    }
     if (s->redo_point == NK_TEXTEDIT_UNDOSTATECOUNT)
         return;
 
@@ -22629,13 +25769,20 @@ nk_textedit_redo(struct nk_text_edit *state)
 NK_INTERN void
 nk_textedit_makeundo_insert(struct nk_text_edit *state, int where, int length)
 {
-    nk_textedit_createundo(&state->undo, where, 0, length);
+    if (state->undo.history)
+        nk_textedit_history_push(state, where, 0, length);
+    else nk_textedit_createundo(&state->undo, where, 0, length);
 }
 NK_INTERN void
 nk_textedit_makeundo_delete(struct nk_text_edit *state, int where, int length)
 {
     int i;
-    nk_rune *p = nk_textedit_createundo(&state->undo, where, length, 0);
+    nk_rune *p;
+    if (state->undo.history) {
+        nk_textedit_history_push(state, where, length, 0);
+        return;
+    }
+    p = nk_textedit_createundo(&state->undo, where, length, 0);
     if (p) {
         for (i=0; i < length; ++i)
             p[i] = nk_str_rune_at(&state->string, where+i);
@@ -22646,7 +25793,12 @@ nk_textedit_makeundo_replace(struct nk_text_edit *state, int where,
     int old_length, int new_length)
 {
     int i;
-    nk_rune *p = nk_textedit_createundo(&state->undo, where, old_length, new_length);
+    nk_rune *p;
+    if (state->undo.history) {
+        nk_textedit_history_push(state, where, old_length, new_length);
+        return;
+    }
+    p = nk_textedit_createundo(&state->undo, where, old_length, new_length);
     if (p) {
         for (i=0; i < old_length; ++i)
             p[i] = nk_str_rune_at(&state->string, where+i);
@@ -22661,6 +25813,8 @@ nk_textedit_clear_state(struct nk_text_edit *state, enum nk_text_edit_type type,
    state->undo.undo_char_point = 0;
    state->undo.redo_point = NK_TEXTEDIT_UNDOSTATECOUNT;
    state->undo.redo_char_point = NK_TEXTEDIT_UNDOCHARCOUNT;
+   state->undo.undo_begin = state->undo.undo_end = 0;
+   state->undo.redo_begin = state->undo.history_size;
    state->select_end = state->select_start = 0;
    state->cursor = 0;
    state->has_preferred_x = 0;
@@ -22692,6 +25846,18 @@ nk_textedit_init(struct nk_text_edit *state, struct nk_allocator *alloc, nk_size
     nk_textedit_clear_state(state, NK_TEXT_EDIT_SINGLE_LINE, 0);
     nk_str_init(&state->string, alloc, size);
 }
+NK_API void
+nk_textedit_init_gap(struct nk_text_edit *state, struct nk_allocator *alloc, nk_size size)
+{
+    NK_ASSERT(state);
+    NK_ASSERT(alloc);
+    if (!state || !alloc) return;
+    NK_MEMSET(state, 0, sizeof(struct nk_text_edit));
+    nk_textedit_clear_state(state, NK_TEXT_EDIT_SINGLE_LINE, 0);
+    nk_str_init_gap(&state->string, alloc, size);
+    nk_str_build_index(&state->string, 0);
+    nk_textedit_undo_history(state, alloc, NK_TEXTEDIT_UNDO_LIMIT);
+}
 #ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
 NK_API void
 nk_textedit_init_default(struct nk_text_edit *state)
@@ -22702,6 +25868,17 @@ nk_textedit_init_default(struct nk_text_edit *state)
     nk_textedit_clear_state(state, NK_TEXT_EDIT_SINGLE_LINE, 0);
     nk_str_init_default(&state->string);
 }
+NK_API void
+nk_textedit_init_gap_default(struct nk_text_edit *state)
+{
+    NK_ASSERT(state);
+    if (!state) return;
+    NK_MEMSET(state, 0, sizeof(struct nk_text_edit));
+    nk_textedit_clear_state(state, NK_TEXT_EDIT_SINGLE_LINE, 0);
+    nk_str_init_gap_default(&state->string);
+    nk_str_build_index(&state->string, 0);
+    nk_textedit_undo_history(state, &state->string.buffer.pool, NK_TEXTEDIT_UNDO_LIMIT);
+}
 #endif
 NK_API void
 nk_textedit_select_all(struct nk_text_edit *state)
@@ -22716,6 +25893,11 @@ nk_textedit_free(struct nk_text_edit *state)
     NK_ASSERT(state);
     if (!state) return;
     nk_str_free(&state->string);
+    if (state->undo.history)
+        state->undo.pool.free(state->undo.pool.userdata, state->undo.history);
+    state->undo.history = 0;
+    state->undo.history_size = 0;
+    state->undo.undo_begin = state->undo.undo_end = state->undo.redo_begin = 0;
 }
 
 
@@ -22792,21 +25974,24 @@ nk_filter_binary(const struct nk_text_edit *box, nk_rune unicode)
 NK_LIB void
 nk_edit_draw_text(struct nk_command_buffer *out,
     const struct nk_style_edit *style, float pos_x, float pos_y,
-    float x_offset, const char *text, int byte_len, float row_height,
+    float x_offset, const struct nk_str *str, int begin, int end, float row_height,
     const struct nk_user_font *font, struct nk_color background,
     struct nk_color foreground, int is_selected)
 {
     NK_ASSERT(out);
     NK_ASSERT(font);
     NK_ASSERT(style);
-    if (!text || !byte_len || !out || !style) return;
+    if (!str || begin >= end || !out || !style) return;
 
     {int glyph_len = 0;
     nk_rune unicode = 0;
-    int text_len = 0;
+    int text_len = begin;
+    int avail = 0;
     float line_width = 0;
+    float line_x = 0;
     float glyph_width;
-    const char *line = text;
+    const char *text;
+    const char *line;
     float line_offset = 0;
     int line_count = 0;
 
@@ -22815,9 +26000,13 @@ nk_edit_draw_text(struct nk_command_buffer *out,
     txt.background = background;
     txt.text = foreground;
 
-    glyph_len = nk_utf_decode(text+text_len, &unicode, byte_len-text_len);
+    /* text is read in contiguous chunks since gap buffer strings
+     * are split in two at the insertion gap */
+    text = line = nk_str_text_at(str, text_len, &avail);
+    avail = NK_MIN(avail, end - text_len);
+    glyph_len = nk_utf_decode(text, &unicode, avail);
     if (!glyph_len) return;
-    while ((text_len < byte_len) && glyph_len)
+    while ((text_len < end) && glyph_len)
     {
         if (unicode == '\n') {
             /* new line separator so draw previous line */
@@ -22825,33 +26014,52 @@ nk_edit_draw_text(struct nk_command_buffer *out,
             label.y = pos_y + line_offset;
             label.h = row_height;
             label.w = line_width;
-            label.x = pos_x;
+            label.x = pos_x + line_x;
             if (!line_count)
                 label.x += x_offset;
 
             if (is_selected) /* selection needs to draw different background color */
                 nk_fill_rect(out, label, 0, background);
-            nk_widget_text(out, label, line, (int)((text + text_len) - line),
+            nk_widget_text(out, label, line, (int)(text - line),
                 &txt, NK_TEXT_CENTERED, font);
 
             text_len++;
             line_count++;
             line_width = 0;
-            line = text + text_len;
+            line_x = 0;
             line_offset += row_height;
-            glyph_len = nk_utf_decode(text + text_len, &unicode, (int)(byte_len-text_len));
-            continue;
+            text++; avail--;
+            line = text;
+        } else {
+            if (unicode != '\r') {
+                glyph_width = font->width(font->userdata, font->height, text, glyph_len);
+                line_width += (float)glyph_width;
+            }
+            text_len += glyph_len;
+            text += glyph_len;
+            avail -= glyph_len;
         }
-        if (unicode == '\r') {
-            text_len++;
-            glyph_len = nk_utf_decode(text + text_len, &unicode, byte_len-text_len);
-            continue;
+        if (!avail && text_len < end) {
+            /* reached the insertion gap so draw the current chunk */
+            if (text != line) {
+                struct nk_rect label;
+                label.y = pos_y + line_offset;
+                label.h = row_height;
+                label.w = line_width;
+                label.x = pos_x + line_x;
+                if (!line_count)
+                    label.x += x_offset;
+                if (is_selected)
+                    nk_fill_rect(out, label, 0, background);
+                nk_widget_text(out, label, line, (int)(text - line),
+                    &txt, NK_TEXT_LEFT, font);
+            }
+            line_x += line_width;
+            line_width = 0;
+            text = line = nk_str_text_at(str, text_len, &avail);
+            avail = NK_MIN(avail, end - text_len);
         }
-        glyph_width = font->width(font->userdata, font->height, text+text_len, glyph_len);
-        line_width += (float)glyph_width;
-        text_len += glyph_len;
-        glyph_len = nk_utf_decode(text + text_len, &unicode, byte_len-text_len);
-        continue;
+        glyph_len = nk_utf_decode(text, &unicode, avail);
     }
     if (line_width > 0) {
         /* draw last line */
@@ -22859,16 +26067,91 @@ nk_edit_draw_text(struct nk_command_buffer *out,
         label.y = pos_y + line_offset;
         label.h = row_height;
         label.w = line_width;
-        label.x = pos_x;
+        label.x = pos_x + line_x;
         if (!line_count)
             label.x += x_offset;
 
         if (is_selected)
             nk_fill_rect(out, label, 0, background);
-        nk_widget_text(out, label, line, (int)((text + text_len) - line),
+        nk_widget_text(out, label, line, (int)(text - line),
             &txt, NK_TEXT_LEFT, font);
     }}
 }
+struct nk_edit_view {
+    int begin, end; /* byte range of the visible lines */
+    float y; /* position of the first visible line */
+};
+NK_INTERN void
+nk_edit_view_init(struct nk_edit_view *view, const struct nk_str *str,
+    int len, float pos_y, float scroll_y, float height, float row_height)
+{
+    /* looks up the lines inside the visible area. Without a line index
+     * the whole text is treated as visible */
+    int rune, first, last, lines;
+    view->begin = 0;
+    view->end = len;
+    view->y = pos_y;
+    if (!str->index_stride || row_height <= 0) return;
+
+    lines = nk_str_line_count(str);
+    first = NK_CLAMP(0, (int)(scroll_y / row_height), lines - 1);
+    last = (int)((scroll_y + height) / row_height) + 1;
+    view->begin = nk_str_line_begin(str, first, &rune);
+    view->y = pos_y + (float)first * row_height;
+    if (last > first && last < lines)
+        view->end = nk_str_line_begin(str, last, &rune);
+}
+NK_INTERN void
+nk_edit_draw_view(struct nk_command_buffer *out, const struct nk_edit_view *view,
+    const struct nk_style_edit *style, float pos_x, float pos_y,
+    float x_offset, const struct nk_str *str, int begin, int end, float row_height,
+    const struct nk_user_font *font, struct nk_color background,
+    struct nk_color foreground, int is_selected)
+{
+    /* same as `nk_edit_draw_text` but only draws the visible lines */
+    if (begin < view->begin) {
+        begin = view->begin;
+        pos_y = view->y;
+        x_offset = 0;
+    }
+    end = NK_MIN(end, view->end);
+    nk_edit_draw_text(out, style, pos_x, pos_y, x_offset, str, begin, end,
+        row_height, font, background, foreground, is_selected);
+}
+NK_INTERN int
+nk_edit_locate(const struct nk_str *str, const struct nk_user_font *font,
+    int pos, float row_height, struct nk_vec2 *at)
+{
+    /* computes the position of codepoint `pos` by only measuring its own
+     * line and returns its byte offset or -1 at the end of the text */
+    const char *text;
+    int glyph_len;
+    int avail = 0;
+    int rune = 0;
+    int offset;
+    nk_rune unicode;
+    int line = nk_str_line_of(str, pos);
+
+    offset = nk_str_line_begin(str, line, &rune);
+    at->x = 0;
+    at->y = (float)line * row_height;
+    if (pos >= str->len)
+        at->y = (float)nk_str_line_count(str) * row_height - row_height;
+
+    text = nk_str_text_at(str, offset, &avail);
+    while (rune < pos && avail) {
+        glyph_len = nk_utf_decode(text, &unicode, avail);
+        if (!glyph_len) break;
+        if (unicode != '\r')
+            at->x += font->width(font->userdata, font->height, text, glyph_len);
+        rune++;
+        offset += glyph_len;
+        text += glyph_len;
+        avail -= glyph_len;
+        if (!avail) text = nk_str_text_at(str, offset, &avail);
+    }
+    return (pos < str->len) ? offset: -1;
+}
 NK_LIB nk_flags
 nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
     struct nk_rect bounds, nk_flags flags, nk_plugin_filter filter,
@@ -23002,7 +26285,7 @@ nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
 
             int begin = NK_MIN(b, e);
             int end = NK_MAX(b, e);
-            text = nk_str_at_const(&edit->string, begin, &unicode, &glyph_len);
+            text = nk_str_at_rune(&edit->string, begin, &unicode, &glyph_len);
             if (edit->clip.copy)
                 edit->clip.copy(edit->clip.userdata, text, end - begin);
             if (cut && !(flags & NK_EDIT_READ_ONLY)){
@@ -23035,8 +26318,7 @@ nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
         *state |= NK_WIDGET_STATE_HOVERED;
 
     /* DRAW EDIT */
-    {const char *text = nk_str_get_const(&edit->string);
-    int len = nk_str_len_char(&edit->string);
+    {int len = nk_str_len_char(&edit->string);
 
     {/* select background colors/images  */
     const struct nk_style_item *background;
@@ -23058,10 +26340,10 @@ nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
         int total_lines = 1;
         struct nk_vec2 text_size = nk_vec2(0,0);
 
-        /* text pointer positions */
-        const char *cursor_ptr = 0;
-        const char *select_begin_ptr = 0;
-        const char *select_end_ptr = 0;
+        /* text byte offsets */
+        int cursor_ofs = -1;
+        int select_begin_ofs = -1;
+        int select_end_ofs = -1;
 
         /* 2D pixel positions */
         struct nk_vec2 cursor_pos = nk_vec2(0,0);
@@ -23073,7 +26355,21 @@ nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
 
         /* calculate total line count + total space + cursor/selection position */
         float line_width = 0.0f;
-        if (text && len)
+        if (len && edit->string.index_stride)
+        {
+            /* the line index knows where each line starts so only the lines
+             * of the cursor and the selection have to be measured */
+            total_lines = nk_str_line_count(&edit->string);
+            text_size.y = (float)total_lines * row_height;
+            cursor_ofs = nk_edit_locate(&edit->string, font, edit->cursor,
+                row_height, &cursor_pos);
+            if (edit->select_start != edit->select_end) {
+                select_begin_ofs = nk_edit_locate(&edit->string, font,
+                    selection_begin, row_height, &selection_offset_start);
+                select_end_ofs = nk_edit_locate(&edit->string, font,
+                    selection_end, row_height, &selection_offset_end);
+            }
+        } else if (len)
         {
             /* utf8 encoding */
             float glyph_width;
@@ -23081,9 +26377,10 @@ nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
             nk_rune unicode = 0;
             int text_len = 0;
             int glyphs = 0;
-            int row_begin = 0;
+            int avail = 0;
+            const char *text = nk_str_text_at(&edit->string, 0, &avail);
 
-            glyph_len = nk_utf_decode(text, &unicode, len);
+            glyph_len = nk_utf_decode(text, &unicode, avail);
             glyph_width = font->width(font->userdata, font->height, text, glyph_len);
             line_width = 0;
 
@@ -23091,56 +26388,28 @@ nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
             while ((text_len < len) && glyph_len)
             {
                 /* set cursor 2D position and line */
-                if (!cursor_ptr && glyphs == edit->cursor)
-                {
-                    int glyph_offset;
-                    struct nk_vec2 out_offset;
-                    struct nk_vec2 row_size;
-                    const char *remaining;
-
-                    /* calculate 2d position */
+                if (cursor_ofs < 0 && glyphs == edit->cursor) {
                     cursor_pos.y = (float)(total_lines-1) * row_height;
-                    row_size = nk_text_calculate_text_bounds(font, text+row_begin,
-                                text_len-row_begin, row_height, &remaining,
-                                &out_offset, &glyph_offset, NK_STOP_ON_NEW_LINE);
-                    cursor_pos.x = row_size.x;
-                    cursor_ptr = text + text_len;
+                    cursor_pos.x = line_width;
+                    cursor_ofs = text_len;
                 }
 
                 /* set start selection 2D position and line */
-                if (!select_begin_ptr && edit->select_start != edit->select_end &&
+                if (select_begin_ofs < 0 && edit->select_start != edit->select_end &&
                     glyphs == selection_begin)
                 {
-                    int glyph_offset;
-                    struct nk_vec2 out_offset;
-                    struct nk_vec2 row_size;
-                    const char *remaining;
-
-                    /* calculate 2d position */
                     selection_offset_start.y = (float)(NK_MAX(total_lines-1,0)) * row_height;
-                    row_size = nk_text_calculate_text_bounds(font, text+row_begin,
-                                text_len-row_begin, row_height, &remaining,
-                                &out_offset, &glyph_offset, NK_STOP_ON_NEW_LINE);
-                    selection_offset_start.x = row_size.x;
-                    select_begin_ptr = text + text_len;
+                    selection_offset_start.x = line_width;
+                    select_begin_ofs = text_len;
                 }
 
                 /* set end selection 2D position and line */
-                if (!select_end_ptr && edit->select_start != edit->select_end &&
+                if (select_end_ofs < 0 && edit->select_start != edit->select_end &&
                     glyphs == selection_end)
                 {
-                    int glyph_offset;
-                    struct nk_vec2 out_offset;
-                    struct nk_vec2 row_size;
-                    const char *remaining;
-
-                    /* calculate 2d position */
                     selection_offset_end.y = (float)(total_lines-1) * row_height;
-                    row_size = nk_text_calculate_text_bounds(font, text+row_begin,
-                                text_len-row_begin, row_height, &remaining,
-                                &out_offset, &glyph_offset, NK_STOP_ON_NEW_LINE);
-                    selection_offset_end.x = row_size.x;
-                    select_end_ptr = text + text_len;
+                    selection_offset_end.x = line_width;
+                    select_end_ofs = text_len;
                 }
                 if (unicode == '\n') {
                     text_size.x = NK_MAX(text_size.x, line_width);
@@ -23148,25 +26417,20 @@ nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
                     line_width = 0;
                     text_len++;
                     glyphs++;
-                    row_begin = text_len;
-                    glyph_len = nk_utf_decode(text + text_len, &unicode, len-text_len);
-                    glyph_width = font->width(font->userdata, font->height, text+text_len, glyph_len);
-                    continue;
+                } else {
+                    glyphs++;
+                    text_len += glyph_len;
+                    if (unicode != '\r')
+                        line_width += (float)glyph_width;
                 }
-
-                glyphs++;
-                text_len += glyph_len;
-                line_width += (float)glyph_width;
-
-                glyph_len = nk_utf_decode(text + text_len, &unicode, len-text_len);
-                glyph_width = font->width(font->userdata, font->height,
-                    text+text_len, glyph_len);
-                continue;
+                text = nk_str_text_at(&edit->string, text_len, &avail);
+                glyph_len = nk_utf_decode(text, &unicode, avail);
+                glyph_width = font->width(font->userdata, font->height, text, glyph_len);
             }
             text_size.y = (float)total_lines * row_height;
 
             /* handle case when cursor is at end of text buffer */
-            if (!cursor_ptr && edit->cursor == edit->string.len) {
+            if (cursor_ofs < 0 && edit->cursor == edit->string.len) {
                 cursor_pos.x = line_width;
                 cursor_pos.y = text_size.y - row_height;
             }
@@ -23219,7 +26483,8 @@ nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
         }
 
         /* draw text */
-        {struct nk_color background_color;
+        {struct nk_edit_view view;
+        struct nk_color background_color;
         struct nk_color text_color;
         struct nk_color sel_background_color;
         struct nk_color sel_text_color;
@@ -23255,51 +26520,44 @@ nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
             background_color = nk_rgba(0,0,0,0);
         else background_color = background->data.color;
 
-
+        nk_edit_view_init(&view, &edit->string, len, area.y - edit->scrollbar.y,
+            edit->scrollbar.y, area.h, row_height);
         if (edit->select_start == edit->select_end) {
             /* no selection so just draw the complete text */
-            const char *begin = nk_str_get_const(&edit->string);
-            int l = nk_str_len_char(&edit->string);
-            nk_edit_draw_text(out, style, area.x - edit->scrollbar.x,
-                area.y - edit->scrollbar.y, 0, begin, l, row_height, font,
-                background_color, text_color, nk_false);
+            nk_edit_draw_view(out, &view, style, area.x - edit->scrollbar.x,
+                area.y - edit->scrollbar.y, 0, &edit->string, 0, len, row_height,
+                font, background_color, text_color, nk_false);
         } else {
             /* edit has selection so draw 1-3 text chunks */
             if (edit->select_start != edit->select_end && selection_begin > 0){
                 /* draw unselected text before selection */
-                const char *begin = nk_str_get_const(&edit->string);
-                NK_ASSERT(select_begin_ptr);
-                nk_edit_draw_text(out, style, area.x - edit->scrollbar.x,
-                    area.y - edit->scrollbar.y, 0, begin, (int)(select_begin_ptr - begin),
+                NK_ASSERT(select_begin_ofs >= 0);
+                nk_edit_draw_view(out, &view, style, area.x - edit->scrollbar.x,
+                    area.y - edit->scrollbar.y, 0, &edit->string, 0, select_begin_ofs,
                     row_height, font, background_color, text_color, nk_false);
             }
             if (edit->select_start != edit->select_end) {
                 /* draw selected text */
-                NK_ASSERT(select_begin_ptr);
-                if (!select_end_ptr) {
-                    const char *begin = nk_str_get_const(&edit->string);
-                    select_end_ptr = begin + nk_str_len_char(&edit->string);
-                }
-                nk_edit_draw_text(out, style,
+                NK_ASSERT(select_begin_ofs >= 0);
+                if (select_end_ofs < 0)
+                    select_end_ofs = len;
+                nk_edit_draw_view(out, &view, style,
                     area.x - edit->scrollbar.x,
                     area.y + selection_offset_start.y - edit->scrollbar.y,
                     selection_offset_start.x,
-                    select_begin_ptr, (int)(select_end_ptr - select_begin_ptr),
+                    &edit->string, select_begin_ofs, select_end_ofs,
                     row_height, font, sel_background_color, sel_text_color, nk_true);
             }
             if ((edit->select_start != edit->select_end &&
                 selection_end < edit->string.len))
             {
                 /* draw unselected text after selected text */
-                const char *begin = select_end_ptr;
-                const char *end = nk_str_get_const(&edit->string) +
-                                    nk_str_len_char(&edit->string);
-                NK_ASSERT(select_end_ptr);
-                nk_edit_draw_text(out, style,
+                NK_ASSERT(select_end_ofs >= 0);
+                nk_edit_draw_view(out, &view, style,
                     area.x - edit->scrollbar.x,
                     area.y + selection_offset_end.y - edit->scrollbar.y,
                     selection_offset_end.x,
-                    begin, (int)(end - begin), row_height, font,
+                    &edit->string, select_end_ofs, len, row_height, font,
                     background_color, text_color, nk_true);
             }
         }
@@ -23307,6 +26565,9 @@ nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
         /* cursor */
         if (edit->select_start == edit->select_end)
         {
+            int avail = 0;
+            const char *cursor_ptr = (cursor_ofs < 0) ? 0:
+                nk_str_text_at(&edit->string, cursor_ofs, &avail);
             if (edit->cursor >= nk_str_len(&edit->string) ||
                 (cursor_ptr && *cursor_ptr == '\n')) {
                 /* draw cursor at end of line */
@@ -23325,7 +26586,7 @@ nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
 
                 nk_rune unicode;
                 NK_ASSERT(cursor_ptr);
-                glyph_len = nk_utf_decode(cursor_ptr, &unicode, 4);
+                glyph_len = nk_utf_decode(cursor_ptr, &unicode, avail);
 
                 label.x = area.x + cursor_pos.x - edit->scrollbar.x;
                 label.y = area.y + cursor_pos.y - edit->scrollbar.y;
@@ -23341,9 +26602,7 @@ nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
         }}
     } else {
         /* not active so just draw text */
-        int l = nk_str_len_char(&edit->string);
-        const char *begin = nk_str_get_const(&edit->string);
-
+        struct nk_edit_view view;
         const struct nk_style_item *background;
         struct nk_color background_color;
         struct nk_color text_color;
@@ -23361,9 +26620,11 @@ nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
         if (background->type == NK_STYLE_ITEM_IMAGE)
             background_color = nk_rgba(0,0,0,0);
         else background_color = background->data.color;
-        nk_edit_draw_text(out, style, area.x - edit->scrollbar.x,
-            area.y - edit->scrollbar.y, 0, begin, l, row_height, font,
-            background_color, text_color, nk_false);
+        nk_edit_view_init(&view, &edit->string, len, area.y - edit->scrollbar.y,
+            edit->scrollbar.y, area.h, row_height);
+        nk_edit_draw_view(out, &view, style, area.x - edit->scrollbar.x,
+            area.y - edit->scrollbar.y, 0, &edit->string, 0, len, row_height,
+            font, background_color, text_color, nk_false);
     }
     nk_push_scissor(out, old_clip);}
     return ret;
@@ -24273,6 +27534,311 @@ nk_chart_push(struct nk_context *ctx, float value)
 {
     return nk_chart_push_slot(ctx, value, 0);
 }
+struct nk_chart_source {
+    const char *values;
+    nk_size stride;
+    void *userdata;
+    float(*getter)(void *user, int index);
+    int offset;
+};
+struct nk_chart_polyline {
+    struct nk_command_buffer *out;
+    struct nk_command_polyline *cmd;
+    struct nk_color color;
+    int capacity;
+    int remaining;
+    int test, hit;
+    struct nk_vec2 mouse;
+    struct nk_vec2i hit_pos;
+};
+NK_INTERN float
+nk_chart_source_value(const struct nk_chart_source *src, int index)
+{
+    if (src->getter)
+        return src->getter(src->userdata, src->offset + index);
+    return *(const float*)(const void*)(src->values + (nk_size)index * src->stride);
+}
+NK_INTERN void
+nk_chart_polyline_hit(struct nk_chart_polyline *line)
+{
+    /* points are sorted by x so a binary search finds the first point
+     * inside the hover box and only the points below the mouse are checked */
+    int lo = 0, hi, best = 3 * 3 + 3 * 3 + 1;
+    const struct nk_vec2i *p;
+    if (!line->cmd || !line->test) return;
+
+    p = line->cmd->points;
+    hi = line->cmd->point_count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if ((float)p[mid].x < line->mouse.x - 3) lo = mid + 1;
+        else hi = mid;
+    }
+    for (; lo < line->cmd->point_count && (float)p[lo].x <= line->mouse.x + 3; ++lo) {
+        float dx = (float)p[lo].x - line->mouse.x;
+        float dy = (float)p[lo].y - line->mouse.y;
+        if (NK_ABS(dy) <= 3 && (int)(dx*dx + dy*dy) < best) {
+            best = (int)(dx*dx + dy*dy);
+            line->hit_pos = p[lo];
+            line->hit = nk_true;
+        }
+    }
+}
+NK_INTERN void
+nk_chart_polyline_add(struct nk_chart_polyline *line, float x, float y)
+{
+    struct nk_vec2i *p;
+    if (!line->out) return;
+    if (!line->cmd || line->cmd->point_count >= line->capacity) {
+        /* polylines hold at most 65535 points so long series continue
+         * in a new command starting at the last point */
+        nk_size size;
+        struct nk_vec2i last = {0,0};
+        int split = (line->cmd != 0);
+        if (split) {
+            last = line->cmd->points[line->cmd->point_count-1];
+            nk_chart_polyline_hit(line);
+            line->remaining++;
+        }
+        line->capacity = NK_CLAMP(2, line->remaining, 0xFFFF);
+        size = sizeof(*line->cmd) + sizeof(short) * 2 * (nk_size)line->capacity;
+        line->cmd = (struct nk_command_polyline*)
+            nk_command_buffer_push(line->out, NK_COMMAND_POLYLINE, size);
+        if (!line->cmd) {
+            line->out = 0;
+            return;
+        }
+        line->cmd->color = line->color;
+        line->cmd->line_thickness = 1;
+        line->cmd->point_count = 0;
+        if (split) {
+            line->cmd->points[line->cmd->point_count++] = last;
+            line->remaining--;
+        }
+    }
+    p = &line->cmd->points[line->cmd->point_count++];
+    p->x = (short)x;
+    p->y = (short)y;
+    line->remaining--;
+}
+NK_INTERN nk_flags
+nk_chart_push_samples(struct nk_context *ctx, struct nk_window *win,
+    struct nk_chart *g, const struct nk_chart_source *src, int count,
+    enum nk_chart_sampling sampling, int slot)
+{
+    /* draws a whole series as a single polyline with markers if the values
+     * are far enough apart. Series with more than two values per pixel are
+     * reduced to the smallest and biggest value of each pixel column or to
+     * one value per column picked by largest triangle three buckets (LTTB). */
+    const struct nk_input *in = &ctx->input;
+    struct nk_chart_slot *s = &g->slots[slot];
+    struct nk_chart_polyline line;
+    int i, start, columns;
+    float step, bottom, scale, value;
+    nk_flags ret = 0;
+
+    NK_ASSERT(slot >= 0 && slot < NK_CHART_MAX_SLOT);
+    if (count <= 0 || s->count <= 0) return 0;
+    start = s->index;
+    step = g->w / (float)s->count;
+    bottom = g->y + g->h;
+    scale = (s->range != 0) ? g->h / s->range: 0;
+    #define NK_CHART_X(index) (g->x + step * (float)(start + (index)))
+    #define NK_CHART_Y(value) (bottom - ((value) - s->min) * scale)
+
+    nk_zero(&line, sizeof(line));
+    line.out = &win->buffer;
+    line.color = s->color;
+    line.mouse = in->mouse.pos;
+    line.test = !(win->layout->flags & NK_WINDOW_ROM) &&
+        NK_INBOX(in->mouse.pos.x, in->mouse.pos.y, g->x - 3, g->y - 3, g->w + 6, g->h + 6);
+
+    /* reserve enough points for the whole series up front */
+    columns = NK_MAX(nk_iceilf(step * (float)count), 1);
+    if (count <= 2 * columns)
+        line.remaining = count;
+    else if (sampling == NK_CHART_SAMPLE_LTTB)
+        line.remaining = NK_MAX(columns, 3);
+    else line.remaining = 2 * (columns + 1);
+
+    /* continue from the last data point of previous pushes */
+    if (start > 0) {
+        line.remaining++;
+        nk_chart_polyline_add(&line, s->last.x, s->last.y);
+    }
+    if (count <= 2 * columns) {
+        for (i = 0; i < count; ++i) {
+            value = nk_chart_source_value(src, i);
+            nk_chart_polyline_add(&line, NK_CHART_X(i), NK_CHART_Y(value));
+        }
+    } else if (sampling == NK_CHART_SAMPLE_LTTB) {
+        int a = 0, bucket, buckets = NK_MAX(columns, 3) - 2;
+        float every = (float)(count - 2) / (float)buckets;
+        float a_value = nk_chart_source_value(src, 0);
+
+        nk_chart_polyline_add(&line, NK_CHART_X(0), NK_CHART_Y(a_value));
+        for (bucket = 0; bucket < buckets; ++bucket) {
+            int j, pick;
+            int lo = (int)((float)bucket * every) + 1;
+            int hi = NK_MIN((int)((float)(bucket + 1) * every) + 1, count - 1);
+            int next = NK_MIN((int)((float)(bucket + 2) * every) + 1, count);
+            float avg_x = 0, avg_y = 0, area = -1, pick_value;
+            if (lo >= hi) continue;
+
+            /* average of the next bucket is the third triangle corner */
+            if (hi < next) {
+                for (j = hi; j < next; ++j)
+                    avg_y += nk_chart_source_value(src, j);
+                avg_x = (float)(hi + next - 1) * 0.5f;
+                avg_y /= (float)(next - hi);
+            } else {
+                avg_x = (float)(count - 1);
+                avg_y = nk_chart_source_value(src, count - 1);
+            }
+            pick = lo;
+            pick_value = a_value;
+            for (j = lo; j < hi; ++j) {
+                float v = nk_chart_source_value(src, j);
+                float t = ((float)a - avg_x) * (v - a_value) -
+                    ((float)a - (float)j) * (avg_y - a_value);
+                t = NK_ABS(t);
+                if (t > area) {
+                    area = t;
+                    pick = j;
+                    pick_value = v;
+                }
+            }
+            nk_chart_polyline_add(&line, NK_CHART_X(pick), NK_CHART_Y(pick_value));
+            a = pick;
+            a_value = pick_value;
+        }
+        value = nk_chart_source_value(src, count - 1);
+        nk_chart_polyline_add(&line, NK_CHART_X(count - 1), NK_CHART_Y(value));
+    } else {
+        int column = -1, lo = 0, hi = 0;
+        float lo_value = 0, hi_value = 0;
+
+        for (i = 0; i <= count; ++i) {
+            int c = (i < count) ? (int)(step * (float)(start + i)): -1;
+            value = (i < count) ? nk_chart_source_value(src, i): 0;
+            if (c == column) {
+                if (value < lo_value) {lo = i; lo_value = value;}
+                if (value > hi_value) {hi = i; hi_value = value;}
+                continue;
+            }
+            /* emit extremes of the finished column in series order */
+            if (column >= 0) {
+                if (lo == hi) {
+                    nk_chart_polyline_add(&line, NK_CHART_X(lo), NK_CHART_Y(lo_value));
+                } else if (lo < hi) {
+                    nk_chart_polyline_add(&line, NK_CHART_X(lo), NK_CHART_Y(lo_value));
+                    nk_chart_polyline_add(&line, NK_CHART_X(hi), NK_CHART_Y(hi_value));
+                } else {
+                    nk_chart_polyline_add(&line, NK_CHART_X(hi), NK_CHART_Y(hi_value));
+                    nk_chart_polyline_add(&line, NK_CHART_X(lo), NK_CHART_Y(lo_value));
+                }
+            }
+            column = c;
+            lo = hi = i;
+            lo_value = hi_value = value;
+        }
+    }
+    nk_chart_polyline_hit(&line);
+
+    /* markers are only drawn if they do not overlap */
+    if (count <= 2 * columns && step >= NK_CHART_MARKER_SPACING) {
+        for (i = 0; i < count; ++i) {
+            value = nk_chart_source_value(src, i);
+            nk_fill_rect(&win->buffer, nk_rect(NK_CHART_X(i) - 2,
+                NK_CHART_Y(value) - 2, 4, 4), 0, s->color);
+        }
+    }
+
+    /* save last data point position */
+    value = nk_chart_source_value(src, count - 1);
+    s->last.x = NK_CHART_X(count - 1);
+    s->last.y = NK_CHART_Y(value);
+    s->index += count;
+    #undef NK_CHART_X
+    #undef NK_CHART_Y
+
+    /* user selection of the data point below the mouse */
+    if (line.hit) {
+        ret = NK_CHART_HOVERING;
+        ret |= (!in->mouse.buttons[NK_BUTTON_LEFT].down &&
+            in->mouse.buttons[NK_BUTTON_LEFT].clicked) ? NK_CHART_CLICKED: 0;
+        nk_fill_rect(&win->buffer, nk_rect((float)line.hit_pos.x - 2,
+            (float)line.hit_pos.y - 2, 4, 4), 0, s->highlight);
+    }
+    return ret;
+}
+NK_INTERN nk_flags
+nk_chart_push_source(struct nk_context *ctx, const struct nk_chart_source *src,
+    int count, enum nk_chart_sampling sampling, int slot)
+{
+    int i;
+    nk_flags flags = 0;
+    struct nk_window *win;
+
+    NK_ASSERT(ctx);
+    NK_ASSERT(ctx->current);
+    NK_ASSERT(slot >= 0 && slot < NK_CHART_MAX_SLOT);
+    NK_ASSERT(slot < ctx->current->layout->chart.slot);
+    if (!ctx || !ctx->current || slot < 0 || slot >= NK_CHART_MAX_SLOT) return nk_false;
+    if (slot >= ctx->current->layout->chart.slot) return nk_false;
+
+    win = ctx->current;
+    switch (win->layout->chart.slots[slot].type) {
+    case NK_CHART_LINES:
+        flags = nk_chart_push_samples(ctx, win, &win->layout->chart, src,
+            count, sampling, slot); break;
+    case NK_CHART_COLUMN:
+        for (i = 0; i < count; ++i)
+            flags |= nk_chart_push_column(ctx, win, &win->layout->chart,
+                nk_chart_source_value(src, i), slot);
+        break;
+    default:
+    case NK_CHART_MAX:
+        flags = 0;
+    }
+    return flags;
+}
+NK_API nk_flags
+nk_chart_push_series_slot(struct nk_context *ctx, const float *values, int count,
+    enum nk_chart_sampling sampling, int slot)
+{
+    struct nk_chart_source src;
+    NK_ASSERT(values || !count);
+    if (!values || count <= 0) return nk_false;
+    nk_zero(&src, sizeof(src));
+    src.values = (const char*)values;
+    src.stride = sizeof(float);
+    return nk_chart_push_source(ctx, &src, count, sampling, slot);
+}
+NK_API nk_flags
+nk_chart_push_series(struct nk_context *ctx, const float *values, int count,
+    enum nk_chart_sampling sampling)
+{
+    return nk_chart_push_series_slot(ctx, values, count, sampling, 0);
+}
+NK_API nk_flags
+nk_chart_push_array_slot(struct nk_context *ctx, const float *values, int count,
+    int stride, int slot)
+{
+    struct nk_chart_source src;
+    NK_ASSERT(values || !count);
+    NK_ASSERT(stride >= 0);
+    if (!values || count <= 0 || stride < 0) return nk_false;
+    nk_zero(&src, sizeof(src));
+    src.values = (const char*)values;
+    src.stride = stride ? (nk_size)stride: sizeof(float);
+    return nk_chart_push_source(ctx, &src, count, NK_CHART_SAMPLE_MINMAX, slot);
+}
+NK_API nk_flags
+nk_chart_push_array(struct nk_context *ctx, const float *values, int count, int stride)
+{
+    return nk_chart_push_array_slot(ctx, values, count, stride, 0);
+}
 NK_API void
 nk_chart_end(struct nk_context *ctx)
 {
@@ -24309,7 +27875,9 @@ nk_plot(struct nk_context *ctx, enum nk_chart_type type, const float *values,
     }
 
     if (nk_chart_begin(ctx, type, count, min_value, max_value)) {
-        for (i = 0; i < count; ++i)
+        if (type == NK_CHART_LINES)
+            nk_chart_push_array(ctx, values + offset, count, 0);
+        else for (i = 0; i < count; ++i)
             nk_chart_push(ctx, values[i + offset]);
         nk_chart_end(ctx);
     }
@@ -24334,7 +27902,14 @@ nk_plot_function(struct nk_context *ctx, enum nk_chart_type type, void *userdata
     }
 
     if (nk_chart_begin(ctx, type, count, min_value, max_value)) {
-        for (i = 0; i < count; ++i)
+        if (type == NK_CHART_LINES) {
+            struct nk_chart_source src;
+            nk_zero(&src, sizeof(src));
+            src.userdata = userdata;
+            src.getter = value_getter;
+            src.offset = offset;
+            nk_chart_push_source(ctx, &src, count, NK_CHART_SAMPLE_MINMAX, 0);
+        } else for (i = 0; i < count; ++i)
             nk_chart_push(ctx, value_getter(userdata, i + offset));
         nk_chart_end(ctx);
     }
@@ -25310,6 +28885,192 @@ nk_combobox_callback(struct nk_context *ctx,
 
 
 
+/* ===============================================================
+ *
+ *                          COMBO LIST
+ *
+ * ===============================================================*/
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+NK_API void
+nk_combo_list_init_default(struct nk_combo_list *list, int count,
+    nk_plugin_item_text text, nk_handle userdata)
+{
+    struct nk_allocator alloc;
+    alloc.userdata.ptr = 0;
+    alloc.alloc = nk_malloc;
+    alloc.free = nk_mfree;
+    nk_combo_list_init(list, &alloc, count, text, userdata);
+}
+#endif
+NK_API void
+nk_combo_list_init(struct nk_combo_list *list, const struct nk_allocator *alloc,
+    int count, nk_plugin_item_text text, nk_handle userdata)
+{
+    NK_ASSERT(list);
+    NK_ASSERT(alloc);
+    NK_ASSERT(text);
+    if (!list || !alloc || !text) return;
+    NK_MEMSET(list, 0, sizeof(*list));
+    list->pool = *alloc;
+    list->text = text;
+    list->userdata = userdata;
+    list->count = NK_MAX(count, 0);
+    list->selected = -1;
+}
+NK_API void
+nk_combo_list_free(struct nk_combo_list *list)
+{
+    NK_ASSERT(list);
+    if (!list) return;
+    if (list->matches && list->pool.free)
+        list->pool.free(list->pool.userdata, list->matches);
+    list->matches = 0;
+    list->match_count = list->capacity = 0;
+    list->valid = nk_false;
+}
+NK_API void
+nk_combo_list_reset(struct nk_combo_list *list, int count)
+{
+    NK_ASSERT(list);
+    if (!list) return;
+    list->count = NK_MAX(count, 0);
+    if (list->selected >= list->count)
+        list->selected = -1;
+    list->valid = nk_false;
+}
+NK_INTERN int
+nk_combo_list_match(struct nk_combo_list *list, int item)
+{
+    int len = 0, score;
+    const char *text = list->text(list->userdata, item, &len);
+    return text && nk_strmatch_fuzzy_text(text, len, list->filter, &score);
+}
+NK_INTERN int
+nk_combo_list_prefix(const char *prefix, int len, const char *text)
+{
+    int i;
+    for (i = 0; i < len; ++i)
+        if (prefix[i] != text[i]) return nk_false;
+    return nk_true;
+}
+NK_INTERN void
+nk_combo_list_update(struct nk_combo_list *list)
+{
+    int i, n = 0;
+    int query_len = nk_strlen(list->query);
+    int extended = list->valid && nk_combo_list_prefix(list->query, query_len, list->filter);
+    if (extended && query_len == list->filter_len)
+        return;
+
+    if (!list->filter_len) {
+        /* no filter so rows map directly to items */
+        list->match_count = list->count;
+    } else if (extended && query_len) {
+        /* a longer pattern can only match a subset of the previous matches */
+        for (i = 0; i < list->match_count; ++i)
+            if (nk_combo_list_match(list, list->matches[i]))
+                list->matches[n++] = list->matches[i];
+        list->match_count = n;
+    } else {
+        if (list->capacity < list->count) {
+            int *matches;
+            list->match_count = 0;
+            if (!list->pool.alloc || !list->pool.free) return;
+            matches = (int*)list->pool.alloc(list->pool.userdata, 0,
+                (nk_size)list->count * sizeof(int));
+            if (!matches) return;
+            if (list->matches)
+                list->pool.free(list->pool.userdata, list->matches);
+            list->matches = matches;
+            list->capacity = list->count;
+        }
+        for (i = 0; i < list->count; ++i)
+            if (nk_combo_list_match(list, i))
+                list->matches[n++] = i;
+        list->match_count = n;
+    }
+    NK_MEMCPY(list->query, list->filter, (nk_size)list->filter_len + 1);
+    list->valid = nk_true;
+}
+NK_API int
+nk_combo_list(struct nk_context *ctx, struct nk_combo_list *list,
+    int item_height, struct nk_vec2 size)
+{
+    int i, len = 0, picked = -1;
+    nk_flags events;
+    const char *label = 0;
+    float height;
+    struct nk_list_view view;
+    struct nk_panel *layout;
+    const struct nk_style *style;
+
+    NK_ASSERT(ctx);
+    NK_ASSERT(list);
+    NK_ASSERT(list->text);
+    if (!ctx || !list || !list->text || !ctx->current)
+        return list ? list->selected: -1;
+
+    if (list->selected >= 0 && list->selected < list->count)
+        label = list->text(list->userdata, list->selected, &len);
+    if (!nk_combo_begin_text(ctx, label ? label: "", label ? len: 0, size)) {
+        list->open = nk_false;
+        return list->selected;
+    }
+
+    /* filter edit field which keeps the keyboard focus while open */
+    style = &ctx->style;
+    nk_layout_row_dynamic(ctx, (float)item_height, 1);
+    if (!list->open) {
+        list->filter[0] = 0;
+        list->filter_len = 0;
+        list->open = nk_true;
+    }
+    nk_edit_focus(ctx, 0);
+    events = nk_edit_string(ctx, NK_EDIT_FIELD|NK_EDIT_SIG_ENTER, list->filter,
+        &list->filter_len, NK_COMBO_LIST_FILTER_SIZE - 1, 0);
+    list->filter[list->filter_len] = 0;
+    nk_combo_list_update(list);
+    if ((events & NK_EDIT_COMMITED) && list->match_count)
+        picked = list->filter_len ? list->matches[0]: 0;
+
+    /* let the list fill the remaining popup space */
+    layout = ctx->current->layout;
+    height = layout->bounds.y + layout->bounds.h - (layout->at_y + layout->row.height);
+    height -= 2 * style->window.spacing.y;
+    nk_layout_row_dynamic(ctx, NK_MAX(height, (float)item_height), 1);
+    if (nk_list_view_begin(ctx, &view, "nk_combo_list", 0, item_height, list->match_count)) {
+        const struct nk_input *in;
+        nk_layout_row_dynamic(ctx, (float)item_height, 1);
+        for (i = view.begin; i < view.end; ++i) {
+            struct nk_rect bounds;
+            enum nk_widget_layout_states state;
+            int item = list->filter_len ? list->matches[i]: i;
+
+            /* items are drawn like combo items but the popup can only be
+             * closed after the list group has been finished */
+            state = nk_widget_fitting(&bounds, ctx, style->contextual_button.padding);
+            if (!state) continue;
+            in = (state == NK_WIDGET_ROM || ctx->current->layout->flags & NK_WINDOW_ROM) ?
+                0: &ctx->input;
+            label = list->text(list->userdata, item, &len);
+            if (nk_do_button_text(&ctx->last_widget_state, &ctx->current->buffer, bounds,
+                label ? label: "", label ? len: 0, NK_TEXT_LEFT, NK_BUTTON_DEFAULT,
+                &style->contextual_button, in, style->font))
+                picked = item;
+        }
+        nk_list_view_end(&view);
+    }
+    if (picked >= 0) {
+        list->selected = picked;
+        nk_combo_close(ctx);
+    }
+    nk_combo_end(ctx);
+    return list->selected;
+}
+
+
+
+
 /* ===============================================================
  *
  *                              TOOLTIP
@@ -25475,6 +29236,44 @@ nk_tooltipfv(struct nk_context *ctx, const char *fmt, va_list args)
 ///    - [yy]: Minor version with non-breaking API and library changes
 ///    - [zz]: Bug fix version with no direct changes to API
 ///
+/// - 2026/10/18 (4.16.0) - Added `nk_record_begin`, `nk_record_end` and `nk_record_resize` to
+///                        record all input of a context together with its surface size and
+///                        the draw command hash of every frame, and `nk_replay_init`,
+///                        `nk_replay_frame` and `nk_replay_check` to replay it.
+/// - 2026/10/18 (4.15.0) - Added `nk_needs_redraw`, `nk_redraw_deadline` and `nk_request_redraw`
+///                        so backends can block on input while the UI is idle, and
+///                        `nk_frame_hash` to hash the draw commands of a frame.
+/// - 2026/10/18 (4.14.1) - Fixed `nk__begin` returning a command from freed memory when the
+///                        cursor overlay grew a dynamic command buffer.
+/// - 2026/10/18 (4.14.0) - Added `nk_group_begin_lazy` and `nk_group_get_content_height` to skip
+///                        filling invisible groups while keeping their measured height.
+/// - 2026/10/18 (4.13.0) - Added `nk_fuzzy_matcher` to fuzzy match a pattern against big string
+///                        arrays and return the best results sorted by score.
+/// - 2026/10/18 (4.12.0) - Added `nk_combo_list`, a combobox with a virtualized popup list for
+///                        callback items and a fuzzy type-ahead filter.
+/// - 2026/10/18 (4.11.0) - Added `nk_chart_push_array` for strided float arrays. Line series are
+///                        drawn as one polyline with markers only if points are far enough
+///                        apart, which `nk_plot` and `nk_plot_function` now use for lines.
+/// - 2026/10/18 (4.10.0) - Added `nk_chart_push_series` which draws a line series as one polyline
+///                        downsampled to the chart width by min/max or LTTB. `nk_plot` and
+///                        `nk_plot_function` use it for series wider than the chart.
+/// - 2026/10/18 (4.09.0) - Added `nk_tree_view` which keeps open nodes in a flattened row cache,
+///                        enumerates children lazily and only draws visible rows.
+/// - 2026/10/18 (4.08.0) - Added `nk_grid`, a virtualized table with frozen header rows and
+///                        columns, column resizing and a cell draw callback.
+/// - 2026/10/18 (4.07.0) - Added `nk_list_view_begin_variable` and `nk_row_heights` for list views
+///                        with individual row heights.
+/// - 2026/10/18 (4.06.0) - Added `nk_textedit_undo_history` for a growable undo history bounded
+///                        by a memory limit, used by default in gap buffer text editors.
+/// - 2026/10/18 (4.05.0) - Added `nk_text_view`, a read-only viewer for huge memory mapped or
+///                        callback backed texts which only reads the visible lines.
+/// - 2026/10/18 (4.04.0) - The rune offset index now tracks line starts and text editors with
+///                        an index only layout and draw the visible lines.
+/// - 2026/10/18 (4.03.0) - Added `nk_str_build_index` to keep a rune offset index inside
+///                        dynamic strings which makes codepoint lookups O(log n).
+/// - 2026/10/18 (4.02.0) - Added gap buffer strings and text editors (`nk_str_init_gap`,
+///                        `nk_textedit_init_gap`) which keep edits near the cursor cheap
+///                        for large texts.
 /// - 2019/09/20 (4.01.3) - Fixed a bug wherein combobox cannot be closed by clicking the header
 ///                        when NK_BUTTON_TRIGGER_ON_RELEASE is defined.
 /// - 2019/09/10 (4.01.2) - Fixed the nk_cos function, which deviated significantly.
@@ -219,6 +219,7 @@ struct nk_draw_list;
 struct nk_user_font;
 struct nk_panel;
 struct nk_context;
+struct nk_replay;
 struct nk_draw_vertex_layout_element;
 struct nk_style_button;
 struct nk_style_toggle;
@@ -255,6 +256,7 @@ enum nk_collapse_states {NK_MINIMIZED = nk_false, NK_MAXIMIZED = nk_true};
 enum nk_show_states     {NK_HIDDEN = nk_false, NK_SHOWN = nk_true};
 enum nk_chart_type      {NK_CHART_LINES, NK_CHART_COLUMN, NK_CHART_MAX};
 enum nk_chart_event     {NK_CHART_HOVERING = 0x01, NK_CHART_CLICKED = 0x02};
+enum nk_chart_sampling  {NK_CHART_SAMPLE_MINMAX, NK_CHART_SAMPLE_LTTB};
 enum nk_color_format    {NK_RGB, NK_RGBA};
 enum nk_popup_type      {NK_POPUP_STATIC, NK_POPUP_DYNAMIC};
 enum nk_layout_format   {NK_DYNAMIC, NK_STATIC};
@@ -447,6 +449,71 @@ NK_API void nk_free(struct nk_context*);
 */
 NK_API void nk_set_user_data(struct nk_context*, nk_handle handle);
 #endif
+/*/// #### nk_needs_redraw
+/// Returns whether another frame has to be built right away or if the
+/// application can block until the next input event or the deadline
+/// returned by `nk_redraw_deadline`. Has to be called after `nk_clear`.
+/// A frame is needed after clicks, key or text input, scrolling, while a
+/// mouse button is held down and while the drawn output still changes.
+/// Mouse motion only counts if it changed the output, for example by
+/// hovering a widget. Tracking starts with the first call, which always
+/// returns `true(1)`.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// int nk_needs_redraw(struct nk_context *ctx);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to a previously initialized `nk_context` struct
+///
+/// Returns `true(1)` if the next frame should not wait for input
+*/
+NK_API int nk_needs_redraw(struct nk_context*);
+/*/// #### nk_redraw_deadline
+/// Returns the number of seconds the application can wait for input before
+/// the next frame has to be built anyway, for example to hide scrollbars
+/// after `NK_SCROLLBAR_HIDING_TIMEOUT`. Returns 0 if a frame is needed now
+/// and a negative value if there is no deadline.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// float nk_redraw_deadline(const struct nk_context *ctx);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to a previously initialized `nk_context` struct
+*/
+NK_API float nk_redraw_deadline(const struct nk_context*);
+/*/// #### nk_request_redraw
+/// Requests a frame at the latest after the given number of seconds, for
+/// example for animations or blinking cursors. Only the earliest request
+/// made while building a frame is kept.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// void nk_request_redraw(struct nk_context *ctx, float seconds);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to a previously initialized `nk_context` struct
+/// __seconds__ | Time from the end of the current frame, 0 for the next frame
+*/
+NK_API void nk_request_redraw(struct nk_context*, float seconds);
+/*/// #### nk_frame_hash
+/// Hashes all draw commands of the current frame in drawing order. Fonts,
+/// image handles and custom callbacks are left out so the hash of a frame
+/// is the same between runs of a program. Has to be called before `nk_clear`.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// nk_hash nk_frame_hash(struct nk_context *ctx);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to a previously initialized `nk_context` struct
+*/
+NK_API nk_hash nk_frame_hash(struct nk_context*);
 /* =============================================================================
  *
  *                                  INPUT
@@ -691,6 +758,105 @@ NK_API void nk_input_unicode(struct nk_context*, nk_rune);
 /// __ctx__     | Must point to a previously initialized `nk_context` struct
 */
 NK_API void nk_input_end(struct nk_context*);
+/*/// #### nk_record_begin
+/// Starts recording all following `nk_input_xxx` calls together with frame
+/// boundaries into a buffer. Each cleared frame additionally stores the
+/// `nk_frame_hash` of its draw commands so a replay can verify them.
+/// Input written directly into `nk_context::input` is not recorded, except for
+/// the mouse position at the end of each frame, which backends overwrite to
+/// hold the cursor in place while the mouse is grabbed.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// int nk_record_begin(struct nk_context *ctx, struct nk_buffer *out);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to a previously initialized `nk_context` struct
+/// __out__     | Must point to an initialized buffer that the recording is appended to
+///
+/// Returns `false(0)` if the context is already recording
+*/
+NK_API int nk_record_begin(struct nk_context*, struct nk_buffer *out);
+/*/// #### nk_record_end
+/// Stops recording. The buffer passed to `nk_record_begin` holds the recording.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// void nk_record_end(struct nk_context *ctx);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to a previously initialized `nk_context` struct
+*/
+NK_API void nk_record_end(struct nk_context*);
+/*/// #### nk_record_resize
+/// Records the size of the surface the UI is drawn to. Has to be called
+/// between `nk_input_begin` and `nk_input_end` once after `nk_record_begin`
+/// and whenever the size changes, since window layouts depend on it.
+/// Does nothing if the context is not recording.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// void nk_record_resize(struct nk_context *ctx, int width, int height);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to a previously initialized `nk_context` struct
+/// __width__   | Width of the surface in pixels
+/// __height__  | Height of the surface in pixels
+*/
+NK_API void nk_record_resize(struct nk_context*, int width, int height);
+/*/// #### nk_replay_init
+/// Prepares the replay of a recording made with `nk_record_begin`.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// int nk_replay_init(struct nk_replay *replay, const void *memory, nk_size size);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __replay__  | Replay state to initialize
+/// __memory__  | Recording which has to stay valid for the whole replay
+/// __size__    | Size of the recording in bytes
+///
+/// Returns `false(0)` if the memory does not hold a recording
+*/
+NK_API int nk_replay_init(struct nk_replay*, const void *memory, nk_size size);
+/*/// #### nk_replay_frame
+/// Replays the input of the next recorded frame. Replaces the
+/// `nk_input_begin`/`nk_input_end` block of a frame. If the frame recorded a
+/// new surface size `nk_replay::resized` is set and `nk_replay::width` and
+/// `nk_replay::height` hold the size the frame has to be drawn at.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// int nk_replay_frame(struct nk_context *ctx, struct nk_replay *replay);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to a previously initialized `nk_context` struct
+/// __replay__  | Replay state initialized by `nk_replay_init`
+///
+/// Returns `false(0)` if the recording ended or is broken
+*/
+NK_API int nk_replay_frame(struct nk_context*, struct nk_replay*);
+/*/// #### nk_replay_check
+/// Compares the draw commands of the current frame against the recorded
+/// frame. Has to be called after the UI was built and before `nk_clear`.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// int nk_replay_check(struct nk_context *ctx, const struct nk_replay *replay);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter   | Description
+/// ------------|-----------------------------------------------------------
+/// __ctx__     | Must point to a previously initialized `nk_context` struct
+/// __replay__  | Replay state after `nk_replay_frame`
+///
+/// Returns `true(1)` if both frames have the same hash or no hash was recorded
+*/
+NK_API int nk_replay_check(struct nk_context*, const struct nk_replay*);
 /* =============================================================================
  *
  *                                  DRAWING
@@ -2426,6 +2592,8 @@ NK_API struct nk_rect nk_layout_space_rect_to_local(struct nk_context*, struct n
 /// nk_group_scrolled_end           | Ends a group with manual scrollbar handling. Should only be called if nk_group_begin returned non-zero
 /// nk_group_get_scroll             | Gets the scroll offset for the given group
 /// nk_group_set_scroll             | Sets the scroll offset for the given group
+/// nk_group_begin_lazy             | Start a new group which only has to be filled if visible and remembers its content height
+/// nk_group_get_content_height     | Gets the content height of a lazy group from the last time it was filled
 */
 /*/// #### nk_group_begin
 /// Starts a new widget group. Requires a previous layouting function to specify a pos/size.
@@ -2543,6 +2711,48 @@ NK_API void nk_group_get_scroll(struct nk_context*, const char *id, nk_uint *x_o
 /// __y_offset__ | The y offset to scroll to
 */
 NK_API void nk_group_set_scroll(struct nk_context*, const char *id, nk_uint x_offset, nk_uint y_offset);
+/*/// #### nk_group_begin_lazy
+/// Starts a new widget group like `nk_group_begin` but only returns `true(1)` if
+/// the group actually has to be filled with widgets. Groups outside the parent
+/// clipping rectangle as well as minimized or closed groups return `false(0)`
+/// and must neither be filled nor ended. The height the group needs to show
+/// all its widgets without scrolling is measured in `nk_group_end` and kept
+/// until the group is filled the next time, so long lists of groups can be
+/// laid out with correct heights while only the visible ones are filled.
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// float height = nk_group_get_content_height(ctx, "stats");
+/// nk_layout_row_dynamic(ctx, height > 0 ? height: 200, 1);
+/// if (nk_group_begin_lazy(ctx, "stats", NK_WINDOW_NO_SCROLLBAR, 0)) {
+///     // [... widgets ...]
+///     nk_group_end(ctx);
+/// }
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter           | Description
+/// --------------------|-----------------------------------------------------------
+/// __ctx__             | Must point to an previously initialized `nk_context` struct
+/// __title__           | Must be an unique identifier for this group that is also used for the group header
+/// __flags__           | Window flags defined in the nk_panel_flags section with a number of different group behaviors
+/// __content_height__  | Optional pointer receiving the cached content height or 0 if the group was never filled
+///
+/// Returns `true(1)` if visible and fillable with widgets or `false(0)` otherwise
+*/
+NK_API int nk_group_begin_lazy(struct nk_context*, const char *title, nk_flags, float *content_height);
+/*/// #### nk_group_get_content_height
+/// Gets the height a group started with `nk_group_begin_lazy` needed to show
+/// all its widgets the last time it was filled.
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~c
+/// float nk_group_get_content_height(struct nk_context*, const char *id);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Parameter    | Description
+/// -------------|-----------------------------------------------------------
+/// __ctx__      | Must point to an previously initialized `nk_context` struct
+/// __id__       | The id of the group
+///
+/// Returns the group height including header and borders or 0 if unknown
+*/
+NK_API float nk_group_get_content_height(struct nk_context*, const char *id);
 /* =============================================================================
  *
  *                                  TREE
@@ -2803,6 +3013,26 @@ NK_API void nk_tree_element_pop(struct nk_context*);
  *                                  LIST VIEW
  *
  * ============================================================================= */
+/*  List views only lay out and draw the rows inside the visible area. Rows
+ *  either all share the same height passed to `nk_list_view_begin` or have
+ *  individual heights kept in a `nk_row_heights` cache which is passed to
+ *  `nk_list_view_begin_variable`. The cache stores prefix sums of all row
+ *  heights in a Fenwick tree so mapping the scroll offset to the first visible
+ *  row, as well as changing the height of a single row, takes O(log n) time.
+ *  Row heights are either filled in by `nk_row_heights_build` from a callback
+ *  or set one by one with `nk_row_heights_set`. Each visible row still has to
+ *  be laid out with its own height:
+ *
+ *      nk_row_heights_build(&heights, count, message_height, nk_handle_ptr(log));
+ *      ...
+ *      if (nk_list_view_begin_variable(ctx, &view, "log", 0, &heights)) {
+ *          for (i = view.begin; i < view.end; ++i) {
+ *              nk_layout_row_dynamic(ctx, (float)nk_row_heights_get(&heights, i), 1);
+ *              nk_label_wrap(ctx, messages[i]);
+ *          }
+ *          nk_list_view_end(&view);
+ *      }
+ */
 struct nk_list_view {
 /* public: */
     int begin, end, count;
@@ -2812,8 +3042,203 @@ struct nk_list_view {
     nk_uint *scroll_pointer;
     nk_uint scroll_value;
 };
+typedef int(*nk_plugin_row_height)(nk_handle, int row);
+struct nk_row_heights {
+    struct nk_allocator pool;
+    int *tree;
+    int count;
+    int capacity;
+};
 NK_API int nk_list_view_begin(struct nk_context*, struct nk_list_view *out, const char *id, nk_flags, int row_height, int row_count);
+NK_API int nk_list_view_begin_variable(struct nk_context*, struct nk_list_view *out, const char *id, nk_flags, const struct nk_row_heights*);
 NK_API void nk_list_view_end(struct nk_list_view*);
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+NK_API void nk_row_heights_init_default(struct nk_row_heights*);
+#endif
+NK_API void nk_row_heights_init(struct nk_row_heights*, const struct nk_allocator*);
+NK_API void nk_row_heights_free(struct nk_row_heights*);
+NK_API int nk_row_heights_build(struct nk_row_heights*, int count, nk_plugin_row_height, nk_handle);
+NK_API int nk_row_heights_resize(struct nk_row_heights*, int count, int height);
+NK_API void nk_row_heights_set(struct nk_row_heights*, int row, int height);
+NK_API int nk_row_heights_get(const struct nk_row_heights*, int row);
+NK_API int nk_row_heights_offset(const struct nk_row_heights*, int row);
+NK_API int nk_row_heights_find(const struct nk_row_heights*, int offset);
+/* =============================================================================
+ *
+ *                                  TEXT VIEW
+ *
+ * =============================================================================
+ *  Read-only viewer for texts that are too big to be copied into a string,
+ *  like log files or memory mapped dumps. The text is either a plain memory
+ *  block (for example the result of `mmap`) or is pulled on demand through a
+ *  `nk_plugin_read` callback, which is asked to fill `dst` with up to `len`
+ *  bytes starting at `offset` and returns the number of bytes written.
+ *
+ *  Only the lines inside the visible area are read and drawn. To find them
+ *  the view keeps a sparse line index which is built incrementally: every call
+ *  to `nk_text_view` scans at most `NK_TEXT_VIEW_INDEX_BUDGET` new bytes and
+ *  applications can call `nk_text_view_index` with a bigger budget between
+ *  frames to finish it faster. Until the scan is done the scrollbar only
+ *  covers the lines found so far. Growing sources like log files that are
+ *  still written to can announce their new size with `nk_text_view_set_size`.
+ *
+ *  Lines are selected by clicking and dragging and the selection is copied
+ *  to the clipboard on `NK_KEY_COPY` as long as the last click went into the
+ *  view. `nk_text_view_selection` returns the selected byte range for
+ *  applications that want to stream huge selections themselves. Lines longer
+ *  than `NK_TEXT_VIEW_BUFFER_SIZE` bytes are cut off.
+ *
+ *      struct nk_text_view view;
+ *      void *data = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+ *      nk_text_view_init_memory_default(&view, data, size);
+ *      ...
+ *      if (nk_begin(ctx, "Log", bounds, 0)) {
+ *          nk_layout_row_dynamic(ctx, 400, 1);
+ *          nk_text_view(ctx, &view, "log", NK_WINDOW_BORDER);
+ *      }
+ *      nk_end(ctx);
+ *      ...
+ *      nk_text_view_free(&view);
+ *      munmap(data, size);
+ */
+#ifndef NK_TEXT_VIEW_BUFFER_SIZE
+#define NK_TEXT_VIEW_BUFFER_SIZE 1024
+#endif
+
+typedef nk_size(*nk_plugin_read)(nk_handle, nk_size offset, char *dst, nk_size len);
+struct nk_text_view {
+/* public: */
+    nk_size size;
+    nk_size select_start;
+    nk_size select_end;
+/* private: */
+    const char *memory;
+    nk_plugin_read read;
+    nk_handle userdata;
+    struct nk_allocator pool;
+    nk_size *lines;
+    int line_capacity;
+    int line_count;
+    nk_size last_line;
+    nk_size indexed;
+    unsigned char selecting;
+    unsigned char active;
+    char buffer[NK_TEXT_VIEW_BUFFER_SIZE];
+};
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+NK_API void nk_text_view_init_default(struct nk_text_view*, nk_plugin_read, nk_handle, nk_size size);
+NK_API void nk_text_view_init_memory_default(struct nk_text_view*, const char *memory, nk_size size);
+#endif
+NK_API void nk_text_view_init(struct nk_text_view*, const struct nk_allocator*, nk_plugin_read, nk_handle, nk_size size);
+NK_API void nk_text_view_init_memory(struct nk_text_view*, const struct nk_allocator*, const char *memory, nk_size size);
+NK_API void nk_text_view_set_size(struct nk_text_view*, nk_size size);
+NK_API int nk_text_view_index(struct nk_text_view*, nk_size max_bytes);
+NK_API int nk_text_view_line_count(const struct nk_text_view*);
+NK_API int nk_text_view_selection(const struct nk_text_view*, nk_size *begin, nk_size *end);
+NK_API int nk_text_view(struct nk_context*, struct nk_text_view*, const char *id, nk_flags);
+NK_API void nk_text_view_free(struct nk_text_view*);
+/* =============================================================================
+ *
+ *                                  GRID
+ *
+ * =============================================================================
+ *  Scrollable table of `rows` times `columns` cells which only visits the
+ *  cells inside the visible area. Instead of laying out widgets the grid calls
+ *  `draw` for every visible cell with the screen rectangle of the cell, so the
+ *  per-frame cost only depends on the size of the grid widget and not on the
+ *  number of rows.
+ *
+ *  The first `frozen_rows` rows and `frozen_columns` columns stay in place
+ *  while the rest of the grid scrolls underneath them, which is used for
+ *  header rows and key columns. Column widths are read from `column_widths`
+ *  every frame and dragging a column border inside the frozen rows resizes the
+ *  column by writing back into the array, but never below `min_column_width`.
+ *
+ *      static void draw_cell(nk_handle data, struct nk_command_buffer *out,
+ *          struct nk_rect cell, int row, int column)
+ *      {
+ *          const char *text = table_cell(data.ptr, row, column);
+ *          nk_draw_text(out, cell, text, (int)strlen(text), font, bg, fg);
+ *      }
+ *      ...
+ *      grid.rows = 100000; grid.columns = 50;
+ *      grid.frozen_rows = 1; grid.frozen_columns = 1;
+ *      grid.row_height = 20; grid.column_widths = widths;
+ *      grid.draw = draw_cell; grid.userdata = nk_handle_ptr(table);
+ *      ...
+ *      nk_layout_row_dynamic(ctx, 400, 1);
+ *      nk_grid(ctx, &grid, "table", NK_WINDOW_BORDER);
+ */
+typedef void(*nk_plugin_draw_cell)(nk_handle, struct nk_command_buffer*, struct nk_rect cell, int row, int column);
+struct nk_grid {
+/* public: */
+    int rows, columns;
+    int frozen_rows, frozen_columns;
+    float row_height;
+    float *column_widths;
+    float min_column_width;
+    nk_plugin_draw_cell draw;
+    nk_handle userdata;
+/* private: */
+    int resizing;
+};
+NK_API int nk_grid(struct nk_context*, struct nk_grid*, const char *id, nk_flags);
+/* =============================================================================
+ *
+ *                                  TREE VIEW
+ *
+ * =============================================================================
+ *  Tree widget for big hierarchies like file systems or scene graphs. Unlike
+ *  `nk_tree_push` the application does not submit nodes every frame. Instead
+ *  the tree view keeps the currently open part of the tree flattened into an
+ *  array of rows and only asks for the children of a node when it is opened:
+ *
+ *  `children(userdata, parent, nodes, max)` returns the number of children of
+ *  `parent` if `nodes` is NULL and otherwise writes up to `max` child handles
+ *  into `nodes` and returns how many were written. The children of the root
+ *  are requested with the handle passed to `nk_tree_view_init`.
+ *  `label(userdata, node, &len)` returns the text shown for a node.
+ *
+ *  Like list views only the rows inside the visible area are laid out and
+ *  drawn and callbacks are only called for those rows, so the cost per frame
+ *  does not depend on the number of open nodes. Opening and closing a node
+ *  moves the rows behind it, which is linear in the number of open rows.
+ *  `selected` holds the row of the last clicked node or -1. After the
+ *  application data changed `nk_tree_view_reset` closes all nodes and
+ *  enumerates the root again.
+ */
+typedef int(*nk_plugin_tree_children)(nk_handle, nk_handle parent, nk_handle *nodes, int max);
+typedef const char*(*nk_plugin_tree_label)(nk_handle, nk_handle node, int *len);
+struct nk_tree_view_row {
+    int depth;
+    int children;
+    int open;
+};
+struct nk_tree_view {
+/* public: */
+    int count;
+    int selected;
+/* private: */
+    struct nk_allocator pool;
+    nk_plugin_tree_children children;
+    nk_plugin_tree_label label;
+    nk_handle userdata;
+    nk_handle root;
+    nk_handle *nodes;
+    struct nk_tree_view_row *rows;
+    int capacity;
+    int valid;
+};
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+NK_API void nk_tree_view_init_default(struct nk_tree_view*, nk_handle root, nk_plugin_tree_children, nk_plugin_tree_label, nk_handle userdata);
+#endif
+NK_API void nk_tree_view_init(struct nk_tree_view*, const struct nk_allocator*, nk_handle root, nk_plugin_tree_children, nk_plugin_tree_label, nk_handle userdata);
+NK_API void nk_tree_view_free(struct nk_tree_view*);
+NK_API void nk_tree_view_reset(struct nk_tree_view*);
+NK_API int nk_tree_view_expand(struct nk_tree_view*, int row);
+NK_API void nk_tree_view_collapse(struct nk_tree_view*, int row);
+NK_API nk_handle nk_tree_view_node(const struct nk_tree_view*, int row);
+NK_API int nk_tree_view(struct nk_context*, struct nk_tree_view*, const char *id, nk_flags);
 /* =============================================================================
  *
  *                                  WIDGET
@@ -3237,6 +3662,11 @@ NK_API void nk_chart_add_slot(struct nk_context *ctx, const enum nk_chart_type,
 NK_API void nk_chart_add_slot_colored(struct nk_context *ctx, const enum nk_chart_type, struct nk_color, struct nk_color active, int count, float min_value, float max_value);
 NK_API nk_flags nk_chart_push(struct nk_context*, float);
 NK_API nk_flags nk_chart_push_slot(struct nk_context*, float, int);
+NK_API nk_flags nk_chart_push_series(struct nk_context*, const float *values, int count, enum nk_chart_sampling);
+NK_API nk_flags nk_chart_push_series_slot(struct nk_context*, const float *values, int count, enum nk_chart_sampling, int slot);
+/* `stride` is the distance in bytes between two values or 0 for tightly packed floats */
+NK_API nk_flags nk_chart_push_array(struct nk_context*, const float *values, int count, int stride);
+NK_API nk_flags nk_chart_push_array_slot(struct nk_context*, const float *values, int count, int stride, int slot);
 NK_API void nk_chart_end(struct nk_context*);
 NK_API void nk_plot(struct nk_context*, enum nk_chart_type, const float *values, int count, int offset);
 NK_API void nk_plot_function(struct nk_context*, enum nk_chart_type, void *userdata, float(*value_getter)(void* user, int index), int count, int offset);
@@ -3285,6 +3715,59 @@ NK_API int nk_combo_item_symbol_label(struct nk_context*, enum nk_symbol_type, c
 NK_API int nk_combo_item_symbol_text(struct nk_context*, enum nk_symbol_type, const char*, int, nk_flags alignment);
 NK_API void nk_combo_close(struct nk_context*);
 NK_API void nk_combo_end(struct nk_context*);
+/* =============================================================================
+ *
+ *                                  COMBO LIST
+ *
+ * =============================================================================
+ *  Searchable combobox for huge item sets. Items are not submitted every frame
+ *  but fetched through `text(userdata, item, &len)` which returns the label of
+ *  an item, and only for the rows visible inside the popup list.
+ *
+ *  The popup starts with a focused edit field. Typing filters the items with
+ *  `nk_strmatch_fuzzy_text` and pressing enter picks the first match. The
+ *  filtered item index is only rebuilt if the filter text changed and typing
+ *  more characters only rescans the items which matched before.
+ *
+ *      struct nk_combo_list symbols;
+ *      nk_combo_list_init_default(&symbols, count, symbol_name, nk_handle_ptr(app));
+ *      ...
+ *      nk_layout_row_dynamic(ctx, 25, 1);
+ *      picked = nk_combo_list(ctx, &symbols, 20, nk_vec2(300, 400));
+ *      ...
+ *      nk_combo_list_free(&symbols);
+ *
+ *  After the item set changed `nk_combo_list_reset` updates the number of
+ *  items and throws away the filtered index.
+ */
+#ifndef NK_COMBO_LIST_FILTER_SIZE
+#define NK_COMBO_LIST_FILTER_SIZE 64
+#endif
+typedef const char*(*nk_plugin_item_text)(nk_handle, int item, int *len);
+struct nk_combo_list {
+/* public: */
+    int count;
+    int selected;
+/* private: */
+    struct nk_allocator pool;
+    nk_plugin_item_text text;
+    nk_handle userdata;
+    char filter[NK_COMBO_LIST_FILTER_SIZE];
+    int filter_len;
+    char query[NK_COMBO_LIST_FILTER_SIZE];
+    int *matches;
+    int match_count;
+    int capacity;
+    int valid;
+    int open;
+};
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+NK_API void nk_combo_list_init_default(struct nk_combo_list*, int count, nk_plugin_item_text, nk_handle userdata);
+#endif
+NK_API void nk_combo_list_init(struct nk_combo_list*, const struct nk_allocator*, int count, nk_plugin_item_text, nk_handle userdata);
+NK_API void nk_combo_list_free(struct nk_combo_list*);
+NK_API void nk_combo_list_reset(struct nk_combo_list*, int count);
+NK_API int nk_combo_list(struct nk_context*, struct nk_combo_list*, int item_height, struct nk_vec2 size);
 /* =============================================================================
  *
  *                                  CONTEXTUAL
@@ -3515,6 +3998,64 @@ NK_API double nk_strtod(const char *str, const char **endptr);
 NK_API int nk_strfilter(const char *text, const char *regexp);
 NK_API int nk_strmatch_fuzzy_string(char const *str, char const *pattern, int *out_score);
 NK_API int nk_strmatch_fuzzy_text(const char *txt, int txt_len, const char *pattern, int *out_score);
+/* =============================================================================
+ *
+ *                                  FUZZY MATCHER
+ *
+ * =============================================================================
+ *  Matches a pattern against a whole array of strings at once, for example to
+ *  filter a command palette on every keystroke. Each string gets a 32 bit
+ *  mask of the character classes it contains when the matcher is initialized.
+ *  Strings which lack any character class of the pattern are rejected with a
+ *  single AND before `nk_strmatch_fuzzy_text` has to look at them.
+ *
+ *  The matcher remembers which strings matched the last pattern. If the new
+ *  pattern only appends characters to it, only those strings are checked
+ *  again. `nk_fuzzy_match` writes the best `max` results into `results`
+ *  sorted by descending score and equal scores by index, and returns how many
+ *  were written. `matches` holds the total number of matching strings.
+ *
+ *      struct nk_fuzzy_matcher palette;
+ *      struct nk_fuzzy_match best[16];
+ *      nk_fuzzy_matcher_init_default(&palette, commands, command_count);
+ *      ...
+ *      n = nk_fuzzy_match(&palette, query, best, 16);
+ *      for (i = 0; i < n; ++i)
+ *          nk_label(ctx, commands[best[i].index], NK_TEXT_LEFT);
+ *      ...
+ *      nk_fuzzy_matcher_free(&palette);
+ *
+ *  The string array must stay valid while the matcher is used. After it
+ *  changed `nk_fuzzy_matcher_reset` has to be called.
+ */
+#ifndef NK_FUZZY_PATTERN_SIZE
+#define NK_FUZZY_PATTERN_SIZE 64
+#endif
+struct nk_fuzzy_match {
+    int index;
+    int score;
+};
+struct nk_fuzzy_matcher {
+/* public: */
+    int count;
+    int matches;
+/* private: */
+    struct nk_allocator pool;
+    const char *const *strings;
+    nk_uint *masks;
+    int *lengths;
+    int *candidates;
+    int capacity;
+    char pattern[NK_FUZZY_PATTERN_SIZE];
+    int valid;
+};
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+NK_API int nk_fuzzy_matcher_init_default(struct nk_fuzzy_matcher*, const char *const *strings, int count);
+#endif
+NK_API int nk_fuzzy_matcher_init(struct nk_fuzzy_matcher*, const struct nk_allocator*, const char *const *strings, int count);
+NK_API int nk_fuzzy_matcher_reset(struct nk_fuzzy_matcher*, const char *const *strings, int count);
+NK_API void nk_fuzzy_matcher_free(struct nk_fuzzy_matcher*);
+NK_API int nk_fuzzy_match(struct nk_fuzzy_matcher*, const char *pattern, struct nk_fuzzy_match *results, int max);
 /* =============================================================================
  *
  *                                  UTF-8
@@ -3941,17 +4482,52 @@ NK_API nk_size nk_buffer_total(struct nk_buffer*);
  *  to manage and manipulate dynamic or fixed size string content. This is _NOT_
  *  the default string handling method. The only instance you should have any contact
  *  with this API is if you interact with an `nk_text_edit` object inside one of the
- *  copy and paste functions and even there only for more advanced cases. */
+ *  copy and paste functions and even there only for more advanced cases.
+ *
+ *  Strings initialized with `nk_str_init_gap` keep an insertion gap at the
+ *  position of the last edit, which makes inserting and deleting near the
+ *  cursor independent of the total string size. The gap is closed again
+ *  whenever a direct pointer into the string is requested, so `nk_str_get`,
+ *  `nk_str_at_char` and `nk_str_at_rune` always see contiguous text. The
+ *  `_const` getters never move memory: the text behind their result is only
+ *  contiguous up to the gap, while `nk_str_rune_at` reads a single codepoint.
+ *
+ *  Dynamic strings can additionally keep a rune offset index by calling
+ *  `nk_str_build_index`. The index stores the byte offset of roughly every
+ *  n-th codepoint as well as of every line start and is updated on every
+ *  insert and delete, so codepoint lookups like `nk_str_rune_at` only have
+ *  to decode a few glyphs instead of the whole string in front of the
+ *  requested position. Text editors use the line starts to only layout and
+ *  draw the visible lines. Strings with an index have to be modified
+ *  through the `nk_str_xxx` functions only. */
+struct nk_str_checkpoint {
+    int rune; /* codepoint index */
+    int byte; /* byte offset of the codepoint */
+    int line; /* line of the codepoint */
+};
 struct nk_str {
     struct nk_buffer buffer;
     int len; /* in codepoints/runes/glyphs */
+    nk_size gap_begin; /* byte offset of the insertion gap */
+    nk_size gap_len; /* size of the insertion gap in bytes */
+    int gap_rune; /* codepoint index of the insertion gap */
+    int gap_buffer; /* nk_true if the string keeps an insertion gap */
+    struct nk_str_checkpoint *index; /* optional rune offset index */
+    int index_front; /* checkpoints in front of the last edit */
+    int index_back; /* checkpoints behind the last edit, relative to the end */
+    int index_capacity; /* number of allocated checkpoints */
+    int index_stride; /* codepoints between checkpoints or 0 if disabled */
+    int index_lines; /* number of line breaks, only counted with an index */
 };
 
 #ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
 NK_API void nk_str_init_default(struct nk_str*);
+NK_API void nk_str_init_gap_default(struct nk_str*);
 #endif
 NK_API void nk_str_init(struct nk_str*, const struct nk_allocator*, nk_size size);
 NK_API void nk_str_init_fixed(struct nk_str*, void *memory, nk_size size);
+NK_API void nk_str_init_gap(struct nk_str*, const struct nk_allocator*, nk_size size);
+NK_API int nk_str_build_index(struct nk_str*, int stride);
 NK_API void nk_str_clear(struct nk_str*);
 NK_API void nk_str_free(struct nk_str*);
 
@@ -4015,6 +4591,23 @@ NK_API int nk_str_len_char(struct nk_str*);
  * complexity I would not recommend editing gigabytes of data with it.
  * It is rather designed for uses cases which make sense for a GUI library not for
  * an full blown text editor.
+ *
+ * For bigger documents `nk_textedit_init_gap` sets up the same dynamically
+ * growing text editor on top of a gap buffer string. Typing and deleting
+ * around the cursor then no longer moves the remaining text on every key press
+ * and the string keeps a rune offset index (see `nk_str_build_index`) so
+ * cursor movement does not decode the whole text in front of the cursor.
+ * The index also tracks line starts, which lets the editor only measure and
+ * draw the lines inside the visible area.
+ *
+ * The undo/redo stack of every text editor is limited to a fixed number of
+ * records and characters. Calling `nk_textedit_undo_history` replaces it with
+ * a growable history which stores edits as UTF-8 and is only bounded by a
+ * memory limit, so large pastes and long editing sessions stay undoable.
+ * Editors set up by `nk_textedit_init_gap` use it by default with a limit of
+ * `NK_TEXTEDIT_UNDO_LIMIT` bytes. Once the limit is reached the oldest records
+ * are dropped. Limits below `NK_TEXTEDIT_HISTORY_MIN_SIZE` (1KB by default) are
+ * rejected and leave the editor unchanged.
  */
 #ifndef NK_TEXTEDIT_UNDOSTATECOUNT
 #define NK_TEXTEDIT_UNDOSTATECOUNT     99
@@ -4024,6 +4617,10 @@ NK_API int nk_str_len_char(struct nk_str*);
 #define NK_TEXTEDIT_UNDOCHARCOUNT      999
 #endif
 
+#ifndef NK_TEXTEDIT_UNDO_LIMIT
+#define NK_TEXTEDIT_UNDO_LIMIT         (16 * 1024 * 1024)
+#endif
+
 struct nk_text_edit;
 struct nk_clipboard {
     nk_handle userdata;
@@ -4045,6 +4642,14 @@ struct nk_text_undo_state {
    short redo_point;
    short undo_char_point;
    short redo_char_point;
+   /* growable history (see `nk_textedit_undo_history`) */
+   struct nk_allocator pool;
+   char *history;
+   nk_size history_size;
+   nk_size history_limit;
+   nk_size undo_begin;
+   nk_size undo_end;
+   nk_size redo_begin;
 };
 
 enum nk_text_edit_type {
@@ -4090,9 +4695,12 @@ NK_API int nk_filter_binary(const struct nk_text_edit*, nk_rune unicode);
 /* text editor */
 #ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
 NK_API void nk_textedit_init_default(struct nk_text_edit*);
+NK_API void nk_textedit_init_gap_default(struct nk_text_edit*);
 #endif
 NK_API void nk_textedit_init(struct nk_text_edit*, struct nk_allocator*, nk_size size);
 NK_API void nk_textedit_init_fixed(struct nk_text_edit*, void *memory, nk_size size);
+NK_API void nk_textedit_init_gap(struct nk_text_edit*, struct nk_allocator*, nk_size size);
+NK_API int nk_textedit_undo_history(struct nk_text_edit*, const struct nk_allocator*, nk_size limit);
 NK_API void nk_textedit_free(struct nk_text_edit*);
 NK_API void nk_textedit_text(struct nk_text_edit*, const char*, int total_len);
 NK_API void nk_textedit_delete(struct nk_text_edit*, int where, int len);
@@ -5109,6 +5717,7 @@ struct nk_panel {
     struct nk_rect bounds;
     nk_uint *offset_x;
     nk_uint *offset_y;
+    nk_uint *content_height;
     float at_x, at_y, max_x;
     float footer_height;
     float header_height;
@@ -5347,6 +5956,33 @@ struct nk_pool {
     nk_size cap;
 };
 
+struct nk_redraw {
+    nk_hash frame;
+    float deadline;
+    float request;
+    int requested;
+    int input;
+    int needed;
+    int enabled;
+};
+
+struct nk_record {
+    struct nk_buffer *buffer;
+    int x, y;
+};
+
+struct nk_replay {
+    const nk_byte *data;
+    nk_size size;
+    nk_size offset;
+    int x, y;
+    int frame;
+    nk_hash hash;
+    int has_hash;
+    int width, height;
+    int resized;
+};
+
 struct nk_context {
 /* public: can be accessed freely */
     struct nk_input input;
@@ -5374,6 +6010,10 @@ struct nk_context {
     struct nk_text_edit text_edit;
     /* draw buffer used for overlay drawing operation like cursor */
     struct nk_command_buffer overlay;
+    /* idle tracking for nk_needs_redraw */
+    struct nk_redraw redraw;
+    /* input recording started by nk_record_begin */
+    struct nk_record record;
 
     /* windows */
     int build;
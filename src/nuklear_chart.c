@@ -249,6 +249,311 @@ nk_chart_push(struct nk_context *ctx, float value)
 {
     return nk_chart_push_slot(ctx, value, 0);
 }
+struct nk_chart_source {
+    const char *values;
+    nk_size stride;
+    void *userdata;
+    float(*getter)(void *user, int index);
+    int offset;
+};
+struct nk_chart_polyline {
+    struct nk_command_buffer *out;
+    struct nk_command_polyline *cmd;
+    struct nk_color color;
+    int capacity;
+    int remaining;
+    int test, hit;
+    struct nk_vec2 mouse;
+    struct nk_vec2i hit_pos;
+};
+NK_INTERN float
+nk_chart_source_value(const struct nk_chart_source *src, int index)
+{
+    if (src->getter)
+        return src->getter(src->userdata, src->offset + index);
+    return *(const float*)(const void*)(src->values + (nk_size)index * src->stride);
+}
+NK_INTERN void
+nk_chart_polyline_hit(struct nk_chart_polyline *line)
+{
+    /* points are sorted by x so a binary search finds the first point
+     * inside the hover box and only the points below the mouse are checked */
+    int lo = 0, hi, best = 3 * 3 + 3 * 3 + 1;
+    const struct nk_vec2i *p;
+    if (!line->cmd || !line->test) return;
+
+    p = line->cmd->points;
+    hi = line->cmd->point_count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if ((float)p[mid].x < line->mouse.x - 3) lo = mid + 1;
+        else hi = mid;
+    }
+    for (; lo < line->cmd->point_count && (float)p[lo].x <= line->mouse.x + 3; ++lo) {
+        float dx = (float)p[lo].x - line->mouse.x;
+        float dy = (float)p[lo].y - line->mouse.y;
+        if (NK_ABS(dy) <= 3 && (int)(dx*dx + dy*dy) < best) {
+            best = (int)(dx*dx + dy*dy);
+            line->hit_pos = p[lo];
+            line->hit = nk_true;
+        }
+    }
+}
+NK_INTERN void
+nk_chart_polyline_add(struct nk_chart_polyline *line, float x, float y)
+{
+    struct nk_vec2i *p;
+    if (!line->out) return;
+    if (!line->cmd || line->cmd->point_count >= line->capacity) {
+        /* polylines hold at most 65535 points so long series continue
+         * in a new command starting at the last point */
+        nk_size size;
+        struct nk_vec2i last = {0,0};
+        int split = (line->cmd != 0);
+        if (split) {
+            last = line->cmd->points[line->cmd->point_count-1];
+            nk_chart_polyline_hit(line);
+            line->remaining++;
+        }
+        line->capacity = NK_CLAMP(2, line->remaining, 0xFFFF);
+        size = sizeof(*line->cmd) + sizeof(short) * 2 * (nk_size)line->capacity;
+        line->cmd = (struct nk_command_polyline*)
+            nk_command_buffer_push(line->out, NK_COMMAND_POLYLINE, size);
+        if (!line->cmd) {
+            line->out = 0;
+            return;
+        }
+        line->cmd->color = line->color;
+        line->cmd->line_thickness = 1;
+        line->cmd->point_count = 0;
+        if (split) {
+            line->cmd->points[line->cmd->point_count++] = last;
+            line->remaining--;
+        }
+    }
+    p = &line->cmd->points[line->cmd->point_count++];
+    p->x = (short)x;
+    p->y = (short)y;
+    line->remaining--;
+}
+NK_INTERN nk_flags
+nk_chart_push_samples(struct nk_context *ctx, struct nk_window *win,
+    struct nk_chart *g, const struct nk_chart_source *src, int count,
+    enum nk_chart_sampling sampling, int slot)
+{
+    /* draws a whole series as a single polyline with markers if the values
+     * are far enough apart. Series with more than two values per pixel are
+     * reduced to the smallest and biggest value of each pixel column or to
+     * one value per column picked by largest triangle three buckets (LTTB). */
+    const struct nk_input *in = &ctx->input;
+    struct nk_chart_slot *s = &g->slots[slot];
+    struct nk_chart_polyline line;
+    int i, start, columns;
+    float step, bottom, scale, value;
+    nk_flags ret = 0;
+
+    NK_ASSERT(slot >= 0 && slot < NK_CHART_MAX_SLOT);
+    if (count <= 0 || s->count <= 0) return 0;
+    start = s->index;
+    step = g->w / (float)s->count;
+    bottom = g->y + g->h;
+    scale = (s->range != 0) ? g->h / s->range: 0;
+    #define NK_CHART_X(index) (g->x + step * (float)(start + (index)))
+    #define NK_CHART_Y(value) (bottom - ((value) - s->min) * scale)
+
+    nk_zero(&line, sizeof(line));
+    line.out = &win->buffer;
+    line.color = s->color;
+    line.mouse = in->mouse.pos;
+    line.test = !(win->layout->flags & NK_WINDOW_ROM) &&
+        NK_INBOX(in->mouse.pos.x, in->mouse.pos.y, g->x - 3, g->y - 3, g->w + 6, g->h + 6);
+
+    /* reserve enough points for the whole series up front */
+    columns = NK_MAX(nk_iceilf(step * (float)count), 1);
+    if (count <= 2 * columns)
+        line.remaining = count;
+    else if (sampling == NK_CHART_SAMPLE_LTTB)
+        line.remaining = NK_MAX(columns, 3);
+    else line.remaining = 2 * (columns + 1);
+
+    /* continue from the last data point of previous pushes */
+    if (start > 0) {
+        line.remaining++;
+        nk_chart_polyline_add(&line, s->last.x, s->last.y);
+    }
+    if (count <= 2 * columns) {
+        for (i = 0; i < count; ++i) {
+            value = nk_chart_source_value(src, i);
+            nk_chart_polyline_add(&line, NK_CHART_X(i), NK_CHART_Y(value));
+        }
+    } else if (sampling == NK_CHART_SAMPLE_LTTB) {
+        int a = 0, bucket, buckets = NK_MAX(columns, 3) - 2;
+        float every = (float)(count - 2) / (float)buckets;
+        float a_value = nk_chart_source_value(src, 0);
+
+        nk_chart_polyline_add(&line, NK_CHART_X(0), NK_CHART_Y(a_value));
+        for (bucket = 0; bucket < buckets; ++bucket) {
+            int j, pick;
+            int lo = (int)((float)bucket * every) + 1;
+            int hi = NK_MIN((int)((float)(bucket + 1) * every) + 1, count - 1);
+            int next = NK_MIN((int)((float)(bucket + 2) * every) + 1, count);
+            float avg_x = 0, avg_y = 0, area = -1, pick_value;
+            if (lo >= hi) continue;
+
+            /* average of the next bucket is the third triangle corner */
+            if (hi < next) {
+                for (j = hi; j < next; ++j)
+                    avg_y += nk_chart_source_value(src, j);
+                avg_x = (float)(hi + next - 1) * 0.5f;
+                avg_y /= (float)(next - hi);
+            } else {
+                avg_x = (float)(count - 1);
+                avg_y = nk_chart_source_value(src, count - 1);
+            }
+            pick = lo;
+            pick_value = a_value;
+            for (j = lo; j < hi; ++j) {
+                float v = nk_chart_source_value(src, j);
+                float t = ((float)a - avg_x) * (v - a_value) -
+                    ((float)a - (float)j) * (avg_y - a_value);
+                t = NK_ABS(t);
+                if (t > area) {
+                    area = t;
+                    pick = j;
+                    pick_value = v;
+                }
+            }
+            nk_chart_polyline_add(&line, NK_CHART_X(pick), NK_CHART_Y(pick_value));
+            a = pick;
+            a_value = pick_value;
+        }
+        value = nk_chart_source_value(src, count - 1);
+        nk_chart_polyline_add(&line, NK_CHART_X(count - 1), NK_CHART_Y(value));
+    } else {
+        int column = -1, lo = 0, hi = 0;
+        float lo_value = 0, hi_value = 0;
+
+        for (i = 0; i <= count; ++i) {
+            int c = (i < count) ? (int)(step * (float)(start + i)): -1;
+            value = (i < count) ? nk_chart_source_value(src, i): 0;
+            if (c == column) {
+                if (value < lo_value) {lo = i; lo_value = value;}
+                if (value > hi_value) {hi = i; hi_value = value;}
+                continue;
+            }
+            /* emit extremes of the finished column in series order */
+            if (column >= 0) {
+                if (lo == hi) {
+                    nk_chart_polyline_add(&line, NK_CHART_X(lo), NK_CHART_Y(lo_value));
+                } else if (lo < hi) {
+                    nk_chart_polyline_add(&line, NK_CHART_X(lo), NK_CHART_Y(lo_value));
+                    nk_chart_polyline_add(&line, NK_CHART_X(hi), NK_CHART_Y(hi_value));
+                } else {
+                    nk_chart_polyline_add(&line, NK_CHART_X(hi), NK_CHART_Y(hi_value));
+                    nk_chart_polyline_add(&line, NK_CHART_X(lo), NK_CHART_Y(lo_value));
+                }
+            }
+            column = c;
+            lo = hi = i;
+            lo_value = hi_value = value;
+        }
+    }
+    nk_chart_polyline_hit(&line);
+
+    /* markers are only drawn if they do not overlap */
+    if (count <= 2 * columns && step >= NK_CHART_MARKER_SPACING) {
+        for (i = 0; i < count; ++i) {
+            value = nk_chart_source_value(src, i);
+            nk_fill_rect(&win->buffer, nk_rect(NK_CHART_X(i) - 2,
+                NK_CHART_Y(value) - 2, 4, 4), 0, s->color);
+        }
+    }
+
+    /* save last data point position */
+    value = nk_chart_source_value(src, count - 1);
+    s->last.x = NK_CHART_X(count - 1);
+    s->last.y = NK_CHART_Y(value);
+    s->index += count;
+    #undef NK_CHART_X
+    #undef NK_CHART_Y
+
+    /* user selection of the data point below the mouse */
+    if (line.hit) {
+        ret = NK_CHART_HOVERING;
+        ret |= (!in->mouse.buttons[NK_BUTTON_LEFT].down &&
+            in->mouse.buttons[NK_BUTTON_LEFT].clicked) ? NK_CHART_CLICKED: 0;
+        nk_fill_rect(&win->buffer, nk_rect((float)line.hit_pos.x - 2,
+            (float)line.hit_pos.y - 2, 4, 4), 0, s->highlight);
+    }
+    return ret;
+}
+NK_INTERN nk_flags
+nk_chart_push_source(struct nk_context *ctx, const struct nk_chart_source *src,
+    int count, enum nk_chart_sampling sampling, int slot)
+{
+    int i;
+    nk_flags flags = 0;
+    struct nk_window *win;
+
+    NK_ASSERT(ctx);
+    NK_ASSERT(ctx->current);
+    NK_ASSERT(slot >= 0 && slot < NK_CHART_MAX_SLOT);
+    NK_ASSERT(slot < ctx->current->layout->chart.slot);
+    if (!ctx || !ctx->current || slot < 0 || slot >= NK_CHART_MAX_SLOT) return nk_false;
+    if (slot >= ctx->current->layout->chart.slot) return nk_false;
+
+    win = ctx->current;
+    switch (win->layout->chart.slots[slot].type) {
+    case NK_CHART_LINES:
+        flags = nk_chart_push_samples(ctx, win, &win->layout->chart, src,
+            count, sampling, slot); break;
+    case NK_CHART_COLUMN:
+        for (i = 0; i < count; ++i)
+            flags |= nk_chart_push_column(ctx, win, &win->layout->chart,
+                nk_chart_source_value(src, i), slot);
+        break;
+    default:
+    case NK_CHART_MAX:
+        flags = 0;
+    }
+    return flags;
+}
+NK_API nk_flags
+nk_chart_push_series_slot(struct nk_context *ctx, const float *values, int count,
+    enum nk_chart_sampling sampling, int slot)
+{
+    struct nk_chart_source src;
+    NK_ASSERT(values || !count);
+    if (!values || count <= 0) return nk_false;
+    nk_zero(&src, sizeof(src));
+    src.values = (const char*)values;
+    src.stride = sizeof(float);
+    return nk_chart_push_source(ctx, &src, count, sampling, slot);
+}
+NK_API nk_flags
+nk_chart_push_series(struct nk_context *ctx, const float *values, int count,
+    enum nk_chart_sampling sampling)
+{
+    return nk_chart_push_series_slot(ctx, values, count, sampling, 0);
+}
+NK_API nk_flags
+nk_chart_push_array_slot(struct nk_context *ctx, const float *values, int count,
+    int stride, int slot)
+{
+    struct nk_chart_source src;
+    NK_ASSERT(values || !count);
+    NK_ASSERT(stride >= 0);
+    if (!values || count <= 0 || stride < 0) return nk_false;
+    nk_zero(&src, sizeof(src));
+    src.values = (const char*)values;
+    src.stride = stride ? (nk_size)stride: sizeof(float);
+    return nk_chart_push_source(ctx, &src, count, NK_CHART_SAMPLE_MINMAX, slot);
+}
+NK_API nk_flags
+nk_chart_push_array(struct nk_context *ctx, const float *values, int count, int stride)
+{
+    return nk_chart_push_array_slot(ctx, values, count, stride, 0);
+}
 NK_API void
 nk_chart_end(struct nk_context *ctx)
 {
@@ -285,7 +590,9 @@ nk_plot(struct nk_context *ctx, enum nk_chart_type type, const float *values,
     }
 
     if (nk_chart_begin(ctx, type, count, min_value, max_value)) {
-        for (i = 0; i < count; ++i)
+        if (type == NK_CHART_LINES)
+            nk_chart_push_array(ctx, values + offset, count, 0);
+        else for (i = 0; i < count; ++i)
             nk_chart_push(ctx, values[i + offset]);
         nk_chart_end(ctx);
     }
@@ -310,7 +617,14 @@ nk_plot_function(struct nk_context *ctx, enum nk_chart_type type, void *userdata
     }
 
     if (nk_chart_begin(ctx, type, count, min_value, max_value)) {
-        for (i = 0; i < count; ++i)
+        if (type == NK_CHART_LINES) {
+            struct nk_chart_source src;
+            nk_zero(&src, sizeof(src));
+            src.userdata = userdata;
+            src.getter = value_getter;
+            src.offset = offset;
+            nk_chart_push_source(ctx, &src, count, NK_CHART_SAMPLE_MINMAX, 0);
+        } else for (i = 0; i < count; ++i)
             nk_chart_push(ctx, value_getter(userdata, i + offset));
         nk_chart_end(ctx);
     }
@@ -0,0 +1,185 @@
+#include "nuklear.h"
+#include "nuklear_internal.h"
+
+/* ===============================================================
+ *
+ *                          COMBO LIST
+ *
+ * ===============================================================*/
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+NK_API void
+nk_combo_list_init_default(struct nk_combo_list *list, int count,
+    nk_plugin_item_text text, nk_handle userdata)
+{
+    struct nk_allocator alloc;
+    alloc.userdata.ptr = 0;
+    alloc.alloc = nk_malloc;
+    alloc.free = nk_mfree;
+    nk_combo_list_init(list, &alloc, count, text, userdata);
+}
+#endif
+NK_API void
+nk_combo_list_init(struct nk_combo_list *list, const struct nk_allocator *alloc,
+    int count, nk_plugin_item_text text, nk_handle userdata)
+{
+    NK_ASSERT(list);
+    NK_ASSERT(alloc);
+    NK_ASSERT(text);
+    if (!list || !alloc || !text) return;
+    NK_MEMSET(list, 0, sizeof(*list));
+    list->pool = *alloc;
+    list->text = text;
+    list->userdata = userdata;
+    list->count = NK_MAX(count, 0);
+    list->selected = -1;
+}
+NK_API void
+nk_combo_list_free(struct nk_combo_list *list)
+{
+    NK_ASSERT(list);
+    if (!list) return;
+    if (list->matches && list->pool.free)
+        list->pool.free(list->pool.userdata, list->matches);
+    list->matches = 0;
+    list->match_count = list->capacity = 0;
+    list->valid = nk_false;
+}
+NK_API void
+nk_combo_list_reset(struct nk_combo_list *list, int count)
+{
+    NK_ASSERT(list);
+    if (!list) return;
+    list->count = NK_MAX(count, 0);
+    if (list->selected >= list->count)
+        list->selected = -1;
+    list->valid = nk_false;
+}
+NK_INTERN int
+nk_combo_list_match(struct nk_combo_list *list, int item)
+{
+    int len = 0, score;
+    const char *text = list->text(list->userdata, item, &len);
+    return text && nk_strmatch_fuzzy_text(text, len, list->filter, &score);
+}
+NK_INTERN int
+nk_combo_list_prefix(const char *prefix, int len, const char *text)
+{
+    int i;
+    for (i = 0; i < len; ++i)
+        if (prefix[i] != text[i]) return nk_false;
+    return nk_true;
+}
+NK_INTERN void
+nk_combo_list_update(struct nk_combo_list *list)
+{
+    int i, n = 0;
+    int query_len = nk_strlen(list->query);
+    int extended = list->valid && nk_combo_list_prefix(list->query, query_len, list->filter);
+    if (extended && query_len == list->filter_len)
+        return;
+
+    if (!list->filter_len) {
+        /* no filter so rows map directly to items */
+        list->match_count = list->count;
+    } else if (extended && query_len) {
+        /* a longer pattern can only match a subset of the previous matches */
+        for (i = 0; i < list->match_count; ++i)
+            if (nk_combo_list_match(list, list->matches[i]))
+                list->matches[n++] = list->matches[i];
+        list->match_count = n;
+    } else {
+        if (list->capacity < list->count) {
+            int *matches;
+            list->match_count = 0;
+            if (!list->pool.alloc || !list->pool.free) return;
+            matches = (int*)list->pool.alloc(list->pool.userdata, 0,
+                (nk_size)list->count * sizeof(int));
+            if (!matches) return;
+            if (list->matches)
+                list->pool.free(list->pool.userdata, list->matches);
+            list->matches = matches;
+            list->capacity = list->count;
+        }
+        for (i = 0; i < list->count; ++i)
+            if (nk_combo_list_match(list, i))
+                list->matches[n++] = i;
+        list->match_count = n;
+    }
+    NK_MEMCPY(list->query, list->filter, (nk_size)list->filter_len + 1);
+    list->valid = nk_true;
+}
+NK_API int
+nk_combo_list(struct nk_context *ctx, struct nk_combo_list *list,
+    int item_height, struct nk_vec2 size)
+{
+    int i, len = 0, picked = -1;
+    nk_flags events;
+    const char *label = 0;
+    float height;
+    struct nk_list_view view;
+    struct nk_panel *layout;
+    const struct nk_style *style;
+
+    NK_ASSERT(ctx);
+    NK_ASSERT(list);
+    NK_ASSERT(list->text);
+    if (!ctx || !list || !list->text || !ctx->current)
+        return list ? list->selected: -1;
+
+    if (list->selected >= 0 && list->selected < list->count)
+        label = list->text(list->userdata, list->selected, &len);
+    if (!nk_combo_begin_text(ctx, label ? label: "", label ? len: 0, size)) {
+        list->open = nk_false;
+        return list->selected;
+    }
+
+    /* filter edit field which keeps the keyboard focus while open */
+    style = &ctx->style;
+    nk_layout_row_dynamic(ctx, (float)item_height, 1);
+    if (!list->open) {
+        list->filter[0] = 0;
+        list->filter_len = 0;
+        list->open = nk_true;
+    }
+    nk_edit_focus(ctx, 0);
+    events = nk_edit_string(ctx, NK_EDIT_FIELD|NK_EDIT_SIG_ENTER, list->filter,
+        &list->filter_len, NK_COMBO_LIST_FILTER_SIZE - 1, 0);
+    list->filter[list->filter_len] = 0;
+    nk_combo_list_update(list);
+    if ((events & NK_EDIT_COMMITED) && list->match_count)
+        picked = list->filter_len ? list->matches[0]: 0;
+
+    /* let the list fill the remaining popup space */
+    layout = ctx->current->layout;
+    height = layout->bounds.y + layout->bounds.h - (layout->at_y + layout->row.height);
+    height -= 2 * style->window.spacing.y;
+    nk_layout_row_dynamic(ctx, NK_MAX(height, (float)item_height), 1);
+    if (nk_list_view_begin(ctx, &view, "nk_combo_list", 0, item_height, list->match_count)) {
+        const struct nk_input *in;
+        nk_layout_row_dynamic(ctx, (float)item_height, 1);
+        for (i = view.begin; i < view.end; ++i) {
+            struct nk_rect bounds;
+            enum nk_widget_layout_states state;
+            int item = list->filter_len ? list->matches[i]: i;
+
+            /* items are drawn like combo items but the popup can only be
+             * closed after the list group has been finished */
+            state = nk_widget_fitting(&bounds, ctx, style->contextual_button.padding);
+            if (!state) continue;
+            in = (state == NK_WIDGET_ROM || ctx->current->layout->flags & NK_WINDOW_ROM) ?
+                0: &ctx->input;
+            label = list->text(list->userdata, item, &len);
+            if (nk_do_button_text(&ctx->last_widget_state, &ctx->current->buffer, bounds,
+                label ? label: "", label ? len: 0, NK_TEXT_LEFT, NK_BUTTON_DEFAULT,
+                &style->contextual_button, in, style->font))
+                picked = item;
+        }
+        nk_list_view_end(&view);
+    }
+    if (picked >= 0) {
+        list->selected = picked;
+        nk_combo_close(ctx);
+    }
+    nk_combo_end(ctx);
+    return list->selected;
+}
@@ -114,6 +114,9 @@ nk_clear(struct nk_context *ctx)
     NK_ASSERT(ctx);
 
     if (!ctx) return;
+    if (ctx->record.buffer)
+        nk_record_hash(ctx);
+    nk_redraw_finish(ctx);
     if (ctx->use_pool)
         nk_buffer_clear(&ctx->memory);
     else nk_buffer_reset(&ctx->memory, NK_BUFFER_FRONT);
@@ -315,11 +318,12 @@ nk__begin(struct nk_context *ctx)
     if (!ctx) return 0;
     if (!ctx->count) return 0;
 
-    buffer = (nk_byte*)ctx->memory.memory.ptr;
     if (!ctx->build) {
         nk_build(ctx);
         ctx->build = nk_true;
     }
+    /* the cursor overlay drawn by nk_build can grow the buffer */
+    buffer = (nk_byte*)ctx->memory.memory.ptr;
     iter = ctx->begin;
     while (iter && ((iter->buffer.begin == iter->buffer.end) ||
         (iter->flags & NK_WINDOW_HIDDEN) || iter->seq != ctx->seq))
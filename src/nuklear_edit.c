@@ -71,21 +71,24 @@ nk_filter_binary(const struct nk_text_edit *box, nk_rune unicode)
 NK_LIB void
 nk_edit_draw_text(struct nk_command_buffer *out,
     const struct nk_style_edit *style, float pos_x, float pos_y,
-    float x_offset, const char *text, int byte_len, float row_height,
+    float x_offset, const struct nk_str *str, int begin, int end, float row_height,
     const struct nk_user_font *font, struct nk_color background,
     struct nk_color foreground, int is_selected)
 {
     NK_ASSERT(out);
     NK_ASSERT(font);
     NK_ASSERT(style);
-    if (!text || !byte_len || !out || !style) return;
+    if (!str || begin >= end || !out || !style) return;
 
     {int glyph_len = 0;
     nk_rune unicode = 0;
-    int text_len = 0;
+    int text_len = begin;
+    int avail = 0;
     float line_width = 0;
+    float line_x = 0;
     float glyph_width;
-    const char *line = text;
+    const char *text;
+    const char *line;
     float line_offset = 0;
     int line_count = 0;
 
@@ -94,9 +97,13 @@ nk_edit_draw_text(struct nk_command_buffer *out,
     txt.background = background;
     txt.text = foreground;
 
-    glyph_len = nk_utf_decode(text+text_len, &unicode, byte_len-text_len);
+    /* text is read in contiguous chunks since gap buffer strings
+     * are split in two at the insertion gap */
+    text = line = nk_str_text_at(str, text_len, &avail);
+    avail = NK_MIN(avail, end - text_len);
+    glyph_len = nk_utf_decode(text, &unicode, avail);
     if (!glyph_len) return;
-    while ((text_len < byte_len) && glyph_len)
+    while ((text_len < end) && glyph_len)
     {
         if (unicode == '\n') {
             /* new line separator so draw previous line */
@@ -104,33 +111,52 @@ nk_edit_draw_text(struct nk_command_buffer *out,
             label.y = pos_y + line_offset;
             label.h = row_height;
             label.w = line_width;
-            label.x = pos_x;
+            label.x = pos_x + line_x;
             if (!line_count)
                 label.x += x_offset;
 
             if (is_selected) /* selection needs to draw different background color */
                 nk_fill_rect(out, label, 0, background);
-            nk_widget_text(out, label, line, (int)((text + text_len) - line),
+            nk_widget_text(out, label, line, (int)(text - line),
                 &txt, NK_TEXT_CENTERED, font);
 
             text_len++;
             line_count++;
             line_width = 0;
-            line = text + text_len;
+            line_x = 0;
             line_offset += row_height;
-            glyph_len = nk_utf_decode(text + text_len, &unicode, (int)(byte_len-text_len));
-            continue;
+            text++; avail--;
+            line = text;
+        } else {
+            if (unicode != '\r') {
+                glyph_width = font->width(font->userdata, font->height, text, glyph_len);
+                line_width += (float)glyph_width;
+            }
+            text_len += glyph_len;
+            text += glyph_len;
+            avail -= glyph_len;
         }
-        if (unicode == '\r') {
-            text_len++;
-            glyph_len = nk_utf_decode(text + text_len, &unicode, byte_len-text_len);
-            continue;
+        if (!avail && text_len < end) {
+            /* reached the insertion gap so draw the current chunk */
+            if (text != line) {
+                struct nk_rect label;
+                label.y = pos_y + line_offset;
+                label.h = row_height;
+                label.w = line_width;
+                label.x = pos_x + line_x;
+                if (!line_count)
+                    label.x += x_offset;
+                if (is_selected)
+                    nk_fill_rect(out, label, 0, background);
+                nk_widget_text(out, label, line, (int)(text - line),
+                    &txt, NK_TEXT_LEFT, font);
+            }
+            line_x += line_width;
+            line_width = 0;
+            text = line = nk_str_text_at(str, text_len, &avail);
+            avail = NK_MIN(avail, end - text_len);
         }
-        glyph_width = font->width(font->userdata, font->height, text+text_len, glyph_len);
-        line_width += (float)glyph_width;
-        text_len += glyph_len;
-        glyph_len = nk_utf_decode(text + text_len, &unicode, byte_len-text_len);
-        continue;
+        glyph_len = nk_utf_decode(text, &unicode, avail);
     }
     if (line_width > 0) {
         /* draw last line */
@@ -138,16 +164,91 @@ nk_edit_draw_text(struct nk_command_buffer *out,
         label.y = pos_y + line_offset;
         label.h = row_height;
         label.w = line_width;
-        label.x = pos_x;
+        label.x = pos_x + line_x;
         if (!line_count)
             label.x += x_offset;
 
         if (is_selected)
             nk_fill_rect(out, label, 0, background);
-        nk_widget_text(out, label, line, (int)((text + text_len) - line),
+        nk_widget_text(out, label, line, (int)(text - line),
             &txt, NK_TEXT_LEFT, font);
     }}
 }
+struct nk_edit_view {
+    int begin, end; /* byte range of the visible lines */
+    float y; /* position of the first visible line */
+};
+NK_INTERN void
+nk_edit_view_init(struct nk_edit_view *view, const struct nk_str *str,
+    int len, float pos_y, float scroll_y, float height, float row_height)
+{
+    /* looks up the lines inside the visible area. Without a line index
+     * the whole text is treated as visible */
+    int rune, first, last, lines;
+    view->begin = 0;
+    view->end = len;
+    view->y = pos_y;
+    if (!str->index_stride || row_height <= 0) return;
+
+    lines = nk_str_line_count(str);
+    first = NK_CLAMP(0, (int)(scroll_y / row_height), lines - 1);
+    last = (int)((scroll_y + height) / row_height) + 1;
+    view->begin = nk_str_line_begin(str, first, &rune);
+    view->y = pos_y + (float)first * row_height;
+    if (last > first && last < lines)
+        view->end = nk_str_line_begin(str, last, &rune);
+}
+NK_INTERN void
+nk_edit_draw_view(struct nk_command_buffer *out, const struct nk_edit_view *view,
+    const struct nk_style_edit *style, float pos_x, float pos_y,
+    float x_offset, const struct nk_str *str, int begin, int end, float row_height,
+    const struct nk_user_font *font, struct nk_color background,
+    struct nk_color foreground, int is_selected)
+{
+    /* same as `nk_edit_draw_text` but only draws the visible lines */
+    if (begin < view->begin) {
+        begin = view->begin;
+        pos_y = view->y;
+        x_offset = 0;
+    }
+    end = NK_MIN(end, view->end);
+    nk_edit_draw_text(out, style, pos_x, pos_y, x_offset, str, begin, end,
+        row_height, font, background, foreground, is_selected);
+}
+NK_INTERN int
+nk_edit_locate(const struct nk_str *str, const struct nk_user_font *font,
+    int pos, float row_height, struct nk_vec2 *at)
+{
+    /* computes the position of codepoint `pos` by only measuring its own
+     * line and returns its byte offset or -1 at the end of the text */
+    const char *text;
+    int glyph_len;
+    int avail = 0;
+    int rune = 0;
+    int offset;
+    nk_rune unicode;
+    int line = nk_str_line_of(str, pos);
+
+    offset = nk_str_line_begin(str, line, &rune);
+    at->x = 0;
+    at->y = (float)line * row_height;
+    if (pos >= str->len)
+        at->y = (float)nk_str_line_count(str) * row_height - row_height;
+
+    text = nk_str_text_at(str, offset, &avail);
+    while (rune < pos && avail) {
+        glyph_len = nk_utf_decode(text, &unicode, avail);
+        if (!glyph_len) break;
+        if (unicode != '\r')
+            at->x += font->width(font->userdata, font->height, text, glyph_len);
+        rune++;
+        offset += glyph_len;
+        text += glyph_len;
+        avail -= glyph_len;
+        if (!avail) text = nk_str_text_at(str, offset, &avail);
+    }
+    return (pos < str->len) ? offset: -1;
+}
 NK_LIB nk_flags
 nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
     struct nk_rect bounds, nk_flags flags, nk_plugin_filter filter,
@@ -281,7 +382,7 @@ nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
 
             int begin = NK_MIN(b, e);
             int end = NK_MAX(b, e);
-            text = nk_str_at_const(&edit->string, begin, &unicode, &glyph_len);
+            text = nk_str_at_rune(&edit->string, begin, &unicode, &glyph_len);
             if (edit->clip.copy)
                 edit->clip.copy(edit->clip.userdata, text, end - begin);
             if (cut && !(flags & NK_EDIT_READ_ONLY)){
@@ -314,8 +415,7 @@ nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
         *state |= NK_WIDGET_STATE_HOVERED;
 
     /* DRAW EDIT */
-    {const char *text = nk_str_get_const(&edit->string);
-    int len = nk_str_len_char(&edit->string);
+    {int len = nk_str_len_char(&edit->string);
 
     {/* select background colors/images  */
     const struct nk_style_item *background;
@@ -337,10 +437,10 @@ nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
         int total_lines = 1;
         struct nk_vec2 text_size = nk_vec2(0,0);
 
-        /* text pointer positions */
-        const char *cursor_ptr = 0;
-        const char *select_begin_ptr = 0;
-        const char *select_end_ptr = 0;
+        /* text byte offsets */
+        int cursor_ofs = -1;
+        int select_begin_ofs = -1;
+        int select_end_ofs = -1;
 
         /* 2D pixel positions */
         struct nk_vec2 cursor_pos = nk_vec2(0,0);
@@ -352,7 +452,21 @@ nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
 
         /* calculate total line count + total space + cursor/selection position */
         float line_width = 0.0f;
-        if (text && len)
+        if (len && edit->string.index_stride)
+        {
+            /* the line index knows where each line starts so only the lines
+             * of the cursor and the selection have to be measured */
+            total_lines = nk_str_line_count(&edit->string);
+            text_size.y = (float)total_lines * row_height;
+            cursor_ofs = nk_edit_locate(&edit->string, font, edit->cursor,
+                row_height, &cursor_pos);
+            if (edit->select_start != edit->select_end) {
+                select_begin_ofs = nk_edit_locate(&edit->string, font,
+                    selection_begin, row_height, &selection_offset_start);
+                select_end_ofs = nk_edit_locate(&edit->string, font,
+                    selection_end, row_height, &selection_offset_end);
+            }
+        } else if (len)
         {
             /* utf8 encoding */
             float glyph_width;
@@ -360,9 +474,10 @@ nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
             nk_rune unicode = 0;
             int text_len = 0;
             int glyphs = 0;
-            int row_begin = 0;
+            int avail = 0;
+            const char *text = nk_str_text_at(&edit->string, 0, &avail);
 
-            glyph_len = nk_utf_decode(text, &unicode, len);
+            glyph_len = nk_utf_decode(text, &unicode, avail);
             glyph_width = font->width(font->userdata, font->height, text, glyph_len);
             line_width = 0;
 
@@ -370,56 +485,28 @@ nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
             while ((text_len < len) && glyph_len)
             {
                 /* set cursor 2D position and line */
-                if (!cursor_ptr && glyphs == edit->cursor)
-                {
-                    int glyph_offset;
-                    struct nk_vec2 out_offset;
-                    struct nk_vec2 row_size;
-                    const char *remaining;
-
-                    /* calculate 2d position */
+                if (cursor_ofs < 0 && glyphs == edit->cursor) {
                     cursor_pos.y = (float)(total_lines-1) * row_height;
-                    row_size = nk_text_calculate_text_bounds(font, text+row_begin,
-                                text_len-row_begin, row_height, &remaining,
-                                &out_offset, &glyph_offset, NK_STOP_ON_NEW_LINE);
-                    cursor_pos.x = row_size.x;
-                    cursor_ptr = text + text_len;
+                    cursor_pos.x = line_width;
+                    cursor_ofs = text_len;
                 }
 
                 /* set start selection 2D position and line */
-                if (!select_begin_ptr && edit->select_start != edit->select_end &&
+                if (select_begin_ofs < 0 && edit->select_start != edit->select_end &&
                     glyphs == selection_begin)
                 {
-                    int glyph_offset;
-                    struct nk_vec2 out_offset;
-                    struct nk_vec2 row_size;
-                    const char *remaining;
-
-                    /* calculate 2d position */
                     selection_offset_start.y = (float)(NK_MAX(total_lines-1,0)) * row_height;
-                    row_size = nk_text_calculate_text_bounds(font, text+row_begin,
-                                text_len-row_begin, row_height, &remaining,
-                                &out_offset, &glyph_offset, NK_STOP_ON_NEW_LINE);
-                    selection_offset_start.x = row_size.x;
-                    select_begin_ptr = text + text_len;
+                    selection_offset_start.x = line_width;
+                    select_begin_ofs = text_len;
                 }
 
                 /* set end selection 2D position and line */
-                if (!select_end_ptr && edit->select_start != edit->select_end &&
+                if (select_end_ofs < 0 && edit->select_start != edit->select_end &&
                     glyphs == selection_end)
                 {
-                    int glyph_offset;
-                    struct nk_vec2 out_offset;
-                    struct nk_vec2 row_size;
-                    const char *remaining;
-
-                    /* calculate 2d position */
                     selection_offset_end.y = (float)(total_lines-1) * row_height;
-                    row_size = nk_text_calculate_text_bounds(font, text+row_begin,
-                                text_len-row_begin, row_height, &remaining,
-                                &out_offset, &glyph_offset, NK_STOP_ON_NEW_LINE);
-                    selection_offset_end.x = row_size.x;
-                    select_end_ptr = text + text_len;
+                    selection_offset_end.x = line_width;
+                    select_end_ofs = text_len;
                 }
                 if (unicode == '\n') {
                     text_size.x = NK_MAX(text_size.x, line_width);
@@ -427,25 +514,20 @@ nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
                     line_width = 0;
                     text_len++;
                     glyphs++;
-                    row_begin = text_len;
-                    glyph_len = nk_utf_decode(text + text_len, &unicode, len-text_len);
-                    glyph_width = font->width(font->userdata, font->height, text+text_len, glyph_len);
-                    continue;
+                } else {
+                    glyphs++;
+                    text_len += glyph_len;
+                    if (unicode != '\r')
+                        line_width += (float)glyph_width;
                 }
-
-                glyphs++;
-                text_len += glyph_len;
-                line_width += (float)glyph_width;
-
-                glyph_len = nk_utf_decode(text + text_len, &unicode, len-text_len);
-                glyph_width = font->width(font->userdata, font->height,
-                    text+text_len, glyph_len);
-                continue;
+                text = nk_str_text_at(&edit->string, text_len, &avail);
+                glyph_len = nk_utf_decode(text, &unicode, avail);
+                glyph_width = font->width(font->userdata, font->height, text, glyph_len);
             }
             text_size.y = (float)total_lines * row_height;
 
             /* handle case when cursor is at end of text buffer */
-            if (!cursor_ptr && edit->cursor == edit->string.len) {
+            if (cursor_ofs < 0 && edit->cursor == edit->string.len) {
                 cursor_pos.x = line_width;
                 cursor_pos.y = text_size.y - row_height;
             }
@@ -498,7 +580,8 @@ nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
         }
 
         /* draw text */
-        {struct nk_color background_color;
+        {struct nk_edit_view view;
+        struct nk_color background_color;
         struct nk_color text_color;
         struct nk_color sel_background_color;
         struct nk_color sel_text_color;
@@ -534,51 +617,44 @@ nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
             background_color = nk_rgba(0,0,0,0);
         else background_color = background->data.color;
 
-
+        nk_edit_view_init(&view, &edit->string, len, area.y - edit->scrollbar.y,
+            edit->scrollbar.y, area.h, row_height);
         if (edit->select_start == edit->select_end) {
             /* no selection so just draw the complete text */
-            const char *begin = nk_str_get_const(&edit->string);
-            int l = nk_str_len_char(&edit->string);
-            nk_edit_draw_text(out, style, area.x - edit->scrollbar.x,
-                area.y - edit->scrollbar.y, 0, begin, l, row_height, font,
-                background_color, text_color, nk_false);
+            nk_edit_draw_view(out, &view, style, area.x - edit->scrollbar.x,
+                area.y - edit->scrollbar.y, 0, &edit->string, 0, len, row_height,
+                font, background_color, text_color, nk_false);
         } else {
             /* edit has selection so draw 1-3 text chunks */
             if (edit->select_start != edit->select_end && selection_begin > 0){
                 /* draw unselected text before selection */
-                const char *begin = nk_str_get_const(&edit->string);
-                NK_ASSERT(select_begin_ptr);
-                nk_edit_draw_text(out, style, area.x - edit->scrollbar.x,
-                    area.y - edit->scrollbar.y, 0, begin, (int)(select_begin_ptr - begin),
+                NK_ASSERT(select_begin_ofs >= 0);
+                nk_edit_draw_view(out, &view, style, area.x - edit->scrollbar.x,
+                    area.y - edit->scrollbar.y, 0, &edit->string, 0, select_begin_ofs,
                     row_height, font, background_color, text_color, nk_false);
             }
             if (edit->select_start != edit->select_end) {
                 /* draw selected text */
-                NK_ASSERT(select_begin_ptr);
-                if (!select_end_ptr) {
-                    const char *begin = nk_str_get_const(&edit->string);
-                    select_end_ptr = begin + nk_str_len_char(&edit->string);
-                }
-                nk_edit_draw_text(out, style,
+                NK_ASSERT(select_begin_ofs >= 0);
+                if (select_end_ofs < 0)
+                    select_end_ofs = len;
+                nk_edit_draw_view(out, &view, style,
                     area.x - edit->scrollbar.x,
                     area.y + selection_offset_start.y - edit->scrollbar.y,
                     selection_offset_start.x,
-                    select_begin_ptr, (int)(select_end_ptr - select_begin_ptr),
+                    &edit->string, select_begin_ofs, select_end_ofs,
                     row_height, font, sel_background_color, sel_text_color, nk_true);
             }
             if ((edit->select_start != edit->select_end &&
                 selection_end < edit->string.len))
             {
                 /* draw unselected text after selected text */
-                const char *begin = select_end_ptr;
-                const char *end = nk_str_get_const(&edit->string) +
-                                    nk_str_len_char(&edit->string);
-                NK_ASSERT(select_end_ptr);
-                nk_edit_draw_text(out, style,
+                NK_ASSERT(select_end_ofs >= 0);
+                nk_edit_draw_view(out, &view, style,
                     area.x - edit->scrollbar.x,
                     area.y + selection_offset_end.y - edit->scrollbar.y,
                     selection_offset_end.x,
-                    begin, (int)(end - begin), row_height, font,
+                    &edit->string, select_end_ofs, len, row_height, font,
                     background_color, text_color, nk_true);
             }
         }
@@ -586,6 +662,9 @@ nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
         /* cursor */
         if (edit->select_start == edit->select_end)
         {
+            int avail = 0;
+            const char *cursor_ptr = (cursor_ofs < 0) ? 0:
+                nk_str_text_at(&edit->string, cursor_ofs, &avail);
             if (edit->cursor >= nk_str_len(&edit->string) ||
                 (cursor_ptr && *cursor_ptr == '\n')) {
                 /* draw cursor at end of line */
@@ -604,7 +683,7 @@ nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
 
                 nk_rune unicode;
                 NK_ASSERT(cursor_ptr);
-                glyph_len = nk_utf_decode(cursor_ptr, &unicode, 4);
+                glyph_len = nk_utf_decode(cursor_ptr, &unicode, avail);
 
                 label.x = area.x + cursor_pos.x - edit->scrollbar.x;
                 label.y = area.y + cursor_pos.y - edit->scrollbar.y;
@@ -620,9 +699,7 @@ nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
         }}
     } else {
         /* not active so just draw text */
-        int l = nk_str_len_char(&edit->string);
-        const char *begin = nk_str_get_const(&edit->string);
-
+        struct nk_edit_view view;
         const struct nk_style_item *background;
         struct nk_color background_color;
         struct nk_color text_color;
@@ -640,9 +717,11 @@ nk_do_edit(nk_flags *state, struct nk_command_buffer *out,
         if (background->type == NK_STYLE_ITEM_IMAGE)
             background_color = nk_rgba(0,0,0,0);
         else background_color = background->data.color;
-        nk_edit_draw_text(out, style, area.x - edit->scrollbar.x,
-            area.y - edit->scrollbar.y, 0, begin, l, row_height, font,
-            background_color, text_color, nk_false);
+        nk_edit_view_init(&view, &edit->string, len, area.y - edit->scrollbar.y,
+            edit->scrollbar.y, area.h, row_height);
+        nk_edit_draw_view(out, &view, style, area.x - edit->scrollbar.x,
+            area.y - edit->scrollbar.y, 0, &edit->string, 0, len, row_height,
+            font, background_color, text_color, nk_false);
     }
     nk_push_scissor(out, old_clip);}
     return ret;
@@ -2347,8 +2347,8 @@ nk_font_bake(struct nk_font_baker *baker, void *image_memory, int width, int hei
                 dst_font->ascent = ((float)unscaled_ascent * font_scale);
                 dst_font->descent = ((float)unscaled_descent * font_scale);
                 dst_font->glyph_offset = glyph_n;
-                // Need to zero this, or it will carry over from a previous
-                // bake, and cause a segfault when accessing glyphs[].
+                /* Need to zero this, or it will carry over from a previous
+                 * bake, and cause a segfault when accessing glyphs[]. */
                 dst_font->glyph_count = 0;
             }
 
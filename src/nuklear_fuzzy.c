@@ -0,0 +1,276 @@
+#include "nuklear.h"
+#include "nuklear_internal.h"
+
+/* ===============================================================
+ *
+ *                          FUZZY MATCHER
+ *
+ * ===============================================================*/
+NK_INTERN nk_uint
+nk_fuzzy_class(char c)
+{
+    /* characters which `nk_strmatch_fuzzy_text` treats as equal always end up
+     * in the same class. Lower case letters get one bit each while all other
+     * characters share the remaining six bits */
+    int lower = nk_to_lower(c);
+    if (lower >= 'a' && lower <= 'z')
+        return (nk_uint)1 << (lower - 'a');
+    return (nk_uint)1 << (26 + (lower + 256) % 6);
+}
+NK_INTERN int
+nk_fuzzy_score(const char *str, int len, const char *pattern, int *out_score)
+{
+    /* computes the same result as `nk_strmatch_fuzzy_text` but runs through
+     * the letters in front of the first and behind the last pattern match
+     * in tight loops since they can only change the score by a penalty */
+    const char *iter = pattern;
+    int i = 0, score = 0, best = -1, best_score = 0;
+    int prev_matched = nk_false, prev_lower = nk_false, prev_separator = nk_true;
+
+    if (*iter) {
+        int first = nk_to_lower(*iter);
+        while (i < len && nk_to_lower(str[i]) != first) ++i;
+        if (i == len) return nk_false;
+        if (i > 0) {
+            score = -i;
+            prev_lower = nk_is_lower(str[i-1]) != 0;
+            prev_separator = str[i-1] == '_' || str[i-1] == ' ';
+        }
+    }
+    for (; i < len; ++i) {
+        const char c = str[i];
+        int next_match, rematch;
+        if (!*iter && best >= 0) {
+            /* only letters equal to the best match can still matter and
+             * every other letter costs one point */
+            const int upper = nk_to_upper(str[best]);
+            for (;; ++i) {
+                int new_score;
+                const int from = i;
+                while (i < len && nk_to_upper(str[i]) != upper) ++i;
+                score -= i - from;
+                if (i == len) break;
+                if (i > from)
+                    prev_matched = nk_false;
+                prev_lower = nk_is_lower(str[i-1]) != 0;
+                prev_separator = str[i-1] == '_' || str[i-1] == ' ';
+                new_score = (prev_matched ? 5: 0) + (prev_separator ? 10: 0);
+                new_score += (prev_lower && nk_is_upper(str[i])) ? 10: 0;
+                if (new_score >= best_score) {
+                    score -= 1;
+                    best = i;
+                    best_score = new_score;
+                }
+                prev_matched = nk_true;
+            }
+            break;
+        }
+
+        next_match = *iter != '\0' && nk_to_lower(*iter) == nk_to_lower(c);
+        rematch = best >= 0 && nk_to_upper(str[best]) == nk_to_upper(c);
+        if ((next_match && best >= 0) || (best >= 0 && *iter != '\0' &&
+            nk_to_lower(str[best]) == nk_to_lower(*iter))) {
+            score += best_score;
+            best = -1;
+            best_score = 0;
+        }
+        if (next_match || rematch) {
+            /* adjacency, separator and camel case bonus */
+            int new_score = (prev_matched ? 5: 0) + (prev_separator ? 10: 0);
+            new_score += (prev_lower && nk_is_upper(c)) ? 10: 0;
+            if (iter == pattern)
+                score += NK_MAX(-3 * i, -9);
+            if (next_match)
+                ++iter;
+            if (new_score >= best_score) {
+                if (best >= 0)
+                    score -= 1;
+                best = i;
+                best_score = new_score;
+            }
+            prev_matched = nk_true;
+        } else {
+            score -= 1;
+            prev_matched = nk_false;
+        }
+        prev_lower = nk_is_lower(c) != 0;
+        prev_separator = c == '_' || c == ' ';
+    }
+    if (best >= 0)
+        score += best_score;
+    if (*iter != '\0')
+        return nk_false;
+    *out_score = score;
+    return nk_true;
+}
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+NK_API int
+nk_fuzzy_matcher_init_default(struct nk_fuzzy_matcher *matcher,
+    const char *const *strings, int count)
+{
+    struct nk_allocator alloc;
+    alloc.userdata.ptr = 0;
+    alloc.alloc = nk_malloc;
+    alloc.free = nk_mfree;
+    return nk_fuzzy_matcher_init(matcher, &alloc, strings, count);
+}
+#endif
+NK_API int
+nk_fuzzy_matcher_init(struct nk_fuzzy_matcher *matcher,
+    const struct nk_allocator *alloc, const char *const *strings, int count)
+{
+    NK_ASSERT(matcher);
+    NK_ASSERT(alloc);
+    if (!matcher || !alloc) return 0;
+    NK_MEMSET(matcher, 0, sizeof(*matcher));
+    matcher->pool = *alloc;
+    return nk_fuzzy_matcher_reset(matcher, strings, count);
+}
+NK_API void
+nk_fuzzy_matcher_free(struct nk_fuzzy_matcher *matcher)
+{
+    NK_ASSERT(matcher);
+    if (!matcher) return;
+    if (matcher->masks && matcher->pool.free)
+        matcher->pool.free(matcher->pool.userdata, matcher->masks);
+    matcher->masks = 0;
+    matcher->lengths = 0;
+    matcher->candidates = 0;
+    matcher->count = matcher->matches = matcher->capacity = 0;
+    matcher->valid = nk_false;
+}
+NK_API int
+nk_fuzzy_matcher_reset(struct nk_fuzzy_matcher *matcher,
+    const char *const *strings, int count)
+{
+    int i;
+    nk_uint classes[256];
+    NK_ASSERT(matcher);
+    NK_ASSERT(strings || !count);
+    if (!matcher || (!strings && count)) return 0;
+
+    matcher->valid = nk_false;
+    matcher->matches = 0;
+    matcher->count = 0;
+    matcher->strings = strings;
+    if (count > matcher->capacity) {
+        /* masks, lengths and candidates share one allocation */
+        void *memory;
+        nk_size size = (nk_size)count * (sizeof(nk_uint) + 2 * sizeof(int));
+        if (!matcher->pool.alloc || !matcher->pool.free) return 0;
+        memory = matcher->pool.alloc(matcher->pool.userdata, 0, size);
+        if (!memory) return 0;
+        if (matcher->masks)
+            matcher->pool.free(matcher->pool.userdata, matcher->masks);
+        matcher->masks = (nk_uint*)memory;
+        matcher->lengths = (int*)(void*)(matcher->masks + count);
+        matcher->candidates = matcher->lengths + count;
+        matcher->capacity = count;
+    }
+    for (i = 0; i < 256; ++i)
+        classes[i] = nk_fuzzy_class((char)i);
+    for (i = 0; i < count; ++i) {
+        const unsigned char *str = (const unsigned char*)strings[i];
+        nk_uint mask = 0;
+        int len = 0;
+        if (str) {
+            for (; str[len]; ++len)
+                mask |= classes[str[len]];
+        }
+        matcher->masks[i] = mask;
+        matcher->lengths[i] = len;
+    }
+    matcher->count = count;
+    return 1;
+}
+NK_INTERN int
+nk_fuzzy_worse(const struct nk_fuzzy_match *a, const struct nk_fuzzy_match *b)
+{
+    return a->score < b->score || (a->score == b->score && a->index > b->index);
+}
+NK_INTERN void
+nk_fuzzy_sift_down(struct nk_fuzzy_match *heap, int i, int n)
+{
+    /* min-heap with the worst result on top */
+    struct nk_fuzzy_match item = heap[i];
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= n) break;
+        if (child + 1 < n && nk_fuzzy_worse(&heap[child+1], &heap[child]))
+            child++;
+        if (!nk_fuzzy_worse(&heap[child], &item)) break;
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = item;
+}
+NK_INTERN void
+nk_fuzzy_push(struct nk_fuzzy_match *heap, int *n, int max, int index, int score)
+{
+    struct nk_fuzzy_match item;
+    int i;
+    item.index = index;
+    item.score = score;
+    if (*n == max) {
+        /* replace the worst result if the new one is better */
+        if (!nk_fuzzy_worse(heap, &item)) return;
+        heap[0] = item;
+        nk_fuzzy_sift_down(heap, 0, *n);
+        return;
+    }
+    i = (*n)++;
+    while (i > 0 && nk_fuzzy_worse(&item, &heap[(i-1)/2])) {
+        heap[i] = heap[(i-1)/2];
+        i = (i-1)/2;
+    }
+    heap[i] = item;
+}
+NK_API int
+nk_fuzzy_match(struct nk_fuzzy_matcher *matcher, const char *pattern,
+    struct nk_fuzzy_match *results, int max)
+{
+    int i, n = 0, found = 0, len, last, extend, total;
+    nk_uint mask = 0;
+
+    NK_ASSERT(matcher);
+    NK_ASSERT(pattern);
+    NK_ASSERT(results || max <= 0);
+    if (!matcher || !pattern) return 0;
+    if (!results) max = 0;
+
+    len = nk_strlen(pattern);
+    for (i = 0; i < len; ++i)
+        mask |= nk_fuzzy_class(pattern[i]);
+
+    /* a longer pattern only matches strings which matched the shorter one */
+    last = nk_strlen(matcher->pattern);
+    extend = matcher->valid && last <= len;
+    for (i = 0; i < last && extend; ++i)
+        extend = (matcher->pattern[i] == pattern[i]);
+    total = extend ? matcher->matches: matcher->count;
+
+    for (i = 0; i < total; ++i) {
+        int score, index = extend ? matcher->candidates[i]: i;
+        if ((matcher->masks[index] & mask) != mask || !matcher->lengths[index])
+            continue;
+        if (!nk_fuzzy_score(matcher->strings[index],
+                matcher->lengths[index], pattern, &score))
+            continue;
+        matcher->candidates[n++] = index;
+        if (max > 0)
+            nk_fuzzy_push(results, &found, max, index, score);
+    }
+    matcher->matches = n;
+    matcher->valid = (len < NK_FUZZY_PATTERN_SIZE);
+    if (matcher->valid)
+        NK_MEMCPY(matcher->pattern, pattern, (nk_size)len + 1);
+
+    /* heap sort puts the best result first */
+    for (i = found - 1; i > 0; --i) {
+        struct nk_fuzzy_match tmp = results[0];
+        results[0] = results[i];
+        results[i] = tmp;
+        nk_fuzzy_sift_down(results, 0, i);
+    }
+    return found;
+}
@@ -0,0 +1,142 @@
+#include "nuklear.h"
+#include "nuklear_internal.h"
+
+/* ===============================================================
+ *
+ *                          GRID
+ *
+ * ===============================================================*/
+NK_INTERN void
+nk_grid_draw_block(struct nk_grid *grid, struct nk_command_buffer *out,
+    struct nk_rect area, const struct nk_rect *clip, float x, float y,
+    int row_begin, int row_end, int column_begin, int column_end)
+{
+    /* draws the visible cells of one frozen or scrolling part of the grid
+     * where (x,y) is the screen position of cell (row_begin, column_begin) */
+    int row, column, first, last;
+    struct nk_rect cell;
+
+    if (row_begin >= row_end || column_begin >= column_end) return;
+    nk_unify(&area, clip, area.x, area.y, area.x + area.w, area.y + area.h);
+    if (area.w <= 0 || area.h <= 0) return;
+
+    first = row_begin + (int)NK_MAX((area.y - y) / grid->row_height, 0.0f);
+    last = row_begin + nk_iceilf((area.y + area.h - y) / grid->row_height);
+    last = NK_MIN(last, row_end);
+
+    /* skip the columns left of the visible area */
+    column = column_begin;
+    while (column < column_end && x + grid->column_widths[column] <= area.x)
+        x += grid->column_widths[column++];
+
+    nk_push_scissor(out, area);
+    for (; column < column_end && x < area.x + area.w; ++column) {
+        cell.x = x;
+        cell.w = grid->column_widths[column];
+        cell.h = grid->row_height;
+        for (row = first; row < last; ++row) {
+            cell.y = y + (float)(row - row_begin) * grid->row_height;
+            grid->draw(grid->userdata, out, cell, row, column);
+        }
+        x += cell.w;
+    }
+}
+NK_INTERN void
+nk_grid_resize(struct nk_grid *grid, const struct nk_input *in,
+    struct nk_rect area, const struct nk_rect *clip, float x,
+    int column_begin, int column_end)
+{
+    /* starts resizing a column when clicking on its right border */
+    int column;
+    struct nk_rect handle;
+
+    nk_unify(&area, clip, area.x, area.y, area.x + area.w, area.y + area.h);
+    if (area.w <= 0 || area.h <= 0) return;
+    handle.y = area.y;
+    handle.h = area.h;
+    handle.w = 6;
+    for (column = column_begin; column < column_end && x < area.x + area.w; ++column) {
+        x += grid->column_widths[column];
+        handle.x = x - handle.w * 0.5f;
+        if (x >= area.x && nk_input_has_mouse_click_down_in_rect(in,
+                NK_BUTTON_LEFT, handle, nk_true))
+            grid->resizing = column + 1;
+    }
+}
+NK_API int
+nk_grid(struct nk_context *ctx, struct nk_grid *grid, const char *id, nk_flags flags)
+{
+    int i, frozen_rows, frozen_columns;
+    float total_width = 0, frozen_width = 0, frozen_height;
+    float scroll_x, scroll_y;
+    struct nk_rect view, clip, area;
+    struct nk_command_buffer *out;
+    const struct nk_input *in;
+    struct nk_panel *layout;
+
+    NK_ASSERT(ctx);
+    NK_ASSERT(grid);
+    NK_ASSERT(id);
+    NK_ASSERT(grid->draw);
+    NK_ASSERT(grid->column_widths || !grid->columns);
+    if (!ctx || !grid || !id || !grid->draw || grid->row_height <= 0 ||
+        (!grid->column_widths && grid->columns))
+        return 0;
+    if (!nk_group_begin(ctx, id, flags))
+        return 0;
+
+    layout = ctx->current->layout;
+    out = &ctx->current->buffer;
+    in = (layout->flags & NK_WINDOW_ROM) ? 0: &ctx->input;
+    view = layout->bounds;
+    clip = layout->clip;
+    frozen_rows = NK_CLAMP(0, grid->frozen_rows, grid->rows);
+    frozen_columns = NK_CLAMP(0, grid->frozen_columns, grid->columns);
+    frozen_height = (float)frozen_rows * grid->row_height;
+
+    /* continue resizing a column until the mouse button is released */
+    if (grid->resizing > 0 && grid->resizing <= grid->columns &&
+        in && in->mouse.buttons[NK_BUTTON_LEFT].down) {
+        float *width = &grid->column_widths[grid->resizing-1];
+        *width = NK_MAX(grid->min_column_width, *width + in->mouse.delta.x);
+    } else grid->resizing = 0;
+
+    for (i = 0; i < grid->columns; ++i) {
+        total_width += grid->column_widths[i];
+        if (i + 1 == frozen_columns)
+            frozen_width = total_width;
+    }
+    scroll_x = (float)*layout->offset_x;
+    scroll_y = (float)*layout->offset_y;
+
+    /* scrolling cells */
+    area = nk_rect(view.x + frozen_width, view.y + frozen_height,
+        view.w - frozen_width, view.h - frozen_height);
+    nk_grid_draw_block(grid, out, area, &clip, area.x - scroll_x, area.y - scroll_y,
+        frozen_rows, grid->rows, frozen_columns, grid->columns);
+
+    /* frozen rows and columns are drawn on top */
+    area = nk_rect(view.x + frozen_width, view.y, view.w - frozen_width, frozen_height);
+    nk_grid_draw_block(grid, out, area, &clip, area.x - scroll_x, view.y,
+        0, frozen_rows, frozen_columns, grid->columns);
+    if (in && !grid->resizing && frozen_rows)
+        nk_grid_resize(grid, in, area, &clip, area.x - scroll_x,
+            frozen_columns, grid->columns);
+
+    area = nk_rect(view.x, view.y + frozen_height, frozen_width, view.h - frozen_height);
+    nk_grid_draw_block(grid, out, area, &clip, view.x, area.y - scroll_y,
+        frozen_rows, grid->rows, 0, frozen_columns);
+
+    area = nk_rect(view.x, view.y, frozen_width, frozen_height);
+    nk_grid_draw_block(grid, out, area, &clip, view.x, view.y,
+        0, frozen_rows, 0, frozen_columns);
+    if (in && !grid->resizing && frozen_rows)
+        nk_grid_resize(grid, in, area, &clip, view.x, 0, frozen_columns);
+    nk_push_scissor(out, clip);
+
+    /* let the group scrollbars cover the whole grid */
+    layout->at_y = view.y + (float)grid->rows * grid->row_height;
+    layout->max_x = view.x + total_width;
+    nk_group_end(ctx);
+    return 1;
+}
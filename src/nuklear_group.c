@@ -108,6 +108,14 @@ nk_group_scrolled_end(struct nk_context *ctx)
     nk_unify(&clip, &parent->clip, pan.bounds.x, pan.bounds.y,
         pan.bounds.x + pan.bounds.w, pan.bounds.y + pan.bounds.h + panel_padding.x);
     nk_push_scissor(&pan.buffer, clip);
+
+    /* remember the height needed to show the whole content */
+    if (g->content_height) {
+        float height = g->at_y + g->row.height - pan.bounds.y + g->footer_height;
+        if (g->flags & NK_WINDOW_BORDER)
+            height += g->border;
+        *g->content_height = (nk_uint)nk_iceilf(NK_MAX(height, 0));
+    }
     nk_end(ctx);
 
     win->buffer = pan.buffer;
@@ -166,6 +174,56 @@ nk_group_end(struct nk_context *ctx)
 {
     nk_group_scrolled_end(ctx);
 }
+NK_INTERN nk_uint*
+nk_group_content_value(struct nk_context *ctx, const char *id)
+{
+    /* content height is kept next to the group scrollbar offsets */
+    nk_hash id_hash;
+    nk_uint *height;
+    struct nk_window *win = ctx->current;
+    id_hash = nk_murmur_hash(id, nk_strlen(id), NK_PANEL_GROUP);
+    height = nk_find_value(win, id_hash+2);
+    if (!height) {
+        height = nk_add_value(ctx, win, id_hash+2, 0);
+        if (height) *height = 0;
+    }
+    return height;
+}
+NK_API int
+nk_group_begin_lazy(struct nk_context *ctx, const char *title, nk_flags flags,
+    float *content_height)
+{
+    nk_uint *height;
+    NK_ASSERT(ctx);
+    NK_ASSERT(title);
+    NK_ASSERT(ctx->current);
+    NK_ASSERT(ctx->current->layout);
+    if (content_height) *content_height = 0;
+    if (!ctx || !ctx->current || !ctx->current->layout || !title)
+        return 0;
+
+    height = nk_group_content_value(ctx, title);
+    if (height && content_height)
+        *content_height = (float)*height;
+
+    /* minimized and closed groups have already been ended */
+    if (nk_group_begin_titled(ctx, title, title, flags) != 1)
+        return 0;
+    ctx->current->layout->content_height = height;
+    return 1;
+}
+NK_API float
+nk_group_get_content_height(struct nk_context *ctx, const char *id)
+{
+    nk_uint *height;
+    NK_ASSERT(ctx);
+    NK_ASSERT(id);
+    NK_ASSERT(ctx->current);
+    if (!ctx || !ctx->current || !ctx->current->layout || !id)
+        return 0;
+    height = nk_group_content_value(ctx, id);
+    return height ? (float)*height: 0;
+}
 NK_API void
 nk_group_get_scroll(struct nk_context *ctx, const char *id, nk_uint *x_offset, nk_uint *y_offset)
 {
@@ -29,10 +29,26 @@ nk_input_begin(struct nk_context *ctx)
 NK_API void
 nk_input_end(struct nk_context *ctx)
 {
+    int i;
     struct nk_input *in;
     NK_ASSERT(ctx);
     if (!ctx) return;
     in = &ctx->input;
+
+    /* input whose effects can show up one frame late, or held buttons
+     * which drive repeating buttons and drags, keep frames coming */
+    ctx->redraw.input = in->keyboard.text_len > 0 ||
+        in->mouse.scroll_delta.x != 0 || in->mouse.scroll_delta.y != 0;
+    for (i = 0; i < NK_BUTTON_MAX; ++i)
+        if (in->mouse.buttons[i].clicked || in->mouse.buttons[i].down)
+            ctx->redraw.input = nk_true;
+    for (i = 0; i < NK_KEY_MAX; ++i)
+        if (in->keyboard.keys[i].clicked)
+            ctx->redraw.input = nk_true;
+    if (ctx->record.buffer) {
+        nk_record_input(ctx, NK_RECORD_POSITION, (int)in->mouse.pos.x, (int)in->mouse.pos.y, 0);
+        nk_record_floats(ctx, NK_RECORD_END, ctx->delta_time_seconds, 0);
+    }
     if (in->mouse.grab)
         in->mouse.grab = 0;
     if (in->mouse.ungrab) {
@@ -48,6 +64,8 @@ nk_input_motion(struct nk_context *ctx, int x, int y)
     NK_ASSERT(ctx);
     if (!ctx) return;
     in = &ctx->input;
+    if (ctx->record.buffer)
+        nk_record_input(ctx, NK_RECORD_MOTION, x, y, 0);
     in->mouse.pos.x = (float)x;
     in->mouse.pos.y = (float)y;
     in->mouse.delta.x = in->mouse.pos.x - in->mouse.prev.x;
@@ -61,12 +79,14 @@ nk_input_key(struct nk_context *ctx, enum nk_keys key, int down)
     if (!ctx) return;
     in = &ctx->input;
 #ifdef NK_KEYSTATE_BASED_INPUT
-    if (in->keyboard.keys[key].down != down)
-        in->keyboard.keys[key].clicked++;
+    if (in->keyboard.keys[key].down == down) return;
+    in->keyboard.keys[key].clicked++;
 #else
     in->keyboard.keys[key].clicked++;
 #endif
     in->keyboard.keys[key].down = down;
+    if (ctx->record.buffer)
+        nk_record_input(ctx, NK_RECORD_KEY, (int)key | (down ? 0x80: 0), 0, 0);
 }
 NK_API void
 nk_input_button(struct nk_context *ctx, enum nk_buttons id, int x, int y, int down)
@@ -83,12 +103,16 @@ nk_input_button(struct nk_context *ctx, enum nk_buttons id, int x, int y, int do
     btn->clicked_pos.y = (float)y;
     btn->down = down;
     btn->clicked++;
+    if (ctx->record.buffer)
+        nk_record_input(ctx, NK_RECORD_BUTTON, (int)id | (down ? 0x80: 0), x, y);
 }
 NK_API void
 nk_input_scroll(struct nk_context *ctx, struct nk_vec2 val)
 {
     NK_ASSERT(ctx);
     if (!ctx) return;
+    if (ctx->record.buffer)
+        nk_record_floats(ctx, NK_RECORD_SCROLL, val.x, val.y);
     ctx->input.mouse.scroll_delta.x += val.x;
     ctx->input.mouse.scroll_delta.y += val.y;
 }
@@ -104,6 +128,8 @@ nk_input_glyph(struct nk_context *ctx, const nk_glyph glyph)
     in = &ctx->input;
 
     len = nk_utf_decode(glyph, &unicode, NK_UTF_SIZE);
+    if (len && ctx->record.buffer)
+        nk_record_input(ctx, NK_RECORD_UNICODE, (int)unicode, 0, 0);
     if (len && ((in->keyboard.text_len + len) < NK_INPUT_MAX)) {
         nk_utf_encode(unicode, &in->keyboard.text[in->keyboard.text_len],
             NK_INPUT_MAX - in->keyboard.text_len);
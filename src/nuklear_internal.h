@@ -13,6 +13,34 @@
 #define NK_BUFFER_DEFAULT_INITIAL_SIZE (4*1024)
 #endif
 
+#ifndef NK_STR_GAP_MIN_SIZE
+#define NK_STR_GAP_MIN_SIZE 64
+#endif
+
+#ifndef NK_STR_INDEX_STRIDE
+#define NK_STR_INDEX_STRIDE 64
+#endif
+
+#ifndef NK_TEXTEDIT_HISTORY_MIN_SIZE
+#define NK_TEXTEDIT_HISTORY_MIN_SIZE 1024
+#endif
+
+#ifndef NK_TEXT_VIEW_LINE_STRIDE
+#define NK_TEXT_VIEW_LINE_STRIDE 64
+#endif
+
+#ifndef NK_TEXT_VIEW_INDEX_BUDGET
+#define NK_TEXT_VIEW_INDEX_BUDGET (4 * 1024 * 1024)
+#endif
+
+#ifndef NK_TEXT_VIEW_MAX_COPY
+#define NK_TEXT_VIEW_MAX_COPY (16 * 1024 * 1024)
+#endif
+
+#ifndef NK_CHART_MARKER_SPACING
+#define NK_CHART_MARKER_SPACING 8
+#endif
+
 /* standard library headers */
 #ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
 #include <stdlib.h> /* malloc, free */
@@ -126,7 +154,6 @@ NK_LIB int nk_iceilf(float x);
 NK_LIB int nk_log10(double n);
 
 /* util */
-enum {NK_DO_NOT_STOP_ON_NEW_LINE, NK_STOP_ON_NEW_LINE};
 NK_LIB int nk_is_lower(int c);
 NK_LIB int nk_is_upper(int c);
 NK_LIB int nk_to_upper(int c);
@@ -138,7 +165,6 @@ NK_LIB char *nk_itoa(char *s, long n);
 NK_LIB int nk_string_float_limit(char *string, int prec);
 NK_LIB char *nk_dtoa(char *s, double n);
 NK_LIB int nk_text_clamp(const struct nk_user_font *font, const char *text, int text_len, float space, int *glyphs, float *text_width, nk_rune *sep_list, int sep_count);
-NK_LIB struct nk_vec2 nk_text_calculate_text_bounds(const struct nk_user_font *font, const char *begin, int byte_len, float row_height, const char **remaining, struct nk_vec2 *out_offset, int *glyphs, int op);
 #ifdef NK_INCLUDE_STANDARD_VARARGS
 NK_LIB int nk_strfmt(char *buf, int buf_size, const char *fmt, va_list args);
 #endif
@@ -155,6 +181,16 @@ NK_LIB void* nk_buffer_align(void *unaligned, nk_size align, nk_size *alignment,
 NK_LIB void* nk_buffer_alloc(struct nk_buffer *b, enum nk_buffer_allocation_type type, nk_size size, nk_size align);
 NK_LIB void* nk_buffer_realloc(struct nk_buffer *b, nk_size capacity, nk_size *size);
 
+/* utf-8 */
+NK_LIB int nk_utf_prev(const char *text, int pos);
+
+/* string */
+NK_LIB const char *nk_str_text_at(const struct nk_str *s, int pos, int *avail);
+NK_LIB int nk_str_rune_offset(const struct nk_str *s, int pos);
+NK_LIB int nk_str_line_of(const struct nk_str *s, int pos);
+NK_LIB int nk_str_line_begin(const struct nk_str *s, int line, int *rune);
+NK_LIB int nk_str_line_count(const struct nk_str *s);
+
 /* draw */
 NK_LIB void nk_command_buffer_init(struct nk_command_buffer *cb, struct nk_buffer *b, enum nk_command_clipping clip);
 NK_LIB void nk_command_buffer_reset(struct nk_command_buffer *b);
@@ -170,6 +206,25 @@ NK_LIB void nk_finish_buffer(struct nk_context *ctx, struct nk_command_buffer *b
 NK_LIB void nk_finish(struct nk_context *ctx, struct nk_window *w);
 NK_LIB void nk_build(struct nk_context *ctx);
 
+/* redraw */
+NK_LIB void nk_redraw_finish(struct nk_context *ctx);
+
+/* input recording */
+enum nk_record_op {
+    NK_RECORD_END,
+    NK_RECORD_MOTION,
+    NK_RECORD_BUTTON,
+    NK_RECORD_KEY,
+    NK_RECORD_UNICODE,
+    NK_RECORD_SCROLL,
+    NK_RECORD_HASH,
+    NK_RECORD_POSITION,
+    NK_RECORD_RESIZE
+};
+NK_LIB void nk_record_input(struct nk_context *ctx, enum nk_record_op op, int a, int b, int c);
+NK_LIB void nk_record_floats(struct nk_context *ctx, enum nk_record_op op, float a, float b);
+NK_LIB void nk_record_hash(struct nk_context *ctx);
+
 /* text editor */
 NK_LIB void nk_textedit_clear_state(struct nk_text_edit *state, enum nk_text_edit_type type, nk_plugin_filter filter);
 NK_LIB void nk_textedit_click(struct nk_text_edit *state, float x, float y, const struct nk_user_font *font, float row_height);
@@ -286,7 +341,7 @@ NK_LIB int nk_do_selectable(nk_flags *state, struct nk_command_buffer *out, stru
 NK_LIB int nk_do_selectable_image(nk_flags *state, struct nk_command_buffer *out, struct nk_rect bounds, const char *str, int len, nk_flags align, int *value, const struct nk_image *img, const struct nk_style_selectable *style, const struct nk_input *in, const struct nk_user_font *font);
 
 /* edit */
-NK_LIB void nk_edit_draw_text(struct nk_command_buffer *out, const struct nk_style_edit *style, float pos_x, float pos_y, float x_offset, const char *text, int byte_len, float row_height, const struct nk_user_font *font, struct nk_color background, struct nk_color foreground, int is_selected);
+NK_LIB void nk_edit_draw_text(struct nk_command_buffer *out, const struct nk_style_edit *style, float pos_x, float pos_y, float x_offset, const struct nk_str *str, int begin, int end, float row_height, const struct nk_user_font *font, struct nk_color background, struct nk_color foreground, int is_selected);
 NK_LIB nk_flags nk_do_edit(nk_flags *state, struct nk_command_buffer *out, struct nk_rect bounds, nk_flags flags, nk_plugin_filter filter, struct nk_text_edit *edit, const struct nk_style_edit *style, struct nk_input *in, const struct nk_user_font *font);
 
 /* color-picker */
@@ -6,32 +6,18 @@
  *                          LIST VIEW
  *
  * ===============================================================*/
-NK_API int
-nk_list_view_begin(struct nk_context *ctx, struct nk_list_view *view,
-    const char *title, nk_flags flags, int row_height, int row_count)
+NK_INTERN int
+nk_list_view_scroll_begin(struct nk_context *ctx, struct nk_list_view *view,
+    const char *title, nk_flags flags)
 {
     int title_len;
     nk_hash title_hash;
     nk_uint *x_offset;
     nk_uint *y_offset;
-
-    int result;
     struct nk_window *win;
-    struct nk_panel *layout;
-    const struct nk_style *style;
-    struct nk_vec2 item_spacing;
-
-    NK_ASSERT(ctx);
-    NK_ASSERT(view);
-    NK_ASSERT(title);
-    if (!ctx || !view || !title) return 0;
-
-    win = ctx->current;
-    style = &ctx->style;
-    item_spacing = style->window.spacing;
-    row_height += NK_MAX(0, (int)item_spacing.y);
 
     /* find persistent list view scrollbar offset */
+    win = ctx->current;
     title_len = (int)nk_strlen(title);
     title_hash = nk_murmur_hash(title, (int)title_len, NK_PANEL_GROUP);
     x_offset = nk_find_value(win, title_hash);
@@ -48,7 +34,29 @@ nk_list_view_begin(struct nk_context *ctx, struct nk_list_view *view,
     view->scroll_pointer = y_offset;
 
     *y_offset = 0;
-    result = nk_group_scrolled_offset_begin(ctx, x_offset, y_offset, title, flags);
+    view->ctx = ctx;
+    return nk_group_scrolled_offset_begin(ctx, x_offset, y_offset, title, flags);
+}
+NK_API int
+nk_list_view_begin(struct nk_context *ctx, struct nk_list_view *view,
+    const char *title, nk_flags flags, int row_height, int row_count)
+{
+    int result;
+    struct nk_window *win;
+    struct nk_panel *layout;
+    const struct nk_style *style;
+    struct nk_vec2 item_spacing;
+
+    NK_ASSERT(ctx);
+    NK_ASSERT(view);
+    NK_ASSERT(title);
+    if (!ctx || !view || !title) return 0;
+
+    style = &ctx->style;
+    item_spacing = style->window.spacing;
+    row_height += NK_MAX(0, (int)item_spacing.y);
+
+    result = nk_list_view_scroll_begin(ctx, view, title, flags);
     win = ctx->current;
     layout = win->layout;
 
@@ -60,6 +68,65 @@ nk_list_view_begin(struct nk_context *ctx, struct nk_list_view *view,
     view->ctx = ctx;
     return result;
 }
+NK_INTERN int
+nk_row_heights_search(const struct nk_row_heights *heights, int offset, int spacing)
+{
+    /* returns the row at `offset` if every row is followed by `spacing`
+     * pixels by descending the Fenwick tree, since each node covers a
+     * power of two number of rows the spacing can be added per node */
+    int row = 0;
+    int mask = 1;
+    if (!heights->count || offset < 0) return 0;
+    while (mask <= heights->count / 2) mask <<= 1;
+    for (; mask; mask >>= 1) {
+        int next = row + mask;
+        int height;
+        if (next > heights->count) continue;
+        height = heights->tree[next] + mask * spacing;
+        if (height <= offset) {
+            row = next;
+            offset -= height;
+        }
+    }
+    return NK_MIN(row, heights->count - 1);
+}
+NK_API int
+nk_list_view_begin_variable(struct nk_context *ctx, struct nk_list_view *view,
+    const char *title, nk_flags flags, const struct nk_row_heights *heights)
+{
+    int result;
+    int spacing;
+    int top, bottom, last;
+    struct nk_window *win;
+    struct nk_panel *layout;
+
+    NK_ASSERT(ctx);
+    NK_ASSERT(view);
+    NK_ASSERT(title);
+    NK_ASSERT(heights);
+    if (!ctx || !view || !title || !heights) return 0;
+
+    spacing = NK_MAX(0, (int)ctx->style.window.spacing.y);
+    result = nk_list_view_scroll_begin(ctx, view, title, flags);
+    win = ctx->current;
+    layout = win->layout;
+
+    view->total_height = nk_row_heights_offset(heights, heights->count) +
+        heights->count * spacing;
+    view->begin = view->end = view->count = 0;
+    if (heights->count) {
+        /* move the first row up by the part that is scrolled out of view */
+        view->begin = nk_row_heights_search(heights, (int)view->scroll_value, spacing);
+        top = nk_row_heights_offset(heights, view->begin) + view->begin * spacing;
+        bottom = (int)view->scroll_value + nk_iceilf(layout->clip.h);
+        last = nk_row_heights_search(heights, NK_MAX(bottom - 1, 0), spacing);
+        view->count = NK_MAX(last - view->begin + 1, 0);
+        view->end = view->begin + view->count;
+        if (result)
+            layout->at_y -= (float)NK_MAX((int)view->scroll_value - top, 0);
+    }
+    return result;
+}
 NK_API void
 nk_list_view_end(struct nk_list_view *view)
 {
@@ -80,3 +147,146 @@ nk_list_view_end(struct nk_list_view *view)
     nk_group_end(view->ctx);
 }
 
+/* ===============================================================
+ *
+ *                          ROW HEIGHTS
+ *
+ * ===============================================================*/
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+NK_API void
+nk_row_heights_init_default(struct nk_row_heights *heights)
+{
+    struct nk_allocator alloc;
+    alloc.userdata.ptr = 0;
+    alloc.alloc = nk_malloc;
+    alloc.free = nk_mfree;
+    nk_row_heights_init(heights, &alloc);
+}
+#endif
+NK_API void
+nk_row_heights_init(struct nk_row_heights *heights, const struct nk_allocator *alloc)
+{
+    NK_ASSERT(heights);
+    NK_ASSERT(alloc);
+    if (!heights || !alloc) return;
+    NK_MEMSET(heights, 0, sizeof(*heights));
+    heights->pool = *alloc;
+}
+NK_API void
+nk_row_heights_free(struct nk_row_heights *heights)
+{
+    NK_ASSERT(heights);
+    if (!heights) return;
+    if (heights->tree && heights->pool.free)
+        heights->pool.free(heights->pool.userdata, heights->tree);
+    heights->tree = 0;
+    heights->count = heights->capacity = 0;
+}
+NK_INTERN int
+nk_row_heights_reserve(struct nk_row_heights *heights, int count)
+{
+    int *tree;
+    int capacity;
+    if (count <= heights->capacity) return nk_true;
+    if (!heights->pool.alloc || !heights->pool.free) return nk_false;
+    capacity = NK_MAX(count, heights->capacity * 2);
+    capacity = NK_MAX(capacity, 64);
+    /* the tree is indexed starting at 1 */
+    tree = (int*)heights->pool.alloc(heights->pool.userdata, 0,
+        (nk_size)(capacity + 1) * sizeof(int));
+    if (!tree) return nk_false;
+    if (heights->tree) {
+        NK_MEMCPY(tree, heights->tree, (nk_size)(heights->count + 1) * sizeof(int));
+        heights->pool.free(heights->pool.userdata, heights->tree);
+    } else tree[0] = 0;
+    heights->tree = tree;
+    heights->capacity = capacity;
+    return nk_true;
+}
+NK_API int
+nk_row_heights_build(struct nk_row_heights *heights, int count,
+    nk_plugin_row_height height, nk_handle userdata)
+{
+    int i;
+    NK_ASSERT(heights);
+    NK_ASSERT(height);
+    if (!heights || !height || count < 0) return nk_false;
+    if (!nk_row_heights_reserve(heights, count)) return nk_false;
+
+    /* fill in all heights and push partial sums up in one pass */
+    for (i = 1; i <= count; ++i)
+        heights->tree[i] = height(userdata, i-1);
+    for (i = 1; i <= count; ++i) {
+        int parent = i + (i & -i);
+        if (parent <= count)
+            heights->tree[parent] += heights->tree[i];
+    }
+    heights->count = count;
+    return nk_true;
+}
+NK_API int
+nk_row_heights_resize(struct nk_row_heights *heights, int count, int height)
+{
+    int i;
+    NK_ASSERT(heights);
+    if (!heights || count < 0) return nk_false;
+    if (count <= heights->count) {
+        /* nodes only cover rows in front of them so shrinking is free */
+        heights->count = count;
+        return nk_true;
+    }
+    if (!nk_row_heights_reserve(heights, count)) return nk_false;
+    for (i = heights->count + 1; i <= count; ++i) {
+        /* a new node covers itself and the nodes right below it */
+        int child, sum = height;
+        for (child = i - 1; child > i - (i & -i); child -= (child & -child))
+            sum += heights->tree[child];
+        heights->tree[i] = sum;
+    }
+    heights->count = count;
+    return nk_true;
+}
+NK_API void
+nk_row_heights_set(struct nk_row_heights *heights, int row, int height)
+{
+    int i, delta;
+    NK_ASSERT(heights);
+    NK_ASSERT(row >= 0 && row < heights->count);
+    if (!heights || row < 0 || row >= heights->count) return;
+    delta = height - nk_row_heights_get(heights, row);
+    if (!delta) return;
+    for (i = row + 1; i <= heights->count; i += (i & -i))
+        heights->tree[i] += delta;
+}
+NK_API int
+nk_row_heights_get(const struct nk_row_heights *heights, int row)
+{
+    int i, parent, height;
+    NK_ASSERT(heights);
+    if (!heights || row < 0 || row >= heights->count) return 0;
+    /* subtract the nodes that end inside the range of the row's node */
+    i = row + 1;
+    height = heights->tree[i];
+    parent = i - (i & -i);
+    for (i = i - 1; i > parent; i -= (i & -i))
+        height -= heights->tree[i];
+    return height;
+}
+NK_API int
+nk_row_heights_offset(const struct nk_row_heights *heights, int row)
+{
+    int i, offset = 0;
+    NK_ASSERT(heights);
+    if (!heights) return 0;
+    row = NK_CLAMP(0, row, heights->count);
+    for (i = row; i > 0; i -= (i & -i))
+        offset += heights->tree[i];
+    return offset;
+}
+NK_API int
+nk_row_heights_find(const struct nk_row_heights *heights, int offset)
+{
+    NK_ASSERT(heights);
+    if (!heights) return 0;
+    return nk_row_heights_search(heights, offset, 0);
+}
@@ -475,6 +475,8 @@ nk_panel_end(struct nk_context *ctx)
         if ((!has_input && is_window_hovered) || (!is_window_hovered && !any_item_active))
             window->scrollbar_hiding_timer += ctx->delta_time_seconds;
         else window->scrollbar_hiding_timer = 0;
+        if (window->scrollbar_hiding_timer < NK_SCROLLBAR_HIDING_TIMEOUT)
+            nk_request_redraw(ctx, NK_SCROLLBAR_HIDING_TIMEOUT - window->scrollbar_hiding_timer);
     } else window->scrollbar_hiding_timer = 0;
 
     /* window border */
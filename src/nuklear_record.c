@@ -0,0 +1,283 @@
+#include "nuklear.h"
+#include "nuklear_internal.h"
+
+/* ===============================================================
+ *
+ *                          RECORD
+ *
+ * ===============================================================*/
+/* A recording starts with a four byte magic followed by one opcode byte
+ * per input call. Coordinates are zigzag varints relative to the last
+ * recorded mouse position, floats and hashes are little endian words.
+ * Surface sizes are stored as NK_RECORD_RESIZE with two unsigned varints.
+ * The input of every frame ends with NK_RECORD_POSITION if the mouse
+ * position was changed outside of `nk_input_motion`, then NK_RECORD_END and,
+ * if the frame was cleared, NK_RECORD_HASH with `nk_frame_hash` of it. */
+NK_GLOBAL const char nk_record_magic[4] = {'N','K','R','1'};
+
+NK_INTERN int
+nk_record_uint(nk_byte *out, nk_uint v)
+{
+    int n = 0;
+    while (v >= 0x80) {
+        out[n++] = (nk_byte)(v | 0x80);
+        v >>= 7;
+    }
+    out[n++] = (nk_byte)v;
+    return n;
+}
+NK_INTERN int
+nk_record_int(nk_byte *out, int v)
+{
+    nk_uint u = (v < 0) ? ((~(nk_uint)v) << 1) | 1: (nk_uint)v << 1;
+    return nk_record_uint(out, u);
+}
+NK_INTERN int
+nk_record_word(nk_byte *out, nk_uint v)
+{
+    out[0] = (nk_byte)v;
+    out[1] = (nk_byte)(v >> 8);
+    out[2] = (nk_byte)(v >> 16);
+    out[3] = (nk_byte)(v >> 24);
+    return 4;
+}
+NK_INTERN int
+nk_record_float(nk_byte *out, float f)
+{
+    nk_uint u;
+    NK_MEMCPY(&u, &f, sizeof(u));
+    return nk_record_word(out, u);
+}
+NK_API int
+nk_record_begin(struct nk_context *ctx, struct nk_buffer *out)
+{
+    NK_ASSERT(ctx);
+    NK_ASSERT(out);
+    if (!ctx || !out || ctx->record.buffer) return 0;
+    ctx->record.buffer = out;
+    ctx->record.x = ctx->record.y = 0;
+    nk_buffer_push(out, NK_BUFFER_FRONT, nk_record_magic, sizeof(nk_record_magic), 1);
+    return 1;
+}
+NK_API void
+nk_record_end(struct nk_context *ctx)
+{
+    NK_ASSERT(ctx);
+    if (!ctx) return;
+    ctx->record.buffer = 0;
+}
+NK_API void
+nk_record_resize(struct nk_context *ctx, int width, int height)
+{
+    nk_byte data[11];
+    int n = 0;
+    NK_ASSERT(ctx);
+    if (!ctx || !ctx->record.buffer) return;
+    data[n++] = NK_RECORD_RESIZE;
+    n += nk_record_uint(data + n, (nk_uint)NK_MAX(width, 0));
+    n += nk_record_uint(data + n, (nk_uint)NK_MAX(height, 0));
+    nk_buffer_push(ctx->record.buffer, NK_BUFFER_FRONT, data, (nk_size)n, 1);
+}
+NK_LIB void
+nk_record_input(struct nk_context *ctx, enum nk_record_op op, int a, int b, int c)
+{
+    struct nk_record *r = &ctx->record;
+    nk_byte data[16];
+    int n = 0;
+
+    data[n++] = (nk_byte)op;
+    switch (op) {
+    case NK_RECORD_POSITION:
+        if (a == r->x && b == r->y) return;
+        /* fallthrough */
+    case NK_RECORD_MOTION:
+        n += nk_record_int(data + n, a - r->x);
+        n += nk_record_int(data + n, b - r->y);
+        r->x = a; r->y = b;
+        break;
+    case NK_RECORD_BUTTON:
+        /* button and key states are stored in the top bit */
+        data[n++] = (nk_byte)a;
+        n += nk_record_int(data + n, b - r->x);
+        n += nk_record_int(data + n, c - r->y);
+        break;
+    case NK_RECORD_KEY:
+        data[n++] = (nk_byte)a;
+        break;
+    case NK_RECORD_UNICODE:
+        n += nk_record_uint(data + n, (nk_uint)a);
+        break;
+    default: return;
+    }
+    nk_buffer_push(r->buffer, NK_BUFFER_FRONT, data, (nk_size)n, 1);
+}
+NK_LIB void
+nk_record_floats(struct nk_context *ctx, enum nk_record_op op, float a, float b)
+{
+    nk_byte data[9];
+    int n = 0;
+    data[n++] = (nk_byte)op;
+    n += nk_record_float(data + n, a);
+    if (op == NK_RECORD_SCROLL)
+        n += nk_record_float(data + n, b);
+    nk_buffer_push(ctx->record.buffer, NK_BUFFER_FRONT, data, (nk_size)n, 1);
+}
+NK_LIB void
+nk_record_hash(struct nk_context *ctx)
+{
+    nk_byte data[5];
+    data[0] = NK_RECORD_HASH;
+    nk_record_word(data + 1, nk_frame_hash(ctx));
+    nk_buffer_push(ctx->record.buffer, NK_BUFFER_FRONT, data, sizeof(data), 1);
+}
+
+/* ===============================================================
+ *
+ *                          REPLAY
+ *
+ * ===============================================================*/
+NK_INTERN int
+nk_replay_byte(struct nk_replay *r, nk_uint *v)
+{
+    if (r->offset >= r->size) return 0;
+    *v = r->data[r->offset++];
+    return 1;
+}
+NK_INTERN int
+nk_replay_uint(struct nk_replay *r, nk_uint *v)
+{
+    nk_uint b;
+    int shift = 0;
+    *v = 0;
+    do {
+        if (shift > 28 || !nk_replay_byte(r, &b)) return 0;
+        *v |= (b & 0x7F) << shift;
+        shift += 7;
+    } while (b & 0x80);
+    return 1;
+}
+NK_INTERN int
+nk_replay_int(struct nk_replay *r, int *v)
+{
+    nk_uint u;
+    if (!nk_replay_uint(r, &u)) return 0;
+    *v = (u & 1) ? (int)~(u >> 1): (int)(u >> 1);
+    return 1;
+}
+NK_INTERN int
+nk_replay_word(struct nk_replay *r, nk_uint *v)
+{
+    const nk_byte *p;
+    if (r->size - r->offset < 4) return 0;
+    p = r->data + r->offset;
+    *v = (nk_uint)p[0] | (nk_uint)p[1] << 8 | (nk_uint)p[2] << 16 | (nk_uint)p[3] << 24;
+    r->offset += 4;
+    return 1;
+}
+NK_INTERN int
+nk_replay_float(struct nk_replay *r, float *f)
+{
+    nk_uint u;
+    if (!nk_replay_word(r, &u)) return 0;
+    NK_MEMCPY(f, &u, sizeof(*f));
+    return 1;
+}
+NK_API int
+nk_replay_init(struct nk_replay *r, const void *memory, nk_size size)
+{
+    int i;
+    NK_ASSERT(r);
+    NK_ASSERT(memory);
+    if (!r || !memory) return 0;
+    nk_zero(r, sizeof(*r));
+    if (size < sizeof(nk_record_magic)) return 0;
+    for (i = 0; i < (int)sizeof(nk_record_magic); ++i)
+        if (((const char*)memory)[i] != nk_record_magic[i]) return 0;
+    r->data = (const nk_byte*)memory;
+    r->size = size;
+    r->offset = sizeof(nk_record_magic);
+    return 1;
+}
+NK_API int
+nk_replay_frame(struct nk_context *ctx, struct nk_replay *r)
+{
+    nk_uint op, v, h;
+    int x, y;
+    float fx, fy;
+
+    NK_ASSERT(ctx);
+    NK_ASSERT(r);
+    if (!ctx || !r || !r->data || r->offset >= r->size)
+        return 0;
+
+    nk_input_begin(ctx);
+    r->has_hash = nk_false;
+    r->resized = nk_false;
+    while (nk_replay_byte(r, &op)) {
+        switch (op) {
+        case NK_RECORD_MOTION:
+            if (!nk_replay_int(r, &x) || !nk_replay_int(r, &y)) goto corrupt;
+            r->x += x; r->y += y;
+            nk_input_motion(ctx, r->x, r->y);
+            break;
+        case NK_RECORD_BUTTON:
+            if (!nk_replay_byte(r, &v) || !nk_replay_int(r, &x) || !nk_replay_int(r, &y) ||
+                (v & 0x7F) >= NK_BUTTON_MAX) goto corrupt;
+            nk_input_button(ctx, (enum nk_buttons)(v & 0x7F), r->x + x, r->y + y, (v & 0x80) != 0);
+            break;
+        case NK_RECORD_KEY:
+            if (!nk_replay_byte(r, &v) || (v & 0x7F) >= NK_KEY_MAX) goto corrupt;
+            nk_input_key(ctx, (enum nk_keys)(v & 0x7F), (v & 0x80) != 0);
+            break;
+        case NK_RECORD_UNICODE:
+            if (!nk_replay_uint(r, &v)) goto corrupt;
+            nk_input_unicode(ctx, (nk_rune)v);
+            break;
+        case NK_RECORD_SCROLL:
+            if (!nk_replay_float(r, &fx) || !nk_replay_float(r, &fy)) goto corrupt;
+            nk_input_scroll(ctx, nk_vec2(fx, fy));
+            break;
+        case NK_RECORD_POSITION:
+            /* moves the cursor but keeps the motion delta of the frame */
+            if (!nk_replay_int(r, &x) || !nk_replay_int(r, &y)) goto corrupt;
+            r->x += x; r->y += y;
+            ctx->input.mouse.pos.x = (float)r->x;
+            ctx->input.mouse.pos.y = (float)r->y;
+            break;
+        case NK_RECORD_RESIZE:
+            if (!nk_replay_uint(r, &v) || !nk_replay_uint(r, &h)) goto corrupt;
+            r->width = (int)v;
+            r->height = (int)h;
+            r->resized = nk_true;
+            break;
+        case NK_RECORD_HASH:
+            /* frames cleared without input in between */
+            if (!nk_replay_word(r, &v)) goto corrupt;
+            break;
+        case NK_RECORD_END:
+            if (!nk_replay_float(r, &ctx->delta_time_seconds)) goto corrupt;
+            nk_input_end(ctx);
+            /* the hash of the recorded frame follows its input */
+            if (r->offset < r->size && r->data[r->offset] == NK_RECORD_HASH) {
+                r->offset++;
+                if (!nk_replay_word(r, &r->hash)) goto corrupt;
+                r->has_hash = nk_true;
+            }
+            r->frame++;
+            return 1;
+        default: goto corrupt;
+        }
+    }
+corrupt:
+    nk_input_end(ctx);
+    r->offset = r->size;
+    return 0;
+}
+NK_API int
+nk_replay_check(struct nk_context *ctx, const struct nk_replay *r)
+{
+    NK_ASSERT(ctx);
+    NK_ASSERT(r);
+    if (!ctx || !r) return 0;
+    return !r->has_hash || nk_frame_hash(ctx) == r->hash;
+}
@@ -0,0 +1,137 @@
+#include "nuklear.h"
+#include "nuklear_internal.h"
+
+/* ===============================================================
+ *
+ *                          REDRAW
+ *
+ * ===============================================================*/
+#define NK_HASH_FIELDS(seed, type, cmd, first, last) \
+    seed = nk_murmur_hash(&((const type*)(cmd))->first, (int)((const nk_byte*)\
+        (&((const type*)(cmd))->last + 1) - (const nk_byte*)&((const type*)(cmd))->first), seed)
+
+NK_INTERN nk_hash
+nk_command_hash(const struct nk_command *cmd, nk_hash hash)
+{
+    /* only draw relevant fields are hashed, since commands are not zeroed
+     * and pointers differ between runs of the same program */
+    int type = (int)cmd->type;
+    hash = nk_murmur_hash(&type, (int)sizeof(type), hash);
+    switch (cmd->type) {
+    case NK_COMMAND_NOP: break;
+    case NK_COMMAND_SCISSOR:
+        NK_HASH_FIELDS(hash, struct nk_command_scissor, cmd, x, h); break;
+    case NK_COMMAND_LINE:
+        NK_HASH_FIELDS(hash, struct nk_command_line, cmd, line_thickness, color); break;
+    case NK_COMMAND_CURVE:
+        NK_HASH_FIELDS(hash, struct nk_command_curve, cmd, line_thickness, color); break;
+    case NK_COMMAND_RECT:
+        NK_HASH_FIELDS(hash, struct nk_command_rect, cmd, rounding, color); break;
+    case NK_COMMAND_RECT_FILLED:
+        NK_HASH_FIELDS(hash, struct nk_command_rect_filled, cmd, rounding, color); break;
+    case NK_COMMAND_RECT_MULTI_COLOR:
+        NK_HASH_FIELDS(hash, struct nk_command_rect_multi_color, cmd, x, right); break;
+    case NK_COMMAND_CIRCLE:
+        NK_HASH_FIELDS(hash, struct nk_command_circle, cmd, x, color); break;
+    case NK_COMMAND_CIRCLE_FILLED:
+        NK_HASH_FIELDS(hash, struct nk_command_circle_filled, cmd, x, color); break;
+    case NK_COMMAND_ARC:
+        NK_HASH_FIELDS(hash, struct nk_command_arc, cmd, cx, color); break;
+    case NK_COMMAND_ARC_FILLED:
+        NK_HASH_FIELDS(hash, struct nk_command_arc_filled, cmd, cx, r);
+        NK_HASH_FIELDS(hash, struct nk_command_arc_filled, cmd, a, color); break;
+    case NK_COMMAND_TRIANGLE:
+        NK_HASH_FIELDS(hash, struct nk_command_triangle, cmd, line_thickness, color); break;
+    case NK_COMMAND_TRIANGLE_FILLED:
+        NK_HASH_FIELDS(hash, struct nk_command_triangle_filled, cmd, a, color); break;
+    case NK_COMMAND_POLYGON: {
+        const struct nk_command_polygon *p = (const struct nk_command_polygon*)cmd;
+        NK_HASH_FIELDS(hash, struct nk_command_polygon, cmd, color, point_count);
+        hash = nk_murmur_hash(p->points, (int)(p->point_count * sizeof(p->points[0])), hash);
+    } break;
+    case NK_COMMAND_POLYGON_FILLED: {
+        const struct nk_command_polygon_filled *p = (const struct nk_command_polygon_filled*)cmd;
+        NK_HASH_FIELDS(hash, struct nk_command_polygon_filled, cmd, color, point_count);
+        hash = nk_murmur_hash(p->points, (int)(p->point_count * sizeof(p->points[0])), hash);
+    } break;
+    case NK_COMMAND_POLYLINE: {
+        const struct nk_command_polyline *p = (const struct nk_command_polyline*)cmd;
+        NK_HASH_FIELDS(hash, struct nk_command_polyline, cmd, color, point_count);
+        hash = nk_murmur_hash(p->points, (int)(p->point_count * sizeof(p->points[0])), hash);
+    } break;
+    case NK_COMMAND_TEXT: {
+        const struct nk_command_text *t = (const struct nk_command_text*)cmd;
+        NK_HASH_FIELDS(hash, struct nk_command_text, cmd, background, length);
+        hash = nk_murmur_hash(t->string, t->length, hash);
+    } break;
+    case NK_COMMAND_IMAGE:
+        NK_HASH_FIELDS(hash, struct nk_command_image, cmd, x, h);
+        NK_HASH_FIELDS(hash, struct nk_command_image, cmd, img.w, img.region);
+        NK_HASH_FIELDS(hash, struct nk_command_image, cmd, col, col); break;
+    case NK_COMMAND_CUSTOM:
+        NK_HASH_FIELDS(hash, struct nk_command_custom, cmd, x, h); break;
+    default: break;
+    }
+    return hash;
+}
+#undef NK_HASH_FIELDS
+NK_API nk_hash
+nk_frame_hash(struct nk_context *ctx)
+{
+    const struct nk_command *cmd;
+    nk_hash h = 0;
+    NK_ASSERT(ctx);
+    if (!ctx) return 0;
+    nk_foreach(cmd, ctx)
+        h = nk_command_hash(cmd, h);
+    return h;
+}
+NK_API void
+nk_request_redraw(struct nk_context *ctx, float seconds)
+{
+    struct nk_redraw *r;
+    NK_ASSERT(ctx);
+    if (!ctx) return;
+    r = &ctx->redraw;
+    seconds = NK_MAX(seconds, 0);
+    if (!r->requested || seconds < r->request)
+        r->request = seconds;
+    r->requested = nk_true;
+}
+NK_API int
+nk_needs_redraw(struct nk_context *ctx)
+{
+    NK_ASSERT(ctx);
+    if (!ctx) return nk_true;
+    if (!ctx->redraw.enabled) {
+        /* nothing is known about the frame before tracking started */
+        ctx->redraw.enabled = nk_true;
+        return nk_true;
+    }
+    return ctx->redraw.needed;
+}
+NK_API float
+nk_redraw_deadline(const struct nk_context *ctx)
+{
+    NK_ASSERT(ctx);
+    if (!ctx || !ctx->redraw.enabled || ctx->redraw.needed)
+        return 0;
+    return ctx->redraw.deadline;
+}
+NK_LIB void
+nk_redraw_finish(struct nk_context *ctx)
+{
+    struct nk_redraw *r = &ctx->redraw;
+    nk_hash frame;
+    if (r->enabled) {
+        /* a frame that looks different from the one before can still be
+         * settling, so it is always followed by another frame */
+        frame = nk_frame_hash(ctx);
+        r->needed = r->input || frame != r->frame ||
+            (r->requested && r->request <= 0);
+        r->frame = frame;
+    }
+    r->deadline = r->requested ? r->request: -1.0f;
+    r->requested = nk_false;
+    r->request = 0;
+}
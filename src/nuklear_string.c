@@ -16,6 +16,19 @@ nk_str_init_default(struct nk_str *str)
     alloc.free = nk_mfree;
     nk_buffer_init(&str->buffer, &alloc, 32);
     str->len = 0;
+    str->gap_begin = str->gap_len = 0;
+    str->gap_rune = 0;
+    str->gap_buffer = nk_false;
+    str->index = 0;
+    str->index_front = str->index_back = 0;
+    str->index_capacity = str->index_stride = 0;
+    str->index_lines = 0;
+}
+NK_API void
+nk_str_init_gap_default(struct nk_str *str)
+{
+    nk_str_init_default(str);
+    str->gap_buffer = nk_true;
 }
 #endif
 
@@ -24,12 +37,394 @@ nk_str_init(struct nk_str *str, const struct nk_allocator *alloc, nk_size size)
 {
     nk_buffer_init(&str->buffer, alloc, size);
     str->len = 0;
+    str->gap_begin = str->gap_len = 0;
+    str->gap_rune = 0;
+    str->gap_buffer = nk_false;
+    str->index = 0;
+    str->index_front = str->index_back = 0;
+    str->index_capacity = str->index_stride = 0;
+    str->index_lines = 0;
 }
 NK_API void
 nk_str_init_fixed(struct nk_str *str, void *memory, nk_size size)
 {
     nk_buffer_init_fixed(&str->buffer, memory, size);
     str->len = 0;
+    str->gap_begin = str->gap_len = 0;
+    str->gap_rune = 0;
+    str->gap_buffer = nk_false;
+    str->index = 0;
+    str->index_front = str->index_back = 0;
+    str->index_capacity = str->index_stride = 0;
+    str->index_lines = 0;
+}
+NK_API void
+nk_str_init_gap(struct nk_str *str, const struct nk_allocator *alloc, nk_size size)
+{
+    nk_str_init(str, alloc, size);
+    str->gap_buffer = nk_true;
+}
+NK_INTERN void
+nk_str_gap_move(struct nk_str *s, nk_size pos)
+{
+    /* moves the insertion gap to logical byte offset `pos` */
+    char *mem = (char*)s->buffer.memory.ptr;
+    nk_size n;
+    if (pos == s->gap_begin) return;
+    if (pos < s->gap_begin) {
+        n = s->gap_begin - pos;
+        s->gap_rune -= nk_utf_len(mem + pos, (int)n);
+        if (s->gap_len)
+            NK_MEMCPY(mem + pos + s->gap_len, mem + pos, n);
+    } else {
+        n = pos - s->gap_begin;
+        s->gap_rune += nk_utf_len(mem + s->gap_begin + s->gap_len, (int)n);
+        if (s->gap_len)
+            NK_MEMCPY(mem + s->gap_begin, mem + s->gap_begin + s->gap_len, n);
+    }
+    s->gap_begin = pos;
+}
+NK_INTERN int
+nk_str_gap_reserve(struct nk_str *s, nk_size len)
+{
+    /* grows the insertion gap to at least `len` bytes. The gap grows with the
+     * text so repeated inserts only move the text behind it occasionally */
+    nk_size text_len, tail, grow;
+    char *mem;
+    if (s->gap_len >= len) return 1;
+
+    text_len = s->buffer.allocated - s->gap_len;
+    tail = text_len - s->gap_begin;
+    grow = (len - s->gap_len) + NK_MAX((nk_size)NK_STR_GAP_MIN_SIZE, text_len/8);
+    if (!nk_buffer_alloc(&s->buffer, NK_BUFFER_FRONT, grow, 0))
+        return 0;
+
+    mem = (char*)s->buffer.memory.ptr;
+    if (tail) NK_MEMCPY(mem + s->gap_begin + s->gap_len + grow,
+        mem + s->gap_begin + s->gap_len, tail);
+    s->gap_len += grow;
+    return 1;
+}
+NK_INTERN void
+nk_str_gap_close(struct nk_str *s)
+{
+    /* moves the gap behind the text so the string content is contiguous */
+    nk_size text_len = s->buffer.allocated - s->gap_len;
+    if (!s->gap_len || s->gap_begin == text_len) return;
+    nk_str_gap_move(s, text_len);
+    s->gap_rune = s->len;
+}
+NK_LIB const char*
+nk_str_text_at(const struct nk_str *s, int pos, int *avail)
+{
+    /* maps a logical byte offset to memory without closing the gap and
+     * returns the number of bytes that can be read contiguously */
+    nk_size text_len;
+    const char *mem;
+
+    NK_ASSERT(s);
+    NK_ASSERT(avail);
+    if (!s || !avail) return 0;
+    text_len = s->buffer.allocated - s->gap_len;
+    mem = (const char*)s->buffer.memory.ptr;
+    if (pos < 0 || (nk_size)pos > text_len) {
+        *avail = 0;
+        return 0;
+    }
+    if (!s->gap_len) {
+        *avail = (int)(text_len - (nk_size)pos);
+        return mem + pos;
+    } else if ((nk_size)pos < s->gap_begin) {
+        *avail = (int)(s->gap_begin - (nk_size)pos);
+        return mem + pos;
+    }
+    *avail = (int)(text_len - (nk_size)pos);
+    return mem + s->gap_len + pos;
+}
+NK_INTERN int
+nk_str_walk(const struct nk_str *s, int offset, int runes)
+{
+    /* returns the logical byte offset `runes` codepoints behind byte offset
+     * `offset` or -1 if the string ends before */
+    const char *text;
+    int avail = 0;
+    int glyph_len;
+    int i = 0;
+    nk_rune unicode;
+
+    text = nk_str_text_at(s, offset, &avail);
+    if (!text) return -1;
+    glyph_len = nk_utf_decode(text, &unicode, avail);
+    while (i < runes && glyph_len) {
+        i++;
+        offset += glyph_len;
+        text += glyph_len;
+        avail -= glyph_len;
+        if (!avail) text = nk_str_text_at(s, offset, &avail);
+        glyph_len = nk_utf_decode(text, &unicode, avail);
+    }
+    if (i != runes) return -1;
+    return offset;
+}
+NK_INTERN struct nk_str_checkpoint
+nk_str_index_at(const struct nk_str *s, int i)
+{
+    /* checkpoints behind the last edit are stored relative to the end of the
+     * string so inserting and deleting does not have to touch them */
+    struct nk_str_checkpoint cp;
+    if (i < s->index_front) return s->index[i];
+    cp = s->index[s->index_capacity - s->index_back + (i - s->index_front)];
+    cp.rune = s->len - cp.rune;
+    cp.byte = (int)(s->buffer.allocated - s->gap_len) - cp.byte;
+    cp.line = s->index_lines - cp.line;
+    return cp;
+}
+NK_INTERN int
+nk_str_index_find(const struct nk_str *s, int pos)
+{
+    /* returns the last checkpoint in front of or at codepoint `pos` */
+    int lo = 0, hi = s->index_front + s->index_back - 1;
+    while (lo < hi) {
+        int mid = lo + (hi - lo + 1) / 2;
+        if (nk_str_index_at(s, mid).rune <= pos)
+            lo = mid;
+        else hi = mid - 1;
+    }
+    return lo;
+}
+NK_INTERN int
+nk_str_count_lines(const char *text, int len)
+{
+    int i, lines = 0;
+    for (i = 0; i < len; ++i)
+        if (text[i] == '\n') lines++;
+    return lines;
+}
+NK_INTERN void
+nk_str_index_split(struct nk_str *s, int pos)
+{
+    /* moves the split between absolute and relative checkpoints to logical
+     * byte offset `pos`. Has to be called before the string is modified */
+    int text_len = (int)(s->buffer.allocated - s->gap_len);
+    struct nk_str_checkpoint cp;
+    if (!s->index_stride) return;
+    while (s->index_front > 1 && s->index[s->index_front-1].byte > pos) {
+        cp = s->index[--s->index_front];
+        s->index_back++;
+        s->index[s->index_capacity - s->index_back].rune = s->len - cp.rune;
+        s->index[s->index_capacity - s->index_back].byte = text_len - cp.byte;
+        s->index[s->index_capacity - s->index_back].line = s->index_lines - cp.line;
+    }
+    while (s->index_back) {
+        cp = nk_str_index_at(s, s->index_front);
+        if (cp.byte > pos) break;
+        s->index[s->index_front++] = cp;
+        s->index_back--;
+    }
+}
+NK_INTERN void
+nk_str_index_erase(struct nk_str *s, int pos, int len)
+{
+    /* drops all checkpoints inside text that is about to be deleted and
+     * the one behind it if it would end up on top of an existing one */
+    int last;
+    if (!s->index_stride) return;
+    nk_str_index_split(s, pos);
+    last = s->index[s->index_front-1].byte;
+    while (s->index_back) {
+        int byte = nk_str_index_at(s, s->index_front).byte;
+        if (byte > pos + len || (byte == pos + len && last != pos)) break;
+        s->index_back--;
+    }
+}
+NK_INTERN void
+nk_str_index_free(struct nk_str *s)
+{
+    if (s->index && s->buffer.pool.free)
+        s->buffer.pool.free(s->buffer.pool.userdata, s->index);
+    s->index = 0;
+    s->index_front = s->index_back = 0;
+    s->index_capacity = s->index_stride = 0;
+    s->index_lines = 0;
+}
+NK_INTERN int
+nk_str_index_push(struct nk_str *s, struct nk_str_checkpoint cp)
+{
+    if (s->index_front + s->index_back >= s->index_capacity) {
+        int capacity = NK_MAX(16, s->index_capacity * 2);
+        struct nk_str_checkpoint *index = (struct nk_str_checkpoint*)
+            s->buffer.pool.alloc(s->buffer.pool.userdata, 0,
+                (nk_size)capacity * sizeof(struct nk_str_checkpoint));
+        if (!index) return 0;
+        if (s->index) {
+            NK_MEMCPY(index, s->index, (nk_size)s->index_front * sizeof(*index));
+            NK_MEMCPY(index + capacity - s->index_back,
+                s->index + s->index_capacity - s->index_back,
+                (nk_size)s->index_back * sizeof(*index));
+            s->buffer.pool.free(s->buffer.pool.userdata, s->index);
+        }
+        s->index = index;
+        s->index_capacity = capacity;
+    }
+    s->index[s->index_front++] = cp;
+    return 1;
+}
+NK_INTERN void
+nk_str_index_fill(struct nk_str *s)
+{
+    /* walks the text between the last edit and the next checkpoint behind it
+     * and adds a checkpoint at every line start and every `stride` codepoints.
+     * Has to be called after the string was modified */
+    struct nk_str_checkpoint cp, next;
+    const char *text;
+    int avail = 0;
+    int glyph_len;
+    int runes = 0;
+    int pushed = 1;
+    nk_rune unicode;
+
+    if (!s->index_stride) return;
+    cp = s->index[s->index_front-1];
+    if (s->index_back) {
+        next = nk_str_index_at(s, s->index_front);
+    } else {
+        next.rune = s->len;
+        next.byte = (int)(s->buffer.allocated - s->gap_len);
+        next.line = s->index_lines;
+    }
+
+    text = nk_str_text_at(s, cp.byte, &avail);
+    while (cp.byte < next.byte) {
+        glyph_len = nk_utf_decode(text, &unicode, avail);
+        if (!glyph_len) break;
+        cp.rune++;
+        cp.byte += glyph_len;
+        text += glyph_len;
+        avail -= glyph_len;
+        if (!avail) text = nk_str_text_at(s, cp.byte, &avail);
+        if (unicode == '\n') {
+            /* line starts always get a checkpoint, even at the end of the text */
+            cp.line++;
+            runes = 0;
+            if (cp.byte < next.byte || !s->index_back)
+                pushed = nk_str_index_push(s, cp);
+        } else if (++runes >= s->index_stride && cp.byte < next.byte) {
+            runes = 0;
+            pushed = nk_str_index_push(s, cp);
+        }
+        if (!pushed) break;
+    }
+    if (!pushed) {
+        /* out of memory so the index cannot be trusted anymore */
+        nk_str_index_free(s);
+    }
+}
+NK_INTERN void
+nk_str_index_clear(struct nk_str *s)
+{
+    if (!s->index_stride) return;
+    s->index[0].rune = s->index[0].byte = s->index[0].line = 0;
+    s->index_front = 1;
+    s->index_back = 0;
+    s->index_lines = 0;
+}
+NK_API int
+nk_str_build_index(struct nk_str *s, int stride)
+{
+    struct nk_str_checkpoint cp;
+    const char *text;
+    int offset = 0;
+    int avail = 0;
+
+    NK_ASSERT(s);
+    NK_ASSERT(stride >= 0);
+    if (!s || stride < 0) return 0;
+    if (s->buffer.type != NK_BUFFER_DYNAMIC || !s->buffer.pool.alloc)
+        return 0;
+
+    s->index_front = s->index_back = 0;
+    s->index_stride = 0;
+    cp.rune = cp.byte = cp.line = 0;
+    if (!nk_str_index_push(s, cp)) return 0;
+
+    /* count line breaks so the end of the text is known to `nk_str_index_fill` */
+    s->index_lines = 0;
+    text = nk_str_text_at(s, offset, &avail);
+    while (avail) {
+        s->index_lines += nk_str_count_lines(text, avail);
+        offset += avail;
+        text = nk_str_text_at(s, offset, &avail);
+    }
+    s->index_stride = (stride) ? stride: NK_STR_INDEX_STRIDE;
+    nk_str_index_fill(s);
+    return s->index_stride != 0;
+}
+NK_LIB int
+nk_str_rune_offset(const struct nk_str *s, int pos)
+{
+    /* returns the logical byte offset of codepoint `pos` or -1 if out of
+     * range. Decoding starts at the closest checkpoint of the rune offset
+     * index or the gap, since that is where most lookups are */
+    int offset = 0;
+    int i = 0;
+
+    if (pos < 0) return -1;
+    if (s->index_stride) {
+        struct nk_str_checkpoint cp;
+        cp = nk_str_index_at(s, nk_str_index_find(s, pos));
+        offset = cp.byte;
+        i = cp.rune;
+    }
+    if (s->gap_buffer) {
+        if (pos >= s->gap_rune && s->gap_rune > i) {
+            offset = (int)s->gap_begin;
+            i = s->gap_rune;
+        } else if (pos < s->gap_rune && s->gap_rune - pos < pos - i) {
+            /* closer to the gap so walk backwards */
+            const char *text = (const char*)s->buffer.memory.ptr;
+            offset = (int)s->gap_begin;
+            for (i = s->gap_rune; i > pos; --i)
+                offset -= nk_utf_prev(text, offset);
+            return offset;
+        }
+    }
+    return nk_str_walk(s, offset, pos - i);
+}
+NK_LIB int
+nk_str_line_of(const struct nk_str *s, int pos)
+{
+    /* returns the line of codepoint `pos`. Every line start has a checkpoint
+     * so the line of the closest checkpoint is the line of the codepoint */
+    NK_ASSERT(s->index_stride);
+    if (!s->index_stride || pos < 0) return 0;
+    return nk_str_index_at(s, nk_str_index_find(s, pos)).line;
+}
+NK_LIB int
+nk_str_line_begin(const struct nk_str *s, int line, int *rune)
+{
+    /* returns the byte offset and codepoint index of the beginning of `line`
+     * or -1 if the line does not exist */
+    struct nk_str_checkpoint cp;
+    int lo = 0, hi = s->index_front + s->index_back;
+
+    NK_ASSERT(s->index_stride);
+    NK_ASSERT(rune);
+    if (!s->index_stride || line < 0 || line > s->index_lines) return -1;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (nk_str_index_at(s, mid).line < line)
+            lo = mid + 1;
+        else hi = mid;
+    }
+    cp = nk_str_index_at(s, lo);
+    *rune = cp.rune;
+    return cp.byte;
+}
+NK_LIB int
+nk_str_line_count(const struct nk_str *s)
+{
+    NK_ASSERT(s->index_stride);
+    return s->index_lines + 1;
 }
 NK_API int
 nk_str_append_text_char(struct nk_str *s, const char *str, int len)
@@ -38,10 +433,18 @@ nk_str_append_text_char(struct nk_str *s, const char *str, int len)
     NK_ASSERT(s);
     NK_ASSERT(str);
     if (!s || !str || !len) return 0;
+    if (s->gap_buffer) {
+        int text_len = (int)(s->buffer.allocated - s->gap_len);
+        return nk_str_insert_at_char(s, text_len, str, len) ? len: 0;
+    }
+    nk_str_index_split(s, (int)s->buffer.allocated);
     mem = (char*)nk_buffer_alloc(&s->buffer, NK_BUFFER_FRONT, (nk_size)len * sizeof(char), 0);
     if (!mem) return 0;
     NK_MEMCPY(mem, str, (nk_size)len * sizeof(char));
     s->len += nk_utf_len(str, len);
+    if (s->index_stride)
+        s->index_lines += nk_str_count_lines(str, len);
+    nk_str_index_fill(s);
     return len;
 }
 NK_API int
@@ -123,7 +526,25 @@ nk_str_insert_at_char(struct nk_str *s, int pos, const char *str, int len)
     NK_ASSERT(s);
     NK_ASSERT(str);
     NK_ASSERT(len >= 0);
-    if (!s || !str || !len || (nk_size)pos > s->buffer.allocated) return 0;
+    if (!s || !str || !len || (nk_size)pos > s->buffer.allocated - s->gap_len) return 0;
+    if (s->gap_buffer) {
+        /* move the gap to the insert position and fill it */
+        int glyphs;
+        if (!nk_str_gap_reserve(s, (nk_size)len)) return 0;
+        nk_str_index_split(s, pos);
+        nk_str_gap_move(s, (nk_size)pos);
+        mem = nk_ptr_add(void, s->buffer.memory.ptr, s->gap_begin);
+        NK_MEMCPY(mem, str, (nk_size)len * sizeof(char));
+        glyphs = nk_utf_len(str, len);
+        s->gap_begin += (nk_size)len;
+        s->gap_len -= (nk_size)len;
+        s->gap_rune += glyphs;
+        s->len += glyphs;
+        if (s->index_stride)
+            s->index_lines += nk_str_count_lines(str, len);
+        nk_str_index_fill(s);
+        return 1;
+    }
     if ((s->buffer.allocated + (nk_size)len >= s->buffer.memory.size) &&
         (s->buffer.type == NK_BUFFER_FIXED)) return 0;
 
@@ -132,6 +553,7 @@ nk_str_insert_at_char(struct nk_str *s, int pos, const char *str, int len)
         nk_str_append_text_char(s, str, len);
         return 1;
     }
+    nk_str_index_split(s, pos);
     mem = nk_buffer_alloc(&s->buffer, NK_BUFFER_FRONT, (nk_size)len * sizeof(char), 0);
     if (!mem) return 0;
 
@@ -144,26 +566,24 @@ nk_str_insert_at_char(struct nk_str *s, int pos, const char *str, int len)
     mem = nk_ptr_add(void, s->buffer.memory.ptr, pos);
     NK_MEMCPY(mem, str, (nk_size)len * sizeof(char));
     s->len = nk_utf_len((char *)s->buffer.memory.ptr, (int)s->buffer.allocated);
+    if (s->index_stride)
+        s->index_lines += nk_str_count_lines(str, len);
+    nk_str_index_fill(s);
     return 1;
 }
 NK_API int
 nk_str_insert_at_rune(struct nk_str *str, int pos, const char *cstr, int len)
 {
-    int glyph_len;
-    nk_rune unicode;
-    const char *begin;
-    const char *buffer;
-
+    int offset;
     NK_ASSERT(str);
     NK_ASSERT(cstr);
     NK_ASSERT(len);
     if (!str || !cstr || !len) return 0;
-    begin = nk_str_at_rune(str, pos, &unicode, &glyph_len);
     if (!str->len)
         return nk_str_append_text_char(str, cstr, len);
-    buffer = nk_str_get_const(str);
-    if (!begin) return 0;
-    return nk_str_insert_at_char(str, (int)(begin - buffer), cstr, len);
+    offset = nk_str_rune_offset(str, pos);
+    if (offset < 0) return 0;
+    return nk_str_insert_at_char(str, offset, cstr, len);
 }
 NK_API int
 nk_str_insert_text_char(struct nk_str *str, int pos, const char *text, int len)
@@ -245,57 +665,76 @@ nk_str_remove_chars(struct nk_str *s, int len)
 {
     NK_ASSERT(s);
     NK_ASSERT(len >= 0);
-    if (!s || len < 0 || (nk_size)len > s->buffer.allocated) return;
+    if (!s || len < 0 || (nk_size)len > s->buffer.allocated - s->gap_len) return;
+    if (s->gap_buffer) {
+        int text_len = (int)(s->buffer.allocated - s->gap_len);
+        nk_str_delete_chars(s, text_len - len, len);
+        return;
+    }
     NK_ASSERT(((int)s->buffer.allocated - (int)len) >= 0);
+    nk_str_index_erase(s, (int)s->buffer.allocated - len, len);
+    if (s->index_stride)
+        s->index_lines -= nk_str_count_lines(nk_ptr_add(char,
+            s->buffer.memory.ptr, s->buffer.allocated - (nk_size)len), len);
     s->buffer.allocated -= (nk_size)len;
     s->len = nk_utf_len((char *)s->buffer.memory.ptr, (int)s->buffer.allocated);
+    nk_str_index_fill(s);
 }
 NK_API void
 nk_str_remove_runes(struct nk_str *str, int len)
 {
-    int index;
-    const char *begin;
-    const char *end;
-    nk_rune unicode;
-
+    int begin;
     NK_ASSERT(str);
     NK_ASSERT(len >= 0);
     if (!str || len < 0) return;
     if (len >= str->len) {
-        str->len = 0;
+        nk_str_clear(str);
         return;
     }
-
-    index = str->len - len;
-    begin = nk_str_at_rune(str, index, &unicode, &len);
-    end = (const char*)str->buffer.memory.ptr + str->buffer.allocated;
-    nk_str_remove_chars(str, (int)(end-begin)+1);
+    begin = nk_str_rune_offset(str, str->len - len);
+    if (begin < 0) return;
+    nk_str_remove_chars(str, (int)(str->buffer.allocated - str->gap_len) - begin);
 }
 NK_API void
 nk_str_delete_chars(struct nk_str *s, int pos, int len)
 {
     NK_ASSERT(s);
-    if (!s || !len || (nk_size)pos > s->buffer.allocated ||
-        (nk_size)(pos + len) > s->buffer.allocated) return;
+    if (!s || !len || (nk_size)pos > s->buffer.allocated - s->gap_len ||
+        (nk_size)(pos + len) > s->buffer.allocated - s->gap_len) return;
 
+    nk_str_index_erase(s, pos, len);
+    if (s->gap_buffer) {
+        /* move the gap to the deleted text and grow it over the text */
+        int glyphs;
+        nk_str_gap_move(s, (nk_size)pos);
+        glyphs = nk_utf_len(nk_ptr_add(char, s->buffer.memory.ptr,
+            s->gap_begin + s->gap_len), len);
+        if (s->index_stride)
+            s->index_lines -= nk_str_count_lines(nk_ptr_add(char,
+                s->buffer.memory.ptr, s->gap_begin + s->gap_len), len);
+        s->gap_len += (nk_size)len;
+        s->len -= glyphs;
+        nk_str_index_fill(s);
+        return;
+    }
     if ((nk_size)(pos + len) < s->buffer.allocated) {
         /* memmove */
         char *dst = nk_ptr_add(char, s->buffer.memory.ptr, pos);
         char *src = nk_ptr_add(char, s->buffer.memory.ptr, pos + len);
+        if (s->index_stride)
+            s->index_lines -= nk_str_count_lines(dst, len);
         NK_MEMCPY(dst, src, s->buffer.allocated - (nk_size)(pos + len));
         NK_ASSERT(((int)s->buffer.allocated - (int)len) >= 0);
         s->buffer.allocated -= (nk_size)len;
     } else nk_str_remove_chars(s, len);
     s->len = nk_utf_len((char *)s->buffer.memory.ptr, (int)s->buffer.allocated);
+    nk_str_index_fill(s);
 }
 NK_API void
 nk_str_delete_runes(struct nk_str *s, int pos, int len)
 {
-    char *temp;
-    nk_rune unicode;
-    char *begin;
-    char *end;
-    int unused;
+    int begin;
+    int end;
 
     NK_ASSERT(s);
     NK_ASSERT(s->len >= pos + len);
@@ -303,73 +742,41 @@ nk_str_delete_runes(struct nk_str *s, int pos, int len)
         len = NK_CLAMP(0, (s->len - pos), s->len);
     if (!len) return;
 
-    temp = (char *)s->buffer.memory.ptr;
-    begin = nk_str_at_rune(s, pos, &unicode, &unused);
-    if (!begin) return;
-    s->buffer.memory.ptr = begin;
-    end = nk_str_at_rune(s, len, &unicode, &unused);
-    s->buffer.memory.ptr = temp;
-    if (!end) return;
-    nk_str_delete_chars(s, (int)(begin - temp), (int)(end - begin));
+    begin = nk_str_rune_offset(s, pos);
+    if (begin < 0) return;
+    end = nk_str_rune_offset(s, pos + len);
+    if (end < 0) return;
+    nk_str_delete_chars(s, begin, end - begin);
 }
 NK_API char*
 nk_str_at_char(struct nk_str *s, int pos)
 {
     NK_ASSERT(s);
-    if (!s || pos > (int)s->buffer.allocated) return 0;
+    if (!s || pos > (int)(s->buffer.allocated - s->gap_len)) return 0;
+    nk_str_gap_close(s);
     return nk_ptr_add(char, s->buffer.memory.ptr, pos);
 }
 NK_API char*
 nk_str_at_rune(struct nk_str *str, int pos, nk_rune *unicode, int *len)
 {
-    int i = 0;
-    int src_len = 0;
-    int glyph_len = 0;
-    char *text;
-    int text_len;
-
-    NK_ASSERT(str);
-    NK_ASSERT(unicode);
-    NK_ASSERT(len);
-
-    if (!str || !unicode || !len) return 0;
-    if (pos < 0) {
-        *unicode = 0;
-        *len = 0;
-        return 0;
-    }
-
-    text = (char*)str->buffer.memory.ptr;
-    text_len = (int)str->buffer.allocated;
-    glyph_len = nk_utf_decode(text, unicode, text_len);
-    while (glyph_len) {
-        if (i == pos) {
-            *len = glyph_len;
-            break;
-        }
-
-        i++;
-        src_len = src_len + glyph_len;
-        glyph_len = nk_utf_decode(text + src_len, unicode, text_len - src_len);
-    }
-    if (i != pos) return 0;
-    return text + src_len;
+    /* callers read past the returned glyph so the text has to be contiguous */
+    if (str) nk_str_gap_close(str);
+    return (char*)nk_str_at_const(str, pos, unicode, len);
 }
 NK_API const char*
 nk_str_at_char_const(const struct nk_str *s, int pos)
 {
+    int avail;
     NK_ASSERT(s);
-    if (!s || pos > (int)s->buffer.allocated) return 0;
-    return nk_ptr_add(char, s->buffer.memory.ptr, pos);
+    if (!s) return 0;
+    return nk_str_text_at(s, pos, &avail);
 }
 NK_API const char*
 nk_str_at_const(const struct nk_str *str, int pos, nk_rune *unicode, int *len)
 {
-    int i = 0;
-    int src_len = 0;
-    int glyph_len = 0;
-    char *text;
-    int text_len;
+    int offset;
+    int avail;
+    const char *text;
 
     NK_ASSERT(str);
     NK_ASSERT(unicode);
@@ -382,28 +789,26 @@ nk_str_at_const(const struct nk_str *str, int pos, nk_rune *unicode, int *len)
         return 0;
     }
 
-    text = (char*)str->buffer.memory.ptr;
-    text_len = (int)str->buffer.allocated;
-    glyph_len = nk_utf_decode(text, unicode, text_len);
-    while (glyph_len) {
-        if (i == pos) {
-            *len = glyph_len;
-            break;
-        }
-
-        i++;
-        src_len = src_len + glyph_len;
-        glyph_len = nk_utf_decode(text + src_len, unicode, text_len - src_len);
-    }
-    if (i != pos) return 0;
-    return text + src_len;
+    offset = nk_str_rune_offset(str, pos);
+    if (offset < 0) return 0;
+    text = nk_str_text_at(str, offset, &avail);
+    *len = nk_utf_decode(text, unicode, avail);
+    return text;
 }
 NK_API nk_rune
 nk_str_rune_at(const struct nk_str *str, int pos)
 {
-    int len;
+    int avail;
+    int offset;
+    const char *text;
     nk_rune unicode = 0;
-    nk_str_at_const(str, pos, &unicode, &len);
+
+    NK_ASSERT(str);
+    if (!str) return 0;
+    offset = nk_str_rune_offset(str, pos);
+    if (offset < 0) return 0;
+    text = nk_str_text_at(str, offset, &avail);
+    nk_utf_decode(text, &unicode, avail);
     return unicode;
 }
 NK_API char*
@@ -411,14 +816,16 @@ nk_str_get(struct nk_str *s)
 {
     NK_ASSERT(s);
     if (!s || !s->len || !s->buffer.allocated) return 0;
+    nk_str_gap_close(s);
     return (char*)s->buffer.memory.ptr;
 }
 NK_API const char*
 nk_str_get_const(const struct nk_str *s)
 {
+    int avail;
     NK_ASSERT(s);
     if (!s || !s->len || !s->buffer.allocated) return 0;
-    return (const char*)s->buffer.memory.ptr;
+    return nk_str_text_at(s, 0, &avail);
 }
 NK_API int
 nk_str_len(struct nk_str *s)
@@ -432,7 +839,7 @@ nk_str_len_char(struct nk_str *s)
 {
     NK_ASSERT(s);
     if (!s || !s->len || !s->buffer.allocated) return 0;
-    return (int)s->buffer.allocated;
+    return (int)(s->buffer.allocated - s->gap_len);
 }
 NK_API void
 nk_str_clear(struct nk_str *str)
@@ -440,12 +847,18 @@ nk_str_clear(struct nk_str *str)
     NK_ASSERT(str);
     nk_buffer_clear(&str->buffer);
     str->len = 0;
+    str->gap_begin = str->gap_len = 0;
+    str->gap_rune = 0;
+    nk_str_index_clear(str);
 }
 NK_API void
 nk_str_free(struct nk_str *str)
 {
     NK_ASSERT(str);
+    nk_str_index_free(str);
     nk_buffer_free(&str->buffer);
     str->len = 0;
+    str->gap_begin = str->gap_len = 0;
+    str->gap_rune = 0;
 }
 
@@ -28,6 +28,7 @@ struct nk_text_edit_row {
 NK_INTERN void nk_textedit_makeundo_delete(struct nk_text_edit*, int, int);
 NK_INTERN void nk_textedit_makeundo_insert(struct nk_text_edit*, int, int);
 NK_INTERN void nk_textedit_makeundo_replace(struct nk_text_edit*, int, int, int);
+NK_INTERN void nk_textedit_history_pop(struct nk_text_undo_state*);
 #define NK_TEXT_HAS_SELECTION(s)   ((s)->select_start != (s)->select_end)
 
 NK_INTERN float
@@ -35,29 +36,49 @@ nk_textedit_get_width(const struct nk_text_edit *edit, int line_start, int char_
     const struct nk_user_font *font)
 {
     int len = 0;
+    int avail = 0;
     nk_rune unicode = 0;
-    const char *str = nk_str_at_const(&edit->string, line_start + char_id, &unicode, &len);
+    const char *str;
+    int offset = nk_str_rune_offset(&edit->string, line_start + char_id);
+    if (offset < 0) return 0;
+    str = nk_str_text_at(&edit->string, offset, &avail);
+    len = nk_utf_decode(str, &unicode, avail);
     return font->width(font->userdata, font->height, str, len);
 }
 NK_INTERN void
 nk_textedit_layout_row(struct nk_text_edit_row *r, struct nk_text_edit *edit,
     int line_start_id, float row_height, const struct nk_user_font *font)
 {
-    int l;
+    /* measures one line up to and including its newline and reads the text
+     * in chunks so the insertion gap can stay where it is */
+    int glyph_len;
     int glyphs = 0;
+    int avail = 0;
+    float width = 0;
     nk_rune unicode;
-    const char *remaining;
-    int len = nk_str_len_char(&edit->string);
-    const char *end = nk_str_get_const(&edit->string) + len;
-    const char *text = nk_str_at_const(&edit->string, line_start_id, &unicode, &l);
-    const struct nk_vec2 size = nk_text_calculate_text_bounds(font,
-        text, (int)(end - text), row_height, &remaining, 0, &glyphs, NK_STOP_ON_NEW_LINE);
+    const char *text = 0;
+    int offset = nk_str_rune_offset(&edit->string, line_start_id);
+
+    if (offset >= 0)
+        text = nk_str_text_at(&edit->string, offset, &avail);
+    while (avail) {
+        glyph_len = nk_utf_decode(text, &unicode, avail);
+        if (!glyph_len) break;
+        glyphs++;
+        if (unicode == '\n') break;
+        if (unicode != '\r')
+            width += font->width(font->userdata, font->height, text, glyph_len);
+        offset += glyph_len;
+        text += glyph_len;
+        avail -= glyph_len;
+        if (!avail) text = nk_str_text_at(&edit->string, offset, &avail);
+    }
 
     r->x0 = 0.0f;
-    r->x1 = size.x;
-    r->baseline_y_delta = size.y;
+    r->x1 = width;
+    r->baseline_y_delta = row_height;
     r->ymin = 0.0f;
-    r->ymax = size.y;
+    r->ymax = row_height;
     r->num_chars = glyphs;
 }
 NK_INTERN int
@@ -73,20 +94,30 @@ nk_textedit_locate_coord(struct nk_text_edit *edit, float x, float y,
     r.ymin = r.ymax = 0;
     r.num_chars = 0;
 
-    /* search rows to find one that straddles 'y' */
-    while (i < n) {
-        nk_textedit_layout_row(&r, edit, i, row_height, font);
-        if (r.num_chars <= 0)
+    if (edit->string.index_stride && !edit->single_line) {
+        /* rows are lines so the line index finds the row directly */
+        int line = (y < 0) ? 0: (int)(y / row_height);
+        if (!n || y < 0)
+            return 0;
+        if (nk_str_line_begin(&edit->string, line, &i) < 0 || i >= n)
             return n;
+        nk_textedit_layout_row(&r, edit, i, row_height, font);
+    } else {
+        /* search rows to find one that straddles 'y' */
+        while (i < n) {
+            nk_textedit_layout_row(&r, edit, i, row_height, font);
+            if (r.num_chars <= 0)
+                return n;
 
-        if (i==0 && y < base_y + r.ymin)
-            return 0;
+            if (i==0 && y < base_y + r.ymin)
+                return 0;
 
-        if (y < base_y + r.ymax)
-            break;
+            if (y < base_y + r.ymax)
+                break;
 
-        i += r.num_chars;
-        base_y += r.baseline_y_delta;
+            i += r.num_chars;
+            base_y += r.baseline_y_delta;
+        }
     }
 
     /* below all text, return 'after' last character */
@@ -154,6 +185,33 @@ nk_textedit_find_charpos(struct nk_text_find *find, struct nk_text_edit *state,
     int i=0, first;
 
     nk_zero_struct(r);
+    if (!single_line && state->string.index_stride) {
+        /* rows are lines so the line index finds the row directly */
+        int line = nk_str_line_of(&state->string, (n == z) ? NK_MAX(z-1, 0): n);
+        nk_str_line_begin(&state->string, line, &i);
+        if (line > 0)
+            nk_str_line_begin(&state->string, line - 1, &prev_start);
+        if (n == z && z) {
+            /* behind the last character like the row scan below */
+            prev_start = i;
+            i = z;
+        }
+        nk_textedit_layout_row(&r, state, i, row_height, font);
+        find->first_char = first = i;
+        find->length = r.num_chars;
+        find->x = r.x0;
+        find->y = (float)line * row_height;
+        find->height = r.ymax - r.ymin;
+        find->prev_first = prev_start;
+        if (n == z) {
+            find->x = r.x1;
+            find->y = r.ymin;
+        } else {
+            for (i=0; first+i < n; ++i)
+                find->x += nk_textedit_get_width(state, first, i, font);
+        }
+        return;
+    }
     if (n == z) {
         /* if it's at the end, then find the last line -- simpler than trying to
         explicitly handle this case in the regular code */
@@ -275,10 +333,9 @@ nk_textedit_move_to_last(struct nk_text_edit *state)
 NK_INTERN int
 nk_is_word_boundary( struct nk_text_edit *state, int idx)
 {
-    int len;
     nk_rune c;
-    if (idx <= 0) return 1;
-    if (!nk_str_at_rune(&state->string, idx, &c, &len)) return 1;
+    if (idx <= 0 || idx > state->string.len) return 1;
+    c = nk_str_rune_at(&state->string, idx);
     return (c == ' ' || c == '\t' ||c == 0x3000 || c == ',' || c == ';' ||
             c == '(' || c == ')' || c == '{' || c == '}' || c == '[' || c == ']' ||
             c == '|');
@@ -350,7 +407,9 @@ nk_textedit_paste(struct nk_text_edit *state, char const *ctext, int len)
         return 1;
     }
     /* remove the undo since we didn't actually insert the characters */
-    if (state->undo.undo_point)
+    if (state->undo.history)
+        nk_textedit_history_pop(&state->undo);
+    else if (state->undo.undo_point)
         --state->undo.undo_point;
     return 0;
 }
@@ -819,11 +878,262 @@ nk_textedit_createundo(struct nk_text_undo_state *state, int pos,
         return &state->undo_char[r->char_storage];
     }
 }
+/* The growable undo history keeps undo records at the front of one
+ * allocation growing up and redo records at the back growing down, like the
+ * fixed arrays above. Undo records are stored as [bytes][text][delta] so the
+ * newest one can be popped from the top and the oldest one dropped from the
+ * bottom, redo records as [delta][text]. Dropped undo records only advance
+ * `undo_begin` and the space is reclaimed by moving the remaining records
+ * down once a quarter of the history is free again. */
+struct nk_text_undo_delta {
+    int where;
+    int insert_length;
+    int delete_length;
+    int bytes;
+};
+#define NK_TEXT_UNDO_RECORD_SIZE(n) (sizeof(int) + (nk_size)(n) + sizeof(struct nk_text_undo_delta))
+#define NK_TEXT_REDO_RECORD_SIZE(n) (sizeof(struct nk_text_undo_delta) + (nk_size)(n))
+
+NK_INTERN int
+nk_textedit_text_range(const struct nk_str *s, int where, int len, int *begin)
+{
+    /* returns the number of bytes taken up by `len` runes at `where` */
+    int end;
+    *begin = nk_str_rune_offset(s, where);
+    end = nk_str_rune_offset(s, where + len);
+    if (*begin < 0 || end < 0) return 0;
+    return end - *begin;
+}
+NK_INTERN void
+nk_textedit_text_copy(const struct nk_str *s, int begin, int len, char *dst)
+{
+    /* copies `len` bytes at byte offset `begin` around the gap */
+    while (len > 0) {
+        int avail = 0;
+        const char *text = nk_str_text_at(s, begin, &avail);
+        if (!text || !avail) break;
+        avail = NK_MIN(avail, len);
+        NK_MEMCPY(dst, text, (nk_size)avail);
+        dst += avail;
+        begin += avail;
+        len -= avail;
+    }
+}
+NK_INTERN struct nk_text_undo_delta
+nk_textedit_history_top(const struct nk_text_undo_state *s)
+{
+    struct nk_text_undo_delta d;
+    NK_MEMCPY(&d, s->history + s->undo_end - sizeof(d), sizeof(d));
+    return d;
+}
+NK_INTERN void
+nk_textedit_history_pop(struct nk_text_undo_state *s)
+{
+    struct nk_text_undo_delta d;
+    if (s->undo_end == s->undo_begin) return;
+    d = nk_textedit_history_top(s);
+    s->undo_end -= NK_TEXT_UNDO_RECORD_SIZE(d.bytes);
+}
+NK_INTERN void
+nk_textedit_history_drop(struct nk_text_undo_state *s)
+{
+    /* discard the oldest entry in the undo history */
+    int bytes;
+    NK_MEMCPY(&bytes, s->history + s->undo_begin, sizeof(bytes));
+    s->undo_begin += NK_TEXT_UNDO_RECORD_SIZE(bytes);
+    if (s->undo_begin == s->undo_end)
+        s->undo_begin = s->undo_end = 0;
+}
+NK_INTERN int
+nk_textedit_history_reserve(struct nk_text_undo_state *s, nk_size need, nk_size keep)
+{
+    /* makes room for `need` bytes between the undo and redo records while
+     * never dropping the newest `keep` bytes of undo records */
+    nk_size undo_len, redo_len;
+    if (s->redo_begin - s->undo_end >= need)
+        return nk_true;
+
+    undo_len = s->undo_end - s->undo_begin;
+    redo_len = s->history_size - s->redo_begin;
+    if (undo_len + redo_len + need > s->history_size &&
+        s->history_size < s->history_limit)
+    {
+        /* grow the history and move undo and redo records to both ends */
+        char *history;
+        nk_size size = NK_MAX(s->history_size * 2, NK_TEXTEDIT_HISTORY_MIN_SIZE);
+        size = NK_MAX(size, undo_len + redo_len + need);
+        size = NK_MIN(size, s->history_limit);
+        history = (char*)s->pool.alloc(s->pool.userdata, 0, size);
+        if (history) {
+            if (undo_len)
+                NK_MEMCPY(history, s->history + s->undo_begin, undo_len);
+            if (redo_len)
+                NK_MEMCPY(history + size - redo_len, s->history + s->redo_begin, redo_len);
+            if (s->history)
+                s->pool.free(s->pool.userdata, s->history);
+            s->history = history;
+            s->history_size = size;
+            s->undo_begin = 0;
+            s->undo_end = undo_len;
+            s->redo_begin = size - redo_len;
+            if (s->redo_begin - s->undo_end >= need)
+                return nk_true;
+        }
+    }
+    if (undo_len + redo_len + need > s->history_size) {
+        /* drop old records until a quarter of the history is free afterwards
+         * so moving the remaining records down is amortized over many edits */
+        nk_size target = s->history_size - s->history_size / 4;
+        while (undo_len > keep && undo_len + redo_len + need > target) {
+            nk_textedit_history_drop(s);
+            undo_len = s->undo_end - s->undo_begin;
+        }
+        if (undo_len + redo_len + need > s->history_size)
+            return nk_false;
+    }
+    if (s->undo_begin) {
+        NK_MEMCPY(s->history, s->history + s->undo_begin, undo_len);
+        s->undo_begin = 0;
+        s->undo_end = undo_len;
+    }
+    return nk_true;
+}
+NK_INTERN void
+nk_textedit_history_push(struct nk_text_edit *state, int where,
+    int insert_len, int delete_len)
+{
+    struct nk_text_undo_state *s = &state->undo;
+    struct nk_text_undo_delta d;
+    int begin = 0;
+    char *record;
+
+    /* any time we create a new undo record, we discard redo */
+    s->redo_begin = s->history_size;
+    d.where = where;
+    d.insert_length = insert_len;
+    d.delete_length = delete_len;
+    d.bytes = insert_len ? nk_textedit_text_range(&state->string, where, insert_len, &begin): 0;
+    if (!d.bytes) d.insert_length = 0;
+    if (!nk_textedit_history_reserve(s, NK_TEXT_UNDO_RECORD_SIZE(d.bytes), 0)) {
+        /* the edit can't be stored so older records can't be undone either */
+        s->undo_begin = s->undo_end = 0;
+        return;
+    }
+    record = s->history + s->undo_end;
+    NK_MEMCPY(record, &d.bytes, sizeof(d.bytes));
+    nk_textedit_text_copy(&state->string, begin, d.bytes, record + sizeof(int));
+    NK_MEMCPY(record + sizeof(int) + d.bytes, &d, sizeof(d));
+    s->undo_end += NK_TEXT_UNDO_RECORD_SIZE(d.bytes);
+}
+NK_INTERN void
+nk_textedit_history_undo(struct nk_text_edit *state)
+{
+    struct nk_text_undo_state *s = &state->undo;
+    struct nk_text_undo_delta u, r;
+    int begin = 0;
+    const char *text;
+
+    if (s->undo_end == s->undo_begin)
+        return;
+
+    /* apply the undo record and store the deleted text as redo record */
+    u = nk_textedit_history_top(s);
+    r.where = u.where;
+    r.insert_length = u.delete_length;
+    r.delete_length = u.insert_length;
+    r.bytes = r.insert_length ? nk_textedit_text_range(&state->string,
+        u.where, u.delete_length, &begin): 0;
+    if (!r.bytes) r.insert_length = 0;
+    if (nk_textedit_history_reserve(s, NK_TEXT_REDO_RECORD_SIZE(r.bytes),
+            NK_TEXT_UNDO_RECORD_SIZE(u.bytes))) {
+        s->redo_begin -= NK_TEXT_REDO_RECORD_SIZE(r.bytes);
+        NK_MEMCPY(s->history + s->redo_begin, &r, sizeof(r));
+        nk_textedit_text_copy(&state->string, begin, r.bytes,
+            s->history + s->redo_begin + sizeof(r));
+    } else s->redo_begin = s->history_size;
+
+    nk_textedit_history_pop(s);
+    text = s->history + s->undo_end + sizeof(int);
+    if (u.delete_length)
+        nk_str_delete_runes(&state->string, u.where, u.delete_length);
+    if (u.insert_length)
+        nk_str_insert_text_utf8(&state->string, u.where, text, u.insert_length);
+    state->cursor = u.where + u.insert_length;
+}
+NK_INTERN void
+nk_textedit_history_redo(struct nk_text_edit *state)
+{
+    struct nk_text_undo_state *s = &state->undo;
+    struct nk_text_undo_delta u, r;
+    int begin = 0;
+    char *record;
+
+    if (s->redo_begin == s->history_size)
+        return;
+
+    /* apply the redo record and store the deleted text as undo record */
+    NK_MEMCPY(&r, s->history + s->redo_begin, sizeof(r));
+    u.where = r.where;
+    u.insert_length = r.delete_length;
+    u.delete_length = r.insert_length;
+    u.bytes = u.insert_length ? nk_textedit_text_range(&state->string,
+        r.where, r.delete_length, &begin): 0;
+    if (!u.bytes) u.insert_length = 0;
+    if (nk_textedit_history_reserve(s, NK_TEXT_UNDO_RECORD_SIZE(u.bytes), 0)) {
+        record = s->history + s->undo_end;
+        NK_MEMCPY(record, &u.bytes, sizeof(u.bytes));
+        nk_textedit_text_copy(&state->string, begin, u.bytes, record + sizeof(int));
+        NK_MEMCPY(record + sizeof(int) + u.bytes, &u, sizeof(u));
+        s->undo_end += NK_TEXT_UNDO_RECORD_SIZE(u.bytes);
+    } else s->undo_begin = s->undo_end = 0;
+
+    /* the redo record stays valid since reserving never touches redo records */
+    record = s->history + s->redo_begin;
+    s->redo_begin += NK_TEXT_REDO_RECORD_SIZE(r.bytes);
+    if (r.delete_length)
+        nk_str_delete_runes(&state->string, r.where, r.delete_length);
+    if (r.insert_length)
+        nk_str_insert_text_utf8(&state->string, r.where,
+            record + sizeof(r), r.insert_length);
+    state->cursor = r.where + r.insert_length;
+}
+NK_API int
+nk_textedit_undo_history(struct nk_text_edit *state,
+    const struct nk_allocator *alloc, nk_size limit)
+{
+    struct nk_text_undo_state *s;
+    char *history;
+    NK_ASSERT(state);
+    NK_ASSERT(alloc);
+    if (!state || !alloc || !alloc->alloc || !alloc->free)
+        return nk_false;
+    if (limit && limit < NK_TEXTEDIT_HISTORY_MIN_SIZE)
+        return nk_false;
+
+    /* allocate up front so a failure leaves the current history untouched */
+    history = (char*)alloc->alloc(alloc->userdata, 0, NK_TEXTEDIT_HISTORY_MIN_SIZE);
+    if (!history) return nk_false;
+
+    s = &state->undo;
+    if (s->history)
+        s->pool.free(s->pool.userdata, s->history);
+    s->pool = *alloc;
+    s->history = history;
+    s->history_size = NK_TEXTEDIT_HISTORY_MIN_SIZE;
+    s->history_limit = limit ? limit: (nk_size)-1;
+    s->undo_begin = s->undo_end = 0;
+    s->redo_begin = s->history_size;
+    return nk_true;
+}
 NK_API void
 nk_textedit_undo(struct nk_text_edit *state)
 {
     struct nk_text_undo_state *s = &state->undo;
     struct nk_text_undo_record u, *r;
+    if (s->history) {
+        nk_textedit_history_undo(state);
+        return;
+    }
     if (s->undo_point == 0)
         return;
 
@@ -891,6 +1201,10 @@ nk_textedit_redo(struct nk_text_edit *state)
 {
     struct nk_text_undo_state *s = &state->undo;
     struct nk_text_undo_record *u, r;
+    if (s->history) {
+        nk_textedit_history_redo(state);
+        return;
+    }
     if (s->redo_point == NK_TEXTEDIT_UNDOSTATECOUNT)
         return;
 
@@ -938,13 +1252,20 @@ nk_textedit_redo(struct nk_text_edit *state)
 NK_INTERN void
 nk_textedit_makeundo_insert(struct nk_text_edit *state, int where, int length)
 {
-    nk_textedit_createundo(&state->undo, where, 0, length);
+    if (state->undo.history)
+        nk_textedit_history_push(state, where, 0, length);
+    else nk_textedit_createundo(&state->undo, where, 0, length);
 }
 NK_INTERN void
 nk_textedit_makeundo_delete(struct nk_text_edit *state, int where, int length)
 {
     int i;
-    nk_rune *p = nk_textedit_createundo(&state->undo, where, length, 0);
+    nk_rune *p;
+    if (state->undo.history) {
+        nk_textedit_history_push(state, where, length, 0);
+        return;
+    }
+    p = nk_textedit_createundo(&state->undo, where, length, 0);
     if (p) {
         for (i=0; i < length; ++i)
             p[i] = nk_str_rune_at(&state->string, where+i);
@@ -955,7 +1276,12 @@ nk_textedit_makeundo_replace(struct nk_text_edit *state, int where,
     int old_length, int new_length)
 {
     int i;
-    nk_rune *p = nk_textedit_createundo(&state->undo, where, old_length, new_length);
+    nk_rune *p;
+    if (state->undo.history) {
+        nk_textedit_history_push(state, where, old_length, new_length);
+        return;
+    }
+    p = nk_textedit_createundo(&state->undo, where, old_length, new_length);
     if (p) {
         for (i=0; i < old_length; ++i)
             p[i] = nk_str_rune_at(&state->string, where+i);
@@ -970,6 +1296,8 @@ nk_textedit_clear_state(struct nk_text_edit *state, enum nk_text_edit_type type,
    state->undo.undo_char_point = 0;
    state->undo.redo_point = NK_TEXTEDIT_UNDOSTATECOUNT;
    state->undo.redo_char_point = NK_TEXTEDIT_UNDOCHARCOUNT;
+   state->undo.undo_begin = state->undo.undo_end = 0;
+   state->undo.redo_begin = state->undo.history_size;
    state->select_end = state->select_start = 0;
    state->cursor = 0;
    state->has_preferred_x = 0;
@@ -1001,6 +1329,18 @@ nk_textedit_init(struct nk_text_edit *state, struct nk_allocator *alloc, nk_size
     nk_textedit_clear_state(state, NK_TEXT_EDIT_SINGLE_LINE, 0);
     nk_str_init(&state->string, alloc, size);
 }
+NK_API void
+nk_textedit_init_gap(struct nk_text_edit *state, struct nk_allocator *alloc, nk_size size)
+{
+    NK_ASSERT(state);
+    NK_ASSERT(alloc);
+    if (!state || !alloc) return;
+    NK_MEMSET(state, 0, sizeof(struct nk_text_edit));
+    nk_textedit_clear_state(state, NK_TEXT_EDIT_SINGLE_LINE, 0);
+    nk_str_init_gap(&state->string, alloc, size);
+    nk_str_build_index(&state->string, 0);
+    nk_textedit_undo_history(state, alloc, NK_TEXTEDIT_UNDO_LIMIT);
+}
 #ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
 NK_API void
 nk_textedit_init_default(struct nk_text_edit *state)
@@ -1011,6 +1351,17 @@ nk_textedit_init_default(struct nk_text_edit *state)
     nk_textedit_clear_state(state, NK_TEXT_EDIT_SINGLE_LINE, 0);
     nk_str_init_default(&state->string);
 }
+NK_API void
+nk_textedit_init_gap_default(struct nk_text_edit *state)
+{
+    NK_ASSERT(state);
+    if (!state) return;
+    NK_MEMSET(state, 0, sizeof(struct nk_text_edit));
+    nk_textedit_clear_state(state, NK_TEXT_EDIT_SINGLE_LINE, 0);
+    nk_str_init_gap_default(&state->string);
+    nk_str_build_index(&state->string, 0);
+    nk_textedit_undo_history(state, &state->string.buffer.pool, NK_TEXTEDIT_UNDO_LIMIT);
+}
 #endif
 NK_API void
 nk_textedit_select_all(struct nk_text_edit *state)
@@ -1025,5 +1376,10 @@ nk_textedit_free(struct nk_text_edit *state)
     NK_ASSERT(state);
     if (!state) return;
     nk_str_free(&state->string);
+    if (state->undo.history)
+        state->undo.pool.free(state->undo.pool.userdata, state->undo.history);
+    state->undo.history = 0;
+    state->undo.history_size = 0;
+    state->undo.undo_begin = state->undo.undo_end = state->undo.redo_begin = 0;
 }
 
@@ -0,0 +1,344 @@
+#include "nuklear.h"
+#include "nuklear_internal.h"
+
+/* ===============================================================
+ *
+ *                          TEXT VIEW
+ *
+ * ===============================================================*/
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+NK_API void
+nk_text_view_init_default(struct nk_text_view *view, nk_plugin_read read,
+    nk_handle userdata, nk_size size)
+{
+    struct nk_allocator alloc;
+    alloc.userdata.ptr = 0;
+    alloc.alloc = nk_malloc;
+    alloc.free = nk_mfree;
+    nk_text_view_init(view, &alloc, read, userdata, size);
+}
+NK_API void
+nk_text_view_init_memory_default(struct nk_text_view *view,
+    const char *memory, nk_size size)
+{
+    struct nk_allocator alloc;
+    alloc.userdata.ptr = 0;
+    alloc.alloc = nk_malloc;
+    alloc.free = nk_mfree;
+    nk_text_view_init_memory(view, &alloc, memory, size);
+}
+#endif
+NK_API void
+nk_text_view_init(struct nk_text_view *view, const struct nk_allocator *alloc,
+    nk_plugin_read read, nk_handle userdata, nk_size size)
+{
+    NK_ASSERT(view);
+    NK_ASSERT(alloc);
+    NK_ASSERT(read);
+    if (!view || !alloc || !read) return;
+    NK_MEMSET(view, 0, sizeof(*view));
+    view->pool = *alloc;
+    view->read = read;
+    view->userdata = userdata;
+    view->size = size;
+}
+NK_API void
+nk_text_view_init_memory(struct nk_text_view *view,
+    const struct nk_allocator *alloc, const char *memory, nk_size size)
+{
+    NK_ASSERT(view);
+    NK_ASSERT(alloc);
+    NK_ASSERT(memory || !size);
+    if (!view || !alloc) return;
+    NK_MEMSET(view, 0, sizeof(*view));
+    view->pool = *alloc;
+    view->memory = memory;
+    view->size = memory ? size: 0;
+}
+NK_API void
+nk_text_view_free(struct nk_text_view *view)
+{
+    NK_ASSERT(view);
+    if (!view) return;
+    if (view->lines && view->pool.free)
+        view->pool.free(view->pool.userdata, view->lines);
+    view->lines = 0;
+    view->line_capacity = 0;
+    view->line_count = 0;
+    view->last_line = view->indexed = 0;
+}
+NK_API void
+nk_text_view_set_size(struct nk_text_view *view, nk_size size)
+{
+    NK_ASSERT(view);
+    if (!view) return;
+    if (size < view->indexed) {
+        /* text got truncated so the index has to be rebuilt from scratch */
+        view->line_count = 0;
+        view->last_line = view->indexed = 0;
+    }
+    view->size = size;
+    view->select_start = NK_MIN(view->select_start, size);
+    view->select_end = NK_MIN(view->select_end, size);
+}
+NK_INTERN const char*
+nk_text_view_fetch(struct nk_text_view *view, nk_size offset, nk_size len,
+    nk_size *fetched)
+{
+    /* returns a pointer to at most `len` bytes of text starting at `offset`
+     * which either points directly into the memory block or into the
+     * scratch buffer filled by the read callback */
+    *fetched = 0;
+    if (offset >= view->size) return 0;
+    len = NK_MIN(len, view->size - offset);
+    if (view->memory) {
+        *fetched = len;
+        return view->memory + offset;
+    }
+    len = NK_MIN(len, (nk_size)NK_TEXT_VIEW_BUFFER_SIZE);
+    *fetched = NK_MIN(view->read(view->userdata, offset, view->buffer, len), len);
+    return view->buffer;
+}
+NK_INTERN nk_size
+nk_text_view_next_line(struct nk_text_view *view, nk_size offset)
+{
+    /* returns the offset behind the next new line or the text size */
+    const char *text;
+    nk_size len, i;
+    while ((text = nk_text_view_fetch(view, offset, view->size, &len)) && len) {
+        for (i = 0; i < len; ++i)
+            if (text[i] == '\n') return offset + i + 1;
+        offset += len;
+    }
+    return view->size;
+}
+NK_INTERN int
+nk_text_view_push_line(struct nk_text_view *view, nk_size offset)
+{
+    int slot;
+    NK_ASSERT(view->line_count % NK_TEXT_VIEW_LINE_STRIDE == 0);
+    slot = view->line_count / NK_TEXT_VIEW_LINE_STRIDE - 1;
+    if (slot >= view->line_capacity) {
+        nk_size *lines;
+        int capacity = NK_MAX(64, view->line_capacity * 2);
+        if (!view->pool.alloc || !view->pool.free) return nk_false;
+        lines = (nk_size*)view->pool.alloc(view->pool.userdata, 0,
+            (nk_size)capacity * sizeof(nk_size));
+        if (!lines) return nk_false;
+        if (view->lines) {
+            NK_MEMCPY(lines, view->lines, (nk_size)view->line_capacity * sizeof(nk_size));
+            view->pool.free(view->pool.userdata, view->lines);
+        }
+        view->lines = lines;
+        view->line_capacity = capacity;
+    }
+    view->lines[slot] = offset;
+    return nk_true;
+}
+NK_API int
+nk_text_view_index(struct nk_text_view *view, nk_size max_bytes)
+{
+    nk_size end, len, i;
+    const char *text;
+
+    NK_ASSERT(view);
+    if (!view) return nk_true;
+    end = view->size;
+    if (max_bytes < end - view->indexed)
+        end = view->indexed + max_bytes;
+
+    while (view->indexed < end) {
+        text = nk_text_view_fetch(view, view->indexed, end - view->indexed, &len);
+        if (!text || !len) break;
+        for (i = 0; i < len; ++i) {
+            if (text[i] != '\n') continue;
+            view->line_count++;
+            if (!(view->line_count % NK_TEXT_VIEW_LINE_STRIDE) &&
+                !nk_text_view_push_line(view, view->indexed + i + 1)) {
+                /* out of memory: stop in front of the line and retry later */
+                view->line_count--;
+                view->indexed += i;
+                return nk_false;
+            }
+            view->last_line = view->indexed + i + 1;
+        }
+        view->indexed += len;
+    }
+    return view->indexed >= view->size;
+}
+NK_API int
+nk_text_view_line_count(const struct nk_text_view *view)
+{
+    NK_ASSERT(view);
+    if (!view) return 0;
+    return view->line_count + ((view->last_line < view->size) ? 1: 0);
+}
+NK_API int
+nk_text_view_selection(const struct nk_text_view *view, nk_size *begin, nk_size *end)
+{
+    NK_ASSERT(view);
+    NK_ASSERT(begin);
+    NK_ASSERT(end);
+    if (!view || !begin || !end) return nk_false;
+    *begin = NK_MIN(view->select_start, view->select_end);
+    *end = NK_MAX(view->select_start, view->select_end);
+    return *begin != *end;
+}
+NK_INTERN nk_size
+nk_text_view_line_begin(struct nk_text_view *view, int line)
+{
+    int i, n = line % NK_TEXT_VIEW_LINE_STRIDE;
+    int slot = line / NK_TEXT_VIEW_LINE_STRIDE;
+    nk_size offset = slot ? view->lines[slot-1]: 0;
+    for (i = 0; i < n; ++i)
+        offset = nk_text_view_next_line(view, offset);
+    return offset;
+}
+NK_INTERN int
+nk_text_view_hit(const struct nk_user_font *font, const char *text, int len, float x)
+{
+    /* returns the byte offset of the glyph boundary closest to `x` */
+    int glyph_len, offset = 0;
+    float width = 0;
+    nk_rune unicode;
+
+    while (offset < len) {
+        float glyph_width;
+        glyph_len = nk_utf_decode(text + offset, &unicode, len - offset);
+        if (!glyph_len) break;
+        glyph_width = font->width(font->userdata, font->height, text + offset, glyph_len);
+        if (x < width + glyph_width * 0.5f) break;
+        width += glyph_width;
+        offset += glyph_len;
+    }
+    return offset;
+}
+NK_INTERN void
+nk_text_view_copy(struct nk_context *ctx, struct nk_text_view *view)
+{
+    nk_size begin, end, len, done = 0;
+    char *mem;
+
+    if (!ctx->clip.copy || !nk_text_view_selection(view, &begin, &end))
+        return;
+    len = NK_MIN(end - begin, (nk_size)NK_TEXT_VIEW_MAX_COPY);
+    if (view->memory) {
+        ctx->clip.copy(ctx->clip.userdata, view->memory + begin, (int)len);
+        return;
+    }
+    if (!view->pool.alloc || !view->pool.free) return;
+    mem = (char*)view->pool.alloc(view->pool.userdata, 0, len);
+    if (!mem) return;
+    while (done < len) {
+        nk_size n = view->read(view->userdata, begin + done, mem + done, len - done);
+        if (!n) break;
+        done += NK_MIN(n, len - done);
+    }
+    ctx->clip.copy(ctx->clip.userdata, mem, (int)done);
+    view->pool.free(view->pool.userdata, mem);
+}
+NK_API int
+nk_text_view(struct nk_context *ctx, struct nk_text_view *view,
+    const char *id, nk_flags flags)
+{
+    int i, row_height;
+    nk_size offset, begin, end;
+    int has_selection;
+    struct nk_list_view list;
+    struct nk_text text;
+    const struct nk_style *style;
+    const struct nk_user_font *font;
+    struct nk_command_buffer *out;
+    const struct nk_input *in;
+    struct nk_rect area;
+
+    NK_ASSERT(ctx);
+    NK_ASSERT(view);
+    NK_ASSERT(id);
+    if (!ctx || !view || !id || !ctx->current)
+        return 0;
+
+    style = &ctx->style;
+    font = style->font;
+    nk_text_view_index(view, NK_TEXT_VIEW_INDEX_BUDGET);
+    row_height = nk_iceilf(font->height + 2 * style->text.padding.y);
+    area = nk_widget_bounds(ctx);
+    if (!nk_list_view_begin(ctx, &list, id, flags, row_height,
+            nk_text_view_line_count(view)))
+        return 0;
+
+    out = &ctx->current->buffer;
+    in = (ctx->current->layout->flags & NK_WINDOW_ROM) ? 0: &ctx->input;
+    if (in && !in->mouse.buttons[NK_BUTTON_LEFT].down)
+        view->selecting = nk_false;
+    /* like an edit box the view only owns the copy key after a click into it */
+    if (nk_input_is_mouse_pressed(&ctx->input, NK_BUTTON_LEFT))
+        view->active = (unsigned char)(in && nk_input_is_mouse_hovering_rect(in, area));
+
+    text.padding = style->text.padding;
+    text.background = style->window.background;
+    text.text = style->text.color;
+    has_selection = nk_text_view_selection(view, &begin, &end);
+
+    nk_layout_row_dynamic(ctx, (float)row_height, 1);
+    offset = (list.begin < list.end) ? nk_text_view_line_begin(view, list.begin): 0;
+    for (i = list.begin; i < list.end; ++i) {
+        int len = 0;
+        int line_end = nk_false;
+        nk_size next = view->size;
+        nk_size fetched;
+        struct nk_rect bounds;
+        enum nk_widget_layout_states state;
+        const char *line = nk_text_view_fetch(view, offset,
+            NK_TEXT_VIEW_BUFFER_SIZE, &fetched);
+
+        /* cut the fetched bytes down to the current line */
+        while (line && (nk_size)len < fetched) {
+            if (line[len] == '\n') {
+                next = offset + (nk_size)len + 1;
+                line_end = nk_true;
+                break;
+            } len++;
+        }
+        if (len && line[len-1] == '\r') len--;
+        if (!line) line = view->buffer;
+
+        state = nk_widget(&bounds, ctx);
+        if (state) {
+            if (has_selection && begin <= offset + (nk_size)len && end > offset) {
+                /* highlight the selected part of the line */
+                struct nk_rect sel = bounds;
+                int from = (begin > offset) ? (int)NK_MIN(begin - offset, (nk_size)len): 0;
+                float x = bounds.x + text.padding.x;
+                sel.x = x + font->width(font->userdata, font->height, line, from);
+                if (end > offset + (nk_size)len)
+                    sel.w = bounds.x + bounds.w - sel.x;
+                else sel.w = x + font->width(font->userdata, font->height,
+                        line, (int)(end - offset)) - sel.x;
+                if (sel.w > 0)
+                    nk_fill_rect(out, sel, 0, style->edit.selected_normal);
+            }
+            nk_widget_text(out, bounds, line, len, &text, NK_TEXT_LEFT, font);
+        }
+        if (state == NK_WIDGET_VALID && in) {
+            /* click sets the selection anchor and dragging extends it */
+            float x = in->mouse.pos.x - bounds.x - text.padding.x;
+            nk_size hit = offset + (nk_size)nk_text_view_hit(font, line, len, x);
+            if (nk_input_has_mouse_click_down_in_rect(in, NK_BUTTON_LEFT, bounds, nk_true)) {
+                view->select_start = view->select_end = hit;
+                view->selecting = nk_true;
+            } else if (view->selecting && in->mouse.pos.y >= bounds.y &&
+                in->mouse.pos.y < bounds.y + bounds.h) {
+                view->select_end = hit;
+            }
+        }
+        if (i + 1 < list.end)
+            offset = (line_end || !line) ? next:
+                nk_text_view_next_line(view, offset + fetched);
+    }
+    nk_list_view_end(&list);
+
+    if (in && view->active && nk_input_is_key_pressed(in, NK_KEY_COPY))
+        nk_text_view_copy(ctx, view);
+    return 1;
+}
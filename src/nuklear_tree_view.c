@@ -0,0 +1,270 @@
+#include "nuklear.h"
+#include "nuklear_internal.h"
+
+/* ===============================================================
+ *
+ *                          TREE VIEW
+ *
+ * ===============================================================*/
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+NK_API void
+nk_tree_view_init_default(struct nk_tree_view *view, nk_handle root,
+    nk_plugin_tree_children children, nk_plugin_tree_label label,
+    nk_handle userdata)
+{
+    struct nk_allocator alloc;
+    alloc.userdata.ptr = 0;
+    alloc.alloc = nk_malloc;
+    alloc.free = nk_mfree;
+    nk_tree_view_init(view, &alloc, root, children, label, userdata);
+}
+#endif
+NK_API void
+nk_tree_view_init(struct nk_tree_view *view, const struct nk_allocator *alloc,
+    nk_handle root, nk_plugin_tree_children children, nk_plugin_tree_label label,
+    nk_handle userdata)
+{
+    NK_ASSERT(view);
+    NK_ASSERT(alloc);
+    NK_ASSERT(children);
+    NK_ASSERT(label);
+    if (!view || !alloc || !children || !label) return;
+    NK_MEMSET(view, 0, sizeof(*view));
+    view->pool = *alloc;
+    view->root = root;
+    view->children = children;
+    view->label = label;
+    view->userdata = userdata;
+    view->selected = -1;
+}
+NK_API void
+nk_tree_view_free(struct nk_tree_view *view)
+{
+    NK_ASSERT(view);
+    if (!view) return;
+    if (view->pool.free) {
+        if (view->nodes) view->pool.free(view->pool.userdata, view->nodes);
+        if (view->rows) view->pool.free(view->pool.userdata, view->rows);
+    }
+    view->nodes = 0;
+    view->rows = 0;
+    view->count = view->capacity = 0;
+    view->selected = -1;
+    view->valid = nk_false;
+}
+NK_API void
+nk_tree_view_reset(struct nk_tree_view *view)
+{
+    NK_ASSERT(view);
+    if (!view) return;
+    view->count = 0;
+    view->selected = -1;
+    view->valid = nk_false;
+}
+NK_INTERN int
+nk_tree_view_reserve(struct nk_tree_view *view, int count)
+{
+    int capacity;
+    nk_handle *nodes;
+    struct nk_tree_view_row *rows;
+
+    if (count <= view->capacity) return nk_true;
+    if (!view->pool.alloc || !view->pool.free) return nk_false;
+    capacity = NK_MAX(count, view->capacity * 2);
+    capacity = NK_MAX(capacity, 64);
+    nodes = (nk_handle*)view->pool.alloc(view->pool.userdata, 0,
+        (nk_size)capacity * sizeof(nk_handle));
+    rows = (struct nk_tree_view_row*)view->pool.alloc(view->pool.userdata, 0,
+        (nk_size)capacity * sizeof(struct nk_tree_view_row));
+    if (!nodes || !rows) {
+        if (nodes) view->pool.free(view->pool.userdata, nodes);
+        if (rows) view->pool.free(view->pool.userdata, rows);
+        return nk_false;
+    }
+    if (view->count) {
+        NK_MEMCPY(nodes, view->nodes, (nk_size)view->count * sizeof(nk_handle));
+        NK_MEMCPY(rows, view->rows, (nk_size)view->count * sizeof(struct nk_tree_view_row));
+    }
+    if (view->nodes) view->pool.free(view->pool.userdata, view->nodes);
+    if (view->rows) view->pool.free(view->pool.userdata, view->rows);
+    view->nodes = nodes;
+    view->rows = rows;
+    view->capacity = capacity;
+    return nk_true;
+}
+NK_INTERN void
+nk_tree_view_move(struct nk_tree_view *view, int dst, int src, int count)
+{
+    /* moves rows within the arrays; the ranges overlap so this cannot use
+     * NK_MEMCPY, which may be defined as a plain memcpy */
+    int i;
+    if (dst > src) {
+        for (i = count - 1; i >= 0; --i) {
+            view->nodes[dst + i] = view->nodes[src + i];
+            view->rows[dst + i] = view->rows[src + i];
+        }
+    } else {
+        for (i = 0; i < count; ++i) {
+            view->nodes[dst + i] = view->nodes[src + i];
+            view->rows[dst + i] = view->rows[src + i];
+        }
+    }
+}
+NK_INTERN int
+nk_tree_view_insert(struct nk_tree_view *view, int at, nk_handle parent, int depth)
+{
+    /* enumerates the children of `parent` into new rows starting at `at`
+     * and returns the number of inserted rows */
+    int i, n, tail;
+    n = view->children(view->userdata, parent, 0, 0);
+    if (n <= 0 || !nk_tree_view_reserve(view, view->count + n))
+        return 0;
+
+    tail = view->count - at;
+    nk_tree_view_move(view, at + n, at, tail);
+    i = view->children(view->userdata, parent, view->nodes + at, n);
+    i = NK_CLAMP(0, i, n);
+    if (i < n) /* fewer children than announced so close the hole again */
+        nk_tree_view_move(view, at + i, at + n, tail);
+    n = i;
+    for (i = 0; i < n; ++i) {
+        view->rows[at + i].depth = depth;
+        view->rows[at + i].children = -1;
+        view->rows[at + i].open = nk_false;
+    }
+    view->count += n;
+    if (view->selected >= at)
+        view->selected += n;
+    return n;
+}
+NK_INTERN void
+nk_tree_view_validate(struct nk_tree_view *view)
+{
+    if (view->valid) return;
+    view->count = 0;
+    view->selected = -1;
+    nk_tree_view_insert(view, 0, view->root, 0);
+    view->valid = nk_true;
+}
+NK_API int
+nk_tree_view_expand(struct nk_tree_view *view, int row)
+{
+    int n;
+    NK_ASSERT(view);
+    if (!view) return 0;
+    nk_tree_view_validate(view);
+    if (row < 0 || row >= view->count) return 0;
+    if (view->rows[row].open) return view->rows[row].children;
+    n = nk_tree_view_insert(view, row + 1, view->nodes[row], view->rows[row].depth + 1);
+    view->rows[row].children = n;
+    view->rows[row].open = (n > 0);
+    return n;
+}
+NK_API void
+nk_tree_view_collapse(struct nk_tree_view *view, int row)
+{
+    int end, removed;
+    NK_ASSERT(view);
+    if (!view || row < 0 || row >= view->count || !view->rows[row].open)
+        return;
+
+    /* all rows behind the node with a bigger depth belong to its subtree */
+    end = row + 1;
+    while (end < view->count && view->rows[end].depth > view->rows[row].depth)
+        end++;
+    removed = end - (row + 1);
+    nk_tree_view_move(view, row + 1, end, view->count - end);
+    view->count -= removed;
+    view->rows[row].open = nk_false;
+    if (view->selected > row && view->selected < end)
+        view->selected = row;
+    else if (view->selected >= end)
+        view->selected -= removed;
+}
+NK_API nk_handle
+nk_tree_view_node(const struct nk_tree_view *view, int row)
+{
+    nk_handle handle = {0};
+    NK_ASSERT(view);
+    if (!view || row < 0 || row >= view->count) return handle;
+    return view->nodes[row];
+}
+NK_API int
+nk_tree_view(struct nk_context *ctx, struct nk_tree_view *view,
+    const char *id, nk_flags flags)
+{
+    int i, row_height;
+    int toggle = -1;
+    struct nk_list_view list;
+    struct nk_text text;
+    const struct nk_style *style;
+    const struct nk_user_font *font;
+    struct nk_command_buffer *out;
+    const struct nk_input *in;
+
+    NK_ASSERT(ctx);
+    NK_ASSERT(view);
+    NK_ASSERT(id);
+    if (!ctx || !view || !id || !ctx->current)
+        return 0;
+
+    style = &ctx->style;
+    font = style->font;
+    nk_tree_view_validate(view);
+    row_height = nk_iceilf(font->height + 2 * style->tab.padding.y);
+    if (!nk_list_view_begin(ctx, &list, id, flags, row_height, view->count))
+        return 0;
+
+    out = &ctx->current->buffer;
+    in = (ctx->current->layout->flags & NK_WINDOW_ROM) ? 0: &ctx->input;
+    text.padding = style->tab.padding;
+    text.background = style->window.background;
+    text.text = style->tab.text;
+
+    nk_layout_row_dynamic(ctx, (float)row_height, 1);
+    for (i = list.begin; i < list.end; ++i) {
+        int len = 0;
+        const char *label;
+        struct nk_rect bounds, sym, content;
+        struct nk_tree_view_row *row = &view->rows[i];
+        enum nk_widget_layout_states state = nk_widget(&bounds, ctx);
+        if (!state) continue;
+
+        /* children are only counted once a row becomes visible */
+        if (row->children < 0)
+            row->children = NK_MAX(view->children(view->userdata, view->nodes[i], 0, 0), 0);
+
+        sym.w = sym.h = font->height;
+        sym.x = bounds.x + (float)row->depth * style->tab.indent + style->tab.padding.x;
+        sym.y = bounds.y + (bounds.h - sym.h) * 0.5f;
+        content = bounds;
+        content.x = sym.x + sym.w;
+        content.w = NK_MAX(bounds.x + bounds.w - content.x, 0);
+
+        if (view->selected == i)
+            nk_fill_rect(out, content, 0, style->edit.selected_normal);
+        if (row->children)
+            nk_draw_symbol(out, row->open ? style->tab.sym_minimize: style->tab.sym_maximize,
+                sym, style->window.background, style->tab.text, 1.0f, font);
+        label = view->label(view->userdata, view->nodes[i], &len);
+        if (label)
+            nk_widget_text(out, content, label, len, &text, NK_TEXT_LEFT, font);
+
+        if (state == NK_WIDGET_VALID && in) {
+            if (row->children && nk_input_has_mouse_click_down_in_rect(in,
+                    NK_BUTTON_LEFT, sym, nk_true))
+                toggle = i;
+            else if (nk_input_has_mouse_click_down_in_rect(in, NK_BUTTON_LEFT, content, nk_true))
+                view->selected = i;
+        }
+    }
+    nk_list_view_end(&list);
+
+    /* only change the rows after all visible rows have been drawn */
+    if (toggle >= 0) {
+        if (view->rows[toggle].open)
+            nk_tree_view_collapse(view, toggle);
+        else nk_tree_view_expand(view, toggle);
+    }
+    return 1;
+}
@@ -104,6 +104,26 @@ nk_utf_len(const char *str, int len)
     }
     return glyphs;
 }
+NK_LIB int
+nk_utf_prev(const char *text, int pos)
+{
+    /* returns the byte length of the glyph ending at byte offset `pos`.
+     * Invalid sequences are treated like `nk_utf_decode` does, which
+     * consumes a single byte for each stray continuation byte. */
+    int i, len;
+    nk_rune unicode;
+    NK_ASSERT(text);
+    if (!text || pos <= 0) return 0;
+    for (i = 1; i <= NK_UTF_SIZE && i <= pos; ++i) {
+        if (((nk_byte)text[pos-i] & 0xC0) == 0x80)
+            continue;
+        len = nk_utf_decode(text + pos - i, &unicode, i);
+        if (len == i || !len)
+            return i;
+        break;
+    }
+    return 1;
+}
 NK_API const char*
 nk_utf_at(const char *buffer, int length, int index,
     nk_rune *unicode, int *len)
@@ -1056,64 +1056,4 @@ nk_text_clamp(const struct nk_user_font *font, const char *text,
         return (!sep_len) ? len: sep_len;
     }
 }
-NK_LIB struct nk_vec2
-nk_text_calculate_text_bounds(const struct nk_user_font *font,
-    const char *begin, int byte_len, float row_height, const char **remaining,
-    struct nk_vec2 *out_offset, int *glyphs, int op)
-{
-    float line_height = row_height;
-    struct nk_vec2 text_size = nk_vec2(0,0);
-    float line_width = 0.0f;
-
-    float glyph_width;
-    int glyph_len = 0;
-    nk_rune unicode = 0;
-    int text_len = 0;
-    if (!begin || byte_len <= 0 || !font)
-        return nk_vec2(0,row_height);
-
-    glyph_len = nk_utf_decode(begin, &unicode, byte_len);
-    if (!glyph_len) return text_size;
-    glyph_width = font->width(font->userdata, font->height, begin, glyph_len);
-
-    *glyphs = 0;
-    while ((text_len < byte_len) && glyph_len) {
-        if (unicode == '\n') {
-            text_size.x = NK_MAX(text_size.x, line_width);
-            text_size.y += line_height;
-            line_width = 0;
-            *glyphs+=1;
-            if (op == NK_STOP_ON_NEW_LINE)
-                break;
-
-            text_len++;
-            glyph_len = nk_utf_decode(begin + text_len, &unicode, byte_len-text_len);
-            continue;
-        }
-
-        if (unicode == '\r') {
-            text_len++;
-            *glyphs+=1;
-            glyph_len = nk_utf_decode(begin + text_len, &unicode, byte_len-text_len);
-            continue;
-        }
-
-        *glyphs = *glyphs + 1;
-        text_len += glyph_len;
-        line_width += (float)glyph_width;
-        glyph_len = nk_utf_decode(begin + text_len, &unicode, byte_len-text_len);
-        glyph_width = font->width(font->userdata, font->height, begin+text_len, glyph_len);
-        continue;
-    }
-
-    if (text_size.x < line_width)
-        text_size.x = line_width;
-    if (out_offset)
-        *out_offset = nk_vec2(line_width, text_size.y + line_height);
-    if (line_width > 0 || text_size.y == 0.0f)
-        text_size.y += line_height;
-    if (remaining)
-        *remaining = begin+text_len;
-    return text_size;
-}
 